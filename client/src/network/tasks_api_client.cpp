@@ -26,12 +26,14 @@ void TasksApiClient::fetchTasksByUser(const QString& userUuid) {
 
   const QUrl url = base_url_.resolved(
       QUrl(QStringLiteral("/task/getByUser?user_id=%1").arg(userUuid)));
-  const QNetworkRequest req(url);
+  QNetworkRequest req(url);
+  if (userUuid == etag_user_ && !etag_.isEmpty())
+    req.setRawHeader("If-None-Match", etag_);
 
   QNetworkReply* reply = nam_->get(req);
   current_reply_ = reply;
 
-  connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+  connect(reply, &QNetworkReply::finished, this, [this, reply, userUuid]() {
     if (reply != current_reply_) {
       reply->deleteLater();
       return;
@@ -46,6 +48,12 @@ void TasksApiClient::fetchTasksByUser(const QString& userUuid) {
       emit tasksFetched(false, {}, reply->errorString());
       return;
     }
+    const int code =
+        reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (code == 304 && userUuid == etag_user_) {
+      emit tasksFetched(true, etag_tasks_, QString());
+      return;
+    }
 
     const QByteArray data = reply->readAll();
     QJsonParseError err{};
@@ -76,6 +84,9 @@ void TasksApiClient::fetchTasksByUser(const QString& userUuid) {
       tasks.push_back(std::move(t));
     }
 
+    etag_user_ = userUuid;
+    etag_ = reply->rawHeader("ETag");
+    etag_tasks_ = etag_.isEmpty() ? QVector<Task>{} : tasks;
     emit tasksFetched(true, tasks, QString());
   });
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QByteArray>
 #include <QObject>
 #include <QPointer>
 #include <QUrl>
@@ -37,4 +38,8 @@ class TasksApiClient : public QObject {
   QSharedPointer<QNetworkAccessManager> nam_;
   QUrl base_url_;
   QPointer<QNetworkReply> current_reply_;
+  // Последний полученный список и его ETag: на 304 отдаётся он.
+  QString etag_user_;
+  QByteArray etag_;
+  QVector<Task> etag_tasks_;
 };
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// Счётчики глобального operator new во всём процессе бенчмарков —
+// для сравнения путей по числу и объёму выделений.
+struct AllocCounters {
+  std::uint64_t allocations = 0;
+  std::uint64_t bytes = 0;
+};
+
+AllocCounters GetAllocCounters();
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <pqxx/pqxx>
+
+#include "postgres_task_repository.hpp"
+
+// Сравнение текстовых запросов с подготовленными на локальном Postgres.
+// Нужна база с применёнными миграциями и DB_CONNECTION_STRING; без неё
+// бенчмарки пропускаются.
+
+namespace {
+
+constexpr const char* kSelectById =
+    "SELECT id, user_id, title, description, status FROM tasks WHERE id=$1";
+constexpr const char* kSelectByUser =
+    "SELECT id, user_id, title, description, status FROM tasks WHERE "
+    "user_id=$1 ORDER BY id";
+
+std::unique_ptr<pqxx::connection> Connect(benchmark::State& state) {
+  const char* connection_string = std::getenv("DB_CONNECTION_STRING");
+  if (connection_string == nullptr) {
+    state.SkipWithError("DB_CONNECTION_STRING is not set");
+    return nullptr;
+  }
+  auto connection = std::make_unique<pqxx::connection>(connection_string);
+  PostgreSQLTaskRepository::PrepareStatements(*connection);
+  return connection;
+}
+
+// Любая существующая задача; на пустой базе — несуществующий id, план
+// запроса от этого не меняется.
+std::pair<std::string, std::string> SampleIds(pqxx::connection& connection) {
+  pqxx::nontransaction txn(connection);
+  auto r = txn.exec("SELECT id, user_id FROM tasks LIMIT 1");
+  if (r.empty()) {
+    const std::string nil = "00000000-0000-0000-0000-000000000000";
+    return {nil, nil};
+  }
+  return {r[0][0].as<std::string>(), r[0][1].as<std::string>()};
+}
+
+void BM_SelectTaskByIdText(benchmark::State& state) {
+  auto connection = Connect(state);
+  if (!connection)
+    return;
+  const auto [task_id, user_id] = SampleIds(*connection);
+  for (auto _ : state) {
+    pqxx::work txn(*connection);
+    benchmark::DoNotOptimize(txn.exec(kSelectById, pqxx::params{task_id}));
+  }
+}
+
+void BM_SelectTaskByIdPrepared(benchmark::State& state) {
+  auto connection = Connect(state);
+  if (!connection)
+    return;
+  const auto [task_id, user_id] = SampleIds(*connection);
+  for (auto _ : state) {
+    pqxx::work txn(*connection);
+    benchmark::DoNotOptimize(
+        txn.exec(pqxx::prepped{"task_select_by_id"}, pqxx::params{task_id}));
+  }
+}
+
+void BM_SelectTasksByUserText(benchmark::State& state) {
+  auto connection = Connect(state);
+  if (!connection)
+    return;
+  const auto [task_id, user_id] = SampleIds(*connection);
+  for (auto _ : state) {
+    pqxx::work txn(*connection);
+    benchmark::DoNotOptimize(txn.exec(kSelectByUser, pqxx::params{user_id}));
+  }
+}
+
+void BM_SelectTasksByUserPrepared(benchmark::State& state) {
+  auto connection = Connect(state);
+  if (!connection)
+    return;
+  const auto [task_id, user_id] = SampleIds(*connection);
+  for (auto _ : state) {
+    pqxx::work txn(*connection);
+    benchmark::DoNotOptimize(txn.exec(pqxx::prepped{"task_select_by_user"},
+                                      pqxx::params{user_id}));
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_SelectTaskByIdText)->UseRealTime();
+BENCHMARK(BM_SelectTaskByIdPrepared)->UseRealTime();
+BENCHMARK(BM_SelectTasksByUserText)->UseRealTime();
+BENCHMARK(BM_SelectTasksByUserPrepared)->UseRealTime();
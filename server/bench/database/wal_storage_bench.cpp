@@ -0,0 +1,204 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <pqxx/pqxx>
+
+#include "postgres_task_repository.hpp"
+#include "postgres_user_repository.hpp"
+#include "wal_repositories.hpp"
+
+// Запись через WalStorage против PostgreSQL из нескольких потоков. Оба
+// подтверждают изменение только после fsync; у WAL параллельные изменения
+// делят один fsync, records_per_sync показывает, сколько в среднем.
+//
+// Журнал пишется во временный каталог; WAL_BENCH_DIR задаёт другой (диск
+// влияет на результат сильнее всего). Для PostgreSQL нужна база с
+// миграциями и DB_CONNECTION_STRING, без неё его бенчмарки пропускаются.
+// Задачи пишутся от нового пользователя, который удаляется в конце.
+
+namespace {
+
+constexpr int kMaxThreads = 16;
+
+struct Target {
+  std::unique_ptr<TaskRepository> tasks;
+  Uuid user_id;
+  // По задаче на поток для UpdateTaskStatus: потоки не ждут блокировок
+  // строк друг друга.
+  std::vector<Uuid> task_ids;
+
+  std::shared_ptr<WalStorage> wal;
+  std::filesystem::path wal_directory;
+  std::shared_ptr<PqxxConnectionPool> pool;
+
+  ~Target() {
+    tasks.reset();
+    wal.reset();
+    if (!wal_directory.empty())
+      std::filesystem::remove_all(wal_directory);
+    if (!pool)
+      return;
+    try {
+      PqxxConnectionPool::ConnectionHolder holder(pool);
+      pqxx::work txn(*holder.connection);
+      txn.exec("DELETE FROM users WHERE id=$1",
+               pqxx::params{user_id.ToString()});
+      txn.commit();
+    } catch (const std::exception&) {
+      // Не удалось убрать за собой: задачи останутся у пользователя bench-*.
+    }
+  }
+};
+
+// Общая для потоков одного запуска: создаётся и удаляется потоком 0 до и
+// после цикла замера.
+std::unique_ptr<Target> target;
+
+bool AddTaskIds(Target& t) {
+  for (int i = 0; i < kMaxThreads; ++i) {
+    const auto task = t.tasks->AddTask(
+        Task{t.user_id, "bench", "", TaskStatus::InProgress});
+    if (!task)
+      return false;
+    t.task_ids.push_back(task->GetId());
+  }
+  return true;
+}
+
+std::unique_ptr<Target> OpenWal(benchmark::State& state) {
+  auto t = std::make_unique<Target>();
+  const char* directory = std::getenv("WAL_BENCH_DIR");
+  t->wal_directory = directory ? std::filesystem::path(directory)
+                               : std::filesystem::temp_directory_path();
+  t->wal_directory /= "wal_bench_" + std::to_string(std::random_device{}());
+  WalStorage::Options options;
+  options.directory = t->wal_directory;
+  options.snapshot_every = 0;
+  t->wal = std::make_shared<WalStorage>(options);
+  t->tasks = std::make_unique<WalTaskRepository>(t->wal);
+  const auto user = WalUserRepository(t->wal).AddUser(User{"bench", "bench"});
+  if (user)
+    t->user_id = user->GetId();
+  if (!user || !AddTaskIds(*t)) {
+    state.SkipWithError("WAL setup failed");
+    return nullptr;
+  }
+  return t;
+}
+
+std::unique_ptr<Target> OpenPostgres(benchmark::State& state) {
+  const char* connection_string = std::getenv("DB_CONNECTION_STRING");
+  if (connection_string == nullptr) {
+    state.SkipWithError("DB_CONNECTION_STRING is not set");
+    return nullptr;
+  }
+  PqxxConnectionPool::Options pool_options;
+  pool_options.min_size = kMaxThreads;
+  pool_options.max_size = kMaxThreads;
+  auto t = std::make_unique<Target>();
+  t->pool = std::make_shared<PqxxConnectionPool>(
+      connection_string, pool_options, [](pqxx::connection& connection) {
+        PostgreSQLTaskRepository::PrepareStatements(connection);
+        PostgreSQLUserRepository::PrepareStatements(connection);
+      });
+  const auto user = PostgreSQLUserRepository(t->pool).AddUser(
+      User{"bench-" + Uuid::Random().ToString(), "bench"});
+  if (!user) {
+    t->pool.reset();
+    state.SkipWithError("cannot create a benchmark user");
+    return nullptr;
+  }
+  t->user_id = user->GetId();
+  t->tasks = std::make_unique<PostgreSQLTaskRepository>(t->pool);
+  if (!AddTaskIds(*t)) {
+    state.SkipWithError("cannot create benchmark tasks");
+    return nullptr;
+  }
+  return t;
+}
+
+using OpenTarget = std::unique_ptr<Target> (*)(benchmark::State&);
+
+void Setup(benchmark::State& state, OpenTarget open) {
+  if (state.thread_index() == 0)
+    target = open(state);
+}
+
+void Teardown(benchmark::State& state) {
+  if (state.thread_index() != 0 || !target)
+    return;
+  if (target->wal) {
+    const auto stats = target->wal->GetStats();
+    state.counters["records_per_sync"] =
+        stats.syncs ? static_cast<double>(stats.records) / stats.syncs : 0;
+  }
+  target.reset();
+}
+
+void AddTask(benchmark::State& state, OpenTarget open) {
+  Setup(state, open);
+  for (auto _ : state) {
+    if (!target) {
+      // Поток 0 уже пропустил замер; остальные тоже должны.
+      state.SkipWithError("setup failed");
+      break;
+    }
+    const auto task = target->tasks->AddTask(
+        Task{target->user_id, "bench", "", TaskStatus::InProgress});
+    if (!task) {
+      state.SkipWithError("AddTask failed");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  Teardown(state);
+}
+
+void UpdateTaskStatus(benchmark::State& state, OpenTarget open) {
+  Setup(state, open);
+  bool done = false;
+  for (auto _ : state) {
+    if (!target) {
+      state.SkipWithError("setup failed");
+      break;
+    }
+    const auto task =
+        target->tasks->UpdateTaskStatus(target->task_ids[state.thread_index()],
+                                        done ? TaskStatus::Done
+                                             : TaskStatus::InProgress);
+    if (!task) {
+      state.SkipWithError("UpdateTaskStatus failed");
+      break;
+    }
+    done = !done;
+  }
+  state.SetItemsProcessed(state.iterations());
+  Teardown(state);
+}
+
+void BM_WalAddTask(benchmark::State& state) { AddTask(state, OpenWal); }
+void BM_PostgresAddTask(benchmark::State& state) {
+  AddTask(state, OpenPostgres);
+}
+void BM_WalUpdateTaskStatus(benchmark::State& state) {
+  UpdateTaskStatus(state, OpenWal);
+}
+void BM_PostgresUpdateTaskStatus(benchmark::State& state) {
+  UpdateTaskStatus(state, OpenPostgres);
+}
+
+}  // namespace
+
+BENCHMARK(BM_WalAddTask)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK(BM_PostgresAddTask)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK(BM_WalUpdateTaskStatus)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK(BM_PostgresUpdateTaskStatus)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
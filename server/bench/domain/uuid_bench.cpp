@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "uuid.hpp"
+
+// Строковые id против 16-байтового Uuid: разбор/форматирование и поиск в
+// хеш-таблице, как в кэшах по id задачи.
+
+namespace {
+
+std::vector<Uuid> RandomIds(std::size_t count) {
+  std::mt19937_64 rng(42);
+  std::vector<Uuid> ids;
+  ids.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    Uuid::Bytes bytes;
+    for (auto& b : bytes)
+      b = static_cast<std::uint8_t>(rng());
+    ids.emplace_back(bytes);
+  }
+  return ids;
+}
+
+void BM_UuidParse(benchmark::State& state) {
+  const std::string text = RandomIds(1)[0].ToString();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Uuid::Parse(text));
+  }
+}
+
+void BM_UuidFormat(benchmark::State& state) {
+  const Uuid id = RandomIds(1)[0];
+  char out[Uuid::kStringSize];
+  for (auto _ : state) {
+    id.Format(out);
+    benchmark::DoNotOptimize(out);
+  }
+}
+
+void BM_StringIdLookup(benchmark::State& state) {
+  const auto ids = RandomIds(static_cast<std::size_t>(state.range(0)));
+  std::unordered_set<std::string> set;
+  std::vector<std::string> keys;
+  for (const auto& id : ids) {
+    set.insert(id.ToString());
+    keys.push_back(id.ToString());
+  }
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(set.find(keys[i++ % keys.size()]));
+  }
+}
+
+void BM_UuidLookup(benchmark::State& state) {
+  const auto ids = RandomIds(static_cast<std::size_t>(state.range(0)));
+  const std::unordered_set<Uuid> set(ids.begin(), ids.end());
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(set.find(ids[i++ % ids.size()]));
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_UuidParse);
+BENCHMARK(BM_UuidFormat);
+BENCHMARK(BM_StringIdLookup)->Arg(1000)->Arg(100000);
+BENCHMARK(BM_UuidLookup)->Arg(1000)->Arg(100000);
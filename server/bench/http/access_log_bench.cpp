@@ -0,0 +1,197 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/log/utility/setup/common_attributes.hpp>
+#include <boost/log/utility/setup/console.hpp>
+
+#include "access_log.hpp"
+#include "router.hpp"
+#include "session.hpp"
+
+// Пропускная способность сервера на loopback при разных способах записи
+// журнала запросов: без журнала, AccessLog и прежний синхронный
+// BOOST_LOG_TRIVIAL на каждый запрос. Строки уходят в поток без вывода,
+// поэтому измеряется только цена самого журнала.
+
+namespace {
+
+enum Mode { kOff, kAccessLog, kBoostLog };
+
+constexpr std::size_t kServerThreads = 4;
+constexpr std::size_t kConnections = 4;
+constexpr std::size_t kDepth = 16;
+
+class NullBuffer final : public std::streambuf {
+ protected:
+  int overflow(int c) override { return c; }
+  std::streamsize xsputn(const char* /*s*/, std::streamsize n) override {
+    return n;
+  }
+};
+
+NullBuffer g_null_buffer;
+std::ostream g_null_stream(&g_null_buffer);
+
+namespace logging = boost::log;
+
+void SetBoostLogSeverity(logging::trivial::severity_level severity) {
+  logging::core::get()->set_filter(logging::trivial::severity >= severity);
+  logging::core::get()->set_logging_enabled(true);
+}
+
+// Тот же sink и формат, что у консольного лога в main.
+void AddNullSink() {
+  static const bool added = [] {
+    logging::add_common_attributes();
+    logging::add_console_log(
+        g_null_stream,
+        logging::keywords::format = "%TimeStamp% [%Severity%] %Message%");
+    return true;
+  }();
+  (void)added;
+}
+
+class PingHandler final : public Handler {
+ public:
+  explicit PingHandler(bool boost_log) : boost_log_(boost_log) {}
+
+  std::string GetMethodEndpoint() const override { return "GET /ping"; }
+
+  HttpResponse Execute(const HttpRequest& req) override {
+    if (boost_log_) {
+      BOOST_LOG_TRIVIAL(info) << "Request received: " << req.method_string()
+                              << " " << req.target()
+                              << " | Thread ID: " << std::this_thread::get_id();
+    }
+    HttpResponse resp;
+    resp.result(http::status::ok);
+    resp.set(http::field::content_type, "application/json");
+    resp.body() = R"({"status":"ok"})";
+    resp.prepare_payload();
+    return resp;
+  }
+
+ private:
+  bool boost_log_;
+};
+
+// Общий io_context на несколько потоков, как IoModel::SharedContext.
+class LoopbackServer {
+ public:
+  LoopbackServer(bool boost_log, std::shared_ptr<AccessLog> access_log) {
+    auto router = std::make_shared<SimpleRouter>();
+    router->Add(std::make_shared<PingHandler>(boost_log));
+    router_ = router;
+    options_.access_log = std::move(access_log);
+    acceptor_.open(ip::tcp::v4());
+    acceptor_.bind({ip::make_address("127.0.0.1"), 0});
+    acceptor_.listen();
+    Accept();
+    for (std::size_t i = 0; i < kServerThreads; ++i)
+      threads_.emplace_back([this] { io_context_.run(); });
+  }
+
+  ~LoopbackServer() {
+    io_context_.stop();
+    for (auto& thread : threads_)
+      thread.join();
+  }
+
+  ip::tcp::endpoint Endpoint() const { return acceptor_.local_endpoint(); }
+
+ private:
+  void Accept() {
+    acceptor_.async_accept(net::make_strand(io_context_),
+                           [this](beast::error_code ec, ip::tcp::socket s) {
+                             if (ec)
+                               return;
+                             HttpSession::Start(std::make_shared<HttpSession>(
+                                 std::move(s), router_, nullptr, options_));
+                             Accept();
+                           });
+  }
+
+  net::io_context io_context_;
+  ip::tcp::acceptor acceptor_{io_context_};
+  std::shared_ptr<Router> router_;
+  SessionOptions options_;
+  std::vector<std::thread> threads_;
+};
+
+const std::string kRequest =
+    "GET /ping HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "\r\n";
+
+// На каждом из kConnections соединений — пачка из kDepth pipelined
+// запросов; сервер обрабатывает соединения параллельно.
+void BM_RequestLogging(benchmark::State& state) {
+  const auto mode = static_cast<Mode>(state.range(0));
+  std::shared_ptr<AccessLog> access_log;
+  if (mode == kAccessLog) {
+    access_log =
+        std::make_shared<AccessLog>(g_null_stream, AccessLog::Options{});
+    // AccessLog выставил фильтр Boost.Log в info; остальные логи не нужны.
+    SetBoostLogSeverity(logging::trivial::warning);
+  } else if (mode == kBoostLog) {
+    AddNullSink();
+    SetBoostLogSeverity(logging::trivial::info);
+  }
+
+  {
+    LoopbackServer server(mode == kBoostLog, access_log);
+    net::io_context client_context;
+    std::vector<ip::tcp::socket> sockets;
+    std::vector<beast::flat_buffer> buffers(kConnections);
+    for (std::size_t i = 0; i < kConnections; ++i) {
+      sockets.emplace_back(client_context);
+      sockets.back().connect(server.Endpoint());
+      sockets.back().set_option(ip::tcp::no_delay(true));
+    }
+
+    std::string burst;
+    for (std::size_t i = 0; i < kDepth; ++i)
+      burst += kRequest;
+
+    for (auto _ : state) {
+      for (auto& socket : sockets)
+        net::write(socket, net::buffer(burst));
+      for (std::size_t c = 0; c < kConnections; ++c) {
+        for (std::size_t i = 0; i < kDepth; ++i) {
+          http::response<http::string_body> resp;
+          http::read(sockets[c], buffers[c], resp);
+          benchmark::DoNotOptimize(resp);
+        }
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * kConnections * kDepth);
+  }
+
+  if (access_log) {
+    access_log->Flush();
+    const auto stats = access_log->GetStats();
+    state.counters["dropped"] = static_cast<double>(stats.dropped);
+  }
+  // Как в bench_main: логи остальных замеров не пишутся.
+  SetBoostLogSeverity(logging::trivial::warning);
+}
+
+}  // namespace
+
+BENCHMARK(BM_RequestLogging)
+    ->ArgName("mode")
+    ->Arg(kOff)
+    ->Arg(kAccessLog)
+    ->Arg(kBoostLog)
+    ->UseRealTime();
@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+
+#include "json_reader.hpp"
+
+// Разбор тела POST /task: DOM nlohmann::json с копиями полей против
+// JsonFieldReader.
+
+namespace {
+
+const std::string kCreateTaskBody =
+    R"({"user_id":"6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60",)"
+    R"("title":"Подготовить релиз 1.4",)"
+    R"("description":"Собрать changelog, прогнать нагрузочные тесты и )"
+    R"(обновить \"docker-compose\" для стенда",)"
+    R"("status":"InProgress"})";
+
+void BM_ParseCreateTaskNlohmann(benchmark::State& state) {
+  for (auto _ : state) {
+    const auto body = nlohmann::json::parse(kCreateTaskBody);
+    auto user_id = body.at("user_id").get<std::string>();
+    auto title = body.at("title").get<std::string>();
+    auto description = body.at("description").get<std::string>();
+    auto status = body.at("status").get<std::string>();
+    benchmark::DoNotOptimize(user_id);
+    benchmark::DoNotOptimize(title);
+    benchmark::DoNotOptimize(description);
+    benchmark::DoNotOptimize(status);
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          kCreateTaskBody.size());
+}
+
+void BM_ParseCreateTaskFieldReader(benchmark::State& state) {
+  for (auto _ : state) {
+    JsonFieldReader body({"user_id", "title", "description", "status"});
+    benchmark::DoNotOptimize(body.Parse(kCreateTaskBody));
+    benchmark::DoNotOptimize(body.Get("description").data());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          kCreateTaskBody.size());
+}
+
+}  // namespace
+
+BENCHMARK(BM_ParseCreateTaskNlohmann);
+BENCHMARK(BM_ParseCreateTaskFieldReader);
@@ -0,0 +1,81 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "handlers/task_json.hpp"
+
+// Сериализация списка задач: дерево nlohmann::json с dump (прежний путь
+// GetAllTasksHandler) против JsonWriter. Счётчики: байты и число выделений
+// памяти на задачу.
+
+namespace {
+
+std::vector<Task> MakeTasks(std::size_t count) {
+  std::mt19937_64 rng(7);
+  const auto random_id = [&rng] {
+    Uuid::Bytes bytes;
+    for (auto& b : bytes)
+      b = static_cast<std::uint8_t>(rng());
+    return Uuid(bytes);
+  };
+  const Uuid user_id = random_id();
+  std::vector<Task> tasks;
+  tasks.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    tasks.emplace_back(random_id(), user_id, "Task #" + std::to_string(i),
+                       "Описание задачи с \"кавычками\" и переводом\nстроки",
+                       static_cast<TaskStatus>(i % 3));
+  }
+  return tasks;
+}
+
+std::string NlohmannTaskList(const std::vector<Task>& tasks) {
+  nlohmann::json out;
+  out["tasks"] = nlohmann::json::array();
+  for (const auto& t : tasks) {
+    out["tasks"].push_back({
+        {"id", t.GetId().ToString()},
+        {"user_id", t.GetUserId().ToString()},
+        {"title", t.GetTitle()},
+        {"description", t.GetDescription()},
+        {"status", ToString(t.GetStatus())},
+    });
+  }
+  return out.dump();
+}
+
+template <class Serialize>
+void RunTaskList(benchmark::State& state, Serialize serialize) {
+  const auto tasks = MakeTasks(static_cast<std::size_t>(state.range(0)));
+  const AllocCounters before = GetAllocCounters();
+  for (auto _ : state) {
+    std::string body = serialize(tasks);
+    benchmark::DoNotOptimize(body.data());
+  }
+  const AllocCounters after = GetAllocCounters();
+  const double per_task =
+      static_cast<double>(state.iterations()) * tasks.size();
+  state.counters["alloc_bytes/task"] = (after.bytes - before.bytes) / per_task;
+  state.counters["allocs/task"] =
+      (after.allocations - before.allocations) / per_task;
+  state.SetItemsProcessed(static_cast<std::int64_t>(per_task));
+}
+
+void BM_TaskListNlohmann(benchmark::State& state) {
+  RunTaskList(state, NlohmannTaskList);
+}
+
+void BM_TaskListJsonWriter(benchmark::State& state) {
+  RunTaskList(state, TaskListToJson);
+}
+
+}  // namespace
+
+BENCHMARK(BM_TaskListNlohmann)->Arg(10000);
+BENCHMARK(BM_TaskListJsonWriter)->Arg(10000);
@@ -0,0 +1,125 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+
+#include "router.hpp"
+#include "session.hpp"
+
+namespace {
+
+class PingHandler final : public Handler {
+ public:
+  std::string GetMethodEndpoint() const override { return "PATCH /task/status"; }
+  HttpResponse Execute(const HttpRequest& /*req*/) override {
+    HttpResponse resp;
+    resp.result(http::status::ok);
+    resp.set(http::field::content_type, "application/json");
+    resp.body() = R"({"status":"ok"})";
+    resp.prepare_payload();
+    return resp;
+  }
+};
+
+// Сервер на loopback с одним потоком io_context и сессиями HttpSession.
+class LoopbackServer {
+ public:
+  LoopbackServer() {
+    auto router = std::make_shared<SimpleRouter>();
+    router->Add(std::make_shared<PingHandler>());
+    router_ = router;
+    acceptor_.open(ip::tcp::v4());
+    acceptor_.bind({ip::make_address("127.0.0.1"), 0});
+    acceptor_.listen();
+    Accept();
+    thread_ = std::thread([this] { io_context_.run(); });
+  }
+
+  ~LoopbackServer() {
+    io_context_.stop();
+    thread_.join();
+  }
+
+  ip::tcp::endpoint Endpoint() const { return acceptor_.local_endpoint(); }
+
+ private:
+  void Accept() {
+    acceptor_.async_accept(net::make_strand(io_context_),
+                           [this](beast::error_code ec, ip::tcp::socket s) {
+                             if (ec)
+                               return;
+                             HttpSession::Start(std::make_shared<HttpSession>(
+                                 std::move(s), router_, nullptr,
+                                 SessionOptions{}));
+                             Accept();
+                           });
+  }
+
+  net::io_context io_context_;
+  ip::tcp::acceptor acceptor_{io_context_};
+  std::shared_ptr<Router> router_;
+  std::thread thread_;
+};
+
+const std::string kRequest =
+    "PATCH /task/status HTTP/1.1\r\n"
+    "Host: localhost\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: 27\r\n"
+    "\r\n"
+    R"({"id":"1","status":"Done"})"
+    "\n";
+
+void BM_Serial(benchmark::State& state) {
+  LoopbackServer server;
+  net::io_context client_context;
+  ip::tcp::socket socket(client_context);
+  socket.connect(server.Endpoint());
+  socket.set_option(ip::tcp::no_delay(true));
+  beast::flat_buffer buffer;
+  const auto depth = static_cast<std::size_t>(state.range(0));
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < depth; ++i) {
+      net::write(socket, net::buffer(kRequest));
+      HttpResponse resp;
+      http::read(socket, buffer, resp);
+      benchmark::DoNotOptimize(resp);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * depth);
+}
+
+void BM_Pipelined(benchmark::State& state) {
+  LoopbackServer server;
+  net::io_context client_context;
+  ip::tcp::socket socket(client_context);
+  socket.connect(server.Endpoint());
+  socket.set_option(ip::tcp::no_delay(true));
+  beast::flat_buffer buffer;
+  const auto depth = static_cast<std::size_t>(state.range(0));
+
+  std::string burst;
+  for (std::size_t i = 0; i < depth; ++i) {
+    burst += kRequest;
+  }
+
+  for (auto _ : state) {
+    net::write(socket, net::buffer(burst));
+    for (std::size_t i = 0; i < depth; ++i) {
+      HttpResponse resp;
+      http::read(socket, buffer, resp);
+      benchmark::DoNotOptimize(resp);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * depth);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Serial)->Arg(1)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
+BENCHMARK(BM_Pipelined)->Arg(1)->Arg(8)->Arg(16)->Arg(32)->UseRealTime();
@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/beast/http.hpp>
+
+#include "router.hpp"
+
+namespace {
+
+class EmptyHandler final : public Handler {
+ public:
+  explicit EmptyHandler(std::string endpoint) : endpoint_(std::move(endpoint)) {}
+  std::string GetMethodEndpoint() const override { return endpoint_; }
+  HttpResponse Execute(const HttpRequest& /*req*/) override { return {}; }
+
+ private:
+  std::string endpoint_;
+};
+
+// Прежняя схема: ключ "METHOD /path" собирается на каждый запрос.
+class StringKeyRouter {
+ public:
+  void Add(std::shared_ptr<Handler> handler) {
+    endpoint_to_handler_[handler->GetMethodEndpoint()] = std::move(handler);
+  }
+
+  HttpResponse Dispatch(const HttpRequest& req) const {
+    const std::string key =
+        std::string(http::to_string(req.method())) + " " +
+        std::string(req.target().substr(0, req.target().find('?')));
+    auto it = endpoint_to_handler_.find(key);
+    if (it == endpoint_to_handler_.end()) {
+      return {};
+    }
+    return it->second->Execute(req);
+  }
+
+ private:
+  std::unordered_map<std::string, std::shared_ptr<Handler>>
+      endpoint_to_handler_;
+};
+
+const std::array<const char*, 7> kEndpoints = {
+    "POST /user/register", "POST /user/login",     "POST /task",
+    "PATCH /task/status",  "DELETE /task/delete",  "GET /task/getByUser",
+    "GET /task/get",
+};
+
+std::vector<HttpRequest> MakeRequests() {
+  const std::array<std::pair<http::verb, const char*>, 7> targets = {{
+      {http::verb::post, "/user/register"},
+      {http::verb::post, "/user/login"},
+      {http::verb::post, "/task"},
+      {http::verb::patch, "/task/status"},
+      {http::verb::delete_, "/task/delete?id=6f1c1f0e-8a4b-4f7d-9c55"},
+      {http::verb::get, "/task/getByUser?user_id=6f1c1f0e-8a4b-4f7d-9c55"},
+      {http::verb::get, "/task/get?id=6f1c1f0e-8a4b-4f7d-9c55"},
+  }};
+  std::vector<HttpRequest> requests;
+  for (const auto& [verb, target] : targets) {
+    requests.emplace_back(verb, target, 11);
+  }
+  return requests;
+}
+
+template <class R>
+void RunDispatch(benchmark::State& state, R& router) {
+  for (const auto* endpoint : kEndpoints) {
+    router.Add(std::make_shared<EmptyHandler>(endpoint));
+  }
+  const auto requests = MakeRequests();
+  const auto& req = requests[state.range(0)];
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(router.Dispatch(req));
+  }
+  state.SetLabel(kEndpoints[state.range(0)]);
+}
+
+void BM_TrieRouterDispatch(benchmark::State& state) {
+  SimpleRouter router;
+  RunDispatch(state, router);
+}
+
+void BM_StringKeyRouterDispatch(benchmark::State& state) {
+  StringKeyRouter router;
+  RunDispatch(state, router);
+}
+
+void BM_TrieRouterPathParam(benchmark::State& state) {
+  SimpleRouter router;
+  router.Add("GET /task/{id}", std::make_shared<EmptyHandler>("GET /task/get"));
+  const HttpRequest req{
+      http::verb::get, "/task/6f1c1f0e-8a4b-4f7d-9c55", 11};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(router.Dispatch(req));
+  }
+}
+
+// То же с гистограммой и счётчиками ответов на маршрут; потоки пишут
+// в метрики одного маршрута одновременно.
+void BM_TrieRouterWithMetrics(benchmark::State& state) {
+  static const auto router = [] {
+    auto r =
+        std::make_unique<SimpleRouter>(std::make_shared<MetricsRegistry>());
+    r->Add("GET /task/{id}", std::make_shared<EmptyHandler>("GET /task"));
+    return r;
+  }();
+  const HttpRequest req{
+      http::verb::get, "/task/6f1c1f0e-8a4b-4f7d-9c55", 11};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(router->Dispatch(req));
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_TrieRouterDispatch)->DenseRange(0, 6);
+BENCHMARK(BM_StringKeyRouterDispatch)->DenseRange(0, 6);
+BENCHMARK(BM_TrieRouterPathParam);
+BENCHMARK(BM_TrieRouterWithMetrics)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,214 @@
+#include "load_generator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+
+namespace {
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kIoTimeout = std::chrono::seconds(10);
+// Пауза после ошибки соединения, чтобы упавший сервер не превращал
+// генератор в цикл connect.
+constexpr auto kErrorBackoff = std::chrono::milliseconds(10);
+
+class LoadRun {
+ public:
+  LoadRun(const LoadOptions& options, const LoadProfile& profile)
+      : options_(options), profile_(profile) {
+    if (profile_.empty())
+      throw std::invalid_argument("Load profile has no routes");
+    unsigned total = 0;
+    for (const auto& route : profile_) {
+      total += route.weight;
+      cumulative_weights_.push_back(total);
+      routes_.push_back(std::make_unique<RouteStats>());
+    }
+    if (total == 0)
+      throw std::invalid_argument("Load profile weights are all zero");
+  }
+
+  LoadReport Run() {
+    const std::size_t threads = std::max<std::size_t>(options_.threads, 1);
+    net::io_context io_context(static_cast<int>(threads));
+    start_ = Clock::now();
+    measure_from_ = start_ + options_.warmup;
+    deadline_ = measure_from_ + options_.duration;
+    for (std::size_t i = 0; i < options_.connections; ++i) {
+      net::co_spawn(net::make_strand(io_context), Connection(i),
+                    net::detached);
+    }
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < threads; ++i)
+      workers.emplace_back([&io_context] { io_context.run(); });
+    for (auto& worker : workers)
+      worker.join();
+    return MakeReport();
+  }
+
+ private:
+  struct RouteStats {
+    LatencyHistogram latency;
+    std::atomic<std::uint64_t> requests{0};
+    std::atomic<std::uint64_t> errors{0};
+  };
+
+  net::awaitable<void> Connection(std::size_t index) {
+    const auto executor = co_await net::this_coro::executor;
+    std::mt19937_64 rng(options_.seed + index);
+    beast::tcp_stream stream(executor);
+    beast::flat_buffer buffer;
+    net::steady_timer timer(executor);
+    bool connected = false;
+
+    // В открытом цикле соединения сдвинуты друг относительно друга, чтобы
+    // запросы не уходили пачками.
+    const bool open_loop = options_.rate > 0;
+    Clock::duration interval{};
+    Clock::time_point next = start_;
+    if (open_loop) {
+      interval = std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(
+              static_cast<double>(options_.connections) / options_.rate));
+      next += interval * static_cast<long>(index) /
+              static_cast<long>(options_.connections);
+    }
+
+    for (;;) {
+      Clock::time_point scheduled = Clock::now();
+      if (open_loop) {
+        if (next > scheduled) {
+          timer.expires_at(next);
+          co_await timer.async_wait(net::use_awaitable);
+        }
+        scheduled = next;
+        next += interval;
+      }
+      if (scheduled >= deadline_)
+        break;
+
+      const std::size_t route = PickRoute(rng);
+      LoadRequest spec = profile_[route].make(rng);
+      http::request<http::string_body> req{spec.method, spec.target, 11};
+      req.set(http::field::host, "localhost");
+      req.keep_alive(options_.keep_alive);
+      if (!spec.body.empty()) {
+        req.set(http::field::content_type, "application/json");
+        req.body() = std::move(spec.body);
+      }
+      req.prepare_payload();
+
+      beast::error_code ec;
+      if (!connected) {
+        stream.expires_after(kIoTimeout);
+        co_await stream.async_connect(
+            options_.endpoint, net::redirect_error(net::use_awaitable, ec));
+        if (!ec) {
+          stream.socket().set_option(net::ip::tcp::no_delay(true));
+          connected = true;
+        }
+      }
+      http::response<http::string_body> resp;
+      if (!ec) {
+        stream.expires_after(kIoTimeout);
+        co_await http::async_write(stream, req,
+                                   net::redirect_error(net::use_awaitable, ec));
+      }
+      if (!ec) {
+        co_await http::async_read(stream, buffer, resp,
+                                  net::redirect_error(net::use_awaitable, ec));
+      }
+      if (ec) {
+        if (scheduled >= measure_from_)
+          io_errors_.fetch_add(1, std::memory_order_relaxed);
+        Reset(stream, buffer, connected);
+        timer.expires_after(kErrorBackoff);
+        co_await timer.async_wait(net::use_awaitable);
+        continue;
+      }
+
+      if (scheduled >= measure_from_)
+        Record(route, Clock::now() - scheduled, resp.result_int());
+      if (!options_.keep_alive || !resp.keep_alive())
+        Reset(stream, buffer, connected);
+    }
+    Reset(stream, buffer, connected);
+  }
+
+  static void Reset(beast::tcp_stream& stream, beast::flat_buffer& buffer,
+                    bool& connected) {
+    beast::error_code ec;
+    stream.socket().shutdown(net::ip::tcp::socket::shutdown_both, ec);
+    stream.close();
+    buffer.clear();
+    connected = false;
+  }
+
+  std::size_t PickRoute(std::mt19937_64& rng) const {
+    std::uniform_int_distribution<unsigned> dist(
+        0, cumulative_weights_.back() - 1);
+    const auto it = std::upper_bound(cumulative_weights_.begin(),
+                                     cumulative_weights_.end(), dist(rng));
+    return static_cast<std::size_t>(it - cumulative_weights_.begin());
+  }
+
+  void Record(std::size_t route, Clock::duration latency, unsigned status) {
+    const auto us =
+        std::chrono::duration_cast<std::chrono::microseconds>(latency);
+    RouteStats& stats = *routes_[route];
+    stats.latency.Record(us);
+    stats.requests.fetch_add(1, std::memory_order_relaxed);
+    if (status >= 400)
+      stats.errors.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  LoadReport MakeReport() const {
+    LoadReport report;
+    report.elapsed = options_.duration;
+    report.io_errors = io_errors_.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < profile_.size(); ++i) {
+      LoadReport::Route route;
+      route.name = profile_[i].name;
+      route.requests = routes_[i]->requests.load(std::memory_order_relaxed);
+      route.errors = routes_[i]->errors.load(std::memory_order_relaxed);
+      route.latency = routes_[i]->latency.GetSnapshot();
+      report.requests += route.requests;
+      report.errors += route.errors;
+      for (std::size_t b = 0; b < LatencyHistogram::kBucketCount; ++b)
+        report.latency.counts[b] += route.latency.counts[b];
+      report.latency.count += route.latency.count;
+      report.latency.sum += route.latency.sum;
+      report.routes.push_back(std::move(route));
+    }
+    return report;
+  }
+
+  const LoadOptions& options_;
+  const LoadProfile& profile_;
+  std::vector<unsigned> cumulative_weights_;
+  std::vector<std::unique_ptr<RouteStats>> routes_;
+  std::atomic<std::uint64_t> io_errors_{0};
+  Clock::time_point start_;
+  Clock::time_point measure_from_;
+  Clock::time_point deadline_;
+};
+
+}  // namespace
+
+double LoadReport::Rps() const {
+  const auto seconds = std::chrono::duration<double>(elapsed).count();
+  return seconds > 0 ? static_cast<double>(requests) / seconds : 0;
+}
+
+LoadReport RunLoad(const LoadOptions& options, const LoadProfile& profile) {
+  LoadRun run(options, profile);
+  return run.Run();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/http/verb.hpp>
+
+#include "metrics_registry.hpp"
+
+// Запрос, который генератор отправит серверу.
+struct LoadRequest {
+  boost::beast::http::verb method = boost::beast::http::verb::get;
+  std::string target;
+  std::string body;
+};
+
+// Маршрут профиля нагрузки: доля weight среди всех маршрутов профиля,
+// make строит очередной запрос (идентификаторы и т. п. берутся из rng).
+struct LoadRoute {
+  std::string name;
+  unsigned weight = 1;
+  std::function<LoadRequest(std::mt19937_64& rng)> make;
+};
+
+using LoadProfile = std::vector<LoadRoute>;
+
+struct LoadOptions {
+  boost::asio::ip::tcp::endpoint endpoint;
+  std::size_t connections = 64;
+  // Потоки io_context генератора.
+  std::size_t threads = 2;
+  std::chrono::steady_clock::duration duration = std::chrono::seconds(10);
+  // Запросы прогрева отправляются, но не попадают в отчёт.
+  std::chrono::steady_clock::duration warmup = std::chrono::seconds(1);
+  // false — на каждый запрос новое соединение с Connection: close, и
+  // задержка включает connect.
+  bool keep_alive = true;
+  // 0 — замкнутый цикл: соединение отправляет следующий запрос сразу после
+  // ответа. Иначе — открытый цикл с суммарным темпом rate запросов в
+  // секунду, поровну между соединениями. Задержка считается от
+  // запланированного момента отправки, так что отставание сервера не
+  // прячется за реже отправленными запросами (coordinated omission).
+  double rate = 0;
+  std::uint64_t seed = 1;
+};
+
+struct LoadReport {
+  struct Route {
+    std::string name;
+    std::uint64_t requests = 0;
+    // Ответы с кодом не из 2xx/3xx.
+    std::uint64_t errors = 0;
+    LatencyHistogram::Snapshot latency;
+  };
+
+  std::chrono::steady_clock::duration elapsed{};
+  std::vector<Route> routes;
+  LatencyHistogram::Snapshot latency;
+  std::uint64_t requests = 0;
+  std::uint64_t errors = 0;
+  // Разорванные соединения и ошибки чтения/записи; соединение после них
+  // открывается заново.
+  std::uint64_t io_errors = 0;
+
+  double Rps() const;
+};
+
+// Прогоняет нагрузку на options.endpoint и блокирует вызывающий поток до
+// конца замера. Соединения — корутины Beast на собственном io_context.
+LoadReport RunLoad(const LoadOptions& options, const LoadProfile& profile);
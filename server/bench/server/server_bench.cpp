@@ -0,0 +1,555 @@
+// Сквозной замер сервера: HttpServer с маршрутами RouterDefaultConfigure
+// поверх заглушки или хранилища в памяти и встроенный генератор нагрузки на
+// loopback.
+// Печатает RPS и квантили задержки в целом и по маршрутам.
+//
+//   server_bench --profile=mixed --connections=64 --duration=10
+//   server_bench --rate=20000 --keep-alive=off
+//
+// Флаги — см. kUsage.
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <expected>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+
+#include "bootstrap/routes.hpp"
+#include "dispatch_pool.hpp"
+#include "load_generator.hpp"
+#include "memory_task_repository.hpp"
+#include "router.hpp"
+#include "server.hpp"
+
+namespace {
+
+constexpr std::string_view kUsage = R"(Usage: server_bench [--flag=value ...]
+
+Load:
+  --profile=read|write|mixed   route mix (mixed)
+  --connections=N              client connections (64)
+  --client-threads=N           load generator threads (2)
+  --duration=SECONDS           measured time (10)
+  --warmup=SECONDS             unmeasured warmup (1)
+  --rate=RPS                   open loop at RPS in total; 0 = closed loop (0)
+  --keep-alive=on|off          reuse connections (on)
+  --seed=N                     seed for route and id choice (1)
+
+Server:
+  --server-threads=N           io_context threads, 0 = all cores (0)
+  --io-model=shared|sharded    IoModel (shared)
+  --dispatch-threads=N         handler pool threads, 0 = none (0)
+  --response-cache-bytes=N     ETag/response cache size, 0 = off (0)
+  --port=N                     listen port on 127.0.0.1, 0 = any free (0)
+
+Data:
+  --storage=stub|memory        fixed stub TaskService or DefaultTaskService
+                               over InMemoryTaskRepository (stub)
+  --users=N                    users in the initial data set (100)
+  --tasks-per-user=N           tasks per user (20)
+)";
+
+using Flags = std::map<std::string, std::string, std::less<>>;
+
+Flags ParseFlags(int argc, char* argv[]) {
+  Flags flags;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg == "--help" || arg == "-h")
+      throw std::invalid_argument("");
+    if (!arg.starts_with("--"))
+      throw std::invalid_argument("Unexpected argument: " + std::string{arg});
+    const auto eq = arg.find('=');
+    if (eq == std::string_view::npos)
+      throw std::invalid_argument("Expected --flag=value: " + std::string{arg});
+    flags.emplace(arg.substr(2, eq - 2), arg.substr(eq + 1));
+  }
+  return flags;
+}
+
+class FlagReader {
+ public:
+  explicit FlagReader(Flags flags) : flags_(std::move(flags)) {}
+
+  std::string String(std::string_view name, std::string default_value) {
+    const auto it = flags_.find(name);
+    if (it == flags_.end())
+      return default_value;
+    std::string value = it->second;
+    flags_.erase(it);
+    return value;
+  }
+
+  template <class T>
+  T Number(std::string_view name, T default_value) {
+    const std::string text = String(name, {});
+    if (text.empty())
+      return default_value;
+    T value{};
+    const auto [end, ec] =
+        std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc{} || end != text.data() + text.size()) {
+      throw std::invalid_argument("Invalid value for --" + std::string{name} +
+                                  ": " + text);
+    }
+    return value;
+  }
+
+  bool Switch(std::string_view name, bool default_value) {
+    const std::string text = String(name, default_value ? "on" : "off");
+    if (text == "on" || text == "true" || text == "1")
+      return true;
+    if (text == "off" || text == "false" || text == "0")
+      return false;
+    throw std::invalid_argument("Invalid value for --" + std::string{name} +
+                                ": " + text);
+  }
+
+  // Ошибка на флаги, которые никто не прочитал: опечатка не должна тихо
+  // давать замер с настройками по умолчанию.
+  void CheckAllUsed() const {
+    if (!flags_.empty())
+      throw std::invalid_argument("Unknown flag: --" + flags_.begin()->first);
+  }
+
+ private:
+  Flags flags_;
+};
+
+Uuid RandomUuid(std::mt19937_64& rng) {
+  Uuid::Bytes bytes;
+  for (std::size_t i = 0; i < bytes.size(); i += 8) {
+    const std::uint64_t value = rng();
+    for (std::size_t j = 0; j < 8; ++j)
+      bytes[i + j] = static_cast<std::uint8_t>(value >> (8 * j));
+  }
+  bytes[6] = static_cast<std::uint8_t>((bytes[6] & 0x0F) | 0x40);
+  bytes[8] = static_cast<std::uint8_t>((bytes[8] & 0x3F) | 0x80);
+  return Uuid{bytes};
+}
+
+// Начальные данные: tasks_per_user задач у каждого из users пользователей.
+struct DataSet {
+  std::vector<Uuid> user_ids;
+  std::vector<Uuid> task_ids;
+  std::vector<Task> tasks;
+};
+
+DataSet MakeDataSet(std::size_t users, std::size_t tasks_per_user) {
+  static constexpr TaskStatus kStatuses[] = {
+      TaskStatus::InProgress, TaskStatus::InProject, TaskStatus::Done};
+  std::mt19937_64 rng(42);
+  DataSet data;
+  for (std::size_t u = 0; u < users; ++u) {
+    const Uuid user_id = RandomUuid(rng);
+    data.user_ids.push_back(user_id);
+    for (std::size_t t = 0; t < tasks_per_user; ++t) {
+      data.tasks.emplace_back(RandomUuid(rng), user_id,
+                              "Task " + std::to_string(t),
+                              "Description of task " + std::to_string(t),
+                              kStatuses[t % std::size(kStatuses)]);
+      data.task_ids.push_back(data.tasks.back().GetId());
+    }
+  }
+  return data;
+}
+
+// Сервис задач без хранилища: данные задаются при старте и дальше не
+// меняются, записи отвечают так, будто прошли. Замер показывает цену HTTP,
+// маршрутизации, разбора и сериализации без базы.
+class StubTaskService final : public TaskService {
+ public:
+  explicit StubTaskService(const DataSet& data) {
+    for (const auto& task : data.tasks) {
+      tasks_.emplace(task.GetId(), task);
+      user_tasks_[task.GetUserId()].push_back(task);
+    }
+    for (auto& [user_id, tasks] : user_tasks_) {
+      std::sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b) {
+        return std::forward_as_tuple(a.GetStatus(), a.GetTitle(), a.GetId()) <
+               std::forward_as_tuple(b.GetStatus(), b.GetTitle(), b.GetId());
+      });
+    }
+  }
+
+  std::expected<Task, AddTaskError> CreateTask(
+      const Uuid& user_id, const std::string& title,
+      const std::string& description, TaskStatus status) override {
+    thread_local std::mt19937_64 rng(std::random_device{}());
+    return Task{RandomUuid(rng), user_id, title, description, status};
+  }
+
+  std::expected<Task, FindTaskError> GetTask(const Uuid& task_id) override {
+    const auto it = tasks_.find(task_id);
+    if (it == tasks_.end())
+      return std::unexpected(FindTaskError::NotFound);
+    return it->second;
+  }
+
+  std::expected<std::vector<Task>, FindTaskError> GetUserTasks(
+      const Uuid& user_id) override {
+    const auto it = user_tasks_.find(user_id);
+    if (it == user_tasks_.end())
+      return std::vector<Task>{};
+    return it->second;
+  }
+
+  std::expected<std::vector<Task>, FindTaskError> GetUserTasksPage(
+      const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+      std::size_t limit) override {
+    const auto it = user_tasks_.find(user_id);
+    if (it == user_tasks_.end())
+      return std::vector<Task>{};
+    const auto& tasks = it->second;
+    auto first = tasks.begin();
+    if (after) {
+      first = std::upper_bound(
+          tasks.begin(), tasks.end(), *after,
+          [](const TaskPageCursor& cursor, const Task& task) {
+            return std::forward_as_tuple(cursor.status, cursor.title,
+                                         cursor.task_id) <
+                   std::forward_as_tuple(task.GetStatus(), task.GetTitle(),
+                                         task.GetId());
+          });
+    }
+    const auto count = std::min<std::size_t>(
+        limit, static_cast<std::size_t>(tasks.end() - first));
+    return std::vector<Task>(first, first + static_cast<std::ptrdiff_t>(count));
+  }
+
+  std::expected<Task, UpdateTaskError> ChangeStatus(
+      const Uuid& task_id, TaskStatus status) override {
+    const auto it = tasks_.find(task_id);
+    if (it == tasks_.end())
+      return std::unexpected(UpdateTaskError::NotFound);
+    const Task& task = it->second;
+    return Task{task.GetId(), task.GetUserId(), task.GetTitle(),
+                task.GetDescription(), status};
+  }
+
+  std::expected<void, DeleteTaskError> DeleteTask(
+      const Uuid& task_id) override {
+    if (!tasks_.contains(task_id))
+      return std::unexpected(DeleteTaskError::NotFound);
+    return {};
+  }
+
+  std::expected<std::vector<Task>, AddTaskError> CreateTasks(
+      const std::vector<Task>& tasks) override {
+    std::vector<Task> created;
+    created.reserve(tasks.size());
+    for (const auto& task : tasks) {
+      auto r = CreateTask(task.GetUserId(), task.GetTitle(),
+                          task.GetDescription(), task.GetStatus());
+      created.push_back(std::move(*r));
+    }
+    return created;
+  }
+
+  std::expected<std::vector<Task>, UpdateTaskError> ChangeStatuses(
+      const std::vector<std::pair<Uuid, TaskStatus>>& updates) override {
+    std::vector<Task> updated;
+    updated.reserve(updates.size());
+    for (const auto& [task_id, status] : updates) {
+      auto r = ChangeStatus(task_id, status);
+      if (!r)
+        return std::unexpected(r.error());
+      updated.push_back(std::move(*r));
+    }
+    return updated;
+  }
+
+  // Данные не меняются, так что версии постоянны.
+  std::uint64_t GetUserTasksVersion(const Uuid& /*user_id*/) override {
+    return 1;
+  }
+  std::uint64_t GetTaskVersion(const Uuid& /*task_id*/) override { return 1; }
+
+ private:
+  std::unordered_map<Uuid, Task> tasks_;
+  std::unordered_map<Uuid, std::vector<Task>> user_tasks_;
+};
+
+class StubUserService final : public UserService {
+ public:
+  std::expected<User, RegistrationError> Registration(
+      const std::string& login, const std::string& password) override {
+    return User{Uuid{}, login, password};
+  }
+
+  std::expected<User, LoginError> Login(const std::string& login,
+                                        const std::string& password) override {
+    return User{Uuid{}, login, password};
+  }
+};
+
+const Uuid& Pick(const std::vector<Uuid>& ids, std::mt19937_64& rng) {
+  return ids[std::uniform_int_distribution<std::size_t>(0, ids.size() - 1)(
+      rng)];
+}
+
+// Маршруты профилей; data живёт до конца замера. Удаление входит в профили,
+// только если хранилище не меняется (with_delete): иначе чтения удалённых
+// задач давали бы 404.
+LoadProfile MakeProfile(std::string_view name, const DataSet& data,
+                        bool with_delete) {
+  const auto& users = data.user_ids;
+  const auto& tasks = data.task_ids;
+  namespace http = boost::beast::http;
+
+  const LoadRoute get_task{
+      "GET /task/{id}", 1, [&tasks](std::mt19937_64& rng) {
+        return LoadRequest{http::verb::get,
+                           "/task/" + Pick(tasks, rng).ToString(), {}};
+      }};
+  const LoadRoute user_tasks{
+      "GET /user/{user_id}/tasks", 1, [&users](std::mt19937_64& rng) {
+        return LoadRequest{
+            http::verb::get,
+            "/user/" + Pick(users, rng).ToString() + "/tasks", {}};
+      }};
+  const LoadRoute user_tasks_page{
+      "GET /user/{user_id}/tasks?limit=10", 1,
+      [&users](std::mt19937_64& rng) {
+        return LoadRequest{
+            http::verb::get,
+            "/user/" + Pick(users, rng).ToString() + "/tasks?limit=10", {}};
+      }};
+  const LoadRoute create_task{
+      "POST /task", 1, [&users](std::mt19937_64& rng) {
+        return LoadRequest{
+            http::verb::post, "/task",
+            R"({"user_id":")" + Pick(users, rng).ToString() +
+                R"(","title":"Load test","description":"Created by )"
+                R"(server_bench","status":"InProject"})"};
+      }};
+  const LoadRoute change_status{
+      "PATCH /task/status", 1, [&tasks](std::mt19937_64& rng) {
+        static constexpr std::string_view kStatuses[] = {"InProgress",
+                                                         "InProject", "Done"};
+        const auto status = kStatuses[rng() % std::size(kStatuses)];
+        return LoadRequest{http::verb::patch, "/task/status",
+                           R"({"id":")" + Pick(tasks, rng).ToString() +
+                               R"(","status":")" + std::string{status} +
+                               "\"}"};
+      }};
+  const LoadRoute delete_task{
+      "DELETE /task/{id}", 1, [&tasks](std::mt19937_64& rng) {
+        return LoadRequest{http::verb::delete_,
+                           "/task/" + Pick(tasks, rng).ToString(), {}};
+      }};
+
+  const auto weighted = [](LoadRoute route, unsigned weight) {
+    route.weight = weight;
+    return route;
+  };
+  const unsigned delete_weight = with_delete ? 1 : 0;
+  LoadProfile profile;
+  if (name == "read") {
+    profile = {weighted(get_task, 50), weighted(user_tasks, 30),
+               weighted(user_tasks_page, 20)};
+  } else if (name == "write") {
+    profile = {weighted(create_task, 40), weighted(change_status, 50),
+               weighted(delete_task, 10 * delete_weight)};
+  } else if (name == "mixed") {
+    profile = {weighted(get_task, 40),
+               weighted(user_tasks, 25),
+               weighted(user_tasks_page, 15),
+               weighted(create_task, 8),
+               weighted(change_status, 10),
+               weighted(delete_task, 2 * delete_weight)};
+  } else {
+    throw std::invalid_argument("Unknown profile: " + std::string{name});
+  }
+  std::erase_if(profile,
+                [](const LoadRoute& route) { return route.weight == 0; });
+  return profile;
+}
+
+std::uint16_t FreePort() {
+  boost::asio::io_context io_context;
+  ip::tcp::acceptor acceptor(io_context,
+                             {ip::make_address("127.0.0.1"), 0});
+  return acceptor.local_endpoint().port();
+}
+
+// HttpServer::Run слушает порт уже в своём потоке; ждём, пока он начнёт
+// принимать соединения.
+void WaitForServer(const ip::tcp::endpoint& endpoint) {
+  boost::asio::io_context io_context;
+  for (int attempt = 0; attempt < 500; ++attempt) {
+    ip::tcp::socket socket(io_context);
+    beast::error_code ec;
+    socket.connect(endpoint, ec);
+    if (!ec)
+      return;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  throw std::runtime_error("Server did not start listening");
+}
+
+void PrintLatency(const LatencyHistogram::Snapshot& latency) {
+  std::printf("p50=%llu p99=%llu p999=%llu max=%llu",
+              static_cast<unsigned long long>(latency.ValueAtQuantile(0.5)),
+              static_cast<unsigned long long>(latency.ValueAtQuantile(0.99)),
+              static_cast<unsigned long long>(latency.ValueAtQuantile(0.999)),
+              static_cast<unsigned long long>(latency.ValueAtQuantile(1.0)));
+}
+
+// Квантили — верхние границы корзин LatencyHistogram (точность 1/8).
+void PrintReport(const LoadReport& report) {
+  const double seconds = std::chrono::duration<double>(report.elapsed).count();
+  std::printf("requests=%llu rps=%.0f errors=%llu io_errors=%llu\n",
+              static_cast<unsigned long long>(report.requests), report.Rps(),
+              static_cast<unsigned long long>(report.errors),
+              static_cast<unsigned long long>(report.io_errors));
+  std::printf("latency_us ");
+  PrintLatency(report.latency);
+  std::printf("\n\n");
+  for (const auto& route : report.routes) {
+    std::printf("%-36s rps=%-8.0f errors=%-6llu ", route.name.c_str(),
+                seconds > 0 ? static_cast<double>(route.requests) / seconds
+                            : 0.0,
+                static_cast<unsigned long long>(route.errors));
+    PrintLatency(route.latency);
+    std::printf("\n");
+  }
+}
+
+int Run(int argc, char* argv[]) {
+  FlagReader flags(ParseFlags(argc, argv));
+
+  const std::string profile_name = flags.String("profile", "mixed");
+  LoadOptions load;
+  load.connections = flags.Number<std::size_t>("connections", 64);
+  load.threads = flags.Number<std::size_t>("client-threads", 2);
+  load.duration = std::chrono::seconds(flags.Number<int>("duration", 10));
+  load.warmup = std::chrono::seconds(flags.Number<int>("warmup", 1));
+  load.rate = flags.Number<double>("rate", 0);
+  load.keep_alive = flags.Switch("keep-alive", true);
+  load.seed = flags.Number<std::uint64_t>("seed", 1);
+
+  const auto server_threads = flags.Number<std::size_t>("server-threads", 0);
+  const std::string io_model_name = flags.String("io-model", "shared");
+  const auto dispatch_threads =
+      flags.Number<std::size_t>("dispatch-threads", 0);
+  const auto response_cache_bytes =
+      flags.Number<std::size_t>("response-cache-bytes", 0);
+  auto port = flags.Number<std::uint16_t>("port", 0);
+
+  const std::string storage = flags.String("storage", "stub");
+  const auto users = flags.Number<std::size_t>("users", 100);
+  const auto tasks_per_user = flags.Number<std::size_t>("tasks-per-user", 20);
+  flags.CheckAllUsed();
+
+  if (io_model_name != "shared" && io_model_name != "sharded")
+    throw std::invalid_argument("Unknown io model: " + io_model_name);
+  if (users == 0 || tasks_per_user == 0)
+    throw std::invalid_argument("--users and --tasks-per-user must be > 0");
+
+  DataSet data = MakeDataSet(users, tasks_per_user);
+  std::shared_ptr<TaskService> task_service;
+  if (storage == "stub") {
+    task_service = std::make_shared<StubTaskService>(data);
+  } else if (storage == "memory") {
+    // InMemoryTaskRepository назначает id сам.
+    auto repository = std::make_unique<InMemoryTaskRepository>();
+    const auto created = repository->AddTasks(data.tasks);
+    data.task_ids.clear();
+    for (const auto& task : *created)
+      data.task_ids.push_back(task.GetId());
+    task_service =
+        std::make_shared<DefaultTaskService>(std::move(repository));
+  } else {
+    throw std::invalid_argument("Unknown storage: " + storage);
+  }
+  const LoadProfile profile =
+      MakeProfile(profile_name, data, storage == "stub");
+
+  std::shared_ptr<UserService> user_service =
+      std::make_shared<StubUserService>();
+  std::shared_ptr<ResponseCache> response_cache;
+  if (response_cache_bytes > 0)
+    response_cache = std::make_shared<ResponseCache>(response_cache_bytes);
+  auto router = std::make_shared<SimpleRouter>();
+  // Пользователи — заглушка без хэширования: пул для них не нужен.
+  RouterDefaultConfigure(router, user_service, task_service, nullptr,
+                         response_cache);
+
+  std::shared_ptr<DispatchPool> dispatch_pool;
+  if (dispatch_threads > 0) {
+    dispatch_pool =
+        std::make_shared<DispatchPool>("handlers", dispatch_threads, 1024);
+  }
+
+  if (port == 0)
+    port = FreePort();
+  HttpServer server("127.0.0.1", port, router, server_threads, dispatch_pool,
+                    SessionOptions{},
+                    io_model_name == "sharded" ? IoModel::ReusePortShards
+                                               : IoModel::SharedContext);
+  std::thread server_thread([&server] { server.Run(); });
+  load.endpoint = {ip::make_address("127.0.0.1"), port};
+
+  LoadReport report;
+  try {
+    WaitForServer(load.endpoint);
+    const std::string loop =
+        load.rate > 0
+            ? "open@" + std::to_string(static_cast<long long>(load.rate))
+            : "closed";
+    std::printf(
+        "profile=%s connections=%zu loop=%s keep_alive=%s duration=%llds\n",
+        profile_name.c_str(), load.connections, loop.c_str(),
+        load.keep_alive ? "on" : "off",
+        static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::seconds>(load.duration)
+                .count()));
+    report = RunLoad(load, profile);
+  } catch (...) {
+    server.Stop();
+    server_thread.join();
+    throw;
+  }
+  server.Stop();
+  server_thread.join();
+
+  PrintReport(report);
+  return EXIT_SUCCESS;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  // Логи сервера в консоль искажают замер, как и в bench_main.
+  boost::log::core::get()->set_filter(boost::log::trivial::severity >=
+                                      boost::log::trivial::warning);
+  try {
+    return Run(argc, argv);
+  } catch (const std::invalid_argument& e) {
+    if (*e.what())
+      std::cerr << e.what() << "\n\n";
+    std::cerr << kUsage;
+    return EXIT_FAILURE;
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+}
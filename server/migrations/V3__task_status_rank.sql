@@ -0,0 +1,16 @@
+-- Order user's task lists in the database: status priority, then title
+
+ALTER TABLE tasks
+  ADD COLUMN status_rank SMALLINT GENERATED ALWAYS AS (
+    CASE status
+      WHEN 'InProgress' THEN 0
+      WHEN 'InProject' THEN 1
+      ELSE 2
+    END
+  ) STORED;
+
+-- Covers both the full list and keyset pages; id makes the key unique.
+CREATE INDEX IF NOT EXISTS idx_tasks_user_rank_title
+  ON tasks(user_id, status_rank, title, id);
+
+DROP INDEX IF EXISTS idx_tasks_user_id;
@@ -0,0 +1,22 @@
+-- Store task status as SMALLINT matching the TaskStatus enum
+-- (0 = InProgress, 1 = InProject, 2 = Done); the value is also the sort rank.
+
+DROP INDEX IF EXISTS idx_tasks_user_rank_title;
+ALTER TABLE tasks DROP COLUMN status_rank;
+ALTER TABLE tasks DROP CONSTRAINT tasks_status_check;
+
+ALTER TABLE tasks
+  ALTER COLUMN status TYPE SMALLINT USING (
+    CASE status
+      WHEN 'InProgress' THEN 0
+      WHEN 'InProject' THEN 1
+      WHEN 'Done' THEN 2
+    END
+  );
+
+ALTER TABLE tasks
+  ADD CONSTRAINT tasks_status_check
+  CHECK (status BETWEEN 0 AND 2);
+
+CREATE INDEX IF NOT EXISTS idx_tasks_user_status_title
+  ON tasks(user_id, status, title, id);
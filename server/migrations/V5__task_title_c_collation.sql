@@ -0,0 +1,7 @@
+-- Order task titles bytewise (COLLATE "C") like the in-memory storages and
+-- the old in-process sort, independent of the database collation.
+
+DROP INDEX IF EXISTS idx_tasks_user_status_title;
+
+CREATE INDEX IF NOT EXISTS idx_tasks_user_status_title
+  ON tasks(user_id, status, title COLLATE "C", id);
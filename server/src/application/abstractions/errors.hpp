@@ -3,29 +3,46 @@
 enum class FindUserError {
   NotFound,
   RepositoryError,
+  // Не дождались свободного соединения с хранилищем.
+  RepositoryTimeout,
 };
 
 enum class AddUserError {
   AlreadyExists,
   RepositoryError,
+  RepositoryTimeout,
+};
+
+enum class UpdateUserError {
+  NotFound,
+  RepositoryError,
+  RepositoryTimeout,
 };
 
 enum class FindTaskError {
   NotFound,
   RepositoryError,
+  RepositoryTimeout,
 };
 
 enum class AddTaskError {
   AlreadyExists,
   RepositoryError,
+  RepositoryTimeout,
 };
 
 enum class UpdateTaskError {
   NotFound,
   RepositoryError,
+  RepositoryTimeout,
 };
 
 enum class DeleteTaskError {
   NotFound,
   RepositoryError,
-};
\ No newline at end of file
+  RepositoryTimeout,
+};
+
+enum class PasswordHashError {
+  InternalError,
+};
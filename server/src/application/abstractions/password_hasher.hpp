@@ -0,0 +1,30 @@
+#pragma once
+#include <expected>
+#include <string>
+
+#include "errors.hpp"
+
+struct PasswordCheck {
+  bool matches = false;
+  // Сохранённое значение — открытый пароль старой записи или хэш с
+  // устаревшими параметрами: после успешной проверки его стоит заменить
+  // новым Hash.
+  bool needs_rehash = false;
+};
+
+// Хэширование паролей для хранения. Вычисления намеренно дорогие по CPU и
+// памяти.
+class PasswordHasher {
+ public:
+  PasswordHasher() = default;
+  // Хэш со свежей солью; его и хранит User::GetPassword.
+  virtual std::expected<std::string, PasswordHashError> Hash(
+      const std::string& password) = 0;
+  // Сравнивает password с сохранённым значением за время, не зависящее от
+  // того, где они расходятся.
+  virtual std::expected<PasswordCheck, PasswordHashError> Verify(
+      const std::string& password, const std::string& stored) = 0;
+  virtual ~PasswordHasher() = 0;
+};
+
+inline PasswordHasher::~PasswordHasher() = default;
@@ -0,0 +1,40 @@
+#pragma once
+#include <expected>
+#include <utility>
+#include <vector>
+
+#include "task.hpp"
+#include "errors.hpp"
+
+// Независимые изменения задач от разных вызывающих. В отличие от пакетных
+// методов TaskRepository, у каждого изменения свой результат: NotFound
+// одного не отменяет остальные.
+struct TaskWriteBatch {
+  std::vector<Task> adds;
+  // Пары (task_id, status).
+  std::vector<std::pair<Uuid, TaskStatus>> updates;
+  std::vector<Uuid> deletes;
+
+  bool empty() const {
+    return adds.empty() && updates.empty() && deletes.empty();
+  }
+};
+
+// Результаты в порядке изменений пакета.
+struct TaskWriteBatchResult {
+  std::vector<std::expected<Task, AddTaskError>> adds;
+  std::vector<std::expected<Task, UpdateTaskError>> updates;
+  std::vector<std::expected<Task, DeleteTaskError>> deletes;
+};
+
+class TaskBatchWriter {
+ public:
+  TaskBatchWriter() = default;
+  // Результат — как у последовательных AddTask, UpdateTaskStatus и
+  // DeleteTaskById: сначала все добавления, затем обновления, затем
+  // удаления, внутри вида — в порядке пакета.
+  virtual TaskWriteBatchResult WriteBatch(const TaskWriteBatch& batch) = 0;
+  virtual ~TaskBatchWriter() = 0;
+};
+
+inline TaskBatchWriter::~TaskBatchWriter() = default;
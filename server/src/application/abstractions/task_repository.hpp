@@ -1,19 +1,43 @@
 #pragma once
+#include <cstddef>
 #include <expected>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "task.hpp"
 #include "errors.hpp"
 
+// Позиция в списке задач пользователя: последняя задача прочитанной страницы.
+// Список упорядочен по статусу (InProgress, InProject, Done), названию и id.
+struct TaskPageCursor {
+  TaskStatus status;
+  std::string title;
+  Uuid task_id;
+
+  bool operator==(const TaskPageCursor&) const = default;
+};
+
 class TaskRepository {
  public:
   TaskRepository() = default;
   virtual std::expected<Task, AddTaskError> AddTask(const Task& task) = 0;
-  virtual std::expected<Task, FindTaskError> GetTaskById(const std::string& task_id) = 0;
-  virtual std::expected<std::vector<Task>, FindTaskError> GetTasksByUser(const std::string& user_id) = 0;
-  virtual std::expected<Task, UpdateTaskError> UpdateTaskStatus(const std::string& task_id, const std::string& status) = 0;
-  virtual std::expected<void, DeleteTaskError> DeleteTaskById(const std::string& task_id) = 0;
+  virtual std::expected<Task, FindTaskError> GetTaskById(const Uuid& task_id) = 0;
+  // Задачи упорядочены как страницы: статус, название, id.
+  virtual std::expected<std::vector<Task>, FindTaskError> GetTasksByUser(const Uuid& user_id) = 0;
+  // До limit задач после after (без after — с начала списка).
+  virtual std::expected<std::vector<Task>, FindTaskError> GetTasksByUserPage(
+      const Uuid& user_id, const std::optional<TaskPageCursor>& after, std::size_t limit) = 0;
+  virtual std::expected<Task, UpdateTaskError> UpdateTaskStatus(const Uuid& task_id, TaskStatus status) = 0;
+  // Возвращает удалённую задачу.
+  virtual std::expected<Task, DeleteTaskError> DeleteTaskById(const Uuid& task_id) = 0;
+
+  // Пакетные операции выполняются одной транзакцией: либо все, либо ни одной.
+  virtual std::expected<std::vector<Task>, AddTaskError> AddTasks(const std::vector<Task>& tasks) = 0;
+  // Пары (task_id, status).
+  virtual std::expected<std::vector<Task>, UpdateTaskError> UpdateTaskStatuses(
+      const std::vector<std::pair<Uuid, TaskStatus>>& updates) = 0;
   virtual ~TaskRepository() = 0;
 };
 
@@ -9,6 +9,9 @@ class UserRepository {
   UserRepository() = default;
   virtual std::expected<User, FindUserError> FindUser(const std::string& login) = 0;
   virtual std::expected<User, AddUserError> AddUser(User) = 0;
+  // Заменяет сохранённый пароль (хэш) пользователя login.
+  virtual std::expected<void, UpdateUserError> UpdatePassword(
+      const std::string& login, const std::string& password) = 0;
   virtual ~UserRepository() = 0;
 };
 
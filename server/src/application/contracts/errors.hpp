@@ -3,10 +3,13 @@
 enum class RegistrationError {
   NameAlreadyExists,
   InternalError,
+  // Хранилище перегружено; запрос можно повторить.
+  ServiceUnavailable,
 };
 
 enum class LoginError {
   UserNotFound,
   WrongPassword,
   InternalError,
+  ServiceUnavailable,
 };
\ No newline at end of file
@@ -1,23 +1,40 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <expected>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "../../domain/task.hpp"
 #include "../abstractions/errors.hpp"
+#include "../abstractions/task_repository.hpp"
 
 class TaskService {
  public:
-  virtual std::expected<Task, AddTaskError> CreateTask(const std::string& user_id,
+  virtual std::expected<Task, AddTaskError> CreateTask(const Uuid& user_id,
                                                        const std::string& title,
                                                        const std::string& description,
-                                                       const std::string& status) = 0;
+                                                       TaskStatus status) = 0;
 
-  virtual std::expected<Task, FindTaskError> GetTask(const std::string& task_id) = 0;
-  virtual std::expected<std::vector<Task>, FindTaskError> GetUserTasks(const std::string& user_id) = 0;
-  virtual std::expected<Task, UpdateTaskError> ChangeStatus(const std::string& task_id,
-                                                            const std::string& status) = 0;
-  virtual std::expected<void, DeleteTaskError> DeleteTask(const std::string& task_id) = 0;
+  virtual std::expected<Task, FindTaskError> GetTask(const Uuid& task_id) = 0;
+  virtual std::expected<std::vector<Task>, FindTaskError> GetUserTasks(const Uuid& user_id) = 0;
+  virtual std::expected<std::vector<Task>, FindTaskError> GetUserTasksPage(
+      const Uuid& user_id, const std::optional<TaskPageCursor>& after, std::size_t limit) = 0;
+  virtual std::expected<Task, UpdateTaskError> ChangeStatus(const Uuid& task_id,
+                                                            TaskStatus status) = 0;
+  virtual std::expected<void, DeleteTaskError> DeleteTask(const Uuid& task_id) = 0;
+
+  virtual std::expected<std::vector<Task>, AddTaskError> CreateTasks(const std::vector<Task>& tasks) = 0;
+  virtual std::expected<std::vector<Task>, UpdateTaskError> ChangeStatuses(
+      const std::vector<std::pair<Uuid, TaskStatus>>& updates) = 0;
+
+  // Меняются после каждого изменения задач пользователя (задачи), так что
+  // годятся для ETag. Совпадение версий значит неизменные данные только для
+  // изменений, прошедших через этот процесс.
+  virtual std::uint64_t GetUserTasksVersion(const Uuid& user_id) = 0;
+  virtual std::uint64_t GetTaskVersion(const Uuid& task_id) = 0;
   virtual ~TaskService() = default;
 };
 
@@ -1,51 +1,88 @@
 #include "default_task_service.hpp"
-#include <algorithm>
+
+// Версии сдвигаются после записи, даже неудачной: исход ошибки хранилища
+// неизвестен, а лишний сдвиг стоит только промаха кэша.
 
 std::expected<Task, AddTaskError> DefaultTaskService::CreateTask(
-    const std::string& user_id, const std::string& title,
-    const std::string& description, const std::string& status) {
-  return task_repository_->AddTask(Task{user_id, title, description, status});
+    const Uuid& user_id, const std::string& title,
+    const std::string& description, TaskStatus status) {
+  auto r = task_repository_->AddTask(Task{user_id, title, description, status});
+  versions_.BumpUser(user_id);
+  return r;
 }
 
 std::expected<Task, FindTaskError> DefaultTaskService::GetTask(
-    const std::string& task_id) {
+    const Uuid& task_id) {
   return task_repository_->GetTaskById(task_id);
 }
 
 std::expected<std::vector<Task>, FindTaskError>
-DefaultTaskService::GetUserTasks(const std::string& user_id) {
-  auto tasks = task_repository_->GetTasksByUser(user_id);
-  if (!tasks) {
-    return tasks;
-  }
+DefaultTaskService::GetUserTasks(const Uuid& user_id) {
+  // Хранилище уже отдаёт задачи в порядке статус, название.
+  return task_repository_->GetTasksByUser(user_id);
+}
 
-  std::sort(tasks->begin(), tasks->end(), [](const Task& a, const Task& b) {
-    if (a.GetStatus() == b.GetStatus()) {
-      return a.GetTitle() < b.GetTitle();
-    }
-    if (a.GetStatus() == "InProgress") {
-      return true;
-    }
-    if (b.GetStatus() == "InProgress") {
-      return false;
-    }
+std::expected<std::vector<Task>, FindTaskError>
+DefaultTaskService::GetUserTasksPage(const Uuid& user_id,
+                                     const std::optional<TaskPageCursor>& after,
+                                     std::size_t limit) {
+  return task_repository_->GetTasksByUserPage(user_id, after, limit);
+}
 
-    if (a.GetStatus() == "InProject") {
-      return true;
-    }
+std::expected<Task, UpdateTaskError> DefaultTaskService::ChangeStatus(
+    const Uuid& task_id, TaskStatus status) {
+  auto r = task_repository_->UpdateTaskStatus(task_id, status);
+  versions_.BumpTask(task_id);
+  if (r.has_value())
+    versions_.BumpUser(r->GetUserId());
+  else if (r.error() == UpdateTaskError::RepositoryError)
+    versions_.BumpAll();
+  return r;
+}
 
-    return false;
-  });
+std::expected<void, DeleteTaskError> DefaultTaskService::DeleteTask(
+    const Uuid& task_id) {
+  auto r = task_repository_->DeleteTaskById(task_id);
+  versions_.BumpTask(task_id);
+  if (r.has_value())
+    versions_.BumpUser(r->GetUserId());
+  else if (r.error() == DeleteTaskError::RepositoryError)
+    versions_.BumpAll();
+  if (!r.has_value())
+    return std::unexpected(r.error());
+  return {};
+}
 
-  return tasks;
+std::expected<std::vector<Task>, AddTaskError> DefaultTaskService::CreateTasks(
+    const std::vector<Task>& tasks) {
+  auto r = task_repository_->AddTasks(tasks);
+  for (const auto& task : tasks) {
+    versions_.BumpUser(task.GetUserId());
+  }
+  return r;
 }
 
-std::expected<Task, UpdateTaskError> DefaultTaskService::ChangeStatus(
-    const std::string& task_id, const std::string& status) {
-  return task_repository_->UpdateTaskStatus(task_id, status);
+std::expected<std::vector<Task>, UpdateTaskError>
+DefaultTaskService::ChangeStatuses(
+    const std::vector<std::pair<Uuid, TaskStatus>>& updates) {
+  auto r = task_repository_->UpdateTaskStatuses(updates);
+  for (const auto& [task_id, status] : updates) {
+    versions_.BumpTask(task_id);
+  }
+  if (r.has_value()) {
+    for (const auto& task : r.value()) {
+      versions_.BumpUser(task.GetUserId());
+    }
+  } else if (r.error() == UpdateTaskError::RepositoryError) {
+    versions_.BumpAll();
+  }
+  return r;
 }
 
-std::expected<void, DeleteTaskError> DefaultTaskService::DeleteTask(
-    const std::string& task_id) {
-  return task_repository_->DeleteTaskById(task_id);
+std::uint64_t DefaultTaskService::GetUserTasksVersion(const Uuid& user_id) {
+  return versions_.ForUser(user_id);
+}
+
+std::uint64_t DefaultTaskService::GetTaskVersion(const Uuid& task_id) {
+  return versions_.ForTask(task_id);
 }
@@ -6,6 +6,7 @@
 
 #include "task_repository.hpp"
 #include "task_service.hpp"
+#include "task_versions.hpp"
 
 
 class DefaultTaskService final : public TaskService {
@@ -13,21 +14,29 @@ class DefaultTaskService final : public TaskService {
   explicit DefaultTaskService(std::unique_ptr<TaskRepository> task_repository)
       : task_repository_(std::move(task_repository)) {}
 
-  std::expected<Task, AddTaskError> CreateTask(const std::string& user_id,
+  std::expected<Task, AddTaskError> CreateTask(const Uuid& user_id,
                                                const std::string& title,
                                                const std::string& description,
-                                               const std::string& status) override;
-
-  std::expected<Task, FindTaskError> GetTask(const std::string& task_id) override;
-  std::expected<std::vector<Task>, FindTaskError> GetUserTasks(const std::string& user_id) override;
-  std::expected<Task, UpdateTaskError> ChangeStatus(const std::string& task_id,
-                                                    const std::string& status) override;
-  std::expected<void, DeleteTaskError> DeleteTask(const std::string& task_id) override;
+                                               TaskStatus status) override;
+
+  std::expected<Task, FindTaskError> GetTask(const Uuid& task_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetUserTasks(const Uuid& user_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetUserTasksPage(
+      const Uuid& user_id, const std::optional<TaskPageCursor>& after, std::size_t limit) override;
+  std::expected<Task, UpdateTaskError> ChangeStatus(const Uuid& task_id,
+                                                    TaskStatus status) override;
+  std::expected<void, DeleteTaskError> DeleteTask(const Uuid& task_id) override;
+  std::expected<std::vector<Task>, AddTaskError> CreateTasks(const std::vector<Task>& tasks) override;
+  std::expected<std::vector<Task>, UpdateTaskError> ChangeStatuses(
+      const std::vector<std::pair<Uuid, TaskStatus>>& updates) override;
+  std::uint64_t GetUserTasksVersion(const Uuid& user_id) override;
+  std::uint64_t GetTaskVersion(const Uuid& task_id) override;
 
   ~DefaultTaskService() override = default;
 
  private:
   std::unique_ptr<TaskRepository> task_repository_;
+  TaskVersions versions_;
 };
 
 
@@ -1,34 +1,85 @@
 #include "default_user_service.hpp"
 
+#include <stdexcept>
+
+DefaultUserService::DefaultUserService(
+    std::unique_ptr<UserRepository> user_repository,
+    std::shared_ptr<PasswordHasher> password_hasher)
+    : user_repository_(std::move(user_repository)),
+      password_hasher_(std::move(password_hasher)) {
+  // Соль случайная, так что сам пароль ни с чем не совпадёт. Без этого
+  // хэша неизвестный логин отвечал бы быстрее, поэтому сервис не создаётся.
+  auto hash = password_hasher_->Hash("dummy password");
+  if (!hash.has_value()) {
+    throw std::runtime_error("Failed to hash the dummy password");
+  }
+  dummy_hash_ = std::move(*hash);
+}
+
 std::expected<User, RegistrationError> DefaultUserService::Registration(
     const std::string& login, const std::string& password) {
   auto user = user_repository_->FindUser(login);
   if (user.has_value()) {
     return std::unexpected(RegistrationError::NameAlreadyExists);
   }
+  if (user.error() == FindUserError::RepositoryTimeout) {
+    return std::unexpected(RegistrationError::ServiceUnavailable);
+  }
   if (user.error() == FindUserError::RepositoryError) {
     return std::unexpected(RegistrationError::InternalError);
   }
 
-  auto result = user_repository_->AddUser(User{login, password});
+  auto hash = password_hasher_->Hash(password);
+  if (!hash.has_value()) {
+    return std::unexpected(RegistrationError::InternalError);
+  }
+
+  auto result = user_repository_->AddUser(User{login, std::move(*hash)});
   if (result.has_value()) {
     return result.value();
   }
+  if (result.error() == AddUserError::RepositoryTimeout) {
+    return std::unexpected(RegistrationError::ServiceUnavailable);
+  }
   return std::unexpected(RegistrationError::InternalError);
 }
 
 std::expected<User, LoginError> DefaultUserService::Login(
     const std::string& login, const std::string& password) {
   auto user = user_repository_->FindUser(login);
+  if (!user.has_value() &&
+      (user.error() == FindUserError::RepositoryTimeout)) {
+    return std::unexpected(LoginError::ServiceUnavailable);
+  }
   if (!user.has_value() && (user.error() == FindUserError::RepositoryError)) {
     return std::unexpected(LoginError::InternalError);
   }
   if (!user.has_value() && (user.error() == FindUserError::NotFound)) {
+    password_hasher_->Verify(password, dummy_hash_);
     return std::unexpected(LoginError::UserNotFound);
   }
 
-  if (!user.value().ComparePassword(password)) {
+  auto check = password_hasher_->Verify(password, user->GetPassword());
+  if (!check.has_value()) {
+    return std::unexpected(LoginError::InternalError);
+  }
+  if (!check->matches) {
     return std::unexpected(LoginError::WrongPassword);
   }
+  if (check->needs_rehash) {
+    return Rehash(*user, password);
+  }
   return user.value();
+}
+
+User DefaultUserService::Rehash(const User& user,
+                                const std::string& password) {
+  auto hash = password_hasher_->Hash(password);
+  if (!hash.has_value()) {
+    return user;
+  }
+  if (!user_repository_->UpdatePassword(user.GetName(), *hash).has_value()) {
+    return user;
+  }
+  return User{user.GetId(), user.GetName(), std::move(*hash)};
 }
\ No newline at end of file
@@ -1,23 +1,38 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include "errors.hpp"
+#include "password_hasher.hpp"
 #include "user_repository.hpp"
 #include "user_service.hpp"
 
 class DefaultUserService final : public UserService {
  public:
-  explicit DefaultUserService(std::unique_ptr<UserRepository> user_repository)
-      : user_repository_(std::move(user_repository)) {}
+  // Считает один хэш для неизвестных логинов (см. dummy_hash_). Бросает
+  // std::runtime_error, если хэшер его не посчитал.
+  DefaultUserService(std::unique_ptr<UserRepository> user_repository,
+                     std::shared_ptr<PasswordHasher> password_hasher);
 
   std::expected<User, RegistrationError> Registration(
       const std::string& login, const std::string& password) override;
 
+  // Старый открытый пароль или хэш с прежними параметрами после успешного
+  // входа заменяется новым хэшем.
   std::expected<User, LoginError> Login(const std::string& login,
                                         const std::string& password) override;
   ~DefaultUserService() override = default;
 
  private:
+  // Не удалось — остаётся старое значение, замена повторится при
+  // следующем входе.
+  User Rehash(const User& user, const std::string& password);
+
   std::unique_ptr<UserRepository> user_repository_;
-};
\ No newline at end of file
+  std::shared_ptr<PasswordHasher> password_hasher_;
+  // Хэш произвольного пароля с текущими параметрами. С ним сверяется пароль
+  // неизвестного логина, чтобы по времени ответа нельзя было узнать, есть
+  // ли такой пользователь.
+  std::string dummy_hash_;
+};
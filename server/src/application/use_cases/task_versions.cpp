@@ -0,0 +1,28 @@
+#include "task_versions.hpp"
+
+#include <random>
+
+TaskVersions::TaskVersions()
+    : epoch_(static_cast<std::uint64_t>(std::random_device{}()) << 32) {}
+
+std::uint64_t TaskVersions::ForUser(const Uuid& user_id) const {
+  return epoch_.load(std::memory_order_acquire) +
+         users_[StripeFor(user_id)].load(std::memory_order_acquire);
+}
+
+std::uint64_t TaskVersions::ForTask(const Uuid& task_id) const {
+  return epoch_.load(std::memory_order_acquire) +
+         tasks_[StripeFor(task_id)].load(std::memory_order_acquire);
+}
+
+void TaskVersions::BumpUser(const Uuid& user_id) {
+  users_[StripeFor(user_id)].fetch_add(1, std::memory_order_acq_rel);
+}
+
+void TaskVersions::BumpTask(const Uuid& task_id) {
+  tasks_[StripeFor(task_id)].fetch_add(1, std::memory_order_acq_rel);
+}
+
+void TaskVersions::BumpAll() {
+  epoch_.fetch_add(1, std::memory_order_acq_rel);
+}
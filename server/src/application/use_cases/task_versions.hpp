@@ -0,0 +1,38 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "uuid.hpp"
+
+// Версии данных задач для ETag: версия списка задач пользователя и версия
+// отдельной задачи. Счётчики полосатые — ключи с одинаковым хешем делят
+// один счётчик, так что память фиксирована, а чужое изменение даёт лишь
+// лишний промах, но не устаревший ответ.
+//
+// Версия — сумма счётчика полосы и общей эпохи, обе только растут, поэтому
+// для одного ключа версия не повторяется. Начальная эпоха случайна, чтобы
+// версии не совпадали между перезапусками процесса.
+class TaskVersions {
+ public:
+  TaskVersions();
+
+  std::uint64_t ForUser(const Uuid& user_id) const;
+  std::uint64_t ForTask(const Uuid& task_id) const;
+
+  void BumpUser(const Uuid& user_id);
+  void BumpTask(const Uuid& task_id);
+  // Когда неизвестно, чьи задачи изменились.
+  void BumpAll();
+
+ private:
+  static constexpr std::size_t kStripes = 1024;
+  using Stripes = std::array<std::atomic<std::uint64_t>, kStripes>;
+
+  static std::size_t StripeFor(const Uuid& id) { return id.Hash() % kStripes; }
+
+  Stripes users_{};
+  Stripes tasks_{};
+  std::atomic<std::uint64_t> epoch_;
+};
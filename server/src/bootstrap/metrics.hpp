@@ -0,0 +1,191 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "access_log.hpp"
+#include "buffer_pool.hpp"
+#include "coalescing_task_repository.hpp"
+#include "dispatch_pool.hpp"
+#include "lru_cache.hpp"
+#include "metrics_registry.hpp"
+#include "../infrastructure/database/postgres/connection_pool.hpp"
+
+// Сборщики для компонентов, которые ведут Stats сами. Сэмплы одного
+// семейства должны идти подряд, поэтому однотипные компоненты выводятся
+// одним сборщиком.
+
+using NamedConnectionPools =
+    std::vector<std::pair<std::string, std::shared_ptr<PqxxConnectionPool>>>;
+
+inline void AddConnectionPoolMetrics(MetricsRegistry& metrics,
+                                     NamedConnectionPools pools) {
+  metrics.AddCollector([pools = std::move(pools)](MetricsWriter& writer) {
+    std::vector<PqxxConnectionPool::Stats> stats;
+    for (const auto& [name, pool] : pools)
+      stats.push_back(pool->GetStats());
+
+    for (std::size_t i = 0; i < pools.size(); ++i) {
+      const auto& name = pools[i].first;
+      writer.WriteGauge("taskmanager_db_pool_connections",
+                        "Open database connections by state.",
+                        {{"pool", name}, {"state", "in_use"}},
+                        static_cast<double>(stats[i].in_use));
+      writer.WriteGauge("taskmanager_db_pool_connections",
+                        "Open database connections by state.",
+                        {{"pool", name}, {"state", "idle"}},
+                        static_cast<double>(stats[i].idle));
+    }
+    const auto counter = [&](const char* metric, const char* help,
+                             std::uint64_t PqxxConnectionPool::Stats::*field) {
+      for (std::size_t i = 0; i < pools.size(); ++i) {
+        writer.WriteCounter(metric, help, {{"pool", pools[i].first}},
+                            static_cast<double>(stats[i].*field));
+      }
+    };
+    counter("taskmanager_db_pool_acquired_total",
+            "Connections handed out by the pool.",
+            &PqxxConnectionPool::Stats::acquired);
+    counter("taskmanager_db_pool_timeouts_total",
+            "Acquires that gave up after acquire_timeout.",
+            &PqxxConnectionPool::Stats::timeouts);
+    counter("taskmanager_db_pool_broken_total",
+            "Broken connections dropped by the pool.",
+            &PqxxConnectionPool::Stats::broken);
+
+    std::array<double, PqxxConnectionPool::kWaitBuckets.size()> bounds{};
+    for (std::size_t b = 0; b < bounds.size(); ++b) {
+      bounds[b] = std::chrono::duration<double>(
+                      PqxxConnectionPool::kWaitBuckets[b])
+                      .count();
+    }
+    for (std::size_t i = 0; i < pools.size(); ++i) {
+      std::array<std::uint64_t, bounds.size()> cumulative{};
+      std::uint64_t total = 0;
+      for (std::size_t b = 0; b < bounds.size(); ++b) {
+        total += stats[i].wait_histogram[b];
+        cumulative[b] = total;
+      }
+      writer.WriteHistogram(
+          "taskmanager_db_pool_acquire_wait_seconds",
+          "Time spent waiting for a free connection, only for acquires "
+          "that had to wait.",
+          {{"pool", pools[i].first}}, bounds, cumulative,
+          std::chrono::duration<double>(stats[i].wait_time).count(),
+          stats[i].waits);
+    }
+  });
+}
+
+using NamedCaches =
+    std::vector<std::pair<std::string, std::function<CacheStats()>>>;
+
+inline void AddCacheMetrics(MetricsRegistry& metrics, NamedCaches caches) {
+  metrics.AddCollector([caches = std::move(caches)](MetricsWriter& writer) {
+    std::vector<CacheStats> stats;
+    for (const auto& [name, get_stats] : caches)
+      stats.push_back(get_stats());
+    const auto write = [&](const char* metric, const char* help, bool counter,
+                           auto CacheStats::*field) {
+      for (std::size_t i = 0; i < caches.size(); ++i) {
+        const MetricLabels labels = {{"cache", caches[i].first}};
+        const auto value = static_cast<double>(stats[i].*field);
+        if (counter) {
+          writer.WriteCounter(metric, help, labels, value);
+        } else {
+          writer.WriteGauge(metric, help, labels, value);
+        }
+      }
+    };
+    write("taskmanager_cache_hits_total", "Cache hits.", true,
+          &CacheStats::hits);
+    write("taskmanager_cache_misses_total", "Cache misses.", true,
+          &CacheStats::misses);
+    write("taskmanager_cache_evictions_total", "Entries evicted by LRU.",
+          true, &CacheStats::evictions);
+    write("taskmanager_cache_entries", "Entries in the cache.", false,
+          &CacheStats::entries);
+    write("taskmanager_cache_weight", "Total weight of cached entries.",
+          false, &CacheStats::weight);
+  });
+}
+
+inline void AddDispatchPoolMetrics(
+    MetricsRegistry& metrics,
+    std::vector<std::shared_ptr<DispatchPool>> pools) {
+  metrics.AddCollector([pools = std::move(pools)](MetricsWriter& writer) {
+    std::vector<DispatchPool::Stats> stats;
+    for (const auto& pool : pools)
+      stats.push_back(pool->GetStats());
+    const auto write = [&](const char* metric, const char* help, bool counter,
+                           auto DispatchPool::Stats::*field) {
+      for (std::size_t i = 0; i < pools.size(); ++i) {
+        const MetricLabels labels = {{"pool", pools[i]->GetName()}};
+        const auto value = static_cast<double>(stats[i].*field);
+        if (counter) {
+          writer.WriteCounter(metric, help, labels, value);
+        } else {
+          writer.WriteGauge(metric, help, labels, value);
+        }
+      }
+    };
+    write("taskmanager_dispatch_queue_depth", "Jobs waiting in the pool queue.",
+          false, &DispatchPool::Stats::queue_depth);
+    write("taskmanager_dispatch_active", "Jobs running on the pool.", false,
+          &DispatchPool::Stats::active);
+    write("taskmanager_dispatch_rejected_total",
+          "Jobs rejected because the queue was full.", true,
+          &DispatchPool::Stats::rejected);
+    write("taskmanager_dispatch_completed_total",
+          "Jobs completed by the pool.", true,
+          &DispatchPool::Stats::completed);
+  });
+}
+
+inline void AddBufferPoolMetrics(MetricsRegistry& metrics) {
+  metrics.AddCollector([](MetricsWriter& writer) {
+    const auto stats = BufferPool::GetStats();
+    writer.WriteCounter("taskmanager_buffer_pool_allocations_total",
+                        "HTTP message buffer allocations.", {},
+                        static_cast<double>(stats.allocations));
+    writer.WriteCounter(
+        "taskmanager_buffer_pool_system_allocations_total",
+        "HTTP message buffer allocations served by operator new.", {},
+        static_cast<double>(stats.system_allocations));
+  });
+}
+
+inline void AddAccessLogMetrics(MetricsRegistry& metrics,
+                                std::shared_ptr<AccessLog> access_log) {
+  metrics.AddCollector(
+      [access_log = std::move(access_log)](MetricsWriter& writer) {
+        const auto stats = access_log->GetStats();
+        writer.WriteCounter("taskmanager_access_log_written_total",
+                            "Access log lines written.", {},
+                            static_cast<double>(stats.written));
+        writer.WriteCounter("taskmanager_access_log_dropped_total",
+                            "Access log records dropped on a full buffer.",
+                            {}, static_cast<double>(stats.dropped));
+      });
+}
+
+inline void AddWriteCoalescingMetrics(
+    MetricsRegistry& metrics,
+    std::function<CoalescingTaskRepository::Stats()> get_stats) {
+  metrics.AddCollector([get_stats = std::move(get_stats)](
+                           MetricsWriter& writer) {
+    const auto stats = get_stats();
+    writer.WriteCounter("taskmanager_task_writes_coalesced_total",
+                        "Task writes submitted for coalescing.", {},
+                        static_cast<double>(stats.writes));
+    writer.WriteCounter("taskmanager_task_write_batches_total",
+                        "Transactions the coalesced task writes used.", {},
+                        static_cast<double>(stats.batches));
+  });
+}
@@ -8,15 +8,34 @@
 #include "../application/use_cases/default_task_service.hpp"
 #include "../infrastructure/database/postgres/postgres_task_repository.hpp"
 
-inline void RouterDefaultConfigure(const std::shared_ptr<Router>& router,
-                            std::shared_ptr<UserService>& user_service,
-                            std::shared_ptr<TaskService>& task_service) {
-  router->Add(std::make_shared<RegisterUserHandler>(user_service));
-  router->Add(std::make_shared<LoginUserHandler>(user_service));
+// hash_pool — пул, на котором выполняются вход и регистрация (см.
+// user_handlers.hpp). response_cache включает ETag и кэш тел для чтения
+// задач.
+inline void RouterDefaultConfigure(
+    const std::shared_ptr<Router>& router,
+    std::shared_ptr<UserService>& user_service,
+    std::shared_ptr<TaskService>& task_service,
+    std::shared_ptr<DispatchPool> hash_pool = nullptr,
+    std::shared_ptr<ResponseCache> response_cache = nullptr) {
+  router->Add(std::make_shared<RegisterUserHandler>(user_service, hash_pool));
+  router->Add(std::make_shared<LoginUserHandler>(user_service, hash_pool));
   
+  auto delete_task = std::make_shared<DeleteTaskHandler>(task_service);
+  auto get_all_tasks =
+      std::make_shared<GetAllTasksHandler>(task_service, response_cache);
+  auto get_one_task =
+      std::make_shared<GetOneTaskHandler>(task_service, response_cache);
+
   router->Add(std::make_shared<CreateTaskHandler>(task_service));
   router->Add(std::make_shared<ChangeStatusTaskHandler>(task_service));
-  router->Add(std::make_shared<DeleteTaskHandler>(task_service));
-  router->Add(std::make_shared<GetAllTasksHandler>(task_service));
-  router->Add(std::make_shared<GetOneTaskHandler>(task_service));
+  router->Add(std::make_shared<CreateTasksBulkHandler>(task_service));
+  router->Add(std::make_shared<ChangeStatusBulkHandler>(task_service));
+  router->Add(delete_task);
+  router->Add(get_all_tasks);
+  router->Add(get_one_task);
+
+  // Маршруты с идентификатором в пути вместо query-параметра.
+  router->Add("DELETE /task/{id}", delete_task);
+  router->Add("GET /task/{id}", get_one_task);
+  router->Add("GET /user/{user_id}/tasks", get_all_tasks);
 }
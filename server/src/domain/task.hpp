@@ -1,40 +1,76 @@
 #pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
+
+#include "uuid.hpp"
+
+// Значение — приоритет в списке задач пользователя (меньше — выше) и
+// значение столбца tasks.status.
+enum class TaskStatus : std::uint8_t {
+  InProgress = 0,
+  InProject = 1,
+  Done = 2,
+};
+
+inline constexpr std::array<std::string_view, 3> kTaskStatusNames = {
+    "InProgress", "InProject", "Done"};
+
+constexpr std::string_view ToString(TaskStatus status) {
+  return kTaskStatusNames[static_cast<std::size_t>(status)];
+}
+
+constexpr std::optional<TaskStatus> ParseTaskStatus(std::string_view name) {
+  for (std::size_t i = 0; i < kTaskStatusNames.size(); ++i) {
+    if (kTaskStatusNames[i] == name)
+      return static_cast<TaskStatus>(i);
+  }
+  return std::nullopt;
+}
+
+constexpr std::optional<TaskStatus> TaskStatusFromInt(int value) {
+  if (value < 0 || value >= static_cast<int>(kTaskStatusNames.size()))
+    return std::nullopt;
+  return static_cast<TaskStatus>(value);
+}
 
 class Task {
  public:
-  Task(std::string id,
-       std::string user_id,
+  Task(Uuid id,
+       Uuid user_id,
        std::string title,
        std::string description,
-       std::string status)
-      : id_(std::move(id)),
-        user_id_(std::move(user_id)),
+       TaskStatus status)
+      : id_(id),
+        user_id_(user_id),
         title_(std::move(title)),
         description_(std::move(description)),
-        status_(std::move(status)) {}
+        status_(status) {}
 
-  Task(std::string user_id,
+  Task(Uuid user_id,
        std::string title,
        std::string description,
-       std::string status)
-      : user_id_(std::move(user_id)),
+       TaskStatus status)
+      : user_id_(user_id),
         title_(std::move(title)),
         description_(std::move(description)),
-        status_(std::move(status)) {}
+        status_(status) {}
 
-  const std::string& GetId() const { return id_; }
-  const std::string& GetUserId() const { return user_id_; }
+  const Uuid& GetId() const { return id_; }
+  const Uuid& GetUserId() const { return user_id_; }
   const std::string& GetTitle() const { return title_; }
   const std::string& GetDescription() const { return description_; }
-  const std::string& GetStatus() const { return status_; }
+  TaskStatus GetStatus() const { return status_; }
 
  private:
-  std::string id_{};
-  std::string user_id_{};
+  Uuid id_{};
+  Uuid user_id_{};
   std::string title_{};
   std::string description_{};
-  std::string status_{};
+  TaskStatus status_{TaskStatus::InProgress};
 };
 
 
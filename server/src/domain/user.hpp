@@ -1,19 +1,21 @@
 #pragma once
 #include <string>
 
+#include "uuid.hpp"
+
+// password — хэш пароля (PasswordHasher::Hash); у записей, созданных до
+// хэширования, — сам пароль, пока его не заменит вход пользователя.
 class User {
  public:
-  User(std::string uuid, std::string name, std::string password);
+  User(Uuid uuid, std::string name, std::string password);
   User(std::string name, std::string password);
 
-  bool ComparePassword(const std::string& password) const;
-
-  const std::string& GetId() const { return uuid_; }
+  const Uuid& GetId() const { return uuid_; }
   const std::string& GetName() const { return name_; }
   const std::string& GetPassword() const { return password_; }
 
  private:
-  std::string uuid_{0};
+  Uuid uuid_{};
   std::string name_;
   std::string password_;
-};
\ No newline at end of file
+};
@@ -0,0 +1,94 @@
+#include "uuid.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include <openssl/rand.h>
+
+namespace {
+
+// Позиция старшей hex-цифры каждого байта в канонической записи.
+constexpr std::array<std::uint8_t, Uuid::kSize> kHexOffsets = {
+    0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34};
+
+// Значение hex-цифры или -1.
+constexpr std::array<std::int8_t, 256> kHexValues = [] {
+  std::array<std::int8_t, 256> table{};
+  for (auto& value : table)
+    value = -1;
+  for (int c = '0'; c <= '9'; ++c)
+    table[c] = static_cast<std::int8_t>(c - '0');
+  for (int c = 'a'; c <= 'f'; ++c)
+    table[c] = static_cast<std::int8_t>(c - 'a' + 10);
+  for (int c = 'A'; c <= 'F'; ++c)
+    table[c] = static_cast<std::int8_t>(c - 'A' + 10);
+  return table;
+}();
+
+// Две hex-цифры на каждое значение байта.
+constexpr std::array<std::array<char, 2>, 256> kByteDigits = [] {
+  constexpr char kDigits[] = "0123456789abcdef";
+  std::array<std::array<char, 2>, 256> table{};
+  for (std::size_t i = 0; i < table.size(); ++i)
+    table[i] = {kDigits[i >> 4], kDigits[i & 0xf]};
+  return table;
+}();
+
+}  // namespace
+
+std::optional<Uuid> Uuid::Parse(std::string_view text) {
+  if (text.size() != kStringSize || text[8] != '-' || text[13] != '-' ||
+      text[18] != '-' || text[23] != '-')
+    return std::nullopt;
+  // Цикл без ветвлений: неверная цифра даёт -1 и взводит знаковый бит
+  // invalid, проверка одна после цикла.
+  Bytes bytes;
+  int invalid = 0;
+  for (std::size_t i = 0; i < kSize; ++i) {
+    const int hi = kHexValues[static_cast<unsigned char>(text[kHexOffsets[i]])];
+    const int lo =
+        kHexValues[static_cast<unsigned char>(text[kHexOffsets[i] + 1])];
+    invalid |= hi | lo;
+    bytes[i] = static_cast<std::uint8_t>((hi << 4) | lo);
+  }
+  if (invalid < 0)
+    return std::nullopt;
+  return Uuid{bytes};
+}
+
+Uuid Uuid::Random() {
+  // id пользователя служит токеном доступа, поэтому байты берутся из
+  // CSPRNG: по выданным id нельзя предсказать следующие.
+  Bytes bytes;
+  if (RAND_bytes(bytes.data(), static_cast<int>(bytes.size())) != 1)
+    throw std::runtime_error("RAND_bytes failed");
+  bytes[6] = static_cast<std::uint8_t>((bytes[6] & 0x0F) | 0x40);
+  bytes[8] = static_cast<std::uint8_t>((bytes[8] & 0x3F) | 0x80);
+  return Uuid{bytes};
+}
+
+void Uuid::Format(char* out) const {
+  out[8] = out[13] = out[18] = out[23] = '-';
+  for (std::size_t i = 0; i < kSize; ++i)
+    std::memcpy(out + kHexOffsets[i], kByteDigits[bytes_[i]].data(), 2);
+}
+
+std::string Uuid::ToString() const {
+  std::string out(kStringSize, '\0');
+  Format(out.data());
+  return out;
+}
+
+std::size_t Uuid::Hash() const {
+  // Два 64-битных слова; перемешивание нужно для последовательных id
+  // (например, UUIDv7), у которых различаются лишь отдельные байты.
+  std::uint64_t high;
+  std::uint64_t low;
+  std::memcpy(&high, bytes_.data(), sizeof(high));
+  std::memcpy(&low, bytes_.data() + sizeof(high), sizeof(low));
+  std::uint64_t h = high ^ (low * 0x9e3779b97f4a7c15ULL);
+  h ^= h >> 32;
+  h *= 0xd6e8feb86659fd93ULL;
+  h ^= h >> 32;
+  return static_cast<std::size_t>(h);
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// UUID в двоичном виде: 16 байт вместо 36-символьной строки. Порядок
+// совпадает с порядком uuid в Postgres (побайтовое сравнение).
+class Uuid {
+ public:
+  static constexpr std::size_t kSize = 16;
+  // Каноническая запись xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx.
+  static constexpr std::size_t kStringSize = 36;
+
+  using Bytes = std::array<std::uint8_t, kSize>;
+
+  constexpr Uuid() = default;
+  explicit constexpr Uuid(const Bytes& bytes) : bytes_(bytes) {}
+
+  // Принимает только каноническую запись; регистр hex-цифр любой.
+  static std::optional<Uuid> Parse(std::string_view text);
+  // Случайный UUID версии 4 из CSPRNG OpenSSL, как gen_random_uuid() в
+  // Postgres. Бросает std::runtime_error, если генератор не отдал байты.
+  static Uuid Random();
+
+  std::string ToString() const;
+  // Пишет ровно kStringSize символов, без завершающего нуля.
+  void Format(char* out) const;
+
+  const Bytes& GetBytes() const { return bytes_; }
+  bool IsNil() const { return *this == Uuid{}; }
+  std::size_t Hash() const;
+
+  auto operator<=>(const Uuid&) const = default;
+
+ private:
+  Bytes bytes_{};
+};
+
+template <>
+struct std::hash<Uuid> {
+  std::size_t operator()(const Uuid& id) const noexcept { return id.Hash(); }
+};
@@ -0,0 +1,163 @@
+#include "buffer_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+
+namespace {
+
+constexpr std::size_t kClassCount =
+    std::bit_width(BufferPool::kMaxBlockSize / BufferPool::kMinBlockSize);
+// Сколько байт блоков одного класса держит кэш потока и склад.
+constexpr std::size_t kThreadCacheBytes = 64 * 1024;
+constexpr std::size_t kDepotBytes = 1024 * 1024;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+constexpr std::size_t ClassIndex(std::size_t size) {
+  return size <= BufferPool::kMinBlockSize
+             ? 0
+             : std::bit_width((size - 1) / BufferPool::kMinBlockSize);
+}
+
+constexpr std::size_t BlockSize(std::size_t index) {
+  return BufferPool::kMinBlockSize << index;
+}
+
+// Небольшой кэш потока быстрее отдаёт излишки на склад, когда память
+// стабильно освобождается не тем потоком, который её выделил.
+constexpr std::size_t ThreadCacheLimit(std::size_t index) {
+  return std::clamp<std::size_t>(kThreadCacheBytes / BlockSize(index), 16,
+                                 128);
+}
+
+constexpr std::size_t DepotLimit(std::size_t index) {
+  return std::max<std::size_t>(64, kDepotBytes / BlockSize(index));
+}
+
+struct FreeList {
+  FreeBlock* head = nullptr;
+  std::size_t size = 0;
+
+  void Push(void* p) {
+    auto* block = static_cast<FreeBlock*>(p);
+    block->next = head;
+    head = block;
+    ++size;
+  }
+
+  void* Pop() {
+    FreeBlock* block = head;
+    head = block->next;
+    --size;
+    return block;
+  }
+};
+
+std::atomic<std::uint64_t> g_allocations{0};
+std::atomic<std::uint64_t> g_system_allocations{0};
+
+// Общий склад: по мьютексу на класс.
+struct Depot {
+  struct Class {
+    std::mutex mutex;
+    FreeList blocks;
+  };
+  std::array<Class, kClassCount> classes;
+
+  // Переносит до count блоков из from в склад, остальное возвращает системе.
+  void Put(std::size_t index, FreeList& from, std::size_t count) {
+    auto& cls = classes[index];
+    std::lock_guard lock(cls.mutex);
+    for (; count > 0; --count) {
+      void* p = from.Pop();
+      if (cls.blocks.size < DepotLimit(index)) {
+        cls.blocks.Push(p);
+      } else {
+        ::operator delete(p);
+      }
+    }
+  }
+
+  void Take(std::size_t index, FreeList& to, std::size_t count) {
+    auto& cls = classes[index];
+    std::lock_guard lock(cls.mutex);
+    for (; count > 0 && cls.blocks.size > 0; --count) {
+      to.Push(cls.blocks.Pop());
+    }
+  }
+};
+
+Depot g_depot;
+
+// Выставляется при разрушении кэша потока: память, освобождаемая
+// деструкторами других thread_local-объектов после него, идёт системе.
+thread_local bool t_cache_destroyed = false;
+
+class ThreadCache {
+ public:
+  ~ThreadCache() {
+    t_cache_destroyed = true;
+    for (std::size_t i = 0; i < kClassCount; ++i) {
+      g_depot.Put(i, lists_[i], lists_[i].size);
+    }
+  }
+
+  void* Allocate(std::size_t index) {
+    FreeList& list = lists_[index];
+    if (list.size == 0)
+      g_depot.Take(index, list, ThreadCacheLimit(index) / 2);
+    if (list.size > 0)
+      return list.Pop();
+    g_system_allocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(BlockSize(index));
+  }
+
+  void Deallocate(std::size_t index, void* p) {
+    FreeList& list = lists_[index];
+    list.Push(p);
+    if (list.size > ThreadCacheLimit(index))
+      g_depot.Put(index, list, list.size / 2);
+  }
+
+ private:
+  std::array<FreeList, kClassCount> lists_;
+};
+
+thread_local ThreadCache t_cache;
+
+}  // namespace
+
+void* BufferPool::Allocate(std::size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (size > kMaxBlockSize) {
+    g_system_allocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(size);
+  }
+  const std::size_t index = ClassIndex(size);
+  if (t_cache_destroyed) {
+    // Блок полного размера класса: его могут вернуть в кэш другого потока.
+    g_system_allocations.fetch_add(1, std::memory_order_relaxed);
+    return ::operator new(BlockSize(index));
+  }
+  return t_cache.Allocate(index);
+}
+
+void BufferPool::Deallocate(void* p, std::size_t size) noexcept {
+  if (p == nullptr)
+    return;
+  if (size > kMaxBlockSize || t_cache_destroyed) {
+    ::operator delete(p);
+    return;
+  }
+  t_cache.Deallocate(ClassIndex(size), p);
+}
+
+BufferPool::Stats BufferPool::GetStats() {
+  return Stats{g_allocations.load(std::memory_order_relaxed),
+               g_system_allocations.load(std::memory_order_relaxed)};
+}
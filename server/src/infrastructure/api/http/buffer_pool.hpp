@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <string>
+
+// Пул блоков для заголовков и тел HTTP-сообщений. Блоки до kMaxBlockSize
+// разбиты на классы размеров (степени двойки); у каждого потока свой кэш
+// свободных блоков без блокировок. Излишки кэша уходят в общий склад, откуда
+// их забирают другие потоки: ответ, собранный на пуле обработчиков и
+// освобождённый в потоке соединения, не оседает навсегда в чужом кэше.
+// В установившемся режиме память у системы не запрашивается.
+class BufferPool {
+ public:
+  static constexpr std::size_t kMinBlockSize = 16;
+  static constexpr std::size_t kMaxBlockSize = 4096;
+
+  struct Stats {
+    // Все вызовы Allocate.
+    std::uint64_t allocations = 0;
+    // Из них ушедшие в operator new: промахи пула и крупные блоки.
+    std::uint64_t system_allocations = 0;
+  };
+
+  static void* Allocate(std::size_t size);
+  // size — тот же, что был передан в Allocate.
+  static void Deallocate(void* p, std::size_t size) noexcept;
+  static Stats GetStats();
+};
+
+// Stateless-аллокатор поверх BufferPool: все экземпляры взаимозаменяемы,
+// поэтому память можно освобождать в другом потоке и другим объектом.
+template <class T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+  PoolAllocator() noexcept = default;
+  template <class U>
+  PoolAllocator(const PoolAllocator<U>& /*other*/) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    return static_cast<T*>(BufferPool::Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    BufferPool::Deallocate(p, n * sizeof(T));
+  }
+
+  template <class U>
+  bool operator==(const PoolAllocator<U>& /*other*/) const noexcept {
+    return true;
+  }
+};
+
+// Строка в памяти пула — тип тел HTTP-сообщений (PooledStringBody).
+using PooledString =
+    std::basic_string<char, std::char_traits<char>, PoolAllocator<char>>;
@@ -0,0 +1,62 @@
+#include "dispatch_pool.hpp"
+
+#include <stdexcept>
+
+DispatchPool::DispatchPool(std::string name, std::size_t thread_count,
+                           std::size_t max_queue_depth)
+    : name_(std::move(name)),
+      thread_count_(thread_count),
+      max_queue_depth_(max_queue_depth),
+      pool_(thread_count) {
+  if (thread_count == 0) {
+    throw std::runtime_error("Dispatch pool size must be greater than 0");
+  }
+  if (max_queue_depth == 0) {
+    throw std::runtime_error("Dispatch queue depth must be greater than 0");
+  }
+}
+
+DispatchPool::~DispatchPool() {
+  Shutdown();
+}
+
+void DispatchPool::Shutdown() {
+  pool_.stop();
+  pool_.join();
+}
+
+DispatchPool::Stats DispatchPool::GetStats() const {
+  return Stats{queue_depth_.load(std::memory_order_relaxed),
+               max_queue_depth_seen_.load(std::memory_order_relaxed),
+               active_.load(std::memory_order_relaxed),
+               submitted_.load(std::memory_order_relaxed),
+               rejected_.load(std::memory_order_relaxed),
+               completed_.load(std::memory_order_relaxed)};
+}
+
+bool DispatchPool::TryReserve() {
+  const std::size_t depth =
+      queue_depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (depth > max_queue_depth_) {
+    queue_depth_.fetch_sub(1, std::memory_order_relaxed);
+    rejected_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  submitted_.fetch_add(1, std::memory_order_relaxed);
+
+  std::size_t seen = max_queue_depth_seen_.load(std::memory_order_relaxed);
+  while (depth > seen && !max_queue_depth_seen_.compare_exchange_weak(
+                             seen, depth, std::memory_order_relaxed)) {
+  }
+  return true;
+}
+
+void DispatchPool::OnStarted() {
+  queue_depth_.fetch_sub(1, std::memory_order_relaxed);
+  active_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DispatchPool::OnFinished() {
+  active_.fetch_sub(1, std::memory_order_relaxed);
+  completed_.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string>
+#include <utility>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/log/trivial.hpp>
+
+// Ограниченный пул потоков, на котором выполняются обработчики запросов,
+// чтобы блокирующие обращения к БД не занимали потоки io_context.
+// Если в очереди уже max_queue_depth задач, TryPost возвращает false и
+// не забирает переданную задачу.
+class DispatchPool {
+ public:
+  struct Stats {
+    std::size_t queue_depth;
+    std::size_t max_queue_depth_seen;
+    std::size_t active;
+    std::uint64_t submitted;
+    std::uint64_t rejected;
+    std::uint64_t completed;
+  };
+
+  DispatchPool(std::string name, std::size_t thread_count,
+               std::size_t max_queue_depth);
+  ~DispatchPool();
+
+  DispatchPool(const DispatchPool&) = delete;
+  DispatchPool& operator=(const DispatchPool&) = delete;
+
+  template <class Task>
+  bool TryPost(Task&& task) {
+    if (!TryReserve()) {
+      return false;
+    }
+    boost::asio::post(pool_, [this, task = std::forward<Task>(task)]() mutable {
+      OnStarted();
+      try {
+        task();
+      } catch (const std::exception& e) {
+        BOOST_LOG_TRIVIAL(error)
+            << "dispatch pool " << name_ << ": " << e.what();
+      }
+      OnFinished();
+    });
+    return true;
+  }
+
+  // Отбрасывает задачи из очереди и дожидается завершения выполняющихся.
+  void Shutdown();
+
+  Stats GetStats() const;
+  const std::string& GetName() const { return name_; }
+  std::size_t GetThreadCount() const { return thread_count_; }
+  std::size_t GetMaxQueueDepth() const { return max_queue_depth_; }
+
+ private:
+  bool TryReserve();
+  void OnStarted();
+  void OnFinished();
+
+  std::string name_;
+  std::size_t thread_count_;
+  std::size_t max_queue_depth_;
+  boost::asio::thread_pool pool_;
+
+  std::atomic<std::size_t> queue_depth_{0};
+  std::atomic<std::size_t> max_queue_depth_seen_{0};
+  std::atomic<std::size_t> active_{0};
+  std::atomic<std::uint64_t> submitted_{0};
+  std::atomic<std::uint64_t> rejected_{0};
+  std::atomic<std::uint64_t> completed_{0};
+};
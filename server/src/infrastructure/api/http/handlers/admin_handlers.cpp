@@ -0,0 +1,64 @@
+#include "admin_handlers.hpp"
+
+#include <string_view>
+
+#include "json_reader.hpp"
+#include "json_writer.hpp"
+
+namespace http = boost::beast::http;
+
+namespace {
+
+HttpResponse JsonResponse(http::status status, std::string_view key,
+                          std::string_view value) {
+  HttpResponse resp;
+  resp.result(status);
+  resp.set(http::field::content_type, "application/json");
+  PooledJsonWriter writer(resp.body());
+  writer.BeginObject();
+  writer.Key(key);
+  writer.String(value);
+  writer.EndObject();
+  resp.prepare_payload();
+  return resp;
+}
+
+// Время сравнения не зависит от того, в каком байте первое расхождение.
+bool TokenEquals(std::string_view given, std::string_view expected) {
+  unsigned char diff = given.size() == expected.size() ? 0 : 1;
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    const char c = i < given.size() ? given[i] : '\0';
+    diff |= static_cast<unsigned char>(c ^ expected[i]);
+  }
+  return diff == 0;
+}
+
+}  // namespace
+
+HttpResponse LogLevelHandler::Execute(const HttpRequest& req) {
+  constexpr std::string_view kBearer = "Bearer ";
+  const auto field = req[http::field::authorization];
+  const std::string_view authorization{field.data(), field.size()};
+  if (token_.empty() || !authorization.starts_with(kBearer) ||
+      !TokenEquals(authorization.substr(kBearer.size()), token_))
+    return JsonResponse(http::status::unauthorized, "error", "unauthorized");
+
+  JsonFieldReader body({"level"});
+  if (!body.Parse(req.body()))
+    return JsonResponse(http::status::bad_request, "error", "invalid_json");
+  const auto level = ParseLogLevel(body.Get("level"));
+  if (!level)
+    return JsonResponse(http::status::bad_request, "error", "invalid_level");
+
+  control_->SetLevel(*level);
+  return JsonResponse(http::status::ok, "level", ToString(*level));
+}
+
+HttpResponse MetricsHandler::Execute(const HttpRequest& /*req*/) {
+  HttpResponse resp;
+  resp.result(http::status::ok);
+  resp.set(http::field::content_type, "text/plain; version=0.0.4");
+  resp.body() = metrics_->Render();
+  resp.prepare_payload();
+  return resp;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <boost/beast/http.hpp>
+#include <memory>
+#include <string>
+
+#include "access_log.hpp"
+#include "handler.hpp"
+#include "metrics_registry.hpp"
+
+namespace http = boost::beast::http;
+
+// PUT /admin/log-level {"level":"debug|info|warning|error|off"} — уровень
+// логов без перезапуска. Запрос должен нести Authorization: Bearer <token>.
+class LogLevelHandler : public Handler {
+ public:
+  LogLevelHandler(std::shared_ptr<LogLevelControl> control, std::string token)
+      : control_(std::move(control)), token_(std::move(token)) {}
+
+  std::string GetMethodEndpoint() const override {
+    return "PUT /admin/log-level";
+  }
+
+  HttpResponse Execute(const HttpRequest& req) override;
+
+ private:
+  std::shared_ptr<LogLevelControl> control_;
+  std::string token_;
+};
+
+// GET /metrics — метрики в текстовом формате Prometheus.
+class MetricsHandler : public Handler {
+ public:
+  explicit MetricsHandler(std::shared_ptr<MetricsRegistry> metrics)
+      : metrics_(std::move(metrics)) {}
+
+  std::string GetMethodEndpoint() const override { return "GET /metrics"; }
+
+  HttpResponse Execute(const HttpRequest& req) override;
+
+ private:
+  std::shared_ptr<MetricsRegistry> metrics_;
+};
@@ -1,15 +1,105 @@
 #pragma once
 
+#include <array>
 #include <boost/beast/http.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
+
+#include "buffer_pool.hpp"
 
 namespace http = boost::beast::http;
 
+// Сообщения сервера: заголовки и тело в памяти BufferPool, чтобы
+// keep-alive соединения в установившемся режиме не ходили в системный
+// аллокатор на каждый запрос.
+using PooledStringBody =
+    http::basic_string_body<char, std::char_traits<char>, PoolAllocator<char>>;
+using HttpFields = http::basic_fields<PoolAllocator<char>>;
+using HttpRequest = http::request<PooledStringBody, HttpFields>;
+using HttpResponse = http::response<PooledStringBody, HttpFields>;
+
+// Параметры пути из шаблонов вида /task/{id}. Имена указывают в таблицу
+// маршрутов, значения — в target запроса, поэтому копий строк нет.
+class PathParams {
+ public:
+  static constexpr std::size_t kMaxParams = 4;
+
+  bool Add(std::string_view name, std::string_view value) {
+    if (size_ == kMaxParams)
+      return false;
+    params_[size_++] = {name, value};
+    return true;
+  }
+
+  void PopBack() { --size_; }
+
+  std::string_view Get(std::string_view name) const {
+    for (std::size_t i = 0; i < size_; ++i) {
+      if (params_[i].first == name)
+        return params_[i].second;
+    }
+    return {};
+  }
+
+  std::size_t Size() const { return size_; }
+
+ private:
+  std::array<std::pair<std::string_view, std::string_view>, kMaxParams>
+      params_{};
+  std::size_t size_ = 0;
+};
+
+// Тело ответа, которое отдаётся частями (chunked transfer encoding).
+// Next вызывается последовательно, пока не вернёт nullopt.
+class ChunkSource {
+ public:
+  virtual ~ChunkSource() = default;
+  virtual std::optional<std::string> Next() = 0;
+};
+
+// Ответ, который готовится на другом пуле (например, вход с хэшированием
+// пароля). Сессия ждёт его, не занимая свой поток: Start возвращается
+// сразу, а done вызывается ровно один раз из любого потока. Запрос и
+// обработчик живы, пока done не вызван.
+class DeferredResponse {
+ public:
+  using Done = std::move_only_function<void(HttpResponse)>;
+
+  virtual ~DeferredResponse() = default;
+  virtual void Start(Done done) = 0;
+};
+
 class Handler {
  public:
   virtual ~Handler() = default;
   virtual std::string GetMethodEndpoint() const = 0;
-  virtual http::response<http::string_body> Execute(
-      const http::request<http::string_body>& req) = 0;
-};
+  virtual HttpResponse Execute(const HttpRequest& req) = 0;
+
+  // Обработчики, которым нужны параметры пути, переопределяют эту версию.
+  virtual HttpResponse Execute(
+      const HttpRequest& req, const PathParams& params) {
+    (void)params;
+    return Execute(req);
+  }
 
+  // Потоковый ответ: обработчик заполняет статус и заголовки response и
+  // возвращает источник тела. nullptr — ответ целиком в response.
+  virtual std::unique_ptr<ChunkSource> ExecuteStreaming(
+      const HttpRequest& req, const PathParams& params,
+      HttpResponse& response) {
+    response = Execute(req, params);
+    return nullptr;
+  }
+
+  // Отложенный ответ вместо ExecuteStreaming. nullptr — обработчик отвечает
+  // сразу.
+  virtual std::unique_ptr<DeferredResponse> ExecuteDeferred(
+      const HttpRequest& /*req*/, const PathParams& /*params*/) {
+    return nullptr;
+  }
+};
@@ -1,30 +1,63 @@
 #include "task_handlers.hpp"
 
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
 #include <sstream>
 #include <string_view>
+#include <utility>
+#include <vector>
+
+#include "json_reader.hpp"
+#include "json_writer.hpp"
+#include "task_json.hpp"
 
 namespace http = boost::beast::http;
 
-http::response<http::string_body> OkJson(const std::string& body) {
-  http::response<http::string_body> resp;
+HttpResponse OkJson(std::string_view body) {
+  HttpResponse resp;
+  resp.result(http::status::ok);
+  resp.set(http::field::content_type, "application/json");
+  resp.body().assign(body.data(), body.size());
+  resp.prepare_payload();
+  return resp;
+}
+
+// Тело, собранное в памяти пула, переходит в ответ без копирования.
+HttpResponse OkJson(PooledString&& body) {
+  HttpResponse resp;
   resp.result(http::status::ok);
   resp.set(http::field::content_type, "application/json");
-  resp.body() = body;
+  resp.body() = std::move(body);
   resp.prepare_payload();
   return resp;
 }
 
-http::response<http::string_body> ErrorJson(http::status status,
-                                            std::string_view code) {
-  http::response<http::string_body> resp;
+HttpResponse ErrorJson(http::status status, std::string_view code) {
+  HttpResponse resp;
   resp.result(status);
   resp.set(http::field::content_type, "application/json");
-  resp.body() = std::string("{\"error\":\"") + std::string(code) + "}";
+  PooledJsonWriter writer(resp.body());
+  writer.BeginObject();
+  writer.Key("error");
+  writer.String(code);
+  writer.EndObject();
   resp.prepare_payload();
   return resp;
 }
 
+// Пул соединений с БД исчерпан: клиенту стоит повторить запрос позже.
+HttpResponse Unavailable() {
+  auto resp = ErrorJson(http::status::service_unavailable, "unavailable");
+  resp.set(http::field::retry_after, "1");
+  return resp;
+}
+
 std::string GetQueryParam(const std::string& target, const std::string& key) {
   auto pos = target.find('?');
   if (pos == std::string::npos)
@@ -44,116 +77,552 @@ std::string GetQueryParam(const std::string& target, const std::string& key) {
   return {};
 }
 
-http::response<http::string_body> CreateTaskHandler::Execute(
-    const http::request<http::string_body>& req) {
-  using nlohmann::json;
-  try {
-    const auto body = json::parse(req.body());
-    const auto user_id = body.at("user_id").get<std::string>();
-    const auto title = body.at("title").get<std::string>();
-    const auto description = body.at("description").get<std::string>();
-    const auto status = body.at("status").get<std::string>();
+// Идентификатор из пути (/task/{id}), а для старых маршрутов — из query.
+std::string GetIdParam(const HttpRequest& req,
+                       const PathParams& params, const std::string& key) {
+  const auto value = params.Get(key);
+  if (!value.empty())
+    return std::string(value);
+  return GetQueryParam(std::string(req.target()), key);
+}
+
+namespace {
+
+constexpr std::size_t kDefaultPageSize = 100;
+constexpr std::size_t kMaxPageSize = 1000;
+
+std::optional<std::size_t> ParsePageSize(const std::string& value) {
+  if (value.empty())
+    return kDefaultPageSize;
+  std::size_t size = 0;
+  const auto [end, ec] =
+      std::from_chars(value.data(), value.data() + value.size(), size);
+  if (ec != std::errc{} || end != value.data() + value.size() || size == 0 ||
+      size > kMaxPageSize)
+    return std::nullopt;
+  return size;
+}
+
+// Для клиента курсор непрозрачен: hex от "status\nid\ntitle" последней
+// задачи страницы.
+std::string EncodeCursor(const Task& task) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  const std::string raw = std::string(ToString(task.GetStatus())) + '\n' +
+                          task.GetId().ToString() + '\n' + task.GetTitle();
+  std::string out;
+  out.reserve(raw.size() * 2);
+  for (const unsigned char c : raw) {
+    out += kHex[c >> 4];
+    out += kHex[c & 0xf];
+  }
+  return out;
+}
+
+int HexValue(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+std::optional<TaskPageCursor> DecodeCursor(const std::string& hex) {
+  if (hex.size() % 2 != 0)
+    return std::nullopt;
+  std::string raw;
+  raw.reserve(hex.size() / 2);
+  for (std::size_t i = 0; i < hex.size(); i += 2) {
+    const int hi = HexValue(hex[i]);
+    const int lo = HexValue(hex[i + 1]);
+    if (hi < 0 || lo < 0)
+      return std::nullopt;
+    raw += static_cast<char>(hi * 16 + lo);
+  }
+  const auto first = raw.find('\n');
+  const auto second =
+      first == std::string::npos ? first : raw.find('\n', first + 1);
+  if (second == std::string::npos)
+    return std::nullopt;
+  const auto status = ParseTaskStatus(std::string_view(raw).substr(0, first));
+  const auto task_id =
+      Uuid::Parse(std::string_view(raw).substr(first + 1, second - first - 1));
+  if (!status || !task_id)
+    return std::nullopt;
+  return TaskPageCursor{*status, raw.substr(second + 1), *task_id};
+}
+
+// Тело {"tasks":[...]} по страницам: каждая страница — отдельный кусок,
+// следующая читается из хранилища, только когда предыдущая отправлена.
+class UserTasksStream final : public ChunkSource {
+ public:
+  UserTasksStream(std::shared_ptr<TaskService> task_service,
+                  Uuid user_id, std::size_t page_size,
+                  std::vector<Task> first_page)
+      : task_service_(std::move(task_service)),
+        user_id_(user_id),
+        page_size_(page_size),
+        first_page_(std::move(first_page)) {}
+
+  std::optional<std::string> Next() override {
+    if (done_)
+      return std::nullopt;
+    std::vector<Task> page;
+    if (first_page_) {
+      page = std::move(*first_page_);
+      first_page_.reset();
+    } else {
+      auto r = task_service_->GetUserTasksPage(user_id_, cursor_, page_size_);
+      if (!r.has_value())
+        throw std::runtime_error("Failed to read tasks page for user " +
+                                 user_id_.ToString());
+      page = std::move(r.value());
+    }
 
-    if (status != "InProgress" && status != "InProject" && status != "Done") {
+    std::size_t size = page.size() + 16;
+    for (const auto& t : page)
+      size += TaskJsonSize(t);
+    std::string chunk;
+    chunk.reserve(size);
+    if (!opened_)
+      chunk += R"({"tasks":[)";
+    opened_ = true;
+    for (const auto& t : page) {
+      if (written_++ > 0)
+        chunk += ',';
+      JsonWriter writer(chunk);
+      WriteTask(writer, t);
+    }
+    if (page.size() < page_size_) {
+      chunk += "]}";
+      done_ = true;
+    } else {
+      const auto& last = page.back();
+      cursor_ = TaskPageCursor{last.GetStatus(), last.GetTitle(), last.GetId()};
+    }
+    return chunk;
+  }
+
+ private:
+  std::shared_ptr<TaskService> task_service_;
+  Uuid user_id_;
+  std::size_t page_size_;
+  std::optional<std::vector<Task>> first_page_;
+  std::optional<TaskPageCursor> cursor_;
+  std::size_t written_ = 0;
+  bool opened_ = false;
+  bool done_ = false;
+};
+
+using BodyOrError = std::expected<PooledString, HttpResponse>;
+
+std::string_view IfNoneMatch(const HttpRequest& req) {
+  const auto value = req[http::field::if_none_match];
+  return {value.data(), value.size()};
+}
+
+HttpResponse NotModified(const std::string& etag) {
+  // Без prepare_payload: Content-Length у 304 описывал бы само тело.
+  HttpResponse resp;
+  resp.result(http::status::not_modified);
+  resp.set(http::field::etag, etag);
+  return resp;
+}
+
+// Ответ с ETag версии: 304, если у клиента тот же ETag, иначе тело из кэша
+// или из build. Ошибки build не кэшируются. Версию нужно взять до чтения
+// данных, чтобы изменение во время чтения сделало запись устаревшей.
+// If-None-Match: * даёт 304, только когда тело есть: для отсутствующей
+// задачи остаётся ошибка build (404).
+template <class Build>
+HttpResponse CachedJson(
+    ResponseCache& cache, const HttpRequest& req,
+    const Uuid& key, std::uint64_t version, Build&& build) {
+  const std::string etag = ResponseCache::MakeETag(version);
+  const auto if_none_match = IfNoneMatch(req);
+  if (ResponseCache::MatchesIfNoneMatch(if_none_match, etag))
+    return NotModified(etag);
+  HttpResponse resp;
+  if (const auto body = cache.Get(key, version)) {
+    if (ResponseCache::IfNoneMatchAny(if_none_match))
+      return NotModified(etag);
+    resp = OkJson(*body);
+  } else {
+    BodyOrError built = build();
+    if (!built.has_value())
+      return std::move(built.error());
+    cache.Put(key, version,
+              std::make_shared<const std::string>(built->begin(),
+                                                  built->end()));
+    if (ResponseCache::IfNoneMatchAny(if_none_match))
+      return NotModified(etag);
+    resp = OkJson(std::move(built.value()));
+  }
+  resp.set(http::field::etag, etag);
+  return resp;
+}
+
+}  // namespace
+
+HttpResponse CreateTaskHandler::Execute(const HttpRequest& req) {
+  try {
+    JsonFieldReader body({"user_id", "title", "description", "status"});
+    if (!body.Parse(req.body()))
+      return ErrorJson(http::status::bad_request, "invalid_json");
+    const auto user_id = Uuid::Parse(body.Get("user_id"));
+    if (!user_id) {
+      return ErrorJson(http::status::bad_request, "invalid_id");
+    }
+    const std::string title(body.Get("title"));
+    const std::string description(body.Get("description"));
+    const auto status = ParseTaskStatus(body.Get("status"));
+    if (!status) {
       return ErrorJson(http::status::bad_request, "invalid_status");
     }
 
-    auto r = task_service_->CreateTask(user_id, title, description, status);
+    auto r = task_service_->CreateTask(*user_id, title, description, *status);
     if (!r.has_value() && (r.error() == AddTaskError::AlreadyExists))
       return ErrorJson(http::status::conflict, "task exist");
+    if (!r.has_value() && (r.error() == AddTaskError::RepositoryTimeout))
+      return Unavailable();
     if (!r.has_value())
       return ErrorJson(http::status::internal_server_error, "create_failed");
-    json out;
-    out["status"] = "ok";
-    out["id"] = r->GetId();
-    return OkJson(out.dump());
+    PooledString out;
+    PooledJsonWriter writer(out);
+    writer.BeginObject();
+    writer.Key("id");
+    writer.String(r->GetId());
+    writer.Key("status");
+    writer.String("ok");
+    writer.EndObject();
+    return OkJson(std::move(out));
   } catch (...) {
     return ErrorJson(http::status::bad_request, "invalid_json");
   }
 }
 
-http::response<http::string_body> ChangeStatusTaskHandler::Execute(
-    const http::request<http::string_body>& req) {
-  using nlohmann::json;
+HttpResponse ChangeStatusTaskHandler::Execute(const HttpRequest& req) {
   try {
-    const auto body = json::parse(req.body());
-    const auto id = body.at("id").get<std::string>();
-    const auto status = body.at("status").get<std::string>();
-
-    if (status != "InProgress" && status != "InProject" && status != "Done") {
+    JsonFieldReader body({"id", "status"});
+    if (!body.Parse(req.body()))
+      return ErrorJson(http::status::bad_request, "invalid_json");
+    const auto id = Uuid::Parse(body.Get("id"));
+    if (!id) {
+      return ErrorJson(http::status::bad_request, "invalid_id");
+    }
+    const auto status = ParseTaskStatus(body.Get("status"));
+    if (!status) {
       return ErrorJson(http::status::bad_request, "invalid_status");
     }
 
-    auto r = task_service_->ChangeStatus(id, status);
+    auto r = task_service_->ChangeStatus(*id, *status);
     if (!r.has_value() && (r.error() == UpdateTaskError::NotFound))
       return ErrorJson(http::status::not_found, "update_failed");
+    if (!r.has_value() && (r.error() == UpdateTaskError::RepositoryTimeout))
+      return Unavailable();
     if (!r.has_value())
       return ErrorJson(http::status::bad_request, "update_failed");
-    json out;
-    out["status"] = "ok";
-    out["id"] = r->GetId();
-    out["new_status"] = r->GetStatus();
-    return OkJson(out.dump());
+    PooledString out;
+    PooledJsonWriter writer(out);
+    writer.BeginObject();
+    writer.Key("id");
+    writer.String(r->GetId());
+    writer.Key("new_status");
+    writer.String(ToString(r->GetStatus()));
+    writer.Key("status");
+    writer.String("ok");
+    writer.EndObject();
+    return OkJson(std::move(out));
   } catch (...) {
     return ErrorJson(http::status::bad_request, "invalid_json");
   }
 }
 
-http::response<http::string_body> DeleteTaskHandler::Execute(
-    const http::request<http::string_body>& req) {
-  const auto id = GetQueryParam(std::string(req.target()), "id");
-  if (id.empty())
+HttpResponse CreateTasksBulkHandler::Execute(const HttpRequest& req) {
+  using nlohmann::json;
+  std::vector<Task> tasks;
+  try {
+    const auto body = json::parse(req.body());
+    const auto& items = body.at("tasks");
+    if (!items.is_array())
+      return ErrorJson(http::status::bad_request, "invalid_json");
+    if (items.size() > kMaxBatchSize)
+      return ErrorJson(http::status::payload_too_large, "batch_too_large");
+    tasks.reserve(items.size());
+    for (const auto& item : items) {
+      const auto user_id =
+          Uuid::Parse(item.at("user_id").get_ref<const std::string&>());
+      if (!user_id)
+        return ErrorJson(http::status::bad_request, "invalid_id");
+      const auto status =
+          ParseTaskStatus(item.at("status").get<std::string>());
+      if (!status)
+        return ErrorJson(http::status::bad_request, "invalid_status");
+      tasks.emplace_back(*user_id,
+                         item.at("title").get<std::string>(),
+                         item.at("description").get<std::string>(), *status);
+    }
+  } catch (...) {
+    return ErrorJson(http::status::bad_request, "invalid_json");
+  }
+
+  auto r = task_service_->CreateTasks(tasks);
+  if (!r.has_value() && (r.error() == AddTaskError::AlreadyExists))
+    return ErrorJson(http::status::conflict, "task exist");
+  if (!r.has_value() && (r.error() == AddTaskError::RepositoryTimeout))
+    return Unavailable();
+  if (!r.has_value())
+    return ErrorJson(http::status::internal_server_error, "create_failed");
+  PooledString out;
+  out.reserve(r->size() * (Uuid::kStringSize + 3) + 32);
+  PooledJsonWriter writer(out);
+  writer.BeginObject();
+  writer.Key("ids");
+  writer.BeginArray();
+  for (const auto& t : r.value())
+    writer.String(t.GetId());
+  writer.EndArray();
+  writer.Key("status");
+  writer.String("ok");
+  writer.EndObject();
+  return OkJson(std::move(out));
+}
+
+HttpResponse ChangeStatusBulkHandler::Execute(const HttpRequest& req) {
+  using nlohmann::json;
+  std::vector<std::pair<Uuid, TaskStatus>> updates;
+  try {
+    const auto body = json::parse(req.body());
+    const auto& items = body.at("updates");
+    if (!items.is_array())
+      return ErrorJson(http::status::bad_request, "invalid_json");
+    if (items.size() > kMaxBatchSize)
+      return ErrorJson(http::status::payload_too_large, "batch_too_large");
+    updates.reserve(items.size());
+    for (const auto& item : items) {
+      const auto id = Uuid::Parse(item.at("id").get_ref<const std::string&>());
+      if (!id)
+        return ErrorJson(http::status::bad_request, "invalid_id");
+      const auto status =
+          ParseTaskStatus(item.at("status").get<std::string>());
+      if (!status)
+        return ErrorJson(http::status::bad_request, "invalid_status");
+      updates.emplace_back(*id, *status);
+    }
+  } catch (...) {
+    return ErrorJson(http::status::bad_request, "invalid_json");
+  }
+
+  auto r = task_service_->ChangeStatuses(updates);
+  if (!r.has_value() && (r.error() == UpdateTaskError::NotFound))
+    return ErrorJson(http::status::not_found, "update_failed");
+  if (!r.has_value() && (r.error() == UpdateTaskError::RepositoryTimeout))
+    return Unavailable();
+  if (!r.has_value())
+    return ErrorJson(http::status::bad_request, "update_failed");
+  PooledString out;
+  PooledJsonWriter writer(out);
+  writer.BeginObject();
+  writer.Key("status");
+  writer.String("ok");
+  writer.Key("updated");
+  writer.Uint(r->size());
+  writer.EndObject();
+  return OkJson(std::move(out));
+}
+
+HttpResponse DeleteTaskHandler::Execute(const HttpRequest& req) {
+  return Execute(req, PathParams{});
+}
+
+HttpResponse DeleteTaskHandler::Execute(
+    const HttpRequest& req, const PathParams& params) {
+  const auto id_param = GetIdParam(req, params, "id");
+  if (id_param.empty())
     return ErrorJson(http::status::bad_request, "missing_id");
+  const auto id = Uuid::Parse(id_param);
+  if (!id)
+    return ErrorJson(http::status::bad_request, "invalid_id");
 
   try {
-    auto r = task_service_->DeleteTask(id);
+    auto r = task_service_->DeleteTask(*id);
     if (!r.has_value() && (r.error() == DeleteTaskError::NotFound))
       return ErrorJson(http::status::not_found, "delete_failed");
+    if (!r.has_value() && (r.error() == DeleteTaskError::RepositoryTimeout))
+      return Unavailable();
     if (!r.has_value())
       return ErrorJson(http::status::bad_request, "delete_failed");
-    return OkJson(R"({"status": "ok"})");
+    PooledString out;
+    PooledJsonWriter writer(out);
+    writer.BeginObject();
+    writer.Key("status");
+    writer.String("ok");
+    writer.EndObject();
+    return OkJson(std::move(out));
   } catch (...) {
     return ErrorJson(http::status::bad_request, "invalid_json");
   }
 }
 
-http::response<http::string_body> GetAllTasksHandler::Execute(
-    const http::request<http::string_body>& req) {
-  const std::string user_id =
-      GetQueryParam(std::string(req.target()), "user_id");
-  if (user_id.empty())
+HttpResponse GetAllTasksHandler::Execute(const HttpRequest& req) {
+  return Execute(req, PathParams{});
+}
+
+HttpResponse GetAllTasksHandler::Execute(
+    const HttpRequest& req, const PathParams& params) {
+  const std::string user_id_param = GetIdParam(req, params, "user_id");
+  if (user_id_param.empty())
     return ErrorJson(http::status::bad_request, "missing_user_id");
-  auto r = task_service_->GetUserTasks(user_id);
+  const auto user_id = Uuid::Parse(user_id_param);
+  if (!user_id)
+    return ErrorJson(http::status::bad_request, "invalid_id");
+  const std::string target(req.target());
+  const auto limit_param = GetQueryParam(target, "limit");
+  const auto after_param = GetQueryParam(target, "after");
+  if (!limit_param.empty() || !after_param.empty())
+    return GetPage(*user_id, limit_param, after_param);
+
+  const auto build = [&]() -> BodyOrError {
+    auto r = task_service_->GetUserTasks(*user_id);
+    if (!r.has_value() && (r.error() == FindTaskError::RepositoryTimeout))
+      return std::unexpected(Unavailable());
+    if (!r.has_value())
+      return std::unexpected(
+          ErrorJson(http::status::bad_request, "get_failed"));
+    PooledString out;
+    AppendTaskListJson(out, r.value());
+    return out;
+  };
+  if (response_cache_) {
+    const auto version = task_service_->GetUserTasksVersion(*user_id);
+    return CachedJson(*response_cache_, req, *user_id, version, build);
+  }
+  auto body = build();
+  if (!body.has_value())
+    return std::move(body.error());
+  return OkJson(std::move(body.value()));
+}
+
+HttpResponse GetAllTasksHandler::GetPage(
+    const Uuid& user_id, const std::string& limit_param,
+    const std::string& after_param) {
+  const auto limit = ParsePageSize(limit_param);
+  if (!limit)
+    return ErrorJson(http::status::bad_request, "invalid_limit");
+  std::optional<TaskPageCursor> after;
+  if (!after_param.empty()) {
+    after = DecodeCursor(after_param);
+    if (!after)
+      return ErrorJson(http::status::bad_request, "invalid_cursor");
+  }
+
+  // Лишняя задача показывает, есть ли следующая страница.
+  auto r = task_service_->GetUserTasksPage(user_id, after, *limit + 1);
+  if (!r.has_value() && (r.error() == FindTaskError::RepositoryTimeout))
+    return Unavailable();
   if (!r.has_value())
     return ErrorJson(http::status::bad_request, "get_failed");
+  auto& tasks = r.value();
+  const bool has_more = tasks.size() > *limit;
+  if (has_more)
+    tasks.erase(tasks.begin() + static_cast<std::ptrdiff_t>(*limit),
+                tasks.end());
+
+  const std::string next = has_more ? EncodeCursor(tasks.back()) : "";
+  std::size_t size = tasks.size() + next.size() + 32;
+  for (const auto& t : tasks)
+    size += TaskJsonSize(t);
+  PooledString out;
+  out.reserve(size);
+  PooledJsonWriter writer(out);
+  writer.BeginObject();
+  writer.Key("tasks");
+  writer.BeginArray();
+  for (const auto& t : tasks)
+    WriteTask(writer, t);
+  writer.EndArray();
+  writer.Key("next");
+  if (has_more)
+    writer.String(next);
+  else
+    writer.Null();
+  writer.EndObject();
+  return OkJson(std::move(out));
+}
+
+std::unique_ptr<ChunkSource> GetAllTasksHandler::ExecuteStreaming(
+    const HttpRequest& req, const PathParams& params, HttpResponse& response) {
+  const std::string target(req.target());
+  if (GetQueryParam(target, "stream") != "1") {
+    response = Execute(req, params);
+    return nullptr;
+  }
+  const std::string user_id_param = GetIdParam(req, params, "user_id");
+  if (user_id_param.empty()) {
+    response = ErrorJson(http::status::bad_request, "missing_user_id");
+    return nullptr;
+  }
+  const auto user_id = Uuid::Parse(user_id_param);
+  if (!user_id) {
+    response = ErrorJson(http::status::bad_request, "invalid_id");
+    return nullptr;
+  }
+  const auto page_size = ParsePageSize(GetQueryParam(target, "limit"));
+  if (!page_size) {
+    response = ErrorJson(http::status::bad_request, "invalid_limit");
+    return nullptr;
+  }
 
-  nlohmann::json out;
-  out["tasks"] = nlohmann::json::array();
-  for (const auto& t : r.value()) {
-    out["tasks"].push_back({
-        {"id", t.GetId()},
-        {"user_id", t.GetUserId()},
-        {"title", t.GetTitle()},
-        {"description", t.GetDescription()},
-        {"status", t.GetStatus()},
-    });
+  // Первая страница читается до отправки заголовка, чтобы ошибка хранилища
+  // ещё могла стать кодом ответа.
+  auto first_page =
+      task_service_->GetUserTasksPage(*user_id, std::nullopt, *page_size);
+  if (!first_page.has_value() &&
+      (first_page.error() == FindTaskError::RepositoryTimeout)) {
+    response = Unavailable();
+    return nullptr;
+  }
+  if (!first_page.has_value()) {
+    response = ErrorJson(http::status::bad_request, "get_failed");
+    return nullptr;
   }
-  return OkJson(out.dump());
+
+  response.result(http::status::ok);
+  response.set(http::field::content_type, "application/json");
+  return std::make_unique<UserTasksStream>(task_service_, *user_id, *page_size,
+                                           std::move(first_page.value()));
 }
 
-http::response<http::string_body> GetOneTaskHandler::Execute(
-    const http::request<http::string_body>& req) {
-  const std::string id = GetQueryParam(std::string(req.target()), "id");
-  if (id.empty())
+HttpResponse GetOneTaskHandler::Execute(const HttpRequest& req) {
+  return Execute(req, PathParams{});
+}
+
+HttpResponse GetOneTaskHandler::Execute(
+    const HttpRequest& req, const PathParams& params) {
+  const std::string id_param = GetIdParam(req, params, "id");
+  if (id_param.empty())
     return ErrorJson(http::status::bad_request, "missing_id");
-  auto r = task_service_->GetTask(id);
-  if (!r.has_value())
-    return ErrorJson(http::status::not_found, "not_found");
-  const auto& t = r.value();
-  nlohmann::json out{{"id", t.GetId()},
-                     {"user_id", t.GetUserId()},
-                     {"title", t.GetTitle()},
-                     {"description", t.GetDescription()},
-                     {"status", t.GetStatus()}};
-  return OkJson(out.dump());
+  const auto id = Uuid::Parse(id_param);
+  if (!id)
+    return ErrorJson(http::status::bad_request, "invalid_id");
+
+  const auto build = [&]() -> BodyOrError {
+    auto r = task_service_->GetTask(*id);
+    if (!r.has_value() && (r.error() == FindTaskError::RepositoryTimeout))
+      return std::unexpected(Unavailable());
+    if (!r.has_value())
+      return std::unexpected(ErrorJson(http::status::not_found, "not_found"));
+    PooledString out;
+    AppendTaskJson(out, r.value());
+    return out;
+  };
+  if (response_cache_) {
+    const auto version = task_service_->GetTaskVersion(*id);
+    return CachedJson(*response_cache_, req, *id, version, build);
+  }
+  auto body = build();
+  if (!body.has_value())
+    return std::move(body.error());
+  return OkJson(std::move(body.value()));
 }
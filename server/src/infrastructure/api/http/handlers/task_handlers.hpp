@@ -1,9 +1,12 @@
 #pragma once
 
 #include <boost/beast/http.hpp>
+#include <cstddef>
+#include <memory>
 #include <string>
 
 #include "handler.hpp"
+#include "response_cache.hpp"
 #include "task_service.hpp"
 
 namespace http = boost::beast::http;
@@ -13,8 +16,7 @@ class CreateTaskHandler : public Handler {
   explicit CreateTaskHandler(std::shared_ptr<TaskService> task_service)
       : task_service_(std::move(task_service)) {}
   std::string GetMethodEndpoint() const override { return "POST /task"; }
-  http::response<http::string_body> Execute(
-      const http::request<http::string_body>& req) override;
+  HttpResponse Execute(const HttpRequest& req) override;
  private:
   std::shared_ptr<TaskService> task_service_;
 };
@@ -24,8 +26,35 @@ class ChangeStatusTaskHandler : public Handler {
   explicit ChangeStatusTaskHandler(std::shared_ptr<TaskService> task_service)
       : task_service_(std::move(task_service)) {}
   std::string GetMethodEndpoint() const override { return "PATCH /task/status"; }
-  http::response<http::string_body> Execute(
-      const http::request<http::string_body>& req) override;
+  HttpResponse Execute(const HttpRequest& req) override;
+ private:
+  std::shared_ptr<TaskService> task_service_;
+};
+
+// Пакетные варианты POST /task и PATCH /task/status: до kMaxBatchSize
+// элементов одной транзакцией.
+class CreateTasksBulkHandler : public Handler {
+ public:
+  static constexpr std::size_t kMaxBatchSize = 1000;
+
+  explicit CreateTasksBulkHandler(std::shared_ptr<TaskService> task_service)
+      : task_service_(std::move(task_service)) {}
+  std::string GetMethodEndpoint() const override { return "POST /task/bulk"; }
+  HttpResponse Execute(const HttpRequest& req) override;
+ private:
+  std::shared_ptr<TaskService> task_service_;
+};
+
+class ChangeStatusBulkHandler : public Handler {
+ public:
+  static constexpr std::size_t kMaxBatchSize = 1000;
+
+  explicit ChangeStatusBulkHandler(std::shared_ptr<TaskService> task_service)
+      : task_service_(std::move(task_service)) {}
+  std::string GetMethodEndpoint() const override {
+    return "PATCH /task/status/bulk";
+  }
+  HttpResponse Execute(const HttpRequest& req) override;
  private:
   std::shared_ptr<TaskService> task_service_;
 };
@@ -35,30 +64,55 @@ class DeleteTaskHandler : public Handler {
   explicit DeleteTaskHandler(std::shared_ptr<TaskService> task_service)
       : task_service_(std::move(task_service)) {}
   std::string GetMethodEndpoint() const override { return "DELETE /task/delete"; }
-  http::response<http::string_body> Execute(
-      const http::request<http::string_body>& req) override;
+  HttpResponse Execute(const HttpRequest& req) override;
+  HttpResponse Execute(
+      const HttpRequest& req, const PathParams& params) override;
  private:
   std::shared_ptr<TaskService> task_service_;
 };
 
+// Без limit/after отдаёт все задачи пользователя. С limit и after —
+// страницу и курсор next следующей страницы; stream=1 — все задачи потоком,
+// страницами по limit.
+//
+// С response_cache полный список отдаётся с ETag (304 на совпавший
+// If-None-Match), а сериализованное тело переиспользуется, пока не
+// изменится версия задач пользователя.
 class GetAllTasksHandler : public Handler {
  public:
-  explicit GetAllTasksHandler(std::shared_ptr<TaskService> task_service)
-      : task_service_(std::move(task_service)) {}
+  explicit GetAllTasksHandler(
+      std::shared_ptr<TaskService> task_service,
+      std::shared_ptr<ResponseCache> response_cache = nullptr)
+      : task_service_(std::move(task_service)),
+        response_cache_(std::move(response_cache)) {}
   std::string GetMethodEndpoint() const override { return "GET /task/getByUser"; }
-  http::response<http::string_body> Execute(
-      const http::request<http::string_body>& req) override;
+  HttpResponse Execute(const HttpRequest& req) override;
+  HttpResponse Execute(
+      const HttpRequest& req, const PathParams& params) override;
+  std::unique_ptr<ChunkSource> ExecuteStreaming(
+      const HttpRequest& req, const PathParams& params,
+      HttpResponse& response) override;
  private:
+  HttpResponse GetPage(const Uuid& user_id, const std::string& limit_param,
+                       const std::string& after_param);
+
   std::shared_ptr<TaskService> task_service_;
+  std::shared_ptr<ResponseCache> response_cache_;
 };
 
+// response_cache — как у GetAllTasksHandler, по версии задачи.
 class GetOneTaskHandler : public Handler {
  public:
-  explicit GetOneTaskHandler(std::shared_ptr<TaskService> task_service)
-      : task_service_(std::move(task_service)) {}
+  explicit GetOneTaskHandler(
+      std::shared_ptr<TaskService> task_service,
+      std::shared_ptr<ResponseCache> response_cache = nullptr)
+      : task_service_(std::move(task_service)),
+        response_cache_(std::move(response_cache)) {}
   std::string GetMethodEndpoint() const override { return "GET /task/get"; }
-  http::response<http::string_body> Execute(
-      const http::request<http::string_body>& req) override;
+  HttpResponse Execute(const HttpRequest& req) override;
+  HttpResponse Execute(
+      const HttpRequest& req, const PathParams& params) override;
  private:
   std::shared_ptr<TaskService> task_service_;
+  std::shared_ptr<ResponseCache> response_cache_;
 };
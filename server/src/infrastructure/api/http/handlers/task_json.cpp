@@ -0,0 +1,82 @@
+#include "task_json.hpp"
+
+#include <string_view>
+
+namespace {
+
+// Всё, кроме значений полей.
+constexpr std::string_view kTaskSkeleton =
+    R"({"id":"","user_id":"","title":"","description":"","status":""})";
+constexpr std::string_view kListOpen = R"({"tasks":[)";
+constexpr std::string_view kListClose = "]}";
+
+}  // namespace
+
+std::size_t TaskJsonSize(const Task& task) {
+  return kTaskSkeleton.size() + 2 * Uuid::kStringSize +
+         task.GetTitle().size() + task.GetDescription().size() +
+         ToString(task.GetStatus()).size();
+}
+
+template <class Out>
+void WriteTask(BasicJsonWriter<Out>& writer, const Task& task) {
+  writer.BeginObject();
+  writer.Key("id");
+  writer.String(task.GetId());
+  writer.Key("user_id");
+  writer.String(task.GetUserId());
+  writer.Key("title");
+  writer.String(task.GetTitle());
+  writer.Key("description");
+  writer.String(task.GetDescription());
+  writer.Key("status");
+  writer.String(ToString(task.GetStatus()));
+  writer.EndObject();
+}
+
+template <class Out>
+void AppendTaskJson(Out& out, const Task& task) {
+  out.reserve(out.size() + TaskJsonSize(task));
+  BasicJsonWriter<Out> writer(out);
+  WriteTask(writer, task);
+}
+
+template <class Out>
+void AppendTaskListJson(Out& out, const std::vector<Task>& tasks) {
+  // Запятые между задачами.
+  std::size_t size = kListOpen.size() + kListClose.size() + tasks.size();
+  for (const auto& t : tasks)
+    size += TaskJsonSize(t);
+  // Запас на экранирование, чтобы редкие кавычки и переводы строк не
+  // вызывали перевыделение всего буфера.
+  out.reserve(out.size() + size + size / 16);
+  BasicJsonWriter<Out> writer(out);
+  writer.BeginObject();
+  writer.Key("tasks");
+  writer.BeginArray();
+  for (const auto& t : tasks)
+    WriteTask(writer, t);
+  writer.EndArray();
+  writer.EndObject();
+}
+
+std::string TaskToJson(const Task& task) {
+  std::string out;
+  AppendTaskJson(out, task);
+  return out;
+}
+
+std::string TaskListToJson(const std::vector<Task>& tasks) {
+  std::string out;
+  AppendTaskListJson(out, tasks);
+  return out;
+}
+
+template void WriteTask(JsonWriter& writer, const Task& task);
+template void WriteTask(PooledJsonWriter& writer, const Task& task);
+template void AppendTaskJson(std::string& out, const Task& task);
+template void AppendTaskJson(PooledString& out, const Task& task);
+template void AppendTaskListJson(std::string& out,
+                                 const std::vector<Task>& tasks);
+template void AppendTaskListJson(PooledString& out,
+                                 const std::vector<Task>& tasks);
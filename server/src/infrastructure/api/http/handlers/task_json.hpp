@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "json_writer.hpp"
+#include "task.hpp"
+
+// JSON-представление задачи в ответах API:
+// {"id":...,"user_id":...,"title":...,"description":...,"status":...}.
+
+// Размер задачи в JSON без учёта экранирования — для reserve.
+std::size_t TaskJsonSize(const Task& task);
+
+// Шаблоны определены для std::string и PooledString.
+template <class Out>
+void WriteTask(BasicJsonWriter<Out>& writer, const Task& task);
+
+// Дописывают JSON в out, заранее зарезервировав под него место.
+template <class Out>
+void AppendTaskJson(Out& out, const Task& task);
+// {"tasks":[...]} одним reserve под весь список.
+template <class Out>
+void AppendTaskListJson(Out& out, const std::vector<Task>& tasks);
+
+std::string TaskToJson(const Task& task);
+std::string TaskListToJson(const std::vector<Task>& tasks);
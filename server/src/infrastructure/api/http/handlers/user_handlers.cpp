@@ -1,23 +1,99 @@
 #include "user_handlers.hpp"
 
+#include <functional>
 #include <nlohmann/json.hpp>
+#include <utility>
+
+#include "json_reader.hpp"
 
 using nlohmann::json;
 namespace http = boost::beast::http;
 
-http::response<http::string_body> RegisterUserHandler::Execute(
-    const http::request<http::string_body>& req) {
-  http::response<http::string_body> resp;
+namespace {
+
+HttpResponse InvalidJson() {
+  HttpResponse resp;
+  resp.result(http::status::bad_request);
+  resp.body() = R"({"error":"invalid_json"})";
+  resp.set(http::field::content_type, "application/json");
+  resp.prepare_payload();
+  return resp;
+}
+
+// Очередь хэширования паролей полна.
+HttpResponse QueueFull() {
+  HttpResponse resp;
+  resp.result(http::status::too_many_requests);
+  resp.set(http::field::retry_after, "1");
+  resp.body() = R"({"error":"too_many_requests"})";
+  resp.set(http::field::content_type, "application/json");
+  resp.prepare_payload();
+  return resp;
+}
+
+HttpResponse InternalError() {
+  HttpResponse resp;
+  resp.result(http::status::internal_server_error);
+  resp.body() = R"({"error":"internal"})";
+  resp.set(http::field::content_type, "application/json");
+  resp.prepare_payload();
+  return resp;
+}
+
+// Выполняет work на pool и отдаёт его ответ; если очередь полна — сразу 429.
+// Исключение из work тоже становится ответом: без вызова done соединение
+// ждало бы вечно.
+class PooledResponse final : public DeferredResponse {
+ public:
+  PooledResponse(std::shared_ptr<DispatchPool> pool,
+                 std::move_only_function<HttpResponse()> work)
+      : pool_(std::move(pool)), work_(std::move(work)) {}
+
+  void Start(Done done) override {
+    auto job = [work = std::move(work_),
+                done = std::move(done)](bool accepted = true) mutable {
+      if (!accepted) {
+        done(QueueFull());
+        return;
+      }
+      HttpResponse resp;
+      try {
+        resp = work();
+      } catch (const std::exception&) {
+        resp = InternalError();
+      }
+      done(std::move(resp));
+    };
+    if (!pool_->TryPost(std::move(job)))
+      job(false);
+  }
+
+ private:
+  std::shared_ptr<DispatchPool> pool_;
+  std::move_only_function<HttpResponse()> work_;
+};
+
+}  // namespace
+
+HttpResponse RegisterUserHandler::Execute(const HttpRequest& req) {
+  HttpResponse resp;
   try {
-    const auto body = json::parse(req.body());
-    const auto login = body.at("login").get<std::string>();
-    const auto password = body.at("password").get<std::string>();
+    JsonFieldReader body({"login", "password"});
+    if (!body.Parse(req.body()))
+      return InvalidJson();
+    const std::string login(body.Get("login"));
+    const std::string password(body.Get("password"));
 
     auto result = user_service_->Registration(login, password);
     if (!result.has_value() &&
         (result.error() == RegistrationError::NameAlreadyExists)) {
       resp.result(http::status::conflict);
       resp.body() = R"({"error":"registration_failed"})";
+    } else if (!result.has_value() &&
+               (result.error() == RegistrationError::ServiceUnavailable)) {
+      resp.result(http::status::service_unavailable);
+      resp.set(http::field::retry_after, "1");
+      resp.body() = R"({"error":"unavailable"})";
     } else if (!result.has_value()) {
       resp.result(http::status::internal_server_error);
       resp.body() = R"({"error":"registration_failed"})";
@@ -25,7 +101,7 @@ http::response<http::string_body> RegisterUserHandler::Execute(
       resp.result(http::status::ok);
       json j;
       j["status"] = "ok";
-      j["id"] = result->GetId();
+      j["id"] = result->GetId().ToString();
       resp.body() = j.dump();
     }
   } catch (const std::exception&) {
@@ -37,24 +113,29 @@ http::response<http::string_body> RegisterUserHandler::Execute(
   return resp;
 }
 
-http::response<http::string_body> LoginUserHandler::Execute(
-    const http::request<http::string_body>& req) {
-  http::response<http::string_body> resp;
+HttpResponse LoginUserHandler::Execute(const HttpRequest& req) {
+  HttpResponse resp;
   try {
-    const auto body = json::parse(req.body());
-    const auto login = body.at("login").get<std::string>();
-    const auto password = body.at("password").get<std::string>();
+    JsonFieldReader body({"login", "password"});
+    if (!body.Parse(req.body()))
+      return InvalidJson();
+    const std::string login(body.Get("login"));
+    const std::string password(body.Get("password"));
 
     auto result = user_service_->Login(login, password);
     if (result.has_value()) {
       resp.result(http::status::ok);
       json j;
       j["status"] = "ok";
-      j["id"] = result->GetId();
+      j["id"] = result->GetId().ToString();
       resp.body() = j.dump();
     } else if (result.error() == LoginError::UserNotFound || result.error() == LoginError::WrongPassword) {
       resp.result(http::status::unauthorized);
       resp.body() = R"({"error":"login_failed"})";
+    } else if (result.error() == LoginError::ServiceUnavailable) {
+      resp.result(http::status::service_unavailable);
+      resp.set(http::field::retry_after, "1");
+      resp.body() = R"({"error":"unavailable"})";
     } else {
       resp.result(http::status::internal_server_error);
       resp.body() = R"({"error":"login_failed"})";
@@ -67,3 +148,19 @@ http::response<http::string_body> LoginUserHandler::Execute(
   resp.prepare_payload();
   return resp;
 }
+
+std::unique_ptr<DeferredResponse> RegisterUserHandler::ExecuteDeferred(
+    const HttpRequest& req, const PathParams& /*params*/) {
+  if (!hash_pool_)
+    return nullptr;
+  return std::make_unique<PooledResponse>(
+      hash_pool_, [this, &req] { return Execute(req); });
+}
+
+std::unique_ptr<DeferredResponse> LoginUserHandler::ExecuteDeferred(
+    const HttpRequest& req, const PathParams& /*params*/) {
+  if (!hash_pool_)
+    return nullptr;
+  return std::make_unique<PooledResponse>(
+      hash_pool_, [this, &req] { return Execute(req); });
+}
@@ -4,35 +4,51 @@
 #include <memory>
 #include <string>
 
+#include "dispatch_pool.hpp"
 #include "user_service.hpp"
 #include "handler.hpp"
 
 namespace http = boost::beast::http;
 
+// С hash_pool обработчики выполняются целиком на пуле хэширования паролей
+// как отложенный ответ: KDF и обращения к хранилищу вокруг него не
+// занимают потоки io_context и обработчиков, а когда очередь пула полна,
+// клиент сразу получает 429. Медленное хранилище держит потоки пула так же,
+// как KDF; пул рассчитывается на оба (см. main.cpp). Без пула — синхронно,
+// в потоке сессии.
 class RegisterUserHandler : public Handler {
  public:
-  explicit RegisterUserHandler(std::shared_ptr<UserService> user_service)
-      : user_service_(std::move(user_service)) {}
+  explicit RegisterUserHandler(
+      std::shared_ptr<UserService> user_service,
+      std::shared_ptr<DispatchPool> hash_pool = nullptr)
+      : user_service_(std::move(user_service)),
+        hash_pool_(std::move(hash_pool)) {}
 
   std::string GetMethodEndpoint() const override { return "POST /user/register"; }
   
-  http::response<http::string_body> Execute(
-      const http::request<http::string_body>& req) override;
+  HttpResponse Execute(const HttpRequest& req) override;
+  std::unique_ptr<DeferredResponse> ExecuteDeferred(
+      const HttpRequest& req, const PathParams& params) override;
 
  private:
   std::shared_ptr<UserService> user_service_;
+  std::shared_ptr<DispatchPool> hash_pool_;
 };
 
 class LoginUserHandler : public Handler {
  public:
-  explicit LoginUserHandler(std::shared_ptr<UserService> user_service)
-      : user_service_(std::move(user_service)) {}
+  explicit LoginUserHandler(std::shared_ptr<UserService> user_service,
+                            std::shared_ptr<DispatchPool> hash_pool = nullptr)
+      : user_service_(std::move(user_service)),
+        hash_pool_(std::move(hash_pool)) {}
 
   std::string GetMethodEndpoint() const override { return "POST /user/login"; }
   
-  http::response<http::string_body> Execute(
-      const http::request<http::string_body>& req) override;
+  HttpResponse Execute(const HttpRequest& req) override;
+  std::unique_ptr<DeferredResponse> ExecuteDeferred(
+      const HttpRequest& req, const PathParams& params) override;
 
  private:
   std::shared_ptr<UserService> user_service_;
+  std::shared_ptr<DispatchPool> hash_pool_;
 };
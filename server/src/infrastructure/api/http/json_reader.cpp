@@ -0,0 +1,401 @@
+#include "json_reader.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+namespace {
+
+// Глубже пропускаемые значения не разбираются: тела запросов плоские.
+constexpr int kMaxDepth = 64;
+
+enum CharClass : std::uint8_t {
+  kPlain = 0,
+  kQuote,
+  kBackslash,
+  kControl,
+  kNonAscii,
+};
+
+constexpr std::array<std::uint8_t, 256> kStringClasses = [] {
+  std::array<std::uint8_t, 256> table{};
+  for (int c = 0; c < 0x20; ++c)
+    table[c] = kControl;
+  for (int c = 0x80; c < 0x100; ++c)
+    table[c] = kNonAscii;
+  table['"'] = kQuote;
+  table['\\'] = kBackslash;
+  return table;
+}();
+
+// Символ, который означает \X; 0 — недопустимая последовательность
+// (кроме \u, она разбирается отдельно).
+constexpr std::array<char, 256> kSimpleEscapes = [] {
+  std::array<char, 256> table{};
+  table['"'] = '"';
+  table['\\'] = '\\';
+  table['/'] = '/';
+  table['b'] = '\b';
+  table['f'] = '\f';
+  table['n'] = '\n';
+  table['r'] = '\r';
+  table['t'] = '\t';
+  return table;
+}();
+
+int HexValue(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+void AppendUtf8(std::string& out, std::uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xC0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xE0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+
+class Scanner {
+ public:
+  explicit Scanner(std::string_view in) : in_(in) {}
+
+  bool AtEnd() const { return pos_ == in_.size(); }
+  char Peek() const { return pos_ < in_.size() ? in_[pos_] : '\0'; }
+
+  bool Consume(char c) {
+    if (Peek() != c)
+      return false;
+    ++pos_;
+    return true;
+  }
+
+  void SkipWhitespace() {
+    while (pos_ < in_.size()) {
+      const char c = in_[pos_];
+      if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+        return;
+      ++pos_;
+    }
+  }
+
+  // Строка с текущей позиции. Без escape-последовательностей out указывает
+  // в тело, иначе — в decoded.
+  bool ReadString(std::string_view& out, std::string& decoded) {
+    if (!Consume('"'))
+      return false;
+    const std::size_t start = pos_;
+    while (pos_ < in_.size()) {
+      const auto c = static_cast<unsigned char>(in_[pos_]);
+      switch (kStringClasses[c]) {
+        case kPlain:
+          ++pos_;
+          break;
+        case kQuote:
+          out = in_.substr(start, pos_ - start);
+          ++pos_;
+          return true;
+        case kNonAscii:
+          if (!SkipUtf8())
+            return false;
+          break;
+        case kBackslash:
+          decoded.assign(in_.substr(start, pos_ - start));
+          if (!DecodeRest(decoded))
+            return false;
+          out = decoded;
+          return true;
+        default:
+          return false;
+      }
+    }
+    return false;
+  }
+
+  bool SkipValue(int depth) {
+    if (depth > kMaxDepth)
+      return false;
+    switch (Peek()) {
+      case '"': {
+        std::string_view unused;
+        return ReadString(unused, scratch_);
+      }
+      case '{':
+        return SkipObject(depth);
+      case '[':
+        return SkipArray(depth);
+      case 't':
+        return ConsumeLiteral("true");
+      case 'f':
+        return ConsumeLiteral("false");
+      case 'n':
+        return ConsumeLiteral("null");
+      default:
+        return SkipNumber();
+    }
+  }
+
+ private:
+  bool SkipObject(int depth) {
+    ++pos_;
+    SkipWhitespace();
+    if (Consume('}'))
+      return true;
+    do {
+      SkipWhitespace();
+      std::string_view key;
+      if (!ReadString(key, scratch_))
+        return false;
+      SkipWhitespace();
+      if (!Consume(':'))
+        return false;
+      SkipWhitespace();
+      if (!SkipValue(depth + 1))
+        return false;
+      SkipWhitespace();
+    } while (Consume(','));
+    return Consume('}');
+  }
+
+  bool SkipArray(int depth) {
+    ++pos_;
+    SkipWhitespace();
+    if (Consume(']'))
+      return true;
+    do {
+      SkipWhitespace();
+      if (!SkipValue(depth + 1))
+        return false;
+      SkipWhitespace();
+    } while (Consume(','));
+    return Consume(']');
+  }
+
+  bool ConsumeLiteral(std::string_view literal) {
+    if (in_.substr(pos_, literal.size()) != literal)
+      return false;
+    pos_ += literal.size();
+    return true;
+  }
+
+  bool SkipDigits() {
+    const std::size_t start = pos_;
+    while (Peek() >= '0' && Peek() <= '9')
+      ++pos_;
+    return pos_ > start;
+  }
+
+  // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+  bool SkipNumber() {
+    Consume('-');
+    if (!Consume('0') && !SkipDigits())
+      return false;
+    if (Consume('.') && !SkipDigits())
+      return false;
+    if (Consume('e') || Consume('E')) {
+      if (!Consume('+'))
+        Consume('-');
+      if (!SkipDigits())
+        return false;
+    }
+    return true;
+  }
+
+  // Длина корректной UTF-8 последовательности с текущей позиции или 0.
+  std::size_t Utf8Length() const {
+    const auto byte = [this](std::size_t i) -> unsigned {
+      return pos_ + i < in_.size() ? static_cast<unsigned char>(in_[pos_ + i])
+                                   : 0;
+    };
+    const auto cont = [](unsigned b) { return (b & 0xC0) == 0x80; };
+    const unsigned b0 = byte(0);
+    const unsigned b1 = byte(1);
+    if (b0 >= 0xC2 && b0 <= 0xDF)
+      return cont(b1) ? 2 : 0;
+    if (b0 >= 0xE0 && b0 <= 0xEF) {
+      // Без overlong-форм и суррогатов.
+      const bool ok = b0 == 0xE0   ? b1 >= 0xA0 && b1 <= 0xBF
+                      : b0 == 0xED ? b1 >= 0x80 && b1 <= 0x9F
+                                   : cont(b1);
+      return ok && cont(byte(2)) ? 3 : 0;
+    }
+    if (b0 >= 0xF0 && b0 <= 0xF4) {
+      const bool ok = b0 == 0xF0   ? b1 >= 0x90 && b1 <= 0xBF
+                      : b0 == 0xF4 ? b1 >= 0x80 && b1 <= 0x8F
+                                   : cont(b1);
+      return ok && cont(byte(2)) && cont(byte(3)) ? 4 : 0;
+    }
+    return 0;
+  }
+
+  bool SkipUtf8() {
+    const std::size_t length = Utf8Length();
+    pos_ += length;
+    return length > 0;
+  }
+
+  bool ReadHex4(std::uint32_t& out) {
+    if (pos_ + 4 > in_.size())
+      return false;
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+      const int digit = HexValue(in_[pos_++]);
+      if (digit < 0)
+        return false;
+      out = out * 16 + static_cast<std::uint32_t>(digit);
+    }
+    return true;
+  }
+
+  bool DecodeEscape(std::string& out) {
+    ++pos_;
+    if (pos_ >= in_.size())
+      return false;
+    const auto c = static_cast<unsigned char>(in_[pos_++]);
+    if (c != 'u') {
+      if (kSimpleEscapes[c] == 0)
+        return false;
+      out += kSimpleEscapes[c];
+      return true;
+    }
+    std::uint32_t cp = 0;
+    if (!ReadHex4(cp))
+      return false;
+    if (cp >= 0xDC00 && cp <= 0xDFFF)
+      return false;
+    if (cp >= 0xD800 && cp <= 0xDBFF) {
+      std::uint32_t low = 0;
+      if (!ConsumeLiteral("\\u") || !ReadHex4(low) || low < 0xDC00 ||
+          low > 0xDFFF)
+        return false;
+      cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+    }
+    AppendUtf8(out, cp);
+    return true;
+  }
+
+  // Остаток строки начиная с первого '\\'.
+  bool DecodeRest(std::string& out) {
+    while (pos_ < in_.size()) {
+      const auto c = static_cast<unsigned char>(in_[pos_]);
+      switch (kStringClasses[c]) {
+        case kPlain: {
+          const std::size_t start = pos_;
+          while (pos_ < in_.size() &&
+                 kStringClasses[static_cast<unsigned char>(in_[pos_])] ==
+                     kPlain)
+            ++pos_;
+          out.append(in_.substr(start, pos_ - start));
+          break;
+        }
+        case kQuote:
+          ++pos_;
+          return true;
+        case kBackslash:
+          if (!DecodeEscape(out))
+            return false;
+          break;
+        case kNonAscii: {
+          const std::size_t length = Utf8Length();
+          if (length == 0)
+            return false;
+          out.append(in_.substr(pos_, length));
+          pos_ += length;
+          break;
+        }
+        default:
+          return false;
+      }
+    }
+    return false;
+  }
+
+  std::string_view in_;
+  std::size_t pos_ = 0;
+  // Декодированные ключи и пропускаемые строки.
+  std::string scratch_;
+};
+
+}  // namespace
+
+JsonFieldReader::JsonFieldReader(
+    std::initializer_list<std::string_view> names) {
+  if (names.size() > kMaxFields)
+    throw std::invalid_argument("Too many JSON fields");
+  for (const auto name : names)
+    fields_[count_++].name = name;
+}
+
+bool JsonFieldReader::Parse(std::string_view body) {
+  for (std::size_t i = 0; i < count_; ++i) {
+    fields_[i].value = {};
+    fields_[i].found = false;
+  }
+
+  Scanner scanner(body);
+  std::string key_buffer;
+  scanner.SkipWhitespace();
+  if (!scanner.Consume('{'))
+    return false;
+  scanner.SkipWhitespace();
+  if (!scanner.Consume('}')) {
+    do {
+      scanner.SkipWhitespace();
+      std::string_view key;
+      if (!scanner.ReadString(key, key_buffer))
+        return false;
+      scanner.SkipWhitespace();
+      if (!scanner.Consume(':'))
+        return false;
+      scanner.SkipWhitespace();
+
+      Field* field = nullptr;
+      for (std::size_t i = 0; i < count_ && !field; ++i) {
+        if (fields_[i].name == key)
+          field = &fields_[i];
+      }
+      if (field) {
+        // Как и get<std::string>() у nlohmann::json: не строка — ошибка.
+        if (!scanner.ReadString(field->value, field->decoded))
+          return false;
+        field->found = true;
+      } else if (!scanner.SkipValue(1)) {
+        return false;
+      }
+      scanner.SkipWhitespace();
+    } while (scanner.Consume(','));
+    if (!scanner.Consume('}'))
+      return false;
+  }
+  scanner.SkipWhitespace();
+  if (!scanner.AtEnd())
+    return false;
+
+  for (std::size_t i = 0; i < count_; ++i) {
+    if (!fields_[i].found)
+      return false;
+  }
+  return true;
+}
+
+std::string_view JsonFieldReader::Get(std::string_view name) const {
+  for (std::size_t i = 0; i < count_; ++i) {
+    if (fields_[i].name == name)
+      return fields_[i].value;
+  }
+  return {};
+}
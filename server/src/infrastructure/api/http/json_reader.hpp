@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+// Разбор тела запроса без построения дерева: из JSON-объекта верхнего уровня
+// извлекаются только заранее названные строковые поля — как string_view в
+// само тело. Остальные поля проверяются на синтаксис и пропускаются.
+// Строки с escape-последовательностями декодируются во внутренний буфер,
+// поэтому значения действительны, пока живы и тело, и читатель.
+class JsonFieldReader {
+ public:
+  static constexpr std::size_t kMaxFields = 8;
+
+  // Не больше kMaxFields имён; строки имён должны пережить читатель.
+  JsonFieldReader(std::initializer_list<std::string_view> names);
+
+  // false, если тело — не корректный JSON-объект (включая неверный UTF-8)
+  // или одно из названных полей отсутствует либо не строка.
+  bool Parse(std::string_view body);
+
+  // Значение названного поля после успешного Parse.
+  std::string_view Get(std::string_view name) const;
+
+ private:
+  struct Field {
+    std::string_view name;
+    std::string_view value;
+    bool found = false;
+    std::string decoded;
+  };
+
+  std::array<Field, kMaxFields> fields_;
+  std::size_t count_ = 0;
+};
@@ -0,0 +1,131 @@
+#include "json_writer.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+
+namespace {
+
+// Для каждого байта: 0 — пишется как есть, 'u' — \u00XX, иначе второй
+// символ короткой escape-последовательности.
+constexpr std::array<char, 256> kEscapes = [] {
+  std::array<char, 256> table{};
+  for (int c = 0; c < 0x20; ++c)
+    table[c] = 'u';
+  table['\b'] = 'b';
+  table['\f'] = 'f';
+  table['\n'] = 'n';
+  table['\r'] = 'r';
+  table['\t'] = 't';
+  table['"'] = '"';
+  table['\\'] = '\\';
+  return table;
+}();
+
+}  // namespace
+
+template <class Out>
+void BasicJsonWriter<Out>::BeginObject() {
+  BeforeValue();
+  out_ += '{';
+  need_comma_ = false;
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::EndObject() {
+  out_ += '}';
+  need_comma_ = true;
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::BeginArray() {
+  BeforeValue();
+  out_ += '[';
+  need_comma_ = false;
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::EndArray() {
+  out_ += ']';
+  need_comma_ = true;
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::Key(std::string_view key) {
+  BeforeValue();
+  out_ += '"';
+  AppendEscaped(out_, key);
+  out_ += "\":";
+  need_comma_ = false;
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::String(std::string_view value) {
+  BeforeValue();
+  out_ += '"';
+  AppendEscaped(out_, value);
+  out_ += '"';
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::String(const Uuid& value) {
+  BeforeValue();
+  const std::size_t at = out_.size();
+  out_.resize(at + Uuid::kStringSize + 2);
+  out_[at] = '"';
+  value.Format(out_.data() + at + 1);
+  out_.back() = '"';
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::Uint(std::uint64_t value) {
+  BeforeValue();
+  char buf[20];
+  const auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+  out_.append(buf, end);
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::Bool(bool value) {
+  BeforeValue();
+  out_ += value ? "true" : "false";
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::Null() {
+  BeforeValue();
+  out_ += "null";
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::BeforeValue() {
+  if (need_comma_)
+    out_ += ',';
+  need_comma_ = true;
+}
+
+template <class Out>
+void BasicJsonWriter<Out>::AppendEscaped(Out& out, std::string_view value) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  // Участки без спецсимволов копируются целиком.
+  std::size_t run = 0;
+  for (std::size_t i = 0; i < value.size(); ++i) {
+    const auto c = static_cast<unsigned char>(value[i]);
+    const char escape = kEscapes[c];
+    if (escape == 0)
+      continue;
+    out.append(value.data() + run, i - run);
+    run = i + 1;
+    if (escape == 'u') {
+      const char seq[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xf]};
+      out.append(seq, sizeof(seq));
+    } else {
+      const char seq[] = {'\\', escape};
+      out.append(seq, sizeof(seq));
+    }
+  }
+  out.append(value.data() + run, value.size() - run);
+}
+
+template class BasicJsonWriter<std::string>;
+template class BasicJsonWriter<PooledString>;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "buffer_pool.hpp"
+#include "uuid.hpp"
+
+// Потоковая запись JSON прямо в строку-буфер, без промежуточного дерева
+// nlohmann::json. Запятые между элементами расставляются сами; правильность
+// вложенности (парность Begin/End, Key перед значением в объекте) остаётся
+// на вызывающем. Байты строк не проверяются на корректность UTF-8.
+// Out — std::string или PooledString: ответ пишется прямо в тело
+// HttpResponse, без промежуточной строки.
+template <class Out>
+class BasicJsonWriter {
+ public:
+  explicit BasicJsonWriter(Out& out) : out_(out) {}
+
+  void BeginObject();
+  void EndObject();
+  void BeginArray();
+  void EndArray();
+
+  void Key(std::string_view key);
+  void String(std::string_view value);
+  // Uuid в канонической записи, без промежуточной std::string.
+  void String(const Uuid& value);
+  void Uint(std::uint64_t value);
+  void Bool(bool value);
+  void Null();
+
+  // Экранирует value по правилам JSON и дописывает в out (без кавычек).
+  static void AppendEscaped(Out& out, std::string_view value);
+
+ private:
+  void BeforeValue();
+
+  Out& out_;
+  // Перед следующим ключом или значением нужна запятая.
+  bool need_comma_ = false;
+};
+
+extern template class BasicJsonWriter<std::string>;
+extern template class BasicJsonWriter<PooledString>;
+
+using JsonWriter = BasicJsonWriter<std::string>;
+using PooledJsonWriter = BasicJsonWriter<PooledString>;
@@ -0,0 +1,67 @@
+#include "response_cache.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Есть ли в списке If-None-Match элемент, для которого matches — true.
+template <class Matches>
+bool AnyIfNoneMatchItem(std::string_view header, Matches&& matches) {
+  while (!header.empty()) {
+    const auto comma = header.find(',');
+    auto item = header.substr(0, comma);
+    header = comma == std::string_view::npos ? std::string_view{}
+                                             : header.substr(comma + 1);
+    while (!item.empty() && item.front() == ' ')
+      item.remove_prefix(1);
+    while (!item.empty() && item.back() == ' ')
+      item.remove_suffix(1);
+    if (matches(item))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+ResponseCache::ResponseCache(std::size_t capacity_bytes, std::size_t shards)
+    : cache_(capacity_bytes, shards) {}
+
+ResponseCache::Body ResponseCache::Get(const Uuid& key,
+                                       std::uint64_t version) {
+  auto entry = cache_.Get(key);
+  if (!entry || entry->version != version)
+    return nullptr;
+  return std::move(entry->body);
+}
+
+void ResponseCache::Put(const Uuid& key, std::uint64_t version, Body body) {
+  const std::size_t weight = std::max<std::size_t>(body->size(), 1);
+  cache_.Put(key, Entry{version, std::move(body)}, weight);
+}
+
+CacheStats ResponseCache::GetStats() const { return cache_.GetStats(); }
+
+std::string ResponseCache::MakeETag(std::uint64_t version) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  std::string etag(18, '"');
+  for (int i = 0; i < 16; ++i)
+    etag[16 - i] = kHex[(version >> (i * 4)) & 0xf];
+  return etag;
+}
+
+bool ResponseCache::MatchesIfNoneMatch(std::string_view header,
+                                       std::string_view etag) {
+  return AnyIfNoneMatchItem(header, [etag](std::string_view item) {
+    // If-None-Match сравнивается слабо: префикс W/ не важен.
+    if (item.starts_with("W/"))
+      item.remove_prefix(2);
+    return item == etag;
+  });
+}
+
+bool ResponseCache::IfNoneMatchAny(std::string_view header) {
+  return AnyIfNoneMatchItem(
+      header, [](std::string_view item) { return item == "*"; });
+}
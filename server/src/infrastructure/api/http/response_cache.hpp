@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "lru_cache.hpp"
+#include "uuid.hpp"
+
+// Уже сериализованные тела ответов, привязанные к версии данных (см.
+// TaskService::GetUserTasksVersion): запись с другой версией считается
+// промахом. Ёмкость — в байтах тел.
+class ResponseCache {
+ public:
+  using Body = std::shared_ptr<const std::string>;
+
+  explicit ResponseCache(std::size_t capacity_bytes, std::size_t shards = 16);
+
+  Body Get(const Uuid& key, std::uint64_t version);
+  void Put(const Uuid& key, std::uint64_t version, Body body);
+  CacheStats GetStats() const;
+
+  // Сильный ETag для версии, в кавычках.
+  static std::string MakeETag(std::uint64_t version);
+  // Совпадает ли ETag с одним из перечисленных в If-None-Match.
+  static bool MatchesIfNoneMatch(std::string_view header,
+                                 std::string_view etag);
+  // If-None-Match: * — совпадает с любым представлением, но только если оно
+  // существует (RFC 9110, 13.1.2), поэтому проверяется отдельно.
+  static bool IfNoneMatchAny(std::string_view header);
+
+ private:
+  struct Entry {
+    std::uint64_t version;
+    Body body;
+  };
+
+  ShardedLruCache<Uuid, Entry> cache_;
+};
@@ -1,14 +1,170 @@
 #include "router.hpp"
 
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
 #include <boost/log/trivial.hpp>
 
 #include "handlers/handler.hpp"
 
+struct SimpleRouter::Node {
+  // Статические сегменты; их немного, линейный поиск быстрее хеширования.
+  std::vector<std::pair<std::string, std::unique_ptr<Node>>> children;
+  // Сегмент-параметр {name}.
+  std::string param_name;
+  std::unique_ptr<Node> param_child;
+
+  std::shared_ptr<Handler> handler;
+  RouteMetrics metrics;
+};
+
+// Время маршрута и класс ответа отложенного ответа учитываются, когда он
+// готов.
+class SimpleRouter::ObservedResponse final : public DeferredResponse {
+ public:
+  ObservedResponse(std::unique_ptr<DeferredResponse> response,
+                   const RouteMetrics& metrics,
+                   std::chrono::steady_clock::time_point start)
+      : response_(std::move(response)), metrics_(metrics), start_(start) {}
+
+  void Start(Done done) override {
+    response_->Start([metrics = metrics_, start = start_,
+                      done = std::move(done)](HttpResponse response) mutable {
+      Observe(metrics, start, response);
+      done(std::move(response));
+    });
+  }
+
+ private:
+  std::unique_ptr<DeferredResponse> response_;
+  RouteMetrics metrics_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+namespace {
+
+HttpResponse JsonError(http::status status, const char* body) {
+  HttpResponse response;
+  response.result(status);
+  response.set(http::field::content_type, "application/json");
+  response.body() = body;
+  response.prepare_payload();
+  return response;
+}
+
+// Отделяет первый сегмент пути: "/task/get" -> "task", остаток "/get".
+std::string_view NextSegment(std::string_view& path) {
+  path.remove_prefix(1);
+  const auto slash = path.find('/');
+  const auto segment = path.substr(0, slash);
+  path = slash == std::string_view::npos ? std::string_view{}
+                                         : path.substr(slash);
+  return segment;
+}
+
+constexpr std::string_view kRequestDuration =
+    "taskmanager_http_request_duration_seconds";
+constexpr std::string_view kRequestDurationHelp =
+    "Time to handle a request, up to the response headers for streamed "
+    "bodies.";
+constexpr std::string_view kResponses = "taskmanager_http_responses_total";
+constexpr std::string_view kResponsesHelp = "Responses by status class.";
+
+}  // namespace
+
+SimpleRouter::SimpleRouter(std::shared_ptr<MetricsRegistry> metrics)
+    : metrics_(std::move(metrics)),
+      unmatched_metrics_(MakeRouteMetrics("unmatched")) {}
+
+SimpleRouter::~SimpleRouter() = default;
+
+SimpleRouter::RouteMetrics SimpleRouter::MakeRouteMetrics(
+    std::string_view route) const {
+  RouteMetrics metrics;
+  if (!metrics_)
+    return metrics;
+  metrics.latency = &metrics_->GetHistogram(
+      kRequestDuration, kRequestDurationHelp, {{"route", std::string(route)}});
+  for (std::size_t i = 0; i < metrics.responses.size(); ++i) {
+    metrics.responses[i] = &metrics_->GetCounter(
+        kResponses, kResponsesHelp,
+        {{"route", std::string(route)},
+         {"code", std::to_string(i + 1) + "xx"}});
+  }
+  return metrics;
+}
+
+void SimpleRouter::Observe(const RouteMetrics& metrics,
+                           std::chrono::steady_clock::time_point start,
+                           const HttpResponse& response) {
+  if (!metrics.latency)
+    return;
+  metrics.latency->Record(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start));
+  const unsigned status_class = response.result_int() / 100;
+  if (status_class >= 1 && status_class <= metrics.responses.size())
+    metrics.responses[status_class - 1]->Add();
+}
+
 void SimpleRouter::Add(std::shared_ptr<Handler> handler) {
   const std::string endpoint = handler->GetMethodEndpoint();
-  const bool existed =
-      endpoint_to_handler_.find(endpoint) != endpoint_to_handler_.end();
-  endpoint_to_handler_[endpoint] = std::move(handler);
+  Add(endpoint, std::move(handler));
+}
+
+void SimpleRouter::Add(std::string_view endpoint,
+                       std::shared_ptr<Handler> handler) {
+  const auto space = endpoint.find(' ');
+  const auto method = endpoint.substr(0, space);
+  const http::verb verb =
+      http::string_to_verb({method.data(), method.size()});
+  std::string_view path = space == std::string_view::npos
+                              ? std::string_view{}
+                              : endpoint.substr(space + 1);
+  if (verb == http::verb::unknown || !path.starts_with('/')) {
+    throw std::invalid_argument("Invalid endpoint: " + std::string(endpoint));
+  }
+
+  auto& root = roots_[static_cast<std::size_t>(verb)];
+  if (!root) {
+    root = std::make_unique<Node>();
+  }
+  Node* node = root.get();
+  while (!path.empty() && path != "/") {
+    const auto segment = NextSegment(path);
+    if (segment.size() > 2 && segment.front() == '{' &&
+        segment.back() == '}') {
+      const auto name = segment.substr(1, segment.size() - 2);
+      if (!node->param_child) {
+        node->param_child = std::make_unique<Node>();
+        node->param_name = name;
+      } else if (node->param_name != name) {
+        throw std::invalid_argument("Conflicting path parameter in " +
+                                    std::string(endpoint));
+      }
+      node = node->param_child.get();
+      continue;
+    }
+    Node* next = nullptr;
+    for (auto& [key, child] : node->children) {
+      if (key == segment) {
+        next = child.get();
+        break;
+      }
+    }
+    if (next == nullptr) {
+      next = node->children
+                 .emplace_back(std::string(segment), std::make_unique<Node>())
+                 .second.get();
+    }
+    node = next;
+  }
+
+  const bool existed = node->handler != nullptr;
+  node->handler = std::move(handler);
+  if (!existed)
+    node->metrics = MakeRouteMetrics(endpoint);
   if (existed) {
     BOOST_LOG_TRIVIAL(warning) << "Handler replaced: " << endpoint;
   } else {
@@ -16,30 +172,105 @@ void SimpleRouter::Add(std::shared_ptr<Handler> handler) {
   }
 }
 
-http::response<http::string_body> SimpleRouter::Dispatch(
-    const http::request<http::string_body>& req) const {
-  const std::string key =
-      std::string(http::to_string(req.method())) + " " +
-      std::string(req.target().substr(0, req.target().find('?')));
+const SimpleRouter::Node* SimpleRouter::Match(const Node& node,
+                                              std::string_view path,
+                                              PathParams& params) {
+  if (path.empty() || path == "/") {
+    return node.handler ? &node : nullptr;
+  }
+  std::string_view rest = path;
+  const auto segment = NextSegment(rest);
 
-  auto it = endpoint_to_handler_.find(key);
-  if (it == endpoint_to_handler_.end()) {
-    http::response<http::string_body> response;
-    response.result(http::status::not_found);
-    response.set(http::field::content_type, "application/json");
-    response.body() = R"({"error":"not_found"})";
-    response.prepare_payload();
-    return response;
+  // Статический сегмент важнее параметра: /task/get не попадает в
+  // /task/{id}.
+  for (const auto& [key, child] : node.children) {
+    if (key == segment) {
+      if (const Node* found = Match(*child, rest, params)) {
+        return found;
+      }
+      break;
+    }
+  }
+  if (node.param_child && !segment.empty() &&
+      params.Add(node.param_name, segment)) {
+    if (const Node* found = Match(*node.param_child, rest, params)) {
+      return found;
+    }
+    params.PopBack();
+  }
+  return nullptr;
+}
+
+HttpResponse SimpleRouter::Dispatch(const HttpRequest& req) const {
+  HttpResponse response;
+  std::unique_ptr<DeferredResponse> deferred;
+  auto stream = Dispatch(req, response, deferred);
+  if (deferred) {
+    std::promise<HttpResponse> ready;
+    auto result = ready.get_future();
+    deferred->Start([ready = std::move(ready)](HttpResponse r) mutable {
+      ready.set_value(std::move(r));
+    });
+    try {
+      return result.get();
+    } catch (const std::future_error& ex) {
+      // Пул отбросил задачу, не вызвав done.
+      BOOST_LOG_TRIVIAL(error) << ex.what();
+      return JsonError(http::status::internal_server_error,
+                       R"({"error":"internal"})");
+    }
+  }
+  if (stream) {
+    try {
+      while (auto chunk = stream->Next()) {
+        response.body() += *chunk;
+      }
+      response.prepare_payload();
+    } catch (const std::exception& ex) {
+      BOOST_LOG_TRIVIAL(error) << ex.what();
+      return JsonError(http::status::internal_server_error,
+                       R"({"error":"internal"})");
+    }
+  }
+  return response;
+}
+
+std::unique_ptr<ChunkSource> SimpleRouter::Dispatch(
+    const HttpRequest& req, HttpResponse& response,
+    std::unique_ptr<DeferredResponse>& deferred) const {
+  const auto start = metrics_ ? std::chrono::steady_clock::now()
+                              : std::chrono::steady_clock::time_point{};
+  const auto verb_index = static_cast<std::size_t>(req.method());
+  const std::string_view target{req.target().data(), req.target().size()};
+  const std::string_view path = target.substr(0, target.find('?'));
+
+  PathParams params;
+  const Node* node = nullptr;
+  if (verb_index < roots_.size() && roots_[verb_index] &&
+      path.starts_with('/')) {
+    node = Match(*roots_[verb_index], path, params);
+  }
+  if (node == nullptr) {
+    response = JsonError(http::status::not_found, R"({"error":"not_found"})");
+    Observe(unmatched_metrics_, start, response);
+    return nullptr;
   }
+  std::unique_ptr<ChunkSource> stream;
   try {
-    return it->second->Execute(req);
+    deferred = node->handler->ExecuteDeferred(req, params);
+    if (deferred) {
+      if (node->metrics.latency) {
+        deferred = std::make_unique<ObservedResponse>(std::move(deferred),
+                                                      node->metrics, start);
+      }
+      return nullptr;
+    }
+    stream = node->handler->ExecuteStreaming(req, params, response);
   } catch (const std::exception& ex) {
     BOOST_LOG_TRIVIAL(error) << ex.what();
-    http::response<http::string_body> response;
-    response.result(http::status::internal_server_error);
-    response.set(http::field::content_type, "application/json");
-    response.body() = R"({"error":"internal"})";
-    response.prepare_payload();
-    return response;
+    response = JsonError(http::status::internal_server_error,
+                         R"({"error":"internal"})");
   }
+  Observe(node->metrics, start, response);
+  return stream;
 }
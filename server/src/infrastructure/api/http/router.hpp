@@ -1,31 +1,79 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <memory>
 #include <string>
-#include <unordered_map>
+#include <string_view>
+#include <vector>
 
 #include <boost/beast/http.hpp>
 
 #include "handlers/handler.hpp"
+#include "metrics_registry.hpp"
 
 class Router {
  public:
   virtual ~Router() = default;
 
   virtual void Add(std::shared_ptr<Handler> handler) = 0;
+  // Регистрирует обработчик на произвольный маршрут "METHOD /path/{param}".
+  virtual void Add(std::string_view endpoint,
+                   std::shared_ptr<Handler> handler) = 0;
 
-  virtual http::response<http::string_body> Dispatch(
-      const http::request<http::string_body>& req) const = 0;
+  virtual HttpResponse Dispatch(const HttpRequest& req) const = 0;
+  // См. Handler::ExecuteStreaming и Handler::ExecuteDeferred: отложенный
+  // ответ возвращается в deferred, и тогда response не заполняется.
+  virtual std::unique_ptr<ChunkSource> Dispatch(
+      const HttpRequest& req, HttpResponse& response,
+      std::unique_ptr<DeferredResponse>& deferred) const = 0;
 };
 
+// Маршруты хранятся в префиксном дереве по сегментам пути, отдельном для
+// каждого HTTP-метода. Dispatch ничего не аллоцирует: сегменты и параметры
+// пути — string_view в target запроса.
+//
+// С реестром метрик для каждого маршрута (шаблона вроде GET /task/{id})
+// ведутся гистограмма времени обработки и счётчики ответов по классам
+// статусов; запросы без маршрута учитываются как route="unmatched".
 class SimpleRouter final : public Router {
  public:
+  explicit SimpleRouter(std::shared_ptr<MetricsRegistry> metrics = nullptr);
+  ~SimpleRouter() override;
+
   void Add(std::shared_ptr<Handler> handler) override;
+  void Add(std::string_view endpoint,
+           std::shared_ptr<Handler> handler) override;
+
+  // Потоковое тело, если оно есть, собирается в строку; отложенного ответа
+  // вызывающий поток ждёт.
+  HttpResponse Dispatch(const HttpRequest& req) const override;
+  std::unique_ptr<ChunkSource> Dispatch(
+      const HttpRequest& req, HttpResponse& response,
+      std::unique_ptr<DeferredResponse>& deferred) const override;
 
-  http::response<http::string_body> Dispatch(
-      const http::request<http::string_body>& req) const override;
-  
  private:
-  std::unordered_map<std::string, std::shared_ptr<Handler>>
-      endpoint_to_handler_;
+  struct Node;
+  class ObservedResponse;
+
+  struct RouteMetrics {
+    LatencyHistogram* latency = nullptr;
+    // 1xx..5xx.
+    std::array<Counter*, 5> responses{};
+  };
+
+  static const Node* Match(const Node& node, std::string_view path,
+                           PathParams& params);
+  RouteMetrics MakeRouteMetrics(std::string_view route) const;
+  static void Observe(const RouteMetrics& metrics,
+                      std::chrono::steady_clock::time_point start,
+                      const HttpResponse& response);
+
+  std::shared_ptr<MetricsRegistry> metrics_;
+  RouteMetrics unmatched_metrics_;
+
+  // Индекс — значение http::verb.
+  std::array<std::unique_ptr<Node>,
+             static_cast<std::size_t>(http::verb::unlink) + 1>
+      roots_;
 };
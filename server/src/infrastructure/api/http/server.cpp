@@ -1,5 +1,7 @@
 #include "server.hpp"
 
+#include <algorithm>
+#include <stdexcept>
 #include <thread>
 
 #include <boost/asio.hpp>
@@ -7,12 +9,44 @@
 #include <boost/asio/ip/address.hpp>
 #include <boost/log/trivial.hpp>
 
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+#ifdef SO_REUSEPORT
+using ReusePort =
+    net::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+#endif
+
+void PinCurrentThread(std::size_t cpu) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+    BOOST_LOG_TRIVIAL(warning) << "Failed to pin thread to CPU " << cpu;
+  }
+#else
+  (void)cpu;
+#endif
+}
+
+}  // namespace
+
 HttpServer::HttpServer(std::string host, std::uint16_t port,
-                       std::shared_ptr<Router> router, std::size_t thread_count)
+                       std::shared_ptr<Router> router, std::size_t thread_count,
+                       std::shared_ptr<DispatchPool> dispatch_pool,
+                       SessionOptions session_options, IoModel io_model)
     : host_(std::move(host)),
       port_(port),
+      io_model_(io_model),
       acceptor_(io_context_),
-      router_(std::move(router)) {
+      router_(std::move(router)),
+      dispatch_pool_(std::move(dispatch_pool)),
+      session_options_(session_options) {
   if (thread_count == 0) {
     const auto hw = std::thread::hardware_concurrency();
     thread_count_ = hw == 0 ? 1 : static_cast<std::size_t>(hw);
@@ -23,158 +57,144 @@ HttpServer::HttpServer(std::string host, std::uint16_t port,
 
 HttpServer::~HttpServer() {
   Stop();
+  JoinWorkers();
 }
 
 void HttpServer::Run() {
-  work_guard_.emplace(net::make_work_guard(io_context_));
-
-  workers_.reserve(thread_count_);
-  for (std::size_t i = 0; i < thread_count_; ++i) {
-    workers_.emplace_back([this, i] {
-      try {
-        io_context_.run();
-      } catch (const std::exception& e) {
-        BOOST_LOG_TRIVIAL(error)
-            << "io_context run exception: " << e.what() << "in thread " << i;
-      }
-    });
-  }
-
   beast::error_code ec;
   ip::tcp::endpoint endpoint(ip::make_address(host_, ec), port_);
   if (ec) {
     throw std::runtime_error("Invalid host address: " + host_ +
                              ", error: " + ec.message());
   }
-  ec = acceptor_.open(endpoint.protocol(), ec);
-  if (ec)
-    throw std::runtime_error(ec.message());
-  acceptor_.set_option(ip::tcp::acceptor::reuse_address(true));
-  ec = acceptor_.bind(endpoint, ec);
-  if (ec)
-    throw std::runtime_error(ec.message());
-  ec = acceptor_.listen(net::socket_base::max_listen_connections, ec);
-  if (ec)
-    throw std::runtime_error(ec.message());
 
-  for (int i = 0; i < thread_count_; ++i) {
-    StartAcceptLoop();
+  if (io_model_ == IoModel::ReusePortShards) {
+    RunSharded(endpoint);
+  } else {
+    RunShared(endpoint);
   }
 
-  for (auto& t : workers_)
-    t.join();
+  JoinWorkers();
+  if (dispatch_pool_)
+    dispatch_pool_->Shutdown();
 }
 
 void HttpServer::Stop() {
-  beast::error_code ec;
-  acceptor_.cancel(ec);
-  acceptor_.close(ec);
   if (work_guard_)
     work_guard_->reset();
   io_context_.stop();
-  for (auto& t : workers_) {
-    if (t.joinable())
-      t.join();
+  for (auto& shard : shards_) {
+    shard->io_context.stop();
   }
-  workers_.clear();
 }
 
-void HttpServer::StartAcceptLoop() {
-  auto socket = std::make_shared<ip::tcp::socket>(io_context_);
-  acceptor_.async_accept(*socket,
-                         [this, socket](const boost::system::error_code& ec) {
-                           OnAccept(ec, socket);
-                         });
-}
-
-void HttpServer::DoAccept(std::shared_ptr<ip::tcp::socket> socket) {
-  auto buffer = std::make_shared<beast::flat_buffer>();
-  auto request = std::make_shared<http::request<http::string_body>>();
-  http::async_read(
-      *socket, *buffer, *request,
-      [this, socket, buffer, request](beast::error_code ec, std::size_t bytes) {
-        OnRead(ec, bytes, socket, buffer, request);
-      });
-}
+void HttpServer::RunShared(const ip::tcp::endpoint& endpoint) {
+  work_guard_.emplace(net::make_work_guard(io_context_));
 
-void HttpServer::DoRead(
-    std::shared_ptr<ip::tcp::socket> socket,
-    std::shared_ptr<beast::flat_buffer> /*buffer*/,
-    std::shared_ptr<http::request<http::string_body>> request) {
-  auto response = router_->Dispatch(*request);
+  workers_.reserve(thread_count_);
+  for (std::size_t i = 0; i < thread_count_; ++i) {
+    workers_.emplace_back([this, i] {
+      try {
+        io_context_.run();
+      } catch (const std::exception& e) {
+        BOOST_LOG_TRIVIAL(error)
+            << "io_context run exception: " << e.what() << "in thread " << i;
+      }
+    });
+  }
 
-  BOOST_LOG_TRIVIAL(info) << "Request received: " << request->method_string()
-                          << " " << request->target()
-                          << " | Thread ID: " << std::this_thread::get_id();
+  Listen(acceptor_, endpoint, false);
 
-  DoWrite(
-      socket,
-      std::make_shared<http::response<http::string_body>>(std::move(response)),
-      request->keep_alive());
+  for (std::size_t i = 0; i < thread_count_; ++i) {
+    net::co_spawn(io_context_, AcceptLoop(acceptor_, io_context_, true),
+                  net::detached);
+  }
 }
 
-void HttpServer::DoWrite(
-    std::shared_ptr<ip::tcp::socket> socket,
-    std::shared_ptr<http::response<http::string_body>> response,
-    bool keep_alive) {
-  http::async_write(*socket, *response,
-                    [this, socket, response, keep_alive](beast::error_code ec,
-                                                         std::size_t bytes) {
-                      OnWrite(ec, bytes, socket, response, keep_alive);
-                    });
-}
+void HttpServer::RunSharded(const ip::tcp::endpoint& endpoint) {
+  const auto cpus = std::max(1u, std::thread::hardware_concurrency());
 
-void HttpServer::OnAccept(const boost::system::error_code& ec,
-                          std::shared_ptr<ip::tcp::socket> socket) {
-  if (ec) {
-    BOOST_LOG_TRIVIAL(error) << ec.message();
-    return;
+  // Все acceptor-ы открываются до старта потоков, чтобы ошибка bind
+  // выбрасывалась из Run, а не терялась в рабочем потоке.
+  shards_.reserve(thread_count_);
+  for (std::size_t i = 0; i < thread_count_; ++i) {
+    auto& shard = *shards_.emplace_back(std::make_unique<Shard>());
+    Listen(shard.acceptor, endpoint, true);
+    net::co_spawn(shard.io_context,
+                  AcceptLoop(shard.acceptor, shard.io_context, false),
+                  net::detached);
   }
-  DoAccept(std::move(socket));
 
-  auto new_socket = std::make_shared<ip::tcp::socket>(io_context_);
-  acceptor_.async_accept(
-      *new_socket, [this, new_socket](const boost::system::error_code& ec) {
-        OnAccept(ec, new_socket);
-      });
+  workers_.reserve(thread_count_);
+  for (std::size_t i = 0; i < thread_count_; ++i) {
+    workers_.emplace_back([this, i, cpus] {
+      PinCurrentThread(i % cpus);
+      try {
+        shards_[i]->io_context.run();
+      } catch (const std::exception& e) {
+        BOOST_LOG_TRIVIAL(error)
+            << "io_context run exception: " << e.what() << "in shard " << i;
+      }
+    });
+  }
+  BOOST_LOG_TRIVIAL(info) << "Started " << thread_count_
+                          << " SO_REUSEPORT shards";
 }
 
-void HttpServer::OnRead(
-    beast::error_code ec, std::size_t /*bytes_transferred*/,
-    std::shared_ptr<ip::tcp::socket> socket,
-    std::shared_ptr<beast::flat_buffer> buffer,
-    std::shared_ptr<http::request<http::string_body>> request) {
-  if (ec) {
-    if (ec == http::error::end_of_stream) {
-      socket->shutdown(ip::tcp::socket::shutdown_both);
-      return;
-    }
-    BOOST_LOG_TRIVIAL(error) << ec.message();
-    return;
+void HttpServer::Listen(ip::tcp::acceptor& acceptor,
+                        const ip::tcp::endpoint& endpoint, bool reuse_port) {
+  beast::error_code ec;
+  ec = acceptor.open(endpoint.protocol(), ec);
+  if (ec)
+    throw std::runtime_error(ec.message());
+  acceptor.set_option(ip::tcp::acceptor::reuse_address(true));
+  if (reuse_port) {
+#ifdef SO_REUSEPORT
+    acceptor.set_option(ReusePort(true));
+#else
+    throw std::runtime_error("SO_REUSEPORT is not supported on this platform");
+#endif
   }
-
-  DoRead(std::move(socket), std::move(buffer), std::move(request));
+  ec = acceptor.bind(endpoint, ec);
+  if (ec)
+    throw std::runtime_error(ec.message());
+  ec = acceptor.listen(net::socket_base::max_listen_connections, ec);
+  if (ec)
+    throw std::runtime_error(ec.message());
 }
 
-void HttpServer::OnWrite(
-    beast::error_code ec, std::size_t /*bytes_transferred*/,
-    std::shared_ptr<ip::tcp::socket> socket,
-    std::shared_ptr<http::response<http::string_body>> /*response*/,
-    bool keep_alive) {
-  if (ec) {
-    BOOST_LOG_TRIVIAL(error) << ec.message();
-    return;
+net::awaitable<void> HttpServer::AcceptLoop(ip::tcp::acceptor& acceptor,
+                                            net::io_context& io_context,
+                                            bool strand_per_connection) {
+  for (;;) {
+    beast::error_code ec;
+    // В общем io_context каждое соединение получает свой strand; у шарда
+    // один поток, и strand не нужен.
+    ip::tcp::socket socket(io_context);
+    if (strand_per_connection) {
+      socket = co_await acceptor.async_accept(
+          net::make_strand(io_context),
+          net::redirect_error(net::use_awaitable, ec));
+    } else {
+      co_await acceptor.async_accept(
+          socket, net::redirect_error(net::use_awaitable, ec));
+    }
+    if (ec == net::error::operation_aborted) {
+      co_return;
+    }
+    if (ec) {
+      BOOST_LOG_TRIVIAL(error) << ec.message();
+      continue;
+    }
+    HttpSession::Start(std::make_shared<HttpSession>(
+        std::move(socket), router_, dispatch_pool_, session_options_));
   }
+}
 
-  if (keep_alive) {
-    auto buffer = std::make_shared<beast::flat_buffer>();
-    auto request = std::make_shared<http::request<http::string_body>>();
-    http::async_read(*socket, *buffer, *request,
-                     [this, socket, buffer, request](beast::error_code ec2,
-                                                     std::size_t bytes2) {
-                       OnRead(ec2, bytes2, socket, buffer, request);
-                     });
-  } else {
-    socket->shutdown(ip::tcp::socket::shutdown_both);
+void HttpServer::JoinWorkers() {
+  for (auto& t : workers_) {
+    if (t.joinable())
+      t.join();
   }
+  workers_.clear();
 }
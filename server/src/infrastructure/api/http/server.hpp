@@ -5,61 +5,73 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 
+#include "dispatch_pool.hpp"
 #include "router.hpp"
+#include "session.hpp"
 
 namespace net = boost::asio;
 namespace beast = boost::beast;
 namespace http = beast::http;
 namespace ip = net::ip;
 
+enum class IoModel {
+  // Один io_context и один acceptor на все потоки.
+  SharedContext,
+  // По io_context, acceptor-у с SO_REUSEPORT и закреплённому потоку на
+  // каждое ядро: соединения между ними распределяет ядро ОС.
+  ReusePortShards,
+};
+
 class HttpServer {
  public:
+  // Если dispatch_pool задан, обработчики выполняются на нём, а ответ
+  // возвращается в strand сокета; иначе — прямо в потоке io_context.
   HttpServer(std::string host, std::uint16_t port,
-             std::shared_ptr<Router> router, std::size_t thread_count = 0);
+             std::shared_ptr<Router> router, std::size_t thread_count = 0,
+             std::shared_ptr<DispatchPool> dispatch_pool = nullptr,
+             SessionOptions session_options = {},
+             IoModel io_model = IoModel::SharedContext);
 
   ~HttpServer();
 
+  // Блокирует вызывающий поток до Stop().
   void Run();
+  // Можно вызывать из другого потока: только останавливает io_context-ы.
   void Stop();
 
  private:
-  void StartAcceptLoop();
-  void DoAccept(std::shared_ptr<ip::tcp::socket> socket);
-
-  void DoRead(std::shared_ptr<ip::tcp::socket> socket,
-              std::shared_ptr<beast::flat_buffer> buffer,
-              std::shared_ptr<http::request<http::string_body>> request);
-
-  void DoWrite(std::shared_ptr<ip::tcp::socket> socket,
-               std::shared_ptr<http::response<http::string_body>> response,
-               bool keep_alive);
-
-  // On* методы — колбэки завершения async-операций
-  void OnAccept(const boost::system::error_code& ec,
-                std::shared_ptr<ip::tcp::socket> socket);
-
-  void OnRead(beast::error_code ec, std::size_t /*bytes_transferred*/,
-              std::shared_ptr<ip::tcp::socket> socket,
-              std::shared_ptr<beast::flat_buffer> buffer,
-              std::shared_ptr<http::request<http::string_body>> request);
-
-  void OnWrite(beast::error_code ec, std::size_t /*bytes_transferred*/,
-               std::shared_ptr<ip::tcp::socket> socket,
-               std::shared_ptr<http::response<http::string_body>> response,
-               bool keep_alive);
+  struct Shard {
+    Shard() : io_context(1), acceptor(io_context) {}
+
+    net::io_context io_context;
+    ip::tcp::acceptor acceptor;
+  };
+
+  void RunShared(const ip::tcp::endpoint& endpoint);
+  void RunSharded(const ip::tcp::endpoint& endpoint);
+  void Listen(ip::tcp::acceptor& acceptor, const ip::tcp::endpoint& endpoint,
+              bool reuse_port);
+  net::awaitable<void> AcceptLoop(ip::tcp::acceptor& acceptor,
+                                  net::io_context& io_context,
+                                  bool strand_per_connection);
+  void JoinWorkers();
 
   std::string host_;
   std::uint16_t port_;
+  IoModel io_model_;
 
   net::io_context io_context_;
   ip::tcp::acceptor acceptor_;
+  std::vector<std::unique_ptr<Shard>> shards_;
   std::size_t thread_count_;
-  std::unique_ptr<net::thread_pool> thread_pool_;
   std::vector<std::thread> workers_;
   std::optional<net::executor_work_guard<net::io_context::executor_type>>
       work_guard_;
 
   std::shared_ptr<Router> router_;
+  std::shared_ptr<DispatchPool> dispatch_pool_;
+  SessionOptions session_options_;
 };
@@ -0,0 +1,357 @@
+#include "session.hpp"
+
+#include <exception>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include <boost/log/trivial.hpp>
+
+namespace {
+
+using Response = HttpResponse;
+using RequestParser =
+    http::request_parser<PooledStringBody, PoolAllocator<char>>;
+using ResponseSerializer =
+    http::response_serializer<PooledStringBody, HttpFields>;
+
+Response ErrorResponse(http::status status, const char* body) {
+  Response response;
+  response.result(status);
+  response.set(http::field::content_type, "application/json");
+  response.body() = body;
+  response.prepare_payload();
+  return response;
+}
+
+Response ServiceUnavailable() {
+  auto response = ErrorResponse(http::status::service_unavailable,
+                                R"({"error":"overloaded"})");
+  response.set(http::field::retry_after, "1");
+  return response;
+}
+
+}  // namespace
+
+HttpSession::HttpSession(ip::tcp::socket socket,
+                         std::shared_ptr<Router> router,
+                         std::shared_ptr<DispatchPool> dispatch_pool,
+                         const SessionOptions& options)
+    : stream_(std::move(socket)),
+      router_(std::move(router)),
+      dispatch_pool_(std::move(dispatch_pool)),
+      options_(options) {
+  // Ответы пишутся целиком, Nagle только задерживает их до ACK клиента.
+  beast::error_code ec;
+  stream_.socket().set_option(ip::tcp::no_delay(true), ec);
+}
+
+void HttpSession::Start(std::shared_ptr<HttpSession> session) {
+  auto executor = session->stream_.get_executor();
+  net::co_spawn(
+      executor, [session = std::move(session)] { return session->Run(); },
+      [](std::exception_ptr e) {
+        if (!e)
+          return;
+        try {
+          std::rethrow_exception(e);
+        } catch (const std::exception& ex) {
+          BOOST_LOG_TRIVIAL(error) << "session: " << ex.what();
+        }
+      });
+}
+
+net::awaitable<void> HttpSession::Run() {
+  bool first_request = true;
+  for (;;) {
+    beast::error_code ec;
+
+    // Парсер получает сообщение, оставшееся от прошлого запроса, поэтому
+    // ёмкость строки тела переиспользуется.
+    request_.clear();
+    request_.body().clear();
+    RequestParser parser{std::move(request_)};
+    parser.body_limit(options_.body_limit);
+
+    stream_.expires_after(first_request ? options_.read_timeout
+                                        : options_.idle_timeout);
+    co_await http::async_read_header(
+        stream_, buffer_, parser, net::redirect_error(net::use_awaitable, ec));
+    if (!ec && !parser.is_done()) {
+      stream_.expires_after(options_.read_timeout);
+      co_await http::async_read(stream_, buffer_, parser,
+                                net::redirect_error(net::use_awaitable, ec));
+    }
+    request_ = parser.release();
+
+    if (ec == http::error::end_of_stream) {
+      Close();
+      co_return;
+    }
+    if (ec == beast::error::timeout) {
+      BOOST_LOG_TRIVIAL(debug) << "Connection timed out";
+      co_return;
+    }
+    if (ec) {
+      BOOST_LOG_TRIVIAL(error) << ec.message();
+      co_return;
+    }
+    first_request = false;
+
+    bool keep_alive = request_.keep_alive();
+    auto reply = co_await Dispatch();
+    reply.response.version(request_.version());
+    reply.response.keep_alive(keep_alive);
+
+    // Таймер записи взводится перед каждой записью, а не до обработчиков:
+    // время их работы не должно съедать write_timeout.
+    if (reply.stream) {
+      ec = co_await WriteStream(reply);
+    } else if (!keep_alive || options_.max_pipeline_batch < 2 ||
+               !ParseBuffered()) {
+      stream_.expires_after(options_.write_timeout);
+      co_await http::async_write(stream_, reply.response,
+                                 net::redirect_error(net::use_awaitable, ec));
+    } else {
+      write_buffer_.clear();
+      Serialize(reply.response);
+      std::size_t batch = 1;
+      do {
+        keep_alive = request_.keep_alive();
+        auto next = co_await Dispatch();
+        next.response.version(request_.version());
+        next.response.keep_alive(keep_alive);
+        if (next.stream) {
+          // Накопленные ответы уходят раньше потокового.
+          stream_.expires_after(options_.write_timeout);
+          co_await net::async_write(
+              stream_, write_buffer_.data(),
+              net::redirect_error(net::use_awaitable, ec));
+          write_buffer_.clear();
+          if (!ec) {
+            ec = co_await WriteStream(next);
+          }
+          break;
+        }
+        Serialize(next.response);
+        ++batch;
+      } while (keep_alive && batch < options_.max_pipeline_batch &&
+               ParseBuffered());
+      if (!ec && write_buffer_.size() > 0) {
+        stream_.expires_after(options_.write_timeout);
+        co_await net::async_write(stream_, write_buffer_.data(),
+                                  net::redirect_error(net::use_awaitable, ec));
+      }
+    }
+    if (ec) {
+      BOOST_LOG_TRIVIAL(error) << ec.message();
+      co_return;
+    }
+    if (!keep_alive) {
+      Close();
+      co_return;
+    }
+  }
+}
+
+net::awaitable<HttpSession::Reply> HttpSession::Dispatch() {
+  const auto start = std::chrono::steady_clock::now();
+  auto reply = co_await DispatchToRouter();
+  if (options_.access_log) {
+    const auto method = request_.method_string();
+    const auto target = request_.target();
+    options_.access_log->Log(
+        {method.data(), method.size()}, {target.data(), target.size()},
+        reply.response.result_int(),
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start));
+  }
+  co_return reply;
+}
+
+net::awaitable<HttpSession::Reply> HttpSession::DispatchToRouter() {
+  auto reply = co_await RunOnPool<Reply>([this] {
+    Reply reply;
+    try {
+      reply.stream =
+          router_->Dispatch(request_, reply.response, reply.deferred);
+      // В HTTP/1.0 нет chunked encoding: тело собирается целиком.
+      if (reply.stream && request_.version() < 11) {
+        while (auto chunk = reply.stream->Next()) {
+          reply.response.body() += *chunk;
+        }
+        reply.response.prepare_payload();
+        reply.stream.reset();
+      }
+    } catch (...) {
+      reply.response = ErrorResponse(http::status::internal_server_error,
+                                     R"({"error":"internal"})");
+      reply.stream.reset();
+    }
+    return reply;
+  });
+  if (!reply) {
+    BOOST_LOG_TRIVIAL(warning)
+        << "Dispatch queue is full, rejecting: " << request_.method_string()
+        << " " << request_.target();
+    Reply rejected;
+    rejected.response = ServiceUnavailable();
+    co_return rejected;
+  }
+  if (reply->deferred) {
+    reply->response = co_await AwaitDeferred(*reply->deferred);
+    reply->deferred.reset();
+  }
+  co_return std::move(*reply);
+}
+
+template <class T, class F>
+net::awaitable<std::optional<T>> HttpSession::RunOnPool(F fn) {
+  if (!dispatch_pool_) {
+    co_return fn();
+  }
+
+  // fn выполняется на пуле, а корутина продолжается в strand сокета.
+  co_return co_await net::async_initiate<decltype(net::use_awaitable),
+                                         void(std::optional<T>)>(
+      [this, &fn](auto handler) {
+        auto executor =
+            net::get_associated_executor(handler, stream_.get_executor());
+        auto job = [fn = std::move(fn), handler = std::move(handler),
+                    executor](bool accepted = true) mutable {
+          std::optional<T> result;
+          if (accepted) {
+            result = fn();
+          }
+          net::post(executor, [handler = std::move(handler),
+                               result = std::move(result)]() mutable {
+            std::move(handler)(std::move(result));
+          });
+        };
+        if (!dispatch_pool_->TryPost(std::move(job))) {
+          job(false);
+        }
+      },
+      net::use_awaitable);
+}
+
+net::awaitable<HttpResponse> HttpSession::AwaitDeferred(
+    DeferredResponse& deferred) {
+  // done приходит из чужого потока (или прямо из Start) и только ставит
+  // продолжение корутины в strand сокета.
+  co_return co_await net::async_initiate<decltype(net::use_awaitable),
+                                         void(HttpResponse)>(
+      [this, &deferred](auto handler) {
+        auto executor =
+            net::get_associated_executor(handler, stream_.get_executor());
+        deferred.Start([handler = std::move(handler),
+                        executor](HttpResponse response) mutable {
+          net::post(executor, [handler = std::move(handler),
+                               response = std::move(response)]() mutable {
+            std::move(handler)(std::move(response));
+          });
+        });
+      },
+      net::use_awaitable);
+}
+
+net::awaitable<beast::error_code> HttpSession::WriteStream(Reply& reply) {
+  struct Chunk {
+    std::optional<std::string> data;
+    bool failed = false;
+  };
+
+  beast::error_code ec;
+  reply.response.body().clear();
+  reply.response.chunked(true);
+  ResponseSerializer serializer{reply.response};
+  stream_.expires_after(options_.write_timeout);
+  co_await http::async_write_header(
+      stream_, serializer, net::redirect_error(net::use_awaitable, ec));
+
+  while (!ec) {
+    auto chunk = co_await RunOnPool<Chunk>([&reply] {
+      try {
+        return Chunk{reply.stream->Next()};
+      } catch (const std::exception& ex) {
+        BOOST_LOG_TRIVIAL(error) << ex.what();
+        return Chunk{std::nullopt, true};
+      }
+    });
+    // Заголовок уже отправлен, сменить статус нельзя: соединение рвётся без
+    // завершающего куска, и клиент видит обрыв ответа.
+    if (!chunk || chunk->failed) {
+      BOOST_LOG_TRIVIAL(warning) << "Streaming response aborted: "
+                                 << request_.target();
+      co_return net::error::operation_aborted;
+    }
+    if (!chunk->data) {
+      break;
+    }
+    // Кусок нулевой длины означал бы конец тела.
+    if (chunk->data->empty()) {
+      continue;
+    }
+    stream_.expires_after(options_.write_timeout);
+    co_await net::async_write(stream_,
+                              http::make_chunk(net::buffer(*chunk->data)),
+                              net::redirect_error(net::use_awaitable, ec));
+  }
+  if (!ec) {
+    stream_.expires_after(options_.write_timeout);
+    co_await net::async_write(stream_, http::make_chunk_last(),
+                              net::redirect_error(net::use_awaitable, ec));
+  }
+  co_return ec;
+}
+
+bool HttpSession::ParseBuffered() {
+  if (buffer_.size() == 0) {
+    return false;
+  }
+  request_.clear();
+  request_.body().clear();
+  RequestParser parser{std::move(request_)};
+  parser.body_limit(options_.body_limit);
+  parser.eager(true);
+
+  // Неполный запрос не забирается из buffer_: его дочитает async_read.
+  const auto data = buffer_.data();
+  std::size_t used = 0;
+  beast::error_code ec;
+  while (!parser.is_done()) {
+    const auto n = parser.put(net::buffer(data + used), ec);
+    used += n;
+    if (ec || n == 0) {
+      break;
+    }
+  }
+  const bool done = parser.is_done();
+  request_ = parser.release();
+  if (done) {
+    buffer_.consume(used);
+  }
+  return done;
+}
+
+void HttpSession::Serialize(Response& response) {
+  ResponseSerializer serializer{response};
+  beast::error_code ec;
+  do {
+    serializer.next(ec, [&](beast::error_code& error, const auto& buffers) {
+      error = {};
+      const auto size = beast::buffer_bytes(buffers);
+      write_buffer_.commit(
+          net::buffer_copy(write_buffer_.prepare(size), buffers));
+      serializer.consume(size);
+    });
+  } while (!ec && !serializer.is_done());
+  if (ec) {
+    BOOST_LOG_TRIVIAL(error) << "serialize: " << ec.message();
+  }
+}
+
+void HttpSession::Close() {
+  beast::error_code ec;
+  stream_.socket().shutdown(ip::tcp::socket::shutdown_send, ec);
+}
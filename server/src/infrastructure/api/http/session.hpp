@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+
+#include "access_log.hpp"
+#include "dispatch_pool.hpp"
+#include "router.hpp"
+
+namespace net = boost::asio;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace ip = net::ip;
+
+struct SessionOptions {
+  // Ожидание следующего запроса на keep-alive соединении.
+  std::chrono::steady_clock::duration idle_timeout = std::chrono::seconds(60);
+  // Чтение одного запроса (заголовок первого запроса и тело).
+  std::chrono::steady_clock::duration read_timeout = std::chrono::seconds(30);
+  std::chrono::steady_clock::duration write_timeout = std::chrono::seconds(30);
+  std::size_t body_limit = 1024 * 1024;
+  // Сколько уже пришедших в буфер pipelined-запросов обрабатывается до
+  // одной общей записи ответов.
+  std::size_t max_pipeline_batch = 16;
+  // Журнал запросов; nullptr — запросы не логируются.
+  std::shared_ptr<AccessLog> access_log;
+};
+
+// Одно TCP-соединение. Буфер и объект запроса живут всё время соединения и
+// переиспользуются между keep-alive запросами. Если клиент прислал несколько
+// запросов подряд (HTTP/1.1 pipelining), ответы на все запросы, уже лежащие
+// в буфере, отправляются одной записью. Потоковые ответы пишутся по мере
+// готовности кусков, которые обработчик отдаёт на пуле. Отложенного ответа
+// (Handler::ExecuteDeferred) корутина ждёт, не занимая поток.
+class HttpSession {
+ public:
+  HttpSession(ip::tcp::socket socket, std::shared_ptr<Router> router,
+              std::shared_ptr<DispatchPool> dispatch_pool,
+              const SessionOptions& options);
+
+  // Запускает корутину соединения на executor-е сокета (strand).
+  static void Start(std::shared_ptr<HttpSession> session);
+
+ private:
+  struct Reply {
+    HttpResponse response;
+    // Тело потокового ответа; тогда response содержит только заголовки.
+    std::unique_ptr<ChunkSource> stream;
+    // Ответ ещё готовится; response пуст.
+    std::unique_ptr<DeferredResponse> deferred;
+  };
+
+  net::awaitable<void> Run();
+  // Обработка запроса и запись в журнал запросов.
+  net::awaitable<Reply> Dispatch();
+  net::awaitable<Reply> DispatchToRouter();
+  // Выполняет fn на пуле обработчиков (без пула — сразу) и возвращается в
+  // strand сокета. nullopt — очередь пула переполнена.
+  template <class T, class F>
+  net::awaitable<std::optional<T>> RunOnPool(F fn);
+  // Запускает отложенный ответ и возвращается в strand сокета, когда он
+  // готов.
+  net::awaitable<HttpResponse> AwaitDeferred(DeferredResponse& deferred);
+  // Пишет заголовок и тело потокового ответа кусками chunked encoding.
+  net::awaitable<beast::error_code> WriteStream(Reply& reply);
+  // Разбирает следующий запрос из buffer_ без чтения из сокета. Возвращает
+  // false, если целого запроса в буфере нет.
+  bool ParseBuffered();
+  void Serialize(HttpResponse& response);
+  void Close();
+
+  beast::tcp_stream stream_;
+  beast::flat_buffer buffer_;
+  beast::flat_buffer write_buffer_;
+  HttpRequest request_;
+  std::shared_ptr<Router> router_;
+  std::shared_ptr<DispatchPool> dispatch_pool_;
+  SessionOptions options_;
+};
@@ -0,0 +1,105 @@
+#include "caching_task_repository.hpp"
+
+#include <algorithm>
+
+CachingTaskRepository::CachingTaskRepository(
+    std::unique_ptr<TaskRepository> repository, Options options)
+    : repository_(std::move(repository)),
+      tasks_(options.capacity, options.shards),
+      user_tasks_(options.capacity, options.shards) {}
+
+std::expected<Task, AddTaskError> CachingTaskRepository::AddTask(
+    const Task& task) {
+  auto r = repository_->AddTask(task);
+  // Даже при ошибке задача могла записаться (обрыв на commit), а
+  // инвалидация ничего не стоит.
+  user_tasks_.Erase(task.GetUserId());
+  return r;
+}
+
+std::expected<Task, FindTaskError> CachingTaskRepository::GetTaskById(
+    const Uuid& task_id) {
+  ShardedLruCache<Uuid, Task>::Generation generation = 0;
+  if (auto cached = tasks_.Get(task_id, &generation))
+    return std::move(*cached);
+  auto r = repository_->GetTaskById(task_id);
+  if (r.has_value())
+    tasks_.Put(task_id, r.value(), 1, generation);
+  return r;
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+CachingTaskRepository::GetTasksByUser(const Uuid& user_id) {
+  ShardedLruCache<Uuid, TaskList>::Generation generation = 0;
+  if (auto cached = user_tasks_.Get(user_id, &generation))
+    return **cached;
+  auto r = repository_->GetTasksByUser(user_id);
+  if (r.has_value()) {
+    const std::size_t weight = std::max<std::size_t>(r->size(), 1);
+    user_tasks_.Put(user_id, std::make_shared<const std::vector<Task>>(*r),
+                    weight, generation);
+  }
+  return r;
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+CachingTaskRepository::GetTasksByUserPage(
+    const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+    std::size_t limit) {
+  return repository_->GetTasksByUserPage(user_id, after, limit);
+}
+
+std::expected<Task, UpdateTaskError> CachingTaskRepository::UpdateTaskStatus(
+    const Uuid& task_id, TaskStatus status) {
+  auto r = repository_->UpdateTaskStatus(task_id, status);
+  tasks_.Erase(task_id);
+  if (r.has_value()) {
+    user_tasks_.Erase(r->GetUserId());
+  } else if (r.error() == UpdateTaskError::RepositoryError) {
+    // Исход неизвестен, а владелец задачи — тоже.
+    user_tasks_.Clear();
+  }
+  return r;
+}
+
+std::expected<Task, DeleteTaskError> CachingTaskRepository::DeleteTaskById(
+    const Uuid& task_id) {
+  auto r = repository_->DeleteTaskById(task_id);
+  tasks_.Erase(task_id);
+  if (r.has_value()) {
+    user_tasks_.Erase(r->GetUserId());
+  } else if (r.error() == DeleteTaskError::RepositoryError) {
+    user_tasks_.Clear();
+  }
+  return r;
+}
+
+std::expected<std::vector<Task>, AddTaskError> CachingTaskRepository::AddTasks(
+    const std::vector<Task>& tasks) {
+  auto r = repository_->AddTasks(tasks);
+  for (const auto& task : tasks) {
+    user_tasks_.Erase(task.GetUserId());
+  }
+  return r;
+}
+
+std::expected<std::vector<Task>, UpdateTaskError>
+CachingTaskRepository::UpdateTaskStatuses(
+    const std::vector<std::pair<Uuid, TaskStatus>>& updates) {
+  auto r = repository_->UpdateTaskStatuses(updates);
+  for (const auto& [task_id, status] : updates) {
+    tasks_.Erase(task_id);
+  }
+  if (r.has_value()) {
+    for (const auto& task : r.value()) {
+      user_tasks_.Erase(task.GetUserId());
+    }
+  } else if (r.error() == UpdateTaskError::RepositoryError) {
+    user_tasks_.Clear();
+  }
+  return r;
+}
+
+CachingTaskRepository::Stats CachingTaskRepository::GetStats() const {
+  return Stats{tasks_.GetStats(), user_tasks_.GetStats()};
+}
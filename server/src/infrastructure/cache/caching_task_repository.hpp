@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "lru_cache.hpp"
+#include "task_repository.hpp"
+
+// Кэш чтения поверх другого TaskRepository: отдельные задачи и полные
+// списки задач пользователя. Изменения инвалидируют ровно затронутые
+// записи; страницы (GetTasksByUserPage) не кэшируются.
+//
+// Инвалидация локальна для процесса: пока в базу пишут другие экземпляры
+// сервера, кэш может отдавать устаревшие данные.
+class CachingTaskRepository final : public TaskRepository {
+ public:
+  struct Options {
+    // Ёмкость каждого из двух кэшей в задачах.
+    std::size_t capacity = 100000;
+    std::size_t shards = 16;
+  };
+
+  struct Stats {
+    CacheStats tasks;
+    CacheStats user_tasks;
+  };
+
+  CachingTaskRepository(std::unique_ptr<TaskRepository> repository,
+                        Options options);
+
+  std::expected<Task, AddTaskError> AddTask(const Task& task) override;
+  std::expected<Task, FindTaskError> GetTaskById(const Uuid& task_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUser(
+      const Uuid& user_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUserPage(
+      const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+      std::size_t limit) override;
+  std::expected<Task, UpdateTaskError> UpdateTaskStatus(
+      const Uuid& task_id, TaskStatus status) override;
+  std::expected<Task, DeleteTaskError> DeleteTaskById(
+      const Uuid& task_id) override;
+  std::expected<std::vector<Task>, AddTaskError> AddTasks(
+      const std::vector<Task>& tasks) override;
+  std::expected<std::vector<Task>, UpdateTaskError> UpdateTaskStatuses(
+      const std::vector<std::pair<Uuid, TaskStatus>>& updates) override;
+
+  Stats GetStats() const;
+
+ private:
+  using TaskList = std::shared_ptr<const std::vector<Task>>;
+
+  std::unique_ptr<TaskRepository> repository_;
+  ShardedLruCache<Uuid, Task> tasks_;
+  ShardedLruCache<Uuid, TaskList> user_tasks_;
+};
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+struct CacheStats {
+  std::uint64_t hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t evictions = 0;
+  std::uint64_t invalidations = 0;
+  std::size_t entries = 0;
+  std::size_t weight = 0;
+};
+
+// LRU-кэш, разбитый на шарды по хешу ключа: у каждого шарда свой мьютекс,
+// поэтому потоки, читающие разные ключи, почти не конкурируют. Ёмкость
+// задаётся в единицах веса (вес записи передаётся в Put) и делится между
+// шардами поровну.
+template <class Key, class Value, class Hash = std::hash<Key>>
+class ShardedLruCache {
+ public:
+  // Поколение шарда: меняется при каждой инвалидации. Get при промахе
+  // отдаёт текущее поколение, и Put с ним ничего не кладёт, если ключ
+  // успели инвалидировать, пока значение читалось из хранилища.
+  using Generation = std::uint64_t;
+
+  ShardedLruCache(std::size_t capacity, std::size_t shard_count)
+      : shard_count_(shard_count == 0 ? 1 : shard_count),
+        shard_capacity_(capacity / shard_count_),
+        shards_(std::make_unique<Shard[]>(shard_count_)) {}
+
+  std::optional<Value> Get(const Key& key, Generation* generation = nullptr) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard lock(shard.mutex);
+    const auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+      ++shard.stats.misses;
+      if (generation)
+        *generation = shard.generation;
+      return std::nullopt;
+    }
+    ++shard.stats.hits;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return it->second->value;
+  }
+
+  void Put(const Key& key, Value value, std::size_t weight,
+           std::optional<Generation> generation = std::nullopt) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard lock(shard.mutex);
+    if (generation && *generation != shard.generation)
+      return;
+    if (const auto it = shard.index.find(key); it != shard.index.end())
+      Remove(shard, it);
+    if (weight > shard_capacity_)
+      return;
+    shard.lru.push_front(Entry{key, std::move(value), weight});
+    shard.index.emplace(key, shard.lru.begin());
+    shard.weight += weight;
+    while (shard.weight > shard_capacity_) {
+      Remove(shard, shard.index.find(shard.lru.back().key));
+      ++shard.stats.evictions;
+    }
+  }
+
+  void Erase(const Key& key) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard lock(shard.mutex);
+    ++shard.generation;
+    if (const auto it = shard.index.find(key); it != shard.index.end()) {
+      Remove(shard, it);
+      ++shard.stats.invalidations;
+    }
+  }
+
+  void Clear() {
+    for (std::size_t i = 0; i < shard_count_; ++i) {
+      Shard& shard = shards_[i];
+      std::lock_guard lock(shard.mutex);
+      ++shard.generation;
+      shard.stats.invalidations += shard.index.size();
+      shard.index.clear();
+      shard.lru.clear();
+      shard.weight = 0;
+    }
+  }
+
+  CacheStats GetStats() const {
+    CacheStats total;
+    for (std::size_t i = 0; i < shard_count_; ++i) {
+      const Shard& shard = shards_[i];
+      std::lock_guard lock(shard.mutex);
+      total.hits += shard.stats.hits;
+      total.misses += shard.stats.misses;
+      total.evictions += shard.stats.evictions;
+      total.invalidations += shard.stats.invalidations;
+      total.entries += shard.index.size();
+      total.weight += shard.weight;
+    }
+    return total;
+  }
+
+ private:
+  struct Entry {
+    Key key;
+    Value value;
+    std::size_t weight;
+  };
+  using EntryList = std::list<Entry>;
+
+  struct Shard {
+    mutable std::mutex mutex;
+    // В начале — последние использованные.
+    EntryList lru;
+    std::unordered_map<Key, typename EntryList::iterator, Hash> index;
+    std::size_t weight = 0;
+    Generation generation = 0;
+    CacheStats stats;
+  };
+
+  Shard& ShardFor(const Key& key) {
+    return shards_[Hash{}(key) % shard_count_];
+  }
+
+  static void Remove(
+      Shard& shard,
+      typename std::unordered_map<Key, typename EntryList::iterator,
+                                  Hash>::iterator it) {
+    shard.weight -= it->second->weight;
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+  }
+
+  std::size_t shard_count_;
+  std::size_t shard_capacity_;
+  std::unique_ptr<Shard[]> shards_;
+};
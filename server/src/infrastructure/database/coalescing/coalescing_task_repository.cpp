@@ -0,0 +1,138 @@
+#include "coalescing_task_repository.hpp"
+
+#include <exception>
+
+#include <boost/log/trivial.hpp>
+
+namespace {
+
+// Результатов столько же, сколько изменений; недостающие — ошибка.
+template <class E>
+void CompleteResults(std::vector<std::expected<Task, E>>& results,
+                     std::size_t size) {
+  results.resize(size, std::unexpected(E::RepositoryError));
+}
+
+}  // namespace
+
+CoalescingTaskRepository::CoalescingTaskRepository(
+    std::unique_ptr<TaskRepository> repository, TaskBatchWriter& writer,
+    Options options)
+    : repository_(std::move(repository)), writer_(writer), options_(options) {}
+
+std::expected<Task, AddTaskError> CoalescingTaskRepository::AddTask(
+    const Task& task) {
+  std::size_t index = 0;
+  const auto batch = Submit(
+      [&](TaskWriteBatch& writes) {
+        writes.adds.push_back(task);
+        return writes.adds.size() - 1;
+      },
+      index);
+  return batch->results.adds[index];
+}
+
+std::expected<Task, FindTaskError> CoalescingTaskRepository::GetTaskById(
+    const Uuid& task_id) {
+  return repository_->GetTaskById(task_id);
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+CoalescingTaskRepository::GetTasksByUser(const Uuid& user_id) {
+  return repository_->GetTasksByUser(user_id);
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+CoalescingTaskRepository::GetTasksByUserPage(
+    const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+    std::size_t limit) {
+  return repository_->GetTasksByUserPage(user_id, after, limit);
+}
+
+std::expected<Task, UpdateTaskError>
+CoalescingTaskRepository::UpdateTaskStatus(const Uuid& task_id,
+                                           TaskStatus status) {
+  std::size_t index = 0;
+  const auto batch = Submit(
+      [&](TaskWriteBatch& writes) {
+        writes.updates.emplace_back(task_id, status);
+        return writes.updates.size() - 1;
+      },
+      index);
+  return batch->results.updates[index];
+}
+
+std::expected<Task, DeleteTaskError> CoalescingTaskRepository::DeleteTaskById(
+    const Uuid& task_id) {
+  std::size_t index = 0;
+  const auto batch = Submit(
+      [&](TaskWriteBatch& writes) {
+        writes.deletes.push_back(task_id);
+        return writes.deletes.size() - 1;
+      },
+      index);
+  return batch->results.deletes[index];
+}
+
+std::expected<std::vector<Task>, AddTaskError>
+CoalescingTaskRepository::AddTasks(const std::vector<Task>& tasks) {
+  return repository_->AddTasks(tasks);
+}
+
+std::expected<std::vector<Task>, UpdateTaskError>
+CoalescingTaskRepository::UpdateTaskStatuses(
+    const std::vector<std::pair<Uuid, TaskStatus>>& updates) {
+  return repository_->UpdateTaskStatuses(updates);
+}
+
+CoalescingTaskRepository::Stats CoalescingTaskRepository::GetStats() const {
+  std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+std::shared_ptr<const CoalescingTaskRepository::Batch>
+CoalescingTaskRepository::Submit(
+    const std::function<std::size_t(TaskWriteBatch&)>& add,
+    std::size_t& index) {
+  std::unique_lock lock(mutex_);
+  ++stats_.writes;
+  const bool leader = !open_;
+  if (leader)
+    open_ = std::make_shared<Batch>();
+  const std::shared_ptr<Batch> batch = open_;
+  index = add(batch->writes);
+  if (++batch->size >= options_.max_batch) {
+    open_.reset();
+    closed_cv_.notify_all();
+  }
+
+  if (!leader) {
+    done_cv_.wait(lock, [&] { return batch->done; });
+    return batch;
+  }
+
+  closed_cv_.wait_for(lock, options_.window, [&] { return open_ != batch; });
+  if (open_ == batch)
+    open_.reset();
+  ++stats_.batches;
+  // Пакет закрыт: в него больше никто не пишет, и выполнять его можно без
+  // блокировки.
+  lock.unlock();
+  Execute(*batch);
+  lock.lock();
+  batch->done = true;
+  done_cv_.notify_all();
+  return batch;
+}
+
+void CoalescingTaskRepository::Execute(Batch& batch) {
+  try {
+    batch.results = writer_.WriteBatch(batch.writes);
+  } catch (const std::exception& e) {
+    BOOST_LOG_TRIVIAL(error) << "Task write batch failed: " << e.what();
+    batch.results = {};
+  }
+  CompleteResults(batch.results.adds, batch.writes.adds.size());
+  CompleteResults(batch.results.updates, batch.writes.updates.size());
+  CompleteResults(batch.results.deletes, batch.writes.deletes.size());
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "task_batch_writer.hpp"
+#include "task_repository.hpp"
+
+// Собирает параллельные AddTask, UpdateTaskStatus и DeleteTaskById в
+// пакеты и отдаёт каждый пакет в TaskBatchWriter одной транзакцией: при
+// перетаскивании задач между колонками вместо транзакции и fsync на каждый
+// PATCH получается одна на пакет.
+//
+// Первый вызов, не застав открытого пакета, открывает его, ждёт window
+// (или пока пакет не наберёт max_batch) и выполняет его в своём потоке;
+// остальные дописываются в пакет и ждут результата. Пока пакет
+// выполняется, следующие вызовы собираются в новый. Чтения и пакетные
+// методы идут в repository напрямую.
+class CoalescingTaskRepository final : public TaskRepository {
+ public:
+  struct Options {
+    // Сколько пакет собирается: на столько же растёт задержка записи при
+    // слабой нагрузке, зато под нагрузкой меньше транзакций.
+    std::chrono::microseconds window{1000};
+    // Пакет уходит сразу, как только набрал столько изменений.
+    std::size_t max_batch = 128;
+  };
+
+  struct Stats {
+    std::uint64_t writes = 0;
+    std::uint64_t batches = 0;
+  };
+
+  // writer — обычно тот же объект, что в основе repository; должен жить не
+  // меньше этого репозитория.
+  CoalescingTaskRepository(std::unique_ptr<TaskRepository> repository,
+                           TaskBatchWriter& writer, Options options);
+
+  std::expected<Task, AddTaskError> AddTask(const Task& task) override;
+  std::expected<Task, FindTaskError> GetTaskById(const Uuid& task_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUser(
+      const Uuid& user_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUserPage(
+      const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+      std::size_t limit) override;
+  std::expected<Task, UpdateTaskError> UpdateTaskStatus(
+      const Uuid& task_id, TaskStatus status) override;
+  std::expected<Task, DeleteTaskError> DeleteTaskById(
+      const Uuid& task_id) override;
+  std::expected<std::vector<Task>, AddTaskError> AddTasks(
+      const std::vector<Task>& tasks) override;
+  std::expected<std::vector<Task>, UpdateTaskError> UpdateTaskStatuses(
+      const std::vector<std::pair<Uuid, TaskStatus>>& updates) override;
+
+  Stats GetStats() const;
+
+ private:
+  struct Batch {
+    TaskWriteBatch writes;
+    TaskWriteBatchResult results;
+    std::size_t size = 0;
+    bool done = false;
+  };
+
+  // Кладёт изменение в открытый пакет (add возвращает его индекс среди
+  // изменений своего вида) и возвращает выполненный пакет.
+  std::shared_ptr<const Batch> Submit(
+      const std::function<std::size_t(TaskWriteBatch&)>& add,
+      std::size_t& index);
+  void Execute(Batch& batch);
+
+  std::unique_ptr<TaskRepository> repository_;
+  TaskBatchWriter& writer_;
+  const Options options_;
+
+  mutable std::mutex mutex_;
+  // Будит открывшего пакет, когда пакет набрал max_batch.
+  std::condition_variable closed_cv_;
+  std::condition_variable done_cv_;
+  std::shared_ptr<Batch> open_;
+  Stats stats_;
+};
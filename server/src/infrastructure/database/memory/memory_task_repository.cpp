@@ -0,0 +1,287 @@
+#include "memory_task_repository.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+namespace {
+
+using PageKeyTuple = std::tuple<TaskStatus, const std::string&, const Uuid&>;
+
+PageKeyTuple PageKey(const Task& task) {
+  return {task.GetStatus(), task.GetTitle(), task.GetId()};
+}
+
+PageKeyTuple PageKey(const TaskPageCursor& cursor) {
+  return {cursor.status, cursor.title, cursor.task_id};
+}
+
+}  // namespace
+
+bool InMemoryTaskRepository::PageOrder::operator()(const TaskPtr& a,
+                                                   const TaskPtr& b) const {
+  return PageKey(*a) < PageKey(*b);
+}
+
+bool InMemoryTaskRepository::PageOrder::operator()(
+    const TaskPtr& a, const TaskPageCursor& b) const {
+  return PageKey(*a) < PageKey(b);
+}
+
+bool InMemoryTaskRepository::PageOrder::operator()(const TaskPageCursor& a,
+                                                   const TaskPtr& b) const {
+  return PageKey(a) < PageKey(*b);
+}
+
+InMemoryTaskRepository::InMemoryTaskRepository(Options options)
+    : shard_count_(options.shards == 0 ? 1 : options.shards),
+      task_shards_(std::make_unique<TaskShard[]>(shard_count_)),
+      user_shards_(std::make_unique<UserShard[]>(shard_count_)) {}
+
+std::expected<Task, AddTaskError> InMemoryTaskRepository::AddTask(
+    const Task& task) {
+  auto stored =
+      std::make_shared<const Task>(Uuid::Random(), task.GetUserId(),
+                                   task.GetTitle(), task.GetDescription(),
+                                   task.GetStatus());
+  const auto locks = LockForWrite({task.GetUserId()}, {stored->GetId()});
+  if (!Insert(stored))
+    return std::unexpected(AddTaskError::AlreadyExists);
+  return *stored;
+}
+
+std::expected<Task, FindTaskError> InMemoryTaskRepository::GetTaskById(
+    const Uuid& task_id) {
+  TaskPtr task;
+  {
+    const TaskShard& shard = TaskShardFor(task_id);
+    std::shared_lock lock(shard.mutex);
+    const auto it = shard.tasks.find(task_id);
+    if (it == shard.tasks.end())
+      return std::unexpected(FindTaskError::NotFound);
+    task = it->second;
+  }
+  return *task;
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+InMemoryTaskRepository::GetTasksByUser(const Uuid& user_id) {
+  return GetTasksByUserPage(user_id, std::nullopt, SIZE_MAX);
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+InMemoryTaskRepository::GetTasksByUserPage(
+    const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+    std::size_t limit) {
+  // Под блокировкой копируются только указатели, задачи — после неё.
+  std::vector<TaskPtr> page;
+  {
+    const UserShard& shard = UserShardFor(user_id);
+    std::shared_lock lock(shard.mutex);
+    const auto user = shard.users.find(user_id);
+    if (user != shard.users.end()) {
+      const UserTasks& tasks = user->second;
+      auto it = after ? tasks.upper_bound(*after) : tasks.begin();
+      page.reserve(std::min(limit, tasks.size()));
+      for (; it != tasks.end() && page.size() < limit; ++it)
+        page.push_back(*it);
+    }
+  }
+  std::vector<Task> result;
+  result.reserve(page.size());
+  for (const auto& task : page)
+    result.push_back(*task);
+  return result;
+}
+
+std::expected<Task, UpdateTaskError> InMemoryTaskRepository::UpdateTaskStatus(
+    const Uuid& task_id, TaskStatus status) {
+  const auto owner = FindOwner(task_id);
+  if (!owner)
+    return std::unexpected(UpdateTaskError::NotFound);
+  const auto locks = LockForWrite({*owner}, {task_id});
+  // Задачу могли удалить, пока блокировки не были взяты.
+  const auto updated = Replace(task_id, status);
+  if (!updated)
+    return std::unexpected(UpdateTaskError::NotFound);
+  return **updated;
+}
+
+std::expected<Task, DeleteTaskError> InMemoryTaskRepository::DeleteTaskById(
+    const Uuid& task_id) {
+  const auto owner = FindOwner(task_id);
+  if (!owner)
+    return std::unexpected(DeleteTaskError::NotFound);
+  const auto locks = LockForWrite({*owner}, {task_id});
+  const auto erased = Erase(task_id);
+  if (!erased)
+    return std::unexpected(DeleteTaskError::NotFound);
+  return **erased;
+}
+
+std::expected<std::vector<Task>, AddTaskError>
+InMemoryTaskRepository::AddTasks(const std::vector<Task>& tasks) {
+  std::vector<TaskPtr> stored;
+  std::vector<Uuid> user_ids;
+  std::vector<Uuid> task_ids;
+  stored.reserve(tasks.size());
+  for (const auto& task : tasks) {
+    stored.push_back(std::make_shared<const Task>(
+        Uuid::Random(), task.GetUserId(), task.GetTitle(),
+        task.GetDescription(), task.GetStatus()));
+    user_ids.push_back(task.GetUserId());
+    task_ids.push_back(stored.back()->GetId());
+  }
+
+  // Все шарды пакета заблокированы сразу: пакет виден целиком или никак.
+  const auto locks = LockForWrite(user_ids, task_ids);
+  for (const auto& task : stored) {
+    const TaskShard& shard = TaskShardFor(task->GetId());
+    if (shard.tasks.contains(task->GetId()))
+      return std::unexpected(AddTaskError::AlreadyExists);
+  }
+  std::vector<Task> created;
+  created.reserve(stored.size());
+  for (auto& task : stored) {
+    created.push_back(*task);
+    Insert(std::move(task));
+  }
+  return created;
+}
+
+std::expected<std::vector<Task>, UpdateTaskError>
+InMemoryTaskRepository::UpdateTaskStatuses(
+    const std::vector<std::pair<Uuid, TaskStatus>>& updates) {
+  std::vector<Uuid> user_ids;
+  std::vector<Uuid> task_ids;
+  for (const auto& [task_id, status] : updates) {
+    const auto owner = FindOwner(task_id);
+    if (!owner)
+      return std::unexpected(UpdateTaskError::NotFound);
+    user_ids.push_back(*owner);
+    task_ids.push_back(task_id);
+  }
+
+  const auto locks = LockForWrite(user_ids, task_ids);
+  // Как в транзакции: если хоть одной задачи нет, не меняется ни одна.
+  for (const auto& task_id : task_ids) {
+    if (!TaskShardFor(task_id).tasks.contains(task_id))
+      return std::unexpected(UpdateTaskError::NotFound);
+  }
+  std::vector<Task> updated;
+  updated.reserve(updates.size());
+  for (const auto& [task_id, status] : updates)
+    updated.push_back(**Replace(task_id, status));
+  return updated;
+}
+
+std::size_t InMemoryTaskRepository::Size() const {
+  std::size_t size = 0;
+  for (std::size_t i = 0; i < shard_count_; ++i) {
+    std::shared_lock lock(task_shards_[i].mutex);
+    size += task_shards_[i].tasks.size();
+  }
+  return size;
+}
+
+bool InMemoryTaskRepository::Restore(const Task& task) {
+  auto stored = std::make_shared<const Task>(task);
+  const auto locks = LockForWrite({task.GetUserId()}, {task.GetId()});
+  return Insert(std::move(stored));
+}
+
+void InMemoryTaskRepository::ForEach(
+    const std::function<void(const Task&)>& visit) const {
+  for (std::size_t i = 0; i < shard_count_; ++i) {
+    std::shared_lock lock(task_shards_[i].mutex);
+    for (const auto& [id, task] : task_shards_[i].tasks)
+      visit(*task);
+  }
+}
+
+InMemoryTaskRepository::TaskShard& InMemoryTaskRepository::TaskShardFor(
+    const Uuid& task_id) const {
+  return task_shards_[task_id.Hash() % shard_count_];
+}
+
+InMemoryTaskRepository::UserShard& InMemoryTaskRepository::UserShardFor(
+    const Uuid& user_id) const {
+  return user_shards_[user_id.Hash() % shard_count_];
+}
+
+std::optional<Uuid> InMemoryTaskRepository::FindOwner(
+    const Uuid& task_id) const {
+  const TaskShard& shard = TaskShardFor(task_id);
+  std::shared_lock lock(shard.mutex);
+  const auto it = shard.tasks.find(task_id);
+  if (it == shard.tasks.end())
+    return std::nullopt;
+  return it->second->GetUserId();
+}
+
+InMemoryTaskRepository::WriteLocks InMemoryTaskRepository::LockForWrite(
+    const std::vector<Uuid>& user_ids,
+    const std::vector<Uuid>& task_ids) const {
+  const auto sorted_unique = [](std::vector<std::shared_mutex*> mutexes) {
+    std::sort(mutexes.begin(), mutexes.end());
+    mutexes.erase(std::unique(mutexes.begin(), mutexes.end()), mutexes.end());
+    return mutexes;
+  };
+  std::vector<std::shared_mutex*> user_mutexes;
+  for (const auto& user_id : user_ids)
+    user_mutexes.push_back(&UserShardFor(user_id).mutex);
+  std::vector<std::shared_mutex*> task_mutexes;
+  for (const auto& task_id : task_ids)
+    task_mutexes.push_back(&TaskShardFor(task_id).mutex);
+
+  WriteLocks locks;
+  for (auto* mutex : sorted_unique(std::move(user_mutexes)))
+    locks.emplace_back(*mutex);
+  for (auto* mutex : sorted_unique(std::move(task_mutexes)))
+    locks.emplace_back(*mutex);
+  return locks;
+}
+
+bool InMemoryTaskRepository::Insert(TaskPtr task) {
+  TaskShard& task_shard = TaskShardFor(task->GetId());
+  if (!task_shard.tasks.try_emplace(task->GetId(), task).second)
+    return false;
+  UserShard& user_shard = UserShardFor(task->GetUserId());
+  user_shard.users[task->GetUserId()].insert(std::move(task));
+  return true;
+}
+
+std::optional<InMemoryTaskRepository::TaskPtr> InMemoryTaskRepository::Replace(
+    const Uuid& task_id, TaskStatus status) {
+  TaskShard& task_shard = TaskShardFor(task_id);
+  const auto it = task_shard.tasks.find(task_id);
+  if (it == task_shard.tasks.end())
+    return std::nullopt;
+  const Task& old = *it->second;
+  auto updated = std::make_shared<const Task>(old.GetId(), old.GetUserId(),
+                                              old.GetTitle(),
+                                              old.GetDescription(), status);
+  UserTasks& user_tasks = UserShardFor(old.GetUserId()).users[old.GetUserId()];
+  user_tasks.erase(it->second);
+  user_tasks.insert(updated);
+  it->second = updated;
+  return updated;
+}
+
+std::optional<InMemoryTaskRepository::TaskPtr> InMemoryTaskRepository::Erase(
+    const Uuid& task_id) {
+  TaskShard& task_shard = TaskShardFor(task_id);
+  const auto it = task_shard.tasks.find(task_id);
+  if (it == task_shard.tasks.end())
+    return std::nullopt;
+  TaskPtr task = std::move(it->second);
+  task_shard.tasks.erase(it);
+
+  UserShard& user_shard = UserShardFor(task->GetUserId());
+  const auto user = user_shard.users.find(task->GetUserId());
+  user->second.erase(task);
+  if (user->second.empty())
+    user_shard.users.erase(user);
+  return task;
+}
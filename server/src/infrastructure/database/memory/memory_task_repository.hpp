@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "task_repository.hpp"
+
+// Задачи в памяти процесса: для замеров HTTP без базы и для узлов без
+// PostgreSQL. Данные теряются при перезапуске.
+//
+// Задачи лежат в шардах по id, список задач пользователя — во вторичном
+// индексе, шардированном по user_id и упорядоченном как страницы. У каждого
+// шарда свой shared_mutex: чтения разных шардов не пересекаются, чтения
+// одного шарда идут параллельно. Запись берёт сначала шард пользователя,
+// потом шард задачи, поэтому чтение списка пользователя видит задачи
+// согласованно с GetTaskById.
+//
+// Названия сравниваются побайтово, а не по collation базы.
+class InMemoryTaskRepository final : public TaskRepository {
+ public:
+  struct Options {
+    std::size_t shards = 64;
+  };
+
+  InMemoryTaskRepository() : InMemoryTaskRepository(Options{}) {}
+  explicit InMemoryTaskRepository(Options options);
+
+  std::expected<Task, AddTaskError> AddTask(const Task& task) override;
+  std::expected<Task, FindTaskError> GetTaskById(const Uuid& task_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUser(
+      const Uuid& user_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUserPage(
+      const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+      std::size_t limit) override;
+  std::expected<Task, UpdateTaskError> UpdateTaskStatus(
+      const Uuid& task_id, TaskStatus status) override;
+  std::expected<Task, DeleteTaskError> DeleteTaskById(
+      const Uuid& task_id) override;
+  std::expected<std::vector<Task>, AddTaskError> AddTasks(
+      const std::vector<Task>& tasks) override;
+  std::expected<std::vector<Task>, UpdateTaskError> UpdateTaskStatuses(
+      const std::vector<std::pair<Uuid, TaskStatus>>& updates) override;
+
+  // Число задач во всех шардах.
+  std::size_t Size() const;
+  // Вставляет задачу с её же id, для восстановления из журнала. false —
+  // задача с таким id уже есть.
+  bool Restore(const Task& task);
+  // Обходит задачи шард за шардом, под разделяемой блокировкой шарда.
+  // Снимок не мгновенный: согласован, только если записей в это время нет.
+  void ForEach(const std::function<void(const Task&)>& visit) const;
+
+ private:
+  // Задача не меняется после вставки: смена статуса заменяет указатель,
+  // и копию можно отдавать, не держа блокировку шарда задач.
+  using TaskPtr = std::shared_ptr<const Task>;
+
+  // Порядок страниц: статус, название, id.
+  struct PageOrder {
+    using is_transparent = void;
+    bool operator()(const TaskPtr& a, const TaskPtr& b) const;
+    bool operator()(const TaskPtr& a, const TaskPageCursor& b) const;
+    bool operator()(const TaskPageCursor& a, const TaskPtr& b) const;
+  };
+  using UserTasks = std::set<TaskPtr, PageOrder>;
+
+  struct alignas(64) TaskShard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<Uuid, TaskPtr> tasks;
+  };
+  struct alignas(64) UserShard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<Uuid, UserTasks> users;
+  };
+
+  using WriteLocks = std::vector<std::unique_lock<std::shared_mutex>>;
+
+  TaskShard& TaskShardFor(const Uuid& task_id) const;
+  UserShard& UserShardFor(const Uuid& user_id) const;
+  // Шард задачи читается отдельно: нужен только user_id, а он у задачи
+  // не меняется.
+  std::optional<Uuid> FindOwner(const Uuid& task_id) const;
+  // Эксклюзивные блокировки шардов пользователей, затем шардов задач, в
+  // порядке адресов: пакеты не дедлочатся друг с другом.
+  WriteLocks LockForWrite(const std::vector<Uuid>& user_ids,
+                          const std::vector<Uuid>& task_ids) const;
+  // Вызываются под блокировками шардов пользователя и задачи.
+  bool Insert(TaskPtr task);
+  std::optional<TaskPtr> Replace(const Uuid& task_id, TaskStatus status);
+  std::optional<TaskPtr> Erase(const Uuid& task_id);
+
+  std::size_t shard_count_;
+  std::unique_ptr<TaskShard[]> task_shards_;
+  std::unique_ptr<UserShard[]> user_shards_;
+};
@@ -0,0 +1,60 @@
+#include "memory_user_repository.hpp"
+
+#include <functional>
+#include <mutex>
+
+InMemoryUserRepository::InMemoryUserRepository(Options options)
+    : shard_count_(options.shards == 0 ? 1 : options.shards),
+      shards_(std::make_unique<Shard[]>(shard_count_)) {}
+
+std::expected<User, FindUserError> InMemoryUserRepository::FindUser(
+    const std::string& login) {
+  const Shard& shard = ShardFor(login);
+  std::shared_lock lock(shard.mutex);
+  const auto it = shard.users.find(login);
+  if (it == shard.users.end())
+    return std::unexpected(FindUserError::NotFound);
+  return it->second;
+}
+
+std::expected<User, AddUserError> InMemoryUserRepository::AddUser(User user) {
+  Shard& shard = ShardFor(user.GetName());
+  User stored{Uuid::Random(), user.GetName(), user.GetPassword()};
+  std::unique_lock lock(shard.mutex);
+  const auto [it, inserted] =
+      shard.users.try_emplace(user.GetName(), std::move(stored));
+  if (!inserted)
+    return std::unexpected(AddUserError::AlreadyExists);
+  return it->second;
+}
+
+std::expected<void, UpdateUserError> InMemoryUserRepository::UpdatePassword(
+    const std::string& login, const std::string& password) {
+  Shard& shard = ShardFor(login);
+  std::unique_lock lock(shard.mutex);
+  const auto it = shard.users.find(login);
+  if (it == shard.users.end())
+    return std::unexpected(UpdateUserError::NotFound);
+  it->second = User{it->second.GetId(), login, password};
+  return {};
+}
+
+bool InMemoryUserRepository::Restore(const User& user) {
+  Shard& shard = ShardFor(user.GetName());
+  std::unique_lock lock(shard.mutex);
+  return shard.users.try_emplace(user.GetName(), user).second;
+}
+
+void InMemoryUserRepository::ForEach(
+    const std::function<void(const User&)>& visit) const {
+  for (std::size_t i = 0; i < shard_count_; ++i) {
+    std::shared_lock lock(shards_[i].mutex);
+    for (const auto& [login, user] : shards_[i].users)
+      visit(user);
+  }
+}
+
+InMemoryUserRepository::Shard& InMemoryUserRepository::ShardFor(
+    const std::string& login) const {
+  return shards_[std::hash<std::string>{}(login) % shard_count_];
+}
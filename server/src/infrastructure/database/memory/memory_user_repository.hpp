@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "user_repository.hpp"
+
+// Пользователи в памяти процесса, шарды по логину со своим shared_mutex.
+// Логин уникален, как ограничение UNIQUE в таблице users.
+class InMemoryUserRepository final : public UserRepository {
+ public:
+  struct Options {
+    std::size_t shards = 16;
+  };
+
+  InMemoryUserRepository() : InMemoryUserRepository(Options{}) {}
+  explicit InMemoryUserRepository(Options options);
+
+  std::expected<User, FindUserError> FindUser(
+      const std::string& login) override;
+  std::expected<User, AddUserError> AddUser(User user) override;
+  std::expected<void, UpdateUserError> UpdatePassword(
+      const std::string& login, const std::string& password) override;
+
+  // Вставляет пользователя с его же id, для восстановления из журнала.
+  // false — логин занят.
+  bool Restore(const User& user);
+  // Обходит пользователей шард за шардом, под разделяемой блокировкой.
+  void ForEach(const std::function<void(const User&)>& visit) const;
+
+ private:
+  struct alignas(64) Shard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, User> users;
+  };
+
+  Shard& ShardFor(const std::string& login) const;
+
+  std::size_t shard_count_;
+  std::unique_ptr<Shard[]> shards_;
+};
@@ -13,49 +13,81 @@ PqxxConnectionPool::ConnectionHolder::~ConnectionHolder() {
 }
 
 PqxxConnectionPool::PqxxConnectionPool(std::string connection_string,
-                                       std::size_t pool_size)
+                                       Options options,
+                                       ConnectionInitializer initializer)
     : connection_string_(std::move(connection_string)),
-      capacity_(pool_size),
-      created_(0) {
-  if (pool_size == 0) {
+      options_(options),
+      initializer_(std::move(initializer)) {
+  if (options_.max_size == 0) {
     throw std::runtime_error("Pool size must be greater than 0");
   }
-  try {
-    auto connection = std::make_unique<pqxx::connection>(connection_string_);
-    if (!connection->is_open()) {
-      throw std::runtime_error("PostgreSQL connection is not open");
-    }
+  if (options_.min_size > options_.max_size) {
+    throw std::runtime_error("Pool min size must not exceed max size");
+  }
+  // Прогрев: соединения, которых ждёт первая волна запросов, открываются
+  // до старта сервера.
+  for (std::size_t i = 0; i < options_.min_size; ++i) {
+    pool_.push(CreateConnection());
     ++created_;
-    BOOST_LOG_TRIVIAL(info) << "pqxx: new connection created";
-    pool_.push(std::move(connection));
-  } catch (const std::exception& e) {
-    throw std::runtime_error(std::string("pqxx connect failed: ") + e.what());
   }
 }
 
 PqxxConnectionPool::ConnectionHolder PqxxConnectionPool::AcquireHolder() {
   ConnectionHolder holder(shared_from_this());
-  {
-    std::unique_lock<std::mutex> lock(mutex_);
-    cv_.wait(lock, [this] { return !pool_.empty() || created_ < capacity_; });
+  const auto start = std::chrono::steady_clock::now();
+  bool waited = false;
 
-    if (!pool_.empty()) {
-      holder.connection = std::move(pool_.front());
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    while (!pool_.empty()) {
+      auto connection = std::move(pool_.front());
       pool_.pop();
-      return holder;
+      if (connection->is_open()) {
+        holder.connection = std::move(connection);
+        ++stats_.acquired;
+        if (waited)
+          RecordWait(std::chrono::steady_clock::now() - start);
+        return holder;
+      }
+      --created_;
+      ++stats_.broken;
+      BOOST_LOG_TRIVIAL(warning) << "pqxx: dropped broken idle connection";
     }
 
-    try {
-      holder.connection =
-          std::make_unique<pqxx::connection>(connection_string_);
-      if (!holder.connection->is_open()) {
-        throw std::runtime_error("PostgreSQL connection is not open");
-      }
+    if (created_ < options_.max_size) {
+      // Место резервируется под мьютексом, а TCP и аутентификация идут без
+      // него, чтобы не блокировать остальных.
       ++created_;
-      BOOST_LOG_TRIVIAL(info) << "pqxx: new connection created";
+      lock.unlock();
+      try {
+        holder.connection = CreateConnection();
+      } catch (...) {
+        lock.lock();
+        --created_;
+        cv_.notify_one();
+        throw;
+      }
+      lock.lock();
+      ++stats_.acquired;
+      if (waited)
+        RecordWait(std::chrono::steady_clock::now() - start);
       return holder;
-    } catch (const std::exception& e) {
-      throw std::runtime_error(std::string("pqxx connect failed: ") + e.what());
+    }
+
+    if (!waited) {
+      waited = true;
+      ++stats_.waits;
+    }
+    const bool ready =
+        cv_.wait_until(lock, start + options_.acquire_timeout, [this] {
+          return !pool_.empty() || created_ < options_.max_size;
+        });
+    if (!ready) {
+      ++stats_.timeouts;
+      RecordWait(std::chrono::steady_clock::now() - start);
+      throw PoolTimeoutError("pqxx: no free connection within " +
+                             std::to_string(options_.acquire_timeout.count()) +
+                             "ms");
     }
   }
 }
@@ -64,6 +96,47 @@ void PqxxConnectionPool::Release(std::unique_ptr<pqxx::connection> connection) {
   if (connection == nullptr)
     return;
   std::lock_guard<std::mutex> lock(mutex_);
-  pool_.push(std::move(connection));
+  if (connection->is_open()) {
+    pool_.push(std::move(connection));
+  } else {
+    --created_;
+    ++stats_.broken;
+    BOOST_LOG_TRIVIAL(warning) << "pqxx: dropped broken connection";
+  }
   cv_.notify_one();
-}
\ No newline at end of file
+}
+
+PqxxConnectionPool::Stats PqxxConnectionPool::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.idle = pool_.size();
+  stats.created = created_;
+  stats.in_use = created_ - pool_.size();
+  return stats;
+}
+
+void PqxxConnectionPool::RecordWait(std::chrono::steady_clock::duration waited) {
+  std::size_t bucket = 0;
+  while (bucket < kWaitBuckets.size() && waited > kWaitBuckets[bucket]) {
+    ++bucket;
+  }
+  ++stats_.wait_histogram[bucket];
+  stats_.wait_time +=
+      std::chrono::duration_cast<std::chrono::nanoseconds>(waited);
+}
+
+std::unique_ptr<pqxx::connection> PqxxConnectionPool::CreateConnection() {
+  try {
+    auto connection = std::make_unique<pqxx::connection>(connection_string_);
+    if (!connection->is_open()) {
+      throw std::runtime_error("PostgreSQL connection is not open");
+    }
+    if (initializer_) {
+      initializer_(*connection);
+    }
+    BOOST_LOG_TRIVIAL(info) << "pqxx: new connection created";
+    return connection;
+  } catch (const std::exception& e) {
+    throw std::runtime_error(std::string("pqxx connect failed: ") + e.what());
+  }
+}
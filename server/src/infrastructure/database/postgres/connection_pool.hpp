@@ -1,18 +1,62 @@
 #pragma once
 
+#include <array>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <pqxx/pqxx>
 #include <queue>
+#include <stdexcept>
 #include <string>
 
+// AcquireHolder не дождался свободного соединения за acquire_timeout.
+// Репозитории отдают это отдельной ошибкой, а HTTP-слой — 503.
+class PoolTimeoutError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
 class PqxxConnectionPool
     : public std::enable_shared_from_this<PqxxConnectionPool> {
  public:
-  explicit PqxxConnectionPool(std::string connection_string,
-                              std::size_t pool_size);
+  // Вызывается для каждого нового соединения до выдачи его из пула,
+  // например чтобы подготовить (prepare) запросы репозиториев.
+  using ConnectionInitializer = std::function<void(pqxx::connection&)>;
+
+  struct Options {
+    // Столько соединений открывается в конструкторе.
+    std::size_t min_size = 1;
+    std::size_t max_size = 1;
+    std::chrono::milliseconds acquire_timeout{5000};
+  };
+
+  // Верхние границы корзин гистограммы ожидания; последняя корзина —
+  // всё, что дольше.
+  static constexpr std::array<std::chrono::milliseconds, 6> kWaitBuckets = {
+      std::chrono::milliseconds{1},   std::chrono::milliseconds{5},
+      std::chrono::milliseconds{10},  std::chrono::milliseconds{50},
+      std::chrono::milliseconds{100}, std::chrono::milliseconds{1000}};
+
+  struct Stats {
+    std::size_t in_use = 0;
+    std::size_t idle = 0;
+    std::size_t created = 0;
+    std::uint64_t acquired = 0;
+    // Сколько AcquireHolder ждали соединения и сколько не дождались.
+    std::uint64_t waits = 0;
+    std::uint64_t timeouts = 0;
+    std::uint64_t broken = 0;
+    std::array<std::uint64_t, kWaitBuckets.size() + 1> wait_histogram{};
+    // Суммарное время ожиданий из wait_histogram.
+    std::chrono::nanoseconds wait_time{0};
+  };
+
+  PqxxConnectionPool(std::string connection_string, Options options,
+                     ConnectionInitializer initializer = {});
 
   struct ConnectionHolder {
     ConnectionHolder(std::shared_ptr<PqxxConnectionPool> pool);
@@ -28,14 +72,26 @@ class PqxxConnectionPool
     std::shared_ptr<PqxxConnectionPool> pool_;
   };
 
+  // Бросает PoolTimeoutError, если за acquire_timeout соединение не
+  // освободилось и новое открыть нельзя.
   ConnectionHolder AcquireHolder();
+  // Закрытые (разорванные) соединения не возвращаются в пул, а освобождают
+  // место под новое.
   void Release(std::unique_ptr<pqxx::connection> connection);
 
+  Stats GetStats() const;
+
  private:
+  std::unique_ptr<pqxx::connection> CreateConnection();
+  void RecordWait(std::chrono::steady_clock::duration waited);
+
   std::string connection_string_;
-  std::mutex mutex_;
+  Options options_;
+  ConnectionInitializer initializer_;
+  mutable std::mutex mutex_;
   std::condition_variable cv_;
   std::queue<std::unique_ptr<pqxx::connection>> pool_;
-  std::size_t capacity_;
-  std::size_t created_;
+  // Открытые соединения плюс открываемые прямо сейчас.
+  std::size_t created_ = 0;
+  Stats stats_;
 };
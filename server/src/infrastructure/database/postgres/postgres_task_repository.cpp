@@ -1,9 +1,174 @@
 #include "postgres_task_repository.hpp"
 #include <boost/log/trivial.hpp>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "uuid_field.hpp"
+
+namespace {
+
+constexpr const char* kInsertTask = "task_insert";
+constexpr const char* kSelectTaskById = "task_select_by_id";
+constexpr const char* kSelectTasksByUser = "task_select_by_user";
+constexpr const char* kSelectTasksPage = "task_select_page";
+constexpr const char* kSelectTasksPageAfter = "task_select_page_after";
+constexpr const char* kUpdateTaskStatus = "task_update_status";
+constexpr const char* kDeleteTask = "task_delete";
+constexpr const char* kInsertTasksBatch = "task_insert_batch";
+constexpr const char* kUpdateTasksBatch = "task_update_status_batch";
+constexpr const char* kDeleteTasksBatch = "task_delete_batch";
+
+// Столбец status — smallint со значением TaskStatus (миграция V4).
+int StatusToDb(TaskStatus status) { return static_cast<int>(status); }
+
+Task TaskFromRow(const pqxx::row& row) {
+  const auto status = TaskStatusFromInt(row[4].as<int>());
+  if (!status)
+    throw std::runtime_error("Unknown task status in database");
+  return Task{UuidFromField(row[0]), UuidFromField(row[1]),
+              row[2].as<std::string>(), row[3].as<std::string>(), *status};
+}
+
+// Один kInsertTasksBatch; задачи с новыми id в порядке tasks.
+std::vector<Task> InsertTasks(pqxx::work& txn, const std::vector<Task>& tasks) {
+  std::vector<std::string> user_ids, titles, descriptions;
+  std::vector<int> statuses;
+  for (const auto& task : tasks) {
+    user_ids.push_back(task.GetUserId().ToString());
+    titles.push_back(task.GetTitle());
+    descriptions.push_back(task.GetDescription());
+    statuses.push_back(StatusToDb(task.GetStatus()));
+  }
+  auto r = txn.exec(pqxx::prepped{kInsertTasksBatch},
+                    pqxx::params{user_ids, titles, descriptions, statuses});
+  if (r.size() != tasks.size())
+    throw std::runtime_error("Task batch insert returned wrong row count");
+  std::vector<Task> added;
+  added.reserve(tasks.size());
+  for (std::size_t i = 0; i < tasks.size(); ++i) {
+    added.emplace_back(UuidFromField(r[i][0]), tasks[i].GetUserId(),
+                       tasks[i].GetTitle(), tasks[i].GetDescription(),
+                       tasks[i].GetStatus());
+  }
+  return added;
+}
+
+// Один kUpdateTasksBatch. Для каждого изменения — задача с его статусом или
+// nullopt, если задачи нет. Одну задачу могут обновить несколько раз: в
+// базу уходит последний статус, как при последовательных UPDATE.
+std::vector<std::optional<Task>> UpdateStatuses(
+    pqxx::work& txn,
+    const std::vector<std::pair<Uuid, TaskStatus>>& updates) {
+  std::unordered_map<Uuid, int> last_status;
+  for (const auto& [task_id, status] : updates)
+    last_status[task_id] = StatusToDb(status);
+  std::vector<std::string> ids;
+  std::vector<int> statuses;
+  for (const auto& [task_id, status] : last_status) {
+    ids.push_back(task_id.ToString());
+    statuses.push_back(status);
+  }
+  auto r =
+      txn.exec(pqxx::prepped{kUpdateTasksBatch}, pqxx::params{ids, statuses});
+  std::unordered_map<Uuid, Task> updated;
+  for (const auto& row : r) {
+    Task task = TaskFromRow(row);
+    updated.emplace(task.GetId(), std::move(task));
+  }
+  std::vector<std::optional<Task>> result;
+  result.reserve(updates.size());
+  for (const auto& [task_id, status] : updates) {
+    const auto it = updated.find(task_id);
+    if (it == updated.end()) {
+      result.emplace_back();
+      continue;
+    }
+    const Task& task = it->second;
+    result.emplace_back(Task{task.GetId(), task.GetUserId(), task.GetTitle(),
+                             task.GetDescription(), status});
+  }
+  return result;
+}
+
+// Все изменения пакета завершились с одной ошибкой.
+TaskWriteBatchResult FailedBatch(const TaskWriteBatch& batch, bool timeout) {
+  TaskWriteBatchResult result;
+  result.adds.assign(batch.adds.size(),
+                     std::unexpected(timeout ? AddTaskError::RepositoryTimeout
+                                             : AddTaskError::RepositoryError));
+  result.updates.assign(
+      batch.updates.size(),
+      std::unexpected(timeout ? UpdateTaskError::RepositoryTimeout
+                              : UpdateTaskError::RepositoryError));
+  result.deletes.assign(
+      batch.deletes.size(),
+      std::unexpected(timeout ? DeleteTaskError::RepositoryTimeout
+                              : DeleteTaskError::RepositoryError));
+  return result;
+}
+
+}  // namespace
 
 PostgreSQLTaskRepository::PostgreSQLTaskRepository(
-    std::shared_ptr<PqxxConnectionPool> pool)
-    : pool_(std::move(pool)) {}
+    std::shared_ptr<PqxxConnectionPool> pool,
+    std::shared_ptr<PqxxConnectionPool> read_pool)
+    : pool_(std::move(pool)),
+      read_pool_(read_pool ? std::move(read_pool) : pool_) {}
+
+void PostgreSQLTaskRepository::PrepareStatements(pqxx::connection& connection) {
+  connection.prepare(kInsertTask,
+                     "INSERT INTO tasks (user_id, title, description, status) "
+                     "VALUES ($1,$2,$3,$4) RETURNING id");
+  connection.prepare(kSelectTaskById,
+                     "SELECT id, user_id, title, description, status FROM "
+                     "tasks WHERE id=$1");
+  // Порядок (status, title, id) берётся из индекса
+  // idx_tasks_user_status_title (миграция V5): значение status — приоритет,
+  // заголовки сравниваются побайтно (COLLATE "C"), как в InMemory-хранилище,
+  // а не по правилам локали базы. Следующая страница начинается строго после
+  // ключа последней задачи предыдущей.
+  connection.prepare(kSelectTasksByUser,
+                     "SELECT id, user_id, title, description, status FROM "
+                     "tasks WHERE user_id=$1 "
+                     "ORDER BY status, title COLLATE \"C\", id");
+  connection.prepare(kSelectTasksPage,
+                     "SELECT id, user_id, title, description, status FROM "
+                     "tasks WHERE user_id=$1 "
+                     "ORDER BY status, title COLLATE \"C\", id LIMIT $2");
+  connection.prepare(
+      kSelectTasksPageAfter,
+      "SELECT id, user_id, title, description, status FROM tasks "
+      "WHERE user_id=$1 AND (status, title COLLATE \"C\", id) > "
+      "($3::smallint, $4::text, $5::uuid) "
+      "ORDER BY status, title COLLATE \"C\", id LIMIT $2");
+  connection.prepare(kUpdateTaskStatus,
+                     "UPDATE tasks SET status=$2 WHERE id=$1 RETURNING id, "
+                     "user_id, title, description, status");
+  connection.prepare(kDeleteTask,
+                     "DELETE FROM tasks WHERE id=$1 RETURNING id, user_id, "
+                     "title, description, status");
+  // Пакетные записи: массивы параметров разворачиваются unnest. Порядок
+  // строк RETURNING не гарантирован, поэтому id новых задач генерирует
+  // gen_random_uuid() в материализованном CTE, и они возвращаются в порядке
+  // массивов (WITH ORDINALITY).
+  connection.prepare(
+      kInsertTasksBatch,
+      "WITH rows AS MATERIALIZED (SELECT gen_random_uuid() AS id, u.* FROM "
+      "unnest($1::uuid[], $2::text[], $3::text[], $4::smallint[]) "
+      "WITH ORDINALITY AS u(user_id, title, description, status, n)), "
+      "inserted AS (INSERT INTO tasks (id, user_id, title, description, "
+      "status) SELECT id, user_id, title, description, status FROM rows) "
+      "SELECT id FROM rows ORDER BY n");
+  connection.prepare(kUpdateTasksBatch,
+                     "UPDATE tasks AS t SET status=u.status FROM "
+                     "unnest($1::uuid[], $2::smallint[]) AS u(id, status) "
+                     "WHERE t.id=u.id RETURNING t.id, t.user_id, t.title, "
+                     "t.description, t.status");
+  connection.prepare(kDeleteTasksBatch,
+                     "DELETE FROM tasks WHERE id=ANY($1::uuid[]) RETURNING "
+                     "id, user_id, title, description, status");
+}
 
 std::expected<Task, AddTaskError> PostgreSQLTaskRepository::AddTask(
     const Task& task) {
@@ -11,17 +176,18 @@ std::expected<Task, AddTaskError> PostgreSQLTaskRepository::AddTask(
     auto holder = pool_->AcquireHolder();
     pqxx::work txn(*holder.connection);
     auto r = txn.exec(
-        "INSERT INTO tasks (user_id, title, description, status) VALUES "
-        "($1,$2,$3,$4) RETURNING id",
-        pqxx::params{task.GetUserId(), task.GetTitle(), task.GetDescription(),
-                     task.GetStatus()});
+        pqxx::prepped{kInsertTask},
+        pqxx::params{task.GetUserId().ToString(), task.GetTitle(),
+                     task.GetDescription(), StatusToDb(task.GetStatus())});
     if (r.empty()) {
       return std::unexpected(AddTaskError::RepositoryError);
     }
-    std::string id = r[0][0].as<std::string>();
+    const Uuid id = UuidFromField(r[0][0]);
     txn.commit();
     return Task{id, task.GetUserId(), task.GetTitle(), task.GetDescription(),
                 task.GetStatus()};
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(AddTaskError::RepositoryTimeout);
   } catch (const pqxx::unique_violation&) {
     return std::unexpected(AddTaskError::AlreadyExists);
   } catch (...) {
@@ -30,78 +196,229 @@ std::expected<Task, AddTaskError> PostgreSQLTaskRepository::AddTask(
 }
 
 std::expected<Task, FindTaskError> PostgreSQLTaskRepository::GetTaskById(
-    const std::string& task_id) {
+    const Uuid& task_id) {
   try {
-    auto holder = pool_->AcquireHolder();
-    pqxx::work txn(*holder.connection);
-    auto r = txn.exec(
-        "SELECT id, user_id, title, description, status FROM tasks WHERE id=$1",
-        pqxx::params{task_id});
+    auto holder = read_pool_->AcquireHolder();
+    // Один оператор: BEGIN/COMMIT не нужны.
+    pqxx::nontransaction txn(*holder.connection);
+    auto r = txn.exec(pqxx::prepped{kSelectTaskById},
+                      pqxx::params{task_id.ToString()});
     if (r.empty())
       return std::unexpected(FindTaskError::NotFound);
     auto row = r[0];
-    return Task{row[0].as<std::string>(), row[1].as<std::string>(),
-                row[2].as<std::string>(), row[3].as<std::string>(),
-                row[4].as<std::string>()};
+    return TaskFromRow(row);
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(FindTaskError::RepositoryTimeout);
   } catch (...) {
     return std::unexpected(FindTaskError::RepositoryError);
   }
 }
 
 std::expected<std::vector<Task>, FindTaskError>
-PostgreSQLTaskRepository::GetTasksByUser(const std::string& user_id) {
+PostgreSQLTaskRepository::GetTasksByUser(const Uuid& user_id) {
   try {
-    auto holder = pool_->AcquireHolder();
-    pqxx::work txn(*holder.connection);
-    auto r = txn.exec(
-        "SELECT id, user_id, title, description, status FROM tasks WHERE "
-        "user_id=$1 ORDER BY id",
-        pqxx::params{user_id});
+    auto holder = read_pool_->AcquireHolder();
+    pqxx::nontransaction txn(*holder.connection);
+    auto r = txn.exec(pqxx::prepped{kSelectTasksByUser},
+                      pqxx::params{user_id.ToString()});
+    std::vector<Task> tasks;
+    tasks.reserve(r.size());
+    for (const auto& row : r) {
+      tasks.push_back(TaskFromRow(row));
+    }
+    return tasks;
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(FindTaskError::RepositoryTimeout);
+  } catch (...) {
+    return std::unexpected(FindTaskError::RepositoryError);
+  }
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+PostgreSQLTaskRepository::GetTasksByUserPage(
+    const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+    std::size_t limit) {
+  try {
+    auto holder = read_pool_->AcquireHolder();
+    pqxx::nontransaction txn(*holder.connection);
+    const auto page_size = static_cast<long>(limit);
+    auto r = after ? txn.exec(pqxx::prepped{kSelectTasksPageAfter},
+                              pqxx::params{user_id.ToString(), page_size,
+                                           StatusToDb(after->status),
+                                           after->title,
+                                           after->task_id.ToString()})
+                   : txn.exec(pqxx::prepped{kSelectTasksPage},
+                              pqxx::params{user_id.ToString(), page_size});
     std::vector<Task> tasks;
     tasks.reserve(r.size());
     for (const auto& row : r) {
-      tasks.emplace_back(row[0].as<std::string>(), row[1].as<std::string>(),
-                         row[2].as<std::string>(), row[3].as<std::string>(),
-                         row[4].as<std::string>());
+      tasks.push_back(TaskFromRow(row));
     }
     return tasks;
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(FindTaskError::RepositoryTimeout);
   } catch (...) {
     return std::unexpected(FindTaskError::RepositoryError);
   }
 }
 
 std::expected<Task, UpdateTaskError> PostgreSQLTaskRepository::UpdateTaskStatus(
-    const std::string& task_id, const std::string& status) {
+    const Uuid& task_id, TaskStatus status) {
   try {
     auto holder = pool_->AcquireHolder();
     pqxx::work txn(*holder.connection);
-    auto r = txn.exec(
-        "UPDATE tasks SET status=$2 WHERE id=$1 RETURNING id, user_id, title, "
-        "description, status",
-        pqxx::params{task_id, status});
+    auto r = txn.exec(pqxx::prepped{kUpdateTaskStatus},
+                      pqxx::params{task_id.ToString(), StatusToDb(status)});
     if (r.empty())
       return std::unexpected(UpdateTaskError::NotFound);
     auto row = r[0];
     txn.commit();
-    return Task{row[0].as<std::string>(), row[1].as<std::string>(),
-                row[2].as<std::string>(), row[3].as<std::string>(),
-                row[4].as<std::string>()};
+    return TaskFromRow(row);
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(UpdateTaskError::RepositoryTimeout);
   } catch (...) {
     return std::unexpected(UpdateTaskError::RepositoryError);
   }
 }
 
-std::expected<void, DeleteTaskError> PostgreSQLTaskRepository::DeleteTaskById(
-    const std::string& task_id) {
+std::expected<Task, DeleteTaskError> PostgreSQLTaskRepository::DeleteTaskById(
+    const Uuid& task_id) {
   try {
     auto holder = pool_->AcquireHolder();
     pqxx::work txn(*holder.connection);
-    auto r = txn.exec("DELETE FROM tasks WHERE id=$1", pqxx::params{task_id});
-    if (r.affected_rows() == 0)
+    auto r = txn.exec(pqxx::prepped{kDeleteTask},
+                      pqxx::params{task_id.ToString()});
+    if (r.empty())
       return std::unexpected(DeleteTaskError::NotFound);
+    auto row = r[0];
     txn.commit();
-    return {};
+    return TaskFromRow(row);
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(DeleteTaskError::RepositoryTimeout);
   } catch (...) {
     return std::unexpected(DeleteTaskError::RepositoryError);
   }
 }
+
+std::expected<std::vector<Task>, AddTaskError>
+PostgreSQLTaskRepository::AddTasks(const std::vector<Task>& tasks) {
+  if (tasks.empty())
+    return std::vector<Task>{};
+  try {
+    auto holder = pool_->AcquireHolder();
+    pqxx::work txn(*holder.connection);
+    auto created = InsertTasks(txn, tasks);
+    txn.commit();
+    return created;
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(AddTaskError::RepositoryTimeout);
+  } catch (const pqxx::unique_violation&) {
+    return std::unexpected(AddTaskError::AlreadyExists);
+  } catch (...) {
+    return std::unexpected(AddTaskError::RepositoryError);
+  }
+}
+
+std::expected<std::vector<Task>, UpdateTaskError>
+PostgreSQLTaskRepository::UpdateTaskStatuses(
+    const std::vector<std::pair<Uuid, TaskStatus>>& updates) {
+  if (updates.empty())
+    return std::vector<Task>{};
+  try {
+    auto holder = pool_->AcquireHolder();
+    pqxx::work txn(*holder.connection);
+    std::vector<Task> updated;
+    updated.reserve(updates.size());
+    for (auto& task : UpdateStatuses(txn, updates)) {
+      // Без commit транзакция откатится, и уже применённые изменения тоже.
+      if (!task)
+        return std::unexpected(UpdateTaskError::NotFound);
+      updated.push_back(std::move(*task));
+    }
+    txn.commit();
+    return updated;
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(UpdateTaskError::RepositoryTimeout);
+  } catch (...) {
+    return std::unexpected(UpdateTaskError::RepositoryError);
+  }
+}
+
+TaskWriteBatchResult PostgreSQLTaskRepository::WriteBatch(
+    const TaskWriteBatch& batch) {
+  try {
+    return WriteBatchInTransaction(batch);
+  } catch (const PoolTimeoutError&) {
+    return FailedBatch(batch, /*timeout=*/true);
+  } catch (const pqxx::in_doubt_error&) {
+    // Неизвестно, применился ли COMMIT: повтор мог бы добавить задачи
+    // дважды.
+    return FailedBatch(batch, /*timeout=*/false);
+  } catch (const std::exception& e) {
+    BOOST_LOG_TRIVIAL(warning)
+        << "Task write batch failed, retrying one by one: " << e.what();
+  }
+  return WriteOneByOne(batch);
+}
+
+TaskWriteBatchResult PostgreSQLTaskRepository::WriteBatchInTransaction(
+    const TaskWriteBatch& batch) {
+  TaskWriteBatchResult result;
+  auto holder = pool_->AcquireHolder();
+  pqxx::work txn(*holder.connection);
+
+  if (!batch.adds.empty()) {
+    for (auto& task : InsertTasks(txn, batch.adds))
+      result.adds.emplace_back(std::move(task));
+  }
+
+  if (!batch.updates.empty()) {
+    for (auto& task : UpdateStatuses(txn, batch.updates)) {
+      if (!task) {
+        result.updates.emplace_back(
+            std::unexpected(UpdateTaskError::NotFound));
+        continue;
+      }
+      result.updates.emplace_back(std::move(*task));
+    }
+  }
+
+  if (!batch.deletes.empty()) {
+    std::vector<std::string> ids;
+    for (const auto& task_id : batch.deletes)
+      ids.push_back(task_id.ToString());
+    auto r = txn.exec(pqxx::prepped{kDeleteTasksBatch}, pqxx::params{ids});
+    std::unordered_map<Uuid, Task> deleted;
+    for (const auto& row : r) {
+      Task task = TaskFromRow(row);
+      deleted.emplace(task.GetId(), std::move(task));
+    }
+    // Повторное удаление той же задачи — NotFound, как при
+    // последовательных DELETE.
+    for (const auto& task_id : batch.deletes) {
+      const auto it = deleted.find(task_id);
+      if (it == deleted.end()) {
+        result.deletes.emplace_back(
+            std::unexpected(DeleteTaskError::NotFound));
+        continue;
+      }
+      result.deletes.emplace_back(std::move(it->second));
+      deleted.erase(it);
+    }
+  }
+
+  txn.commit();
+  return result;
+}
+
+TaskWriteBatchResult PostgreSQLTaskRepository::WriteOneByOne(
+    const TaskWriteBatch& batch) {
+  TaskWriteBatchResult result;
+  for (const auto& task : batch.adds)
+    result.adds.push_back(AddTask(task));
+  for (const auto& [task_id, status] : batch.updates)
+    result.updates.push_back(UpdateTaskStatus(task_id, status));
+  for (const auto& task_id : batch.deletes)
+    result.deletes.push_back(DeleteTaskById(task_id));
+  return result;
+}
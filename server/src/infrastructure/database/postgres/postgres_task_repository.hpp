@@ -1,28 +1,59 @@
 #pragma once
 
+#include <cstddef>
 #include <expected>
+#include <optional>
 #include <pqxx/pqxx>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "task_batch_writer.hpp"
 #include "task_repository.hpp"
 #include "connection_pool.hpp"
 
-class PostgreSQLTaskRepository : public TaskRepository {
+class PostgreSQLTaskRepository : public TaskRepository,
+                                 public TaskBatchWriter {
  public:
-  explicit PostgreSQLTaskRepository(std::shared_ptr<PqxxConnectionPool> pool);
+  // read_pool — необязательный пул реплики для GetTaskById и
+  // GetTasksByUser; без него чтения идут в основной пул.
+  explicit PostgreSQLTaskRepository(
+      std::shared_ptr<PqxxConnectionPool> pool,
+      std::shared_ptr<PqxxConnectionPool> read_pool = nullptr);
   ~PostgreSQLTaskRepository() override = default;
 
+  // Готовит запросы репозитория на соединении; передаётся в
+  // PqxxConnectionPool как инициализатор соединений.
+  static void PrepareStatements(pqxx::connection& connection);
+
   std::expected<Task, AddTaskError> AddTask(const Task& task) override;
   std::expected<Task, FindTaskError> GetTaskById(
-      const std::string& task_id) override;
+      const Uuid& task_id) override;
   std::expected<std::vector<Task>, FindTaskError> GetTasksByUser(
-      const std::string& user_id) override;
+      const Uuid& user_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUserPage(
+      const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+      std::size_t limit) override;
   std::expected<Task, UpdateTaskError> UpdateTaskStatus(
-      const std::string& task_id, const std::string& status) override;
-  std::expected<void, DeleteTaskError> DeleteTaskById(
-      const std::string& task_id) override;
+      const Uuid& task_id, TaskStatus status) override;
+  std::expected<Task, DeleteTaskError> DeleteTaskById(
+      const Uuid& task_id) override;
+  std::expected<std::vector<Task>, AddTaskError> AddTasks(
+      const std::vector<Task>& tasks) override;
+  std::expected<std::vector<Task>, UpdateTaskError> UpdateTaskStatuses(
+      const std::vector<std::pair<Uuid, TaskStatus>>& updates)
+      override;
+
+  // Один INSERT/UPDATE/DELETE по массивам (unnest) на вид изменений, всё в
+  // одной транзакции. Если транзакция откатилась (например, задача
+  // несуществующего пользователя), изменения повторяются по одному, и
+  // ошибку получает только виновник.
+  TaskWriteBatchResult WriteBatch(const TaskWriteBatch& batch) override;
 
  private:
+  TaskWriteBatchResult WriteBatchInTransaction(const TaskWriteBatch& batch);
+  TaskWriteBatchResult WriteOneByOne(const TaskWriteBatch& batch);
+
   std::shared_ptr<PqxxConnectionPool> pool_;
+  std::shared_ptr<PqxxConnectionPool> read_pool_;
 };
@@ -1,26 +1,49 @@
 #include "postgres_user_repository.hpp"
 #include <boost/log/trivial.hpp>
 
+#include "uuid_field.hpp"
+
+namespace {
+
+constexpr const char* kFindUser = "user_find";
+constexpr const char* kInsertUser = "user_insert";
+constexpr const char* kUpdatePassword = "user_update_password";
+
+}  // namespace
+
 PostgreSQLUserRepository::PostgreSQLUserRepository(
     std::shared_ptr<PqxxConnectionPool> pool)
     : pool_(std::move(pool)) {}
 
+void PostgreSQLUserRepository::PrepareStatements(pqxx::connection& connection) {
+  connection.prepare(kFindUser,
+                     "SELECT id, username, password FROM users WHERE "
+                     "username = $1");
+  connection.prepare(kInsertUser,
+                     "INSERT INTO users (username, password) VALUES ($1, $2) "
+                     "RETURNING id");
+  connection.prepare(kUpdatePassword,
+                     "UPDATE users SET password = $2 WHERE username = $1");
+}
+
 std::expected<User, FindUserError> PostgreSQLUserRepository::FindUser(
     const std::string& login) {
   try {
+    // Логин сразу после регистрации должен видеть пользователя, поэтому
+    // чтение идёт в основной пул, а не в реплику.
     auto holder = pool_->AcquireHolder();
-    pqxx::work txn(*holder.connection);
-    auto result =
-        txn.exec("SELECT id, username, password FROM users WHERE username = $1",
-                 pqxx::params{login});
+    pqxx::nontransaction txn(*holder.connection);
+    auto result = txn.exec(pqxx::prepped{kFindUser}, pqxx::params{login});
     if (result.empty()) {
       return std::unexpected(FindUserError::NotFound);
     }
     auto row = result[0];
-    std::string uuid = row[0].as<std::string>();
+    Uuid uuid = UuidFromField(row[0]);
     std::string username = row[1].as<std::string>();
     std::string password = row[2].as<std::string>();
     return User{uuid, username, password};
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(FindUserError::RepositoryTimeout);
   } catch (const std::exception&) {
     return std::unexpected(FindUserError::RepositoryError);
   }
@@ -30,18 +53,38 @@ std::expected<User, AddUserError> PostgreSQLUserRepository::AddUser(User user) {
   try {
     auto holder = pool_->AcquireHolder();
     pqxx::work txn(*holder.connection);
-    auto result = txn.exec(
-        "INSERT INTO users (username, password) VALUES ($1, $2) RETURNING id",
-        pqxx::params{user.GetName(), user.GetPassword()});
+    auto result = txn.exec(pqxx::prepped{kInsertUser},
+                           pqxx::params{user.GetName(), user.GetPassword()});
     if (result.empty()) {
       return std::unexpected(AddUserError::RepositoryError);
     }
-    std::string uuid = result[0][0].as<std::string>();
+    Uuid uuid = UuidFromField(result[0][0]);
     txn.commit();
     return User{uuid, user.GetName(), user.GetPassword()};
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(AddUserError::RepositoryTimeout);
   } catch (const pqxx::unique_violation&) {
     return std::unexpected(AddUserError::AlreadyExists);
   } catch (const std::exception&) {
     return std::unexpected(AddUserError::RepositoryError);
   }
 }
+
+std::expected<void, UpdateUserError> PostgreSQLUserRepository::UpdatePassword(
+    const std::string& login, const std::string& password) {
+  try {
+    auto holder = pool_->AcquireHolder();
+    pqxx::work txn(*holder.connection);
+    auto result = txn.exec(pqxx::prepped{kUpdatePassword},
+                           pqxx::params{login, password});
+    if (result.affected_rows() == 0) {
+      return std::unexpected(UpdateUserError::NotFound);
+    }
+    txn.commit();
+    return {};
+  } catch (const PoolTimeoutError&) {
+    return std::unexpected(UpdateUserError::RepositoryTimeout);
+  } catch (const std::exception&) {
+    return std::unexpected(UpdateUserError::RepositoryError);
+  }
+}
@@ -12,9 +12,14 @@ class PostgreSQLUserRepository : public UserRepository {
   explicit PostgreSQLUserRepository(std::shared_ptr<PqxxConnectionPool> pool);
   ~PostgreSQLUserRepository() override = default;
 
+  // См. PostgreSQLTaskRepository::PrepareStatements.
+  static void PrepareStatements(pqxx::connection& connection);
+
   std::expected<User, FindUserError> FindUser(
       const std::string& login) override;
   std::expected<User, AddUserError> AddUser(User user) override;
+  std::expected<void, UpdateUserError> UpdatePassword(
+      const std::string& login, const std::string& password) override;
 
  private:
   std::shared_ptr<PqxxConnectionPool> pool_;
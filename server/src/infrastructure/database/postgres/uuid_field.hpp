@@ -0,0 +1,17 @@
+#pragma once
+
+#include <pqxx/pqxx>
+#include <stdexcept>
+#include <string>
+
+#include "uuid.hpp"
+
+// Postgres отдаёт uuid в канонической записи; разбор без промежуточной
+// std::string.
+inline Uuid UuidFromField(const pqxx::field& field) {
+  const auto id = Uuid::Parse(field.view());
+  if (!id)
+    throw std::runtime_error("Invalid uuid in database: " +
+                             std::string(field.view()));
+  return *id;
+}
@@ -0,0 +1,224 @@
+#include "wal_format.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace {
+
+enum class OpType : std::uint8_t {
+  AddUser = 1,
+  AddTask = 2,
+  UpdateTaskStatus = 3,
+  DeleteTask = 4,
+  UpdateUserPassword = 5,
+};
+
+constexpr std::array<std::uint32_t, 256> kCrc32cTable = [] {
+  std::array<std::uint32_t, 256> table{};
+  for (std::uint32_t i = 0; i < table.size(); ++i) {
+    std::uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc >> 1) ^ (crc & 1 ? 0x82F63B78u : 0);
+    table[i] = crc;
+  }
+  return table;
+}();
+
+void PutU32(std::string& out, std::uint32_t value) {
+  for (int i = 0; i < 4; ++i)
+    out += static_cast<char>(value >> (8 * i));
+}
+
+void PutU64(std::string& out, std::uint64_t value) {
+  for (int i = 0; i < 8; ++i)
+    out += static_cast<char>(value >> (8 * i));
+}
+
+void PutUuid(std::string& out, const Uuid& id) {
+  out.append(reinterpret_cast<const char*>(id.GetBytes().data()),
+             Uuid::kSize);
+}
+
+void PutString(std::string& out, const std::string& value) {
+  PutU32(out, static_cast<std::uint32_t>(value.size()));
+  out += value;
+}
+
+// Чтение с проверкой границ: при нехватке байтов ok становится false, и
+// дальнейшие вызовы ничего не читают.
+class Reader {
+ public:
+  explicit Reader(std::string_view data) : data_(data) {}
+
+  bool Done() const { return data_.empty(); }
+  bool Ok() const { return ok_; }
+
+  std::uint8_t U8() {
+    if (!Need(1))
+      return 0;
+    const auto value = static_cast<std::uint8_t>(data_[0]);
+    data_.remove_prefix(1);
+    return value;
+  }
+
+  Uuid ReadUuid() {
+    if (!Need(Uuid::kSize))
+      return {};
+    Uuid::Bytes bytes;
+    std::memcpy(bytes.data(), data_.data(), Uuid::kSize);
+    data_.remove_prefix(Uuid::kSize);
+    return Uuid{bytes};
+  }
+
+  std::string String() {
+    if (!Need(4))
+      return {};
+    const std::uint32_t size = LoadWalU32(data_.data());
+    data_.remove_prefix(4);
+    if (!Need(size))
+      return {};
+    std::string value(data_.substr(0, size));
+    data_.remove_prefix(size);
+    return value;
+  }
+
+  TaskStatus Status() {
+    const auto status = TaskStatusFromInt(U8());
+    if (!status) {
+      ok_ = false;
+      return TaskStatus::InProgress;
+    }
+    return *status;
+  }
+
+ private:
+  bool Need(std::size_t size) {
+    if (ok_ && data_.size() >= size)
+      return true;
+    ok_ = false;
+    return false;
+  }
+
+  std::string_view data_;
+  bool ok_ = true;
+};
+
+struct OpEncoder {
+  std::string& out;
+
+  void operator()(const WalAddUser& op) {
+    out += static_cast<char>(OpType::AddUser);
+    PutUuid(out, op.user.GetId());
+    PutString(out, op.user.GetName());
+    PutString(out, op.user.GetPassword());
+  }
+  void operator()(const WalAddTask& op) {
+    out += static_cast<char>(OpType::AddTask);
+    PutUuid(out, op.task.GetId());
+    PutUuid(out, op.task.GetUserId());
+    out += static_cast<char>(op.task.GetStatus());
+    PutString(out, op.task.GetTitle());
+    PutString(out, op.task.GetDescription());
+  }
+  void operator()(const WalUpdateTaskStatus& op) {
+    out += static_cast<char>(OpType::UpdateTaskStatus);
+    PutUuid(out, op.task_id);
+    out += static_cast<char>(op.status);
+  }
+  void operator()(const WalDeleteTask& op) {
+    out += static_cast<char>(OpType::DeleteTask);
+    PutUuid(out, op.task_id);
+  }
+  void operator()(const WalUpdateUserPassword& op) {
+    out += static_cast<char>(OpType::UpdateUserPassword);
+    PutString(out, op.login);
+    PutString(out, op.password);
+  }
+};
+
+}  // namespace
+
+std::uint32_t Crc32c(std::string_view data) {
+  std::uint32_t crc = 0xFFFFFFFFu;
+  for (const char c : data) {
+    crc = (crc >> 8) ^
+          kCrc32cTable[(crc ^ static_cast<std::uint8_t>(c)) & 0xFF];
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+void AppendWalHeader(std::string& out, std::string_view magic,
+                     std::uint64_t generation) {
+  out += magic;
+  PutU64(out, generation);
+}
+
+std::int64_t ReadWalHeader(std::string_view data, std::string_view magic) {
+  if (data.size() < kWalHeaderSize || !data.starts_with(magic))
+    return -1;
+  std::uint64_t generation = 0;
+  for (int i = 7; i >= 0; --i) {
+    generation = generation << 8 |
+                 static_cast<std::uint8_t>(data[magic.size() + i]);
+  }
+  return static_cast<std::int64_t>(generation);
+}
+
+void AppendWalRecord(std::string& out, const std::vector<WalOp>& ops) {
+  const std::size_t header = out.size();
+  out.append(kWalRecordHeaderSize, '\0');
+  OpEncoder encoder{out};
+  for (const auto& op : ops)
+    std::visit(encoder, op);
+
+  const std::string_view payload(out.data() + header + kWalRecordHeaderSize,
+                                 out.size() - header - kWalRecordHeaderSize);
+  std::string prefix;
+  PutU32(prefix, static_cast<std::uint32_t>(payload.size()));
+  PutU32(prefix, Crc32c(payload));
+  out.replace(header, kWalRecordHeaderSize, prefix);
+}
+
+bool DecodeWalRecord(std::string_view payload, std::vector<WalOp>& ops) {
+  Reader reader(payload);
+  while (reader.Ok() && !reader.Done()) {
+    switch (static_cast<OpType>(reader.U8())) {
+      case OpType::AddUser: {
+        const Uuid id = reader.ReadUuid();
+        std::string name = reader.String();
+        std::string password = reader.String();
+        ops.emplace_back(WalAddUser{User{id, std::move(name),
+                                         std::move(password)}});
+        break;
+      }
+      case OpType::AddTask: {
+        const Uuid id = reader.ReadUuid();
+        const Uuid user_id = reader.ReadUuid();
+        const TaskStatus status = reader.Status();
+        std::string title = reader.String();
+        std::string description = reader.String();
+        ops.emplace_back(WalAddTask{Task{id, user_id, std::move(title),
+                                         std::move(description), status}});
+        break;
+      }
+      case OpType::UpdateTaskStatus: {
+        const Uuid id = reader.ReadUuid();
+        ops.emplace_back(WalUpdateTaskStatus{id, reader.Status()});
+        break;
+      }
+      case OpType::DeleteTask:
+        ops.emplace_back(WalDeleteTask{reader.ReadUuid()});
+        break;
+      case OpType::UpdateUserPassword: {
+        std::string login = reader.String();
+        std::string password = reader.String();
+        ops.emplace_back(
+            WalUpdateUserPassword{std::move(login), std::move(password)});
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return reader.Ok() && !ops.empty();
+}
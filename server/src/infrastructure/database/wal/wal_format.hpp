@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "task.hpp"
+#include "user.hpp"
+
+// Формат журнала и снимка. Файл — заголовок (kHeaderSize байт: магия и
+// поколение) и записи подряд. Запись — [u32 длина][u32 crc32c][операции];
+// одна запись — одно изменение (пакет целиком), поэтому при восстановлении
+// оно применяется полностью или не применяется. Числа — little-endian.
+
+struct WalAddUser {
+  User user;
+};
+
+struct WalUpdateUserPassword {
+  std::string login;
+  std::string password;
+};
+
+struct WalAddTask {
+  Task task;
+};
+
+struct WalUpdateTaskStatus {
+  Uuid task_id;
+  TaskStatus status;
+};
+
+struct WalDeleteTask {
+  Uuid task_id;
+};
+
+using WalOp = std::variant<WalAddUser, WalAddTask, WalUpdateTaskStatus,
+                           WalDeleteTask, WalUpdateUserPassword>;
+
+inline constexpr std::string_view kWalLogMagic = "TMWALLOG";
+inline constexpr std::string_view kWalSnapshotMagic = "TMWALSNP";
+inline constexpr std::size_t kWalHeaderSize = 16;
+inline constexpr std::size_t kWalRecordHeaderSize = 8;
+
+std::uint32_t Crc32c(std::string_view data);
+
+void AppendWalHeader(std::string& out, std::string_view magic,
+                     std::uint64_t generation);
+// Поколение из заголовка или -1, если заголовок не тот.
+std::int64_t ReadWalHeader(std::string_view data, std::string_view magic);
+
+// Дописывает в out одну запись со всеми ops.
+void AppendWalRecord(std::string& out, const std::vector<WalOp>& ops);
+
+struct WalParseResult {
+  // Байты, занятые целыми записями с верной контрольной суммой. Всё, что
+  // дальше, — недописанный или повреждённый хвост.
+  std::size_t valid_bytes = 0;
+  std::size_t records = 0;
+};
+
+// Операции одной записи; false — запись повреждена.
+bool DecodeWalRecord(std::string_view payload, std::vector<WalOp>& ops);
+
+inline std::uint32_t LoadWalU32(const char* data) {
+  const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+  return static_cast<std::uint32_t>(bytes[0]) |
+         static_cast<std::uint32_t>(bytes[1]) << 8 |
+         static_cast<std::uint32_t>(bytes[2]) << 16 |
+         static_cast<std::uint32_t>(bytes[3]) << 24;
+}
+
+// Разбирает записи из data (без заголовка файла) и передаёт операции
+// каждой записи в apply.
+template <class Apply>
+WalParseResult ParseWalRecords(std::string_view data, Apply&& apply) {
+  WalParseResult result;
+  std::vector<WalOp> ops;
+  while (data.size() - result.valid_bytes >= kWalRecordHeaderSize) {
+    const char* header = data.data() + result.valid_bytes;
+    const std::uint32_t size = LoadWalU32(header);
+    const std::uint32_t crc = LoadWalU32(header + 4);
+    const std::size_t available =
+        data.size() - result.valid_bytes - kWalRecordHeaderSize;
+    if (size == 0 || size > available)
+      break;
+    const auto payload =
+        data.substr(result.valid_bytes + kWalRecordHeaderSize, size);
+    ops.clear();
+    if (Crc32c(payload) != crc || !DecodeWalRecord(payload, ops))
+      break;
+    apply(ops);
+    result.valid_bytes += kWalRecordHeaderSize + size;
+    ++result.records;
+  }
+  return result;
+}
@@ -0,0 +1,126 @@
+#include "wal_repositories.hpp"
+
+namespace {
+
+// Выполняет change в WalStorage::Commit. change возвращает результат
+// операции в памяти и дописывает в ops операции для журнала.
+template <class T, class E, class Change>
+std::expected<T, E> CommitChange(WalStorage& storage, Change&& change) {
+  std::optional<std::expected<T, E>> result;
+  const bool durable = storage.Commit(
+      [&](std::vector<WalOp>& ops) { result.emplace(change(ops)); });
+  if (!durable || !result)
+    return std::unexpected(E::RepositoryError);
+  return std::move(*result);
+}
+
+}  // namespace
+
+WalTaskRepository::WalTaskRepository(std::shared_ptr<WalStorage> storage)
+    : storage_(std::move(storage)) {}
+
+std::expected<Task, AddTaskError> WalTaskRepository::AddTask(
+    const Task& task) {
+  return CommitChange<Task, AddTaskError>(
+      *storage_, [&](std::vector<WalOp>& ops) {
+        auto added = storage_->Tasks().AddTask(task);
+        if (added)
+          ops.emplace_back(WalAddTask{*added});
+        return added;
+      });
+}
+
+std::expected<Task, FindTaskError> WalTaskRepository::GetTaskById(
+    const Uuid& task_id) {
+  return storage_->Tasks().GetTaskById(task_id);
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+WalTaskRepository::GetTasksByUser(const Uuid& user_id) {
+  return storage_->Tasks().GetTasksByUser(user_id);
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+WalTaskRepository::GetTasksByUserPage(
+    const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+    std::size_t limit) {
+  return storage_->Tasks().GetTasksByUserPage(user_id, after, limit);
+}
+
+std::expected<Task, UpdateTaskError> WalTaskRepository::UpdateTaskStatus(
+    const Uuid& task_id, TaskStatus status) {
+  return CommitChange<Task, UpdateTaskError>(
+      *storage_, [&](std::vector<WalOp>& ops) {
+        auto updated = storage_->Tasks().UpdateTaskStatus(task_id, status);
+        if (updated)
+          ops.emplace_back(WalUpdateTaskStatus{task_id, status});
+        return updated;
+      });
+}
+
+std::expected<Task, DeleteTaskError> WalTaskRepository::DeleteTaskById(
+    const Uuid& task_id) {
+  return CommitChange<Task, DeleteTaskError>(
+      *storage_, [&](std::vector<WalOp>& ops) {
+        auto deleted = storage_->Tasks().DeleteTaskById(task_id);
+        if (deleted)
+          ops.emplace_back(WalDeleteTask{task_id});
+        return deleted;
+      });
+}
+
+std::expected<std::vector<Task>, AddTaskError> WalTaskRepository::AddTasks(
+    const std::vector<Task>& tasks) {
+  return CommitChange<std::vector<Task>, AddTaskError>(
+      *storage_, [&](std::vector<WalOp>& ops) {
+        auto added = storage_->Tasks().AddTasks(tasks);
+        if (added) {
+          for (const auto& task : *added)
+            ops.emplace_back(WalAddTask{task});
+        }
+        return added;
+      });
+}
+
+std::expected<std::vector<Task>, UpdateTaskError>
+WalTaskRepository::UpdateTaskStatuses(
+    const std::vector<std::pair<Uuid, TaskStatus>>& updates) {
+  return CommitChange<std::vector<Task>, UpdateTaskError>(
+      *storage_, [&](std::vector<WalOp>& ops) {
+        auto updated = storage_->Tasks().UpdateTaskStatuses(updates);
+        if (updated) {
+          for (const auto& [task_id, status] : updates)
+            ops.emplace_back(WalUpdateTaskStatus{task_id, status});
+        }
+        return updated;
+      });
+}
+
+WalUserRepository::WalUserRepository(std::shared_ptr<WalStorage> storage)
+    : storage_(std::move(storage)) {}
+
+std::expected<User, FindUserError> WalUserRepository::FindUser(
+    const std::string& login) {
+  return storage_->Users().FindUser(login);
+}
+
+std::expected<User, AddUserError> WalUserRepository::AddUser(User user) {
+  return CommitChange<User, AddUserError>(
+      *storage_, [&](std::vector<WalOp>& ops) {
+        auto added = storage_->Users().AddUser(std::move(user));
+        if (added)
+          ops.emplace_back(WalAddUser{*added});
+        return added;
+      });
+}
+
+std::expected<void, UpdateUserError> WalUserRepository::UpdatePassword(
+    const std::string& login, const std::string& password) {
+  return CommitChange<void, UpdateUserError>(
+      *storage_, [&](std::vector<WalOp>& ops) {
+        auto updated = storage_->Users().UpdatePassword(login, password);
+        if (updated)
+          ops.emplace_back(WalUpdateUserPassword{login, password});
+        return updated;
+      });
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "task_repository.hpp"
+#include "user_repository.hpp"
+#include "wal_storage.hpp"
+
+// Репозитории поверх WalStorage: чтения идут в память, изменения — через
+// WalStorage::Commit и возвращаются после fsync. Ошибка записи журнала —
+// RepositoryError.
+class WalTaskRepository final : public TaskRepository {
+ public:
+  explicit WalTaskRepository(std::shared_ptr<WalStorage> storage);
+
+  std::expected<Task, AddTaskError> AddTask(const Task& task) override;
+  std::expected<Task, FindTaskError> GetTaskById(const Uuid& task_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUser(
+      const Uuid& user_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUserPage(
+      const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+      std::size_t limit) override;
+  std::expected<Task, UpdateTaskError> UpdateTaskStatus(
+      const Uuid& task_id, TaskStatus status) override;
+  std::expected<Task, DeleteTaskError> DeleteTaskById(
+      const Uuid& task_id) override;
+  std::expected<std::vector<Task>, AddTaskError> AddTasks(
+      const std::vector<Task>& tasks) override;
+  std::expected<std::vector<Task>, UpdateTaskError> UpdateTaskStatuses(
+      const std::vector<std::pair<Uuid, TaskStatus>>& updates) override;
+
+ private:
+  std::shared_ptr<WalStorage> storage_;
+};
+
+class WalUserRepository final : public UserRepository {
+ public:
+  explicit WalUserRepository(std::shared_ptr<WalStorage> storage);
+
+  std::expected<User, FindUserError> FindUser(
+      const std::string& login) override;
+  std::expected<User, AddUserError> AddUser(User user) override;
+  std::expected<void, UpdateUserError> UpdatePassword(
+      const std::string& login, const std::string& password) override;
+
+ private:
+  std::shared_ptr<WalStorage> storage_;
+};
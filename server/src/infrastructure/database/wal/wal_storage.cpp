@@ -0,0 +1,333 @@
+#include "wal_storage.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include <boost/log/trivial.hpp>
+
+namespace {
+
+constexpr std::string_view kSnapshotFile = "snapshot";
+constexpr std::string_view kSegmentPrefix = "wal-";
+constexpr std::string_view kSegmentSuffix = ".log";
+// Операций в одной записи снимка.
+constexpr std::size_t kSnapshotRecordOps = 1024;
+
+// Файл, отображённый в память только для чтения.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::filesystem::path& path) {
+    fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0)
+      Fail("open " + path.string());
+    struct stat st {};
+    if (::fstat(fd_, &st) != 0)
+      Fail("stat " + path.string());
+    size_ = static_cast<std::size_t>(st.st_size);
+    if (size_ == 0)
+      return;
+    data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (data_ == MAP_FAILED) {
+      data_ = nullptr;
+      Fail("mmap " + path.string());
+    }
+    ::madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+
+  ~MappedFile() { Close(); }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  std::string_view Data() const {
+    return {static_cast<const char*>(data_), data_ ? size_ : 0};
+  }
+
+ private:
+  [[noreturn]] void Fail(const std::string& what) {
+    const int error = errno;
+    Close();
+    throw std::system_error(error, std::generic_category(), what);
+  }
+
+  void Close() {
+    if (data_)
+      ::munmap(data_, size_);
+    if (fd_ >= 0)
+      ::close(fd_);
+    data_ = nullptr;
+    fd_ = -1;
+  }
+
+  int fd_ = -1;
+  void* data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+std::optional<std::uint64_t> ParseSegmentName(std::string_view name) {
+  if (!name.starts_with(kSegmentPrefix) || !name.ends_with(kSegmentSuffix))
+    return std::nullopt;
+  name.remove_prefix(kSegmentPrefix.size());
+  name.remove_suffix(kSegmentSuffix.size());
+  std::uint64_t generation = 0;
+  const auto [end, error] =
+      std::from_chars(name.data(), name.data() + name.size(), generation);
+  if (error != std::errc{} || end != name.data() + name.size())
+    return std::nullopt;
+  return generation;
+}
+
+std::vector<std::uint64_t> ListSegments(
+    const std::filesystem::path& directory) {
+  std::vector<std::uint64_t> segments;
+  for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+    if (const auto generation =
+            ParseSegmentName(entry.path().filename().string())) {
+      segments.push_back(*generation);
+    }
+  }
+  std::sort(segments.begin(), segments.end());
+  return segments;
+}
+
+// Повтор операций при восстановлении; см. комментарий к WalStorage.
+struct OpApplier {
+  InMemoryUserRepository& users;
+  InMemoryTaskRepository& tasks;
+
+  void operator()(const WalAddUser& op) { users.Restore(op.user); }
+  void operator()(const WalAddTask& op) { tasks.Restore(op.task); }
+  void operator()(const WalUpdateTaskStatus& op) {
+    (void)tasks.UpdateTaskStatus(op.task_id, op.status);
+  }
+  void operator()(const WalDeleteTask& op) {
+    (void)tasks.DeleteTaskById(op.task_id);
+  }
+  void operator()(const WalUpdateUserPassword& op) {
+    (void)users.UpdatePassword(op.login, op.password);
+  }
+};
+
+}  // namespace
+
+WalStorage::WalStorage(Options options) : options_(std::move(options)) {
+  Recover();
+  snapshot_thread_ = std::thread([this] { SnapshotLoop(); });
+}
+
+WalStorage::~WalStorage() {
+  {
+    std::lock_guard lock(snapshot_mutex_);
+    stop_ = true;
+  }
+  snapshot_cv_.notify_one();
+  snapshot_thread_.join();
+}
+
+bool WalStorage::Commit(
+    const std::function<void(std::vector<WalOp>& ops)>& change) {
+  std::uint64_t lsn = 0;
+  {
+    std::lock_guard lock(write_mutex_);
+    if (log_->Failed())
+      return false;
+    ops_.clear();
+    change(ops_);
+    if (ops_.empty())
+      return true;
+    record_.clear();
+    AppendWalRecord(record_, ops_);
+    lsn = log_->Append(record_);
+
+    if (options_.snapshot_every > 0 &&
+        ++records_since_snapshot_ >= options_.snapshot_every) {
+      records_since_snapshot_ = 0;
+      {
+        std::lock_guard snapshot_lock(snapshot_mutex_);
+        snapshot_requested_ = true;
+      }
+      snapshot_cv_.notify_one();
+    }
+  }
+  return log_->WaitDurable(lsn);
+}
+
+void WalStorage::Snapshot() {
+  std::lock_guard run_lock(snapshot_run_mutex_);
+  std::uint64_t generation = 0;
+  {
+    std::lock_guard lock(write_mutex_);
+    generation = generation_ + 1;
+    if (!log_->SwitchTo(SegmentPath(generation), generation))
+      throw std::runtime_error("WAL is not writable");
+    generation_ = generation;
+    records_since_snapshot_ = 0;
+  }
+
+  // Данные обходятся без блокировки записи: изменения, сделанные во время
+  // обхода, уже в сегменте generation и повторятся поверх снимка.
+  std::string data;
+  AppendWalHeader(data, kWalSnapshotMagic, generation);
+  std::vector<WalOp> ops;
+  const auto flush = [&] {
+    if (ops.empty())
+      return;
+    AppendWalRecord(data, ops);
+    ops.clear();
+  };
+  users_.ForEach([&](const User& user) {
+    ops.emplace_back(WalAddUser{user});
+    if (ops.size() >= kSnapshotRecordOps)
+      flush();
+  });
+  tasks_.ForEach([&](const Task& task) {
+    ops.emplace_back(WalAddTask{task});
+    if (ops.size() >= kSnapshotRecordOps)
+      flush();
+  });
+  flush();
+  WriteFileAtomically(options_.directory / kSnapshotFile, data);
+
+  for (const auto old : ListSegments(options_.directory)) {
+    if (old < generation)
+      std::filesystem::remove(SegmentPath(old));
+  }
+  SyncDirectory(options_.directory);
+  ++snapshots_;
+}
+
+WalStorage::Stats WalStorage::GetStats() const {
+  const auto log = log_->GetStats();
+  Stats stats;
+  stats.records = log.records;
+  stats.syncs = log.syncs;
+  stats.snapshots = snapshots_.load();
+  {
+    std::lock_guard lock(write_mutex_);
+    stats.generation = generation_;
+  }
+  return stats;
+}
+
+std::filesystem::path WalStorage::SegmentPath(std::uint64_t generation) const {
+  // Номер дополнен нулями, чтобы сегменты в листинге шли по порядку.
+  const std::string number = std::to_string(generation);
+  return options_.directory /
+         (std::string(kSegmentPrefix) + std::string(20 - number.size(), '0') +
+          number + std::string(kSegmentSuffix));
+}
+
+void WalStorage::Recover() {
+  std::filesystem::create_directories(options_.directory);
+
+  const auto snapshot_path = options_.directory / kSnapshotFile;
+  if (std::filesystem::exists(snapshot_path)) {
+    const MappedFile file(snapshot_path);
+    const std::string_view data = file.Data();
+    const std::int64_t generation = ReadWalHeader(data, kWalSnapshotMagic);
+    if (generation < 0) {
+      throw std::runtime_error("WAL snapshot header is corrupt: " +
+                               snapshot_path.string());
+    }
+    const auto records = data.substr(kWalHeaderSize);
+    const auto parsed = ParseWalRecords(
+        records, [&](const std::vector<WalOp>& ops) { Apply(ops); });
+    if (parsed.valid_bytes != records.size()) {
+      throw std::runtime_error("WAL snapshot is corrupt: " +
+                               snapshot_path.string());
+    }
+    generation_ = static_cast<std::uint64_t>(generation);
+  }
+
+  // Сегменты до снимка остаются, если сбой случился между записью снимка
+  // и их удалением.
+  std::vector<std::uint64_t> segments = ListSegments(options_.directory);
+  const auto first = std::lower_bound(segments.begin(), segments.end(),
+                                      generation_);
+  if (first != segments.begin()) {
+    for (auto it = segments.begin(); it != first; ++it)
+      std::filesystem::remove(SegmentPath(*it));
+    segments.erase(segments.begin(), first);
+    SyncDirectory(options_.directory);
+  }
+
+  for (std::size_t i = 0; i < segments.size(); ++i) {
+    ReplaySegment(SegmentPath(segments[i]), segments[i],
+                  i + 1 == segments.size());
+  }
+  if (!segments.empty())
+    generation_ = segments.back();
+
+  WriteAheadLog::Options log_options;
+  log_options.commit_delay = options_.commit_delay;
+  log_ = std::make_unique<WriteAheadLog>(SegmentPath(generation_),
+                                         generation_, log_options);
+  BOOST_LOG_TRIVIAL(info) << "WAL recovered from " << options_.directory
+                          << ": generation " << generation_ << ", "
+                          << tasks_.Size() << " tasks";
+}
+
+void WalStorage::ReplaySegment(const std::filesystem::path& path,
+                               std::uint64_t generation, bool last) {
+  std::size_t valid_size = 0;
+  std::size_t file_size = 0;
+  {
+    const MappedFile file(path);
+    const std::string_view data = file.Data();
+    file_size = data.size();
+    if (data.size() >= kWalHeaderSize) {
+      if (ReadWalHeader(data, kWalLogMagic) !=
+          static_cast<std::int64_t>(generation)) {
+        throw std::runtime_error("WAL segment header is corrupt: " +
+                                 path.string());
+      }
+      const auto parsed = ParseWalRecords(
+          data.substr(kWalHeaderSize),
+          [&](const std::vector<WalOp>& ops) { Apply(ops); });
+      valid_size = kWalHeaderSize + parsed.valid_bytes;
+    }
+  }
+  if (valid_size == file_size)
+    return;
+  if (!last)
+    throw std::runtime_error("WAL segment is corrupt: " + path.string());
+
+  // Сбой посреди записи: записи, которые не дописаны целиком, не были
+  // подтверждены. Сегмент без целого заголовка начинается заново.
+  BOOST_LOG_TRIVIAL(warning) << "WAL: dropping " << file_size - valid_size
+                             << " bytes of torn tail in " << path;
+  std::filesystem::resize_file(path, valid_size);
+}
+
+void WalStorage::Apply(const std::vector<WalOp>& ops) {
+  OpApplier applier{users_, tasks_};
+  for (const auto& op : ops)
+    std::visit(applier, op);
+}
+
+void WalStorage::SnapshotLoop() {
+  std::unique_lock lock(snapshot_mutex_);
+  for (;;) {
+    snapshot_cv_.wait(lock, [&] { return stop_ || snapshot_requested_; });
+    if (stop_)
+      return;
+    snapshot_requested_ = false;
+    lock.unlock();
+    try {
+      Snapshot();
+    } catch (const std::exception& e) {
+      BOOST_LOG_TRIVIAL(error) << "WAL snapshot failed: " << e.what();
+    }
+    lock.lock();
+  }
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "memory_task_repository.hpp"
+#include "memory_user_repository.hpp"
+#include "wal_format.hpp"
+#include "write_ahead_log.hpp"
+
+// Хранилище в памяти с журналом на диске. Данные живут в
+// InMemory*Repository; каждое изменение сначала применяется в памяти,
+// затем его операции дописываются в журнал, и вызывающий ждёт fsync.
+// Параллельные изменения делят один fsync (см. WriteAheadLog).
+//
+// Каталог:
+//   snapshot         — снимок поколения G: заголовок и AddUser/AddTask;
+//   wal-<N>.log      — сегменты журнала, N >= G.
+// Снимок поколения G снимается после переключения журнала на сегмент G, не
+// останавливая запись, поэтому может уже содержать часть изменений из
+// сегмента G. Операции при восстановлении идемпотентны: повторное
+// добавление существующей записи и изменение отсутствующей пропускаются, и
+// повтор сегмента поверх снимка приходит к тому же состоянию.
+//
+// При открытии снимок читается через mmap, затем повторяются сегменты.
+// Недописанный хвост последнего сегмента (сбой посреди записи) отрезается;
+// повреждение снимка или не последнего сегмента — исключение.
+//
+// Чтения видят изменение чуть раньше, чем оно попадает на диск: до
+// fsync его может прочитать другой запрос. После ошибки записи изменения
+// больше не принимаются, а уже применённые в памяти могут пропасть при
+// перезапуске.
+class WalStorage {
+ public:
+  struct Options {
+    std::filesystem::path directory;
+    // См. WriteAheadLog::Options::commit_delay.
+    std::chrono::microseconds commit_delay{0};
+    // Снимок в фоне после стольких записей журнала; 0 — только по вызову
+    // Snapshot.
+    std::uint64_t snapshot_every = 100000;
+  };
+
+  struct Stats {
+    std::uint64_t records = 0;
+    std::uint64_t syncs = 0;
+    std::uint64_t snapshots = 0;
+    std::uint64_t generation = 0;
+  };
+
+  // Восстанавливает данные из каталога (создаёт его, если нет). Бросает
+  // std::runtime_error при повреждённых данных и std::system_error при
+  // ошибках ввода-вывода.
+  explicit WalStorage(Options options);
+  ~WalStorage();
+
+  WalStorage(const WalStorage&) = delete;
+  WalStorage& operator=(const WalStorage&) = delete;
+
+  // Для чтения. Менять данные можно только внутри Commit.
+  InMemoryUserRepository& Users() { return users_; }
+  InMemoryTaskRepository& Tasks() { return tasks_; }
+
+  // Выполняет change под общей блокировкой записи: change меняет данные в
+  // памяти и складывает в ops операции, которые их повторяют. Операции
+  // одного вызова — одна запись журнала. Ждёт fsync; false — журнал не
+  // записан, и change мог не выполняться.
+  bool Commit(const std::function<void(std::vector<WalOp>& ops)>& change);
+
+  // Снимает снимок и удаляет сегменты, которые он заменил. Бросает
+  // std::system_error или std::runtime_error, если журнал не пишется.
+  void Snapshot();
+
+  Stats GetStats() const;
+
+ private:
+  std::filesystem::path SegmentPath(std::uint64_t generation) const;
+  void Recover();
+  // Повторяет сегмент; повреждённый хвост последнего сегмента отрезает.
+  void ReplaySegment(const std::filesystem::path& path,
+                     std::uint64_t generation, bool last);
+  void Apply(const std::vector<WalOp>& ops);
+  void SnapshotLoop();
+
+  const Options options_;
+  InMemoryUserRepository users_;
+  InMemoryTaskRepository tasks_;
+  std::unique_ptr<WriteAheadLog> log_;
+
+  // Порядок операций в журнале совпадает с порядком применения в памяти.
+  mutable std::mutex write_mutex_;
+  std::vector<WalOp> ops_;
+  std::string record_;
+  std::uint64_t generation_ = 0;
+  std::uint64_t records_since_snapshot_ = 0;
+
+  // Снимки не пересекаются.
+  std::mutex snapshot_run_mutex_;
+  std::atomic<std::uint64_t> snapshots_{0};
+
+  std::mutex snapshot_mutex_;
+  std::condition_variable snapshot_cv_;
+  bool snapshot_requested_ = false;
+  bool stop_ = false;
+  std::thread snapshot_thread_;
+};
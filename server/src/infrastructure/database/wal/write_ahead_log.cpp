@@ -0,0 +1,180 @@
+#include "write_ahead_log.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <system_error>
+
+#include <boost/log/trivial.hpp>
+
+#include "wal_format.hpp"
+
+namespace {
+
+[[noreturn]] void ThrowErrno(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+bool WriteAll(int fd, std::string_view data) {
+  while (!data.empty()) {
+    const ssize_t written = ::write(fd, data.data(), data.size());
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data.remove_prefix(static_cast<std::size_t>(written));
+  }
+  return true;
+}
+
+}  // namespace
+
+WriteAheadLog::WriteAheadLog(const std::filesystem::path& path,
+                             std::uint64_t generation, Options options)
+    : options_(options), fd_(OpenSegment(path, generation)) {
+  flush_thread_ = std::thread([this] { FlushLoop(); });
+}
+
+WriteAheadLog::~WriteAheadLog() {
+  {
+    std::lock_guard lock(mutex_);
+    stop_ = true;
+  }
+  pending_cv_.notify_one();
+  flush_thread_.join();
+  ::close(fd_);
+}
+
+std::uint64_t WriteAheadLog::Append(std::string_view record) {
+  std::lock_guard lock(mutex_);
+  pending_ += record;
+  const std::uint64_t lsn = ++appended_lsn_;
+  pending_cv_.notify_one();
+  return lsn;
+}
+
+bool WriteAheadLog::WaitDurable(std::uint64_t lsn) {
+  std::unique_lock lock(mutex_);
+  durable_cv_.wait(lock, [&] { return failed_ || durable_lsn_ >= lsn; });
+  return durable_lsn_ >= lsn;
+}
+
+bool WriteAheadLog::SwitchTo(const std::filesystem::path& path,
+                             std::uint64_t generation) {
+  std::unique_lock lock(mutex_);
+  durable_cv_.wait(lock,
+                   [&] { return failed_ || durable_lsn_ == appended_lsn_; });
+  if (failed_)
+    return false;
+  // Очередь пуста, и FlushLoop не трогает fd_, пока в неё ничего не
+  // добавят.
+  try {
+    const int fd = OpenSegment(path, generation);
+    ::close(fd_);
+    fd_ = fd;
+    return true;
+  } catch (const std::system_error& e) {
+    BOOST_LOG_TRIVIAL(error) << "WAL segment switch failed: " << e.what();
+    failed_ = true;
+    return false;
+  }
+}
+
+bool WriteAheadLog::Failed() const {
+  std::lock_guard lock(mutex_);
+  return failed_;
+}
+
+WriteAheadLog::Stats WriteAheadLog::GetStats() const {
+  std::lock_guard lock(mutex_);
+  return {appended_lsn_, syncs_};
+}
+
+int WriteAheadLog::OpenSegment(const std::filesystem::path& path,
+                               std::uint64_t generation) {
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                        0644);
+  if (fd < 0)
+    ThrowErrno("open " + path.string());
+  struct stat st {};
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    ThrowErrno("stat " + path.string());
+  }
+  if (st.st_size == 0) {
+    std::string header;
+    AppendWalHeader(header, kWalLogMagic, generation);
+    if (!WriteAll(fd, header) || ::fdatasync(fd) != 0) {
+      ::close(fd);
+      ThrowErrno("write " + path.string());
+    }
+    // Новый файл должен пережить сбой вместе с записями в нём.
+    SyncDirectory(path.parent_path());
+  }
+  return fd;
+}
+
+void WriteAheadLog::FlushLoop() {
+  std::unique_lock lock(mutex_);
+  for (;;) {
+    pending_cv_.wait(lock, [&] { return stop_ || !pending_.empty(); });
+    if (pending_.empty())
+      return;
+    if (options_.commit_delay.count() > 0 && !stop_) {
+      lock.unlock();
+      std::this_thread::sleep_for(options_.commit_delay);
+      lock.lock();
+    }
+    flushing_.clear();
+    flushing_.swap(pending_);
+    const std::uint64_t lsn = appended_lsn_;
+    lock.unlock();
+
+    const bool ok = WriteAll(fd_, flushing_) && ::fdatasync(fd_) == 0;
+    if (!ok) {
+      BOOST_LOG_TRIVIAL(error)
+          << "WAL write failed: " << std::generic_category().message(errno);
+    }
+
+    lock.lock();
+    ++syncs_;
+    if (ok) {
+      durable_lsn_ = lsn;
+    } else {
+      failed_ = true;
+    }
+    durable_cv_.notify_all();
+    if (failed_)
+      return;
+  }
+}
+
+void WriteFileAtomically(const std::filesystem::path& path,
+                         std::string_view data) {
+  const auto temp = std::filesystem::path(path) += ".tmp";
+  const int fd =
+      ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0)
+    ThrowErrno("open " + temp.string());
+  if (!WriteAll(fd, data) || ::fsync(fd) != 0) {
+    ::close(fd);
+    ThrowErrno("write " + temp.string());
+  }
+  ::close(fd);
+  if (::rename(temp.c_str(), path.c_str()) != 0)
+    ThrowErrno("rename " + temp.string());
+  SyncDirectory(path.parent_path());
+}
+
+void SyncDirectory(const std::filesystem::path& directory) {
+  const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0)
+    ThrowErrno("open " + directory.string());
+  const int result = ::fsync(fd);
+  ::close(fd);
+  if (result != 0)
+    ThrowErrno("fsync " + directory.string());
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Сегмент журнала с групповой фиксацией. Append только ставит запись в
+// очередь; фоновый поток дописывает в файл всё, что накопилось, одним
+// write и одним fdatasync, после чего будит всех, кто ждёт в WaitDurable.
+// Пока идёт один fdatasync, следующие записи копятся для следующего, так
+// что при параллельной записи одна синхронизация приходится на много
+// записей.
+//
+// После ошибки записи журнал больше ничего не принимает: что из очереди
+// попало на диск, неизвестно.
+class WriteAheadLog {
+ public:
+  struct Options {
+    // Пауза перед записью очереди: собирает больше записей в один fsync
+    // при слабой нагрузке ценой задержки каждой записи.
+    std::chrono::microseconds commit_delay{0};
+  };
+
+  struct Stats {
+    std::uint64_t records = 0;
+    std::uint64_t syncs = 0;
+  };
+
+  // Открывает сегмент для дозаписи в конец или создаёт его с заголовком.
+  // Бросает std::system_error, если файл не открыть.
+  WriteAheadLog(const std::filesystem::path& path, std::uint64_t generation,
+                Options options);
+  ~WriteAheadLog();
+
+  WriteAheadLog(const WriteAheadLog&) = delete;
+  WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+  // Порядок записей в файле — порядок вызовов Append. Возвращает номер
+  // записи для WaitDurable.
+  std::uint64_t Append(std::string_view record);
+  // true, когда запись lsn и все предыдущие на диске; false — ошибка
+  // записи.
+  bool WaitDurable(std::uint64_t lsn);
+  // Дописывает очередь в текущий сегмент и продолжает в новом. Вызывающий
+  // не даёт вызывать Append, пока переключение не закончено.
+  bool SwitchTo(const std::filesystem::path& path, std::uint64_t generation);
+  // Была ошибка записи: новые записи не примутся.
+  bool Failed() const;
+
+  Stats GetStats() const;
+
+ private:
+  static int OpenSegment(const std::filesystem::path& path,
+                         std::uint64_t generation);
+  void FlushLoop();
+
+  const Options options_;
+  int fd_ = -1;
+
+  mutable std::mutex mutex_;
+  std::condition_variable pending_cv_;
+  std::condition_variable durable_cv_;
+  std::string pending_;
+  // Буфер, который пишет поток FlushLoop; переиспользуется.
+  std::string flushing_;
+  std::uint64_t appended_lsn_ = 0;
+  std::uint64_t durable_lsn_ = 0;
+  std::uint64_t syncs_ = 0;
+  bool failed_ = false;
+  bool stop_ = false;
+  std::thread flush_thread_;
+};
+
+// Записывает data в path через временный файл, fsync и rename, затем
+// синхронизирует каталог: после сбоя в path либо старое, либо новое
+// содержимое целиком. Бросает std::system_error.
+void WriteFileAtomically(const std::filesystem::path& path,
+                         std::string_view data);
+// fsync каталога: делает надёжными создание, переименование и удаление
+// файлов в нём.
+void SyncDirectory(const std::filesystem::path& directory);
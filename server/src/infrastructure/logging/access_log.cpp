@@ -0,0 +1,275 @@
+#include "access_log.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <functional>
+
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/trivial.hpp>
+
+namespace {
+
+constexpr std::string_view kLevelNames[] = {"debug", "info", "warning",
+                                            "error", "off"};
+
+std::atomic<std::uint64_t> g_next_log_id{1};
+
+// Кольцо последнего журнала, в который писал поток: в типичном случае журнал
+// один, и поиск в thread_rings_ не нужен.
+struct CachedRing {
+  std::uint64_t log_id = 0;
+  void* ring = nullptr;
+};
+
+thread_local CachedRing t_cached_ring;
+
+void AppendNumber(std::string& out, std::uint64_t value) {
+  char buffer[20];
+  const auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, end);
+}
+
+void AppendPadded(std::string& out, unsigned value, int width) {
+  char buffer[8];
+  for (int i = width - 1; i >= 0; --i) {
+    buffer[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  out.append(buffer, static_cast<std::size_t>(width));
+}
+
+// 2024-05-01T12:00:00.123456Z
+void AppendTimestamp(std::string& out, std::int64_t unix_us) {
+  using namespace std::chrono;
+  const sys_time<microseconds> time{microseconds(unix_us)};
+  const auto day = floor<days>(time);
+  const year_month_day date{day};
+  const hh_mm_ss clock{floor<microseconds>(time - day)};
+  AppendPadded(out, static_cast<unsigned>(static_cast<int>(date.year())), 4);
+  out += '-';
+  AppendPadded(out, static_cast<unsigned>(date.month()), 2);
+  out += '-';
+  AppendPadded(out, static_cast<unsigned>(date.day()), 2);
+  out += 'T';
+  AppendPadded(out, static_cast<unsigned>(clock.hours().count()), 2);
+  out += ':';
+  AppendPadded(out, static_cast<unsigned>(clock.minutes().count()), 2);
+  out += ':';
+  AppendPadded(out, static_cast<unsigned>(clock.seconds().count()), 2);
+  out += '.';
+  AppendPadded(out, static_cast<unsigned>(clock.subseconds().count()), 6);
+  out += 'Z';
+}
+
+// Пробелы, кавычки и управляющие символы в target ломали бы разбор строки:
+// они заменяются на '?'. Корректный target таких символов не содержит.
+void AppendSafe(std::string& out, std::string_view value) {
+  for (const char c : value) {
+    const auto byte = static_cast<unsigned char>(c);
+    out += byte <= 0x20 || byte == 0x7F || c == '"' ? '?' : c;
+  }
+}
+
+void ApplyBoostLogLevel(LogLevel level) {
+  namespace logging = boost::log;
+  auto core = logging::core::get();
+  if (level == LogLevel::Off) {
+    core->set_logging_enabled(false);
+    return;
+  }
+  static constexpr logging::trivial::severity_level kSeverities[] = {
+      logging::trivial::debug, logging::trivial::info,
+      logging::trivial::warning, logging::trivial::error};
+  core->set_filter(logging::trivial::severity >=
+                   kSeverities[static_cast<std::size_t>(level)]);
+  core->set_logging_enabled(true);
+}
+
+}  // namespace
+
+std::string_view ToString(LogLevel level) {
+  return kLevelNames[static_cast<std::size_t>(level)];
+}
+
+std::optional<LogLevel> ParseLogLevel(std::string_view name) {
+  for (std::size_t i = 0; i < std::size(kLevelNames); ++i) {
+    if (kLevelNames[i] == name)
+      return static_cast<LogLevel>(i);
+  }
+  return std::nullopt;
+}
+
+AccessLog::Ring::Ring(std::size_t capacity, std::uint64_t thread_id)
+    : records(std::make_unique_for_overwrite<Record[]>(capacity)),
+      mask(capacity - 1),
+      thread_id(thread_id) {}
+
+AccessLog::AccessLog(std::ostream& out, Options options)
+    : out_(out),
+      id_(g_next_log_id.fetch_add(1, std::memory_order_relaxed)),
+      ring_capacity_(
+          std::bit_ceil(std::max<std::size_t>(options.ring_capacity, 2))),
+      drain_interval_(options.drain_interval),
+      level_(options.level),
+      sample_every_(options.sample_every) {
+  ApplyBoostLogLevel(options.level);
+  drain_thread_ = std::thread([this] { DrainLoop(); });
+}
+
+AccessLog::~AccessLog() {
+  {
+    std::lock_guard lock(stop_mutex_);
+    stop_ = true;
+  }
+  stop_cv_.notify_one();
+  drain_thread_.join();
+  Flush();
+}
+
+void AccessLog::Log(std::string_view method, std::string_view target,
+                    unsigned status, std::chrono::microseconds latency) {
+  const LogLevel level = status >= 500 ? LogLevel::Warning : LogLevel::Info;
+  if (level < level_.load(std::memory_order_relaxed))
+    return;
+
+  Ring& ring = ThreadRing();
+  if (status < 400) {
+    const auto every = sample_every_.load(std::memory_order_relaxed);
+    if (every == 0 || ++ring.sample_counter < every) {
+      ring.sampled_out.store(
+          ring.sampled_out.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+      return;
+    }
+    ring.sample_counter = 0;
+  }
+
+  const std::size_t head = ring.head.load(std::memory_order_relaxed);
+  if (head - ring.tail.load(std::memory_order_acquire) > ring.mask) {
+    ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+    return;
+  }
+
+  Record& record = ring.records[head & ring.mask];
+  record.unix_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                       std::chrono::system_clock::now().time_since_epoch())
+                       .count();
+  record.latency_us = static_cast<std::uint32_t>(std::min<std::int64_t>(
+      std::max<std::int64_t>(latency.count(), 0), UINT32_MAX));
+  record.status = static_cast<std::uint16_t>(status);
+  record.level = level;
+  record.method_size =
+      static_cast<std::uint8_t>(std::min(method.size(), kMaxMethod));
+  std::memcpy(record.method.data(), method.data(), record.method_size);
+  record.target_size =
+      static_cast<std::uint8_t>(std::min(target.size(), kMaxTarget));
+  record.target_truncated = target.size() > kMaxTarget;
+  std::memcpy(record.target.data(), target.data(), record.target_size);
+  ring.head.store(head + 1, std::memory_order_release);
+}
+
+LogLevel AccessLog::GetLevel() const {
+  return level_.load(std::memory_order_relaxed);
+}
+
+void AccessLog::SetLevel(LogLevel level) {
+  level_.store(level, std::memory_order_relaxed);
+  ApplyBoostLogLevel(level);
+}
+
+void AccessLog::SetSampleEvery(std::uint32_t sample_every) {
+  sample_every_.store(sample_every, std::memory_order_relaxed);
+}
+
+std::uint32_t AccessLog::GetSampleEvery() const {
+  return sample_every_.load(std::memory_order_relaxed);
+}
+
+void AccessLog::Flush() {
+  std::lock_guard lock(drain_mutex_);
+  DrainOnce();
+}
+
+AccessLog::Stats AccessLog::GetStats() const {
+  Stats stats;
+  stats.written = written_.load(std::memory_order_relaxed);
+  std::lock_guard lock(rings_mutex_);
+  for (const auto& ring : rings_) {
+    stats.dropped += ring->dropped.load(std::memory_order_relaxed);
+    stats.sampled_out += ring->sampled_out.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+AccessLog::Ring& AccessLog::ThreadRing() {
+  if (t_cached_ring.log_id == id_)
+    return *static_cast<Ring*>(t_cached_ring.ring);
+
+  const auto thread = std::this_thread::get_id();
+  std::lock_guard lock(rings_mutex_);
+  auto [it, inserted] = thread_rings_.try_emplace(thread, nullptr);
+  if (inserted) {
+    rings_.push_back(std::make_unique<Ring>(
+        ring_capacity_, std::hash<std::thread::id>{}(thread)));
+    it->second = rings_.back().get();
+  }
+  t_cached_ring = {id_, it->second};
+  return *it->second;
+}
+
+void AccessLog::DrainLoop() {
+  std::unique_lock lock(stop_mutex_);
+  while (!stop_) {
+    stop_cv_.wait_for(lock, drain_interval_, [this] { return stop_; });
+    lock.unlock();
+    Flush();
+    lock.lock();
+  }
+}
+
+void AccessLog::DrainOnce() {
+  line_buffer_.clear();
+  std::uint64_t lines = 0;
+  {
+    std::lock_guard lock(rings_mutex_);
+    for (const auto& ring : rings_) {
+      const std::size_t tail = ring->tail.load(std::memory_order_relaxed);
+      const std::size_t head = ring->head.load(std::memory_order_acquire);
+      for (std::size_t i = tail; i != head; ++i)
+        AppendRecord(ring->records[i & ring->mask], ring->thread_id);
+      ring->tail.store(head, std::memory_order_release);
+      lines += head - tail;
+    }
+  }
+  if (lines == 0)
+    return;
+  out_.write(line_buffer_.data(),
+             static_cast<std::streamsize>(line_buffer_.size()));
+  out_.flush();
+  written_.fetch_add(lines, std::memory_order_relaxed);
+}
+
+void AccessLog::AppendRecord(const Record& record, std::uint64_t thread_id) {
+  std::string& out = line_buffer_;
+  out += "ts=";
+  AppendTimestamp(out, record.unix_us);
+  out += " level=";
+  out += ToString(record.level);
+  out += " method=";
+  AppendSafe(out, {record.method.data(), record.method_size});
+  out += " target=";
+  AppendSafe(out, {record.target.data(), record.target_size});
+  if (record.target_truncated)
+    out += "...";
+  out += " status=";
+  AppendNumber(out, record.status);
+  out += " latency_us=";
+  AppendNumber(out, record.latency_us);
+  out += " thread=";
+  AppendNumber(out, thread_id);
+  out += '\n';
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum class LogLevel : std::uint8_t {
+  Debug = 0,
+  Info = 1,
+  Warning = 2,
+  Error = 3,
+  Off = 4,
+};
+
+std::string_view ToString(LogLevel level);
+std::optional<LogLevel> ParseLogLevel(std::string_view name);
+
+// Уровень и для журнала запросов, и для остальных логов (Boost.Log).
+class LogLevelControl {
+ public:
+  virtual ~LogLevelControl() = default;
+  virtual LogLevel GetLevel() const = 0;
+  virtual void SetLevel(LogLevel level) = 0;
+};
+
+// Журнал запросов без блокировок на горячем пути: каждый поток пишет записи
+// фиксированного размера в свой кольцевой буфер (один писатель, один
+// читатель), фоновый поток раз в drain_interval собирает их и пишет в out
+// одной операцией. Если буфер потока полон, запись отбрасывается и
+// учитывается в Stats::dropped.
+//
+// Строка записи — пары ключ=значение:
+//   ts=2024-05-01T12:00:00.123456Z level=info method=GET target=/task/1
+//   status=200 latency_us=153 thread=140245
+// Успешные ответы (статус < 400) пишутся с уровнем info и выборочно —
+// каждый sample_every-й в потоке; 4xx — info без выборки, 5xx — warning.
+class AccessLog final : public LogLevelControl {
+ public:
+  struct Options {
+    LogLevel level = LogLevel::Info;
+    // 1 — все успешные запросы, 0 — ни одного.
+    std::uint32_t sample_every = 1;
+    // Записей в буфере одного потока; округляется до степени двойки.
+    std::size_t ring_capacity = 4096;
+    std::chrono::milliseconds drain_interval{10};
+  };
+
+  struct Stats {
+    std::uint64_t written = 0;
+    std::uint64_t dropped = 0;
+    std::uint64_t sampled_out = 0;
+  };
+
+  // out используется только фоновым потоком (и Flush).
+  AccessLog(std::ostream& out, Options options);
+  ~AccessLog() override;
+
+  AccessLog(const AccessLog&) = delete;
+  AccessLog& operator=(const AccessLog&) = delete;
+
+  // Проверки уровня и выборки — до всякой работы с записью.
+  void Log(std::string_view method, std::string_view target,
+           unsigned status, std::chrono::microseconds latency);
+
+  LogLevel GetLevel() const override;
+  // Меняет и фильтр Boost.Log.
+  void SetLevel(LogLevel level) override;
+  void SetSampleEvery(std::uint32_t sample_every);
+  std::uint32_t GetSampleEvery() const;
+
+  // Дописывает в out всё, что уже лежит в буферах.
+  void Flush();
+  Stats GetStats() const;
+
+ private:
+  static constexpr std::size_t kMaxMethod = 15;
+  static constexpr std::size_t kMaxTarget = 255;
+
+  struct Record {
+    std::int64_t unix_us;
+    std::uint32_t latency_us;
+    std::uint16_t status;
+    LogLevel level;
+    std::uint8_t method_size;
+    std::uint8_t target_size;
+    bool target_truncated;
+    std::array<char, kMaxMethod> method;
+    std::array<char, kMaxTarget> target;
+  };
+
+  // Кольцо одного потока: head и счётчики меняет только поток-владелец,
+  // tail — только фоновый поток.
+  struct Ring {
+    Ring(std::size_t capacity, std::uint64_t thread_id);
+
+    const std::unique_ptr<Record[]> records;
+    const std::size_t mask;
+    const std::uint64_t thread_id;
+    alignas(64) std::atomic<std::size_t> head{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::uint64_t> sampled_out{0};
+    std::uint32_t sample_counter = 0;
+    alignas(64) std::atomic<std::size_t> tail{0};
+  };
+
+  Ring& ThreadRing();
+  void DrainLoop();
+  // Под drain_mutex_.
+  void DrainOnce();
+  void AppendRecord(const Record& record, std::uint64_t thread_id);
+
+  std::ostream& out_;
+  const std::uint64_t id_;
+  const std::size_t ring_capacity_;
+  const std::chrono::milliseconds drain_interval_;
+  std::atomic<LogLevel> level_;
+  std::atomic<std::uint32_t> sample_every_;
+
+  // Кольца живут до разрушения журнала, даже если поток завершился.
+  mutable std::mutex rings_mutex_;
+  std::vector<std::unique_ptr<Ring>> rings_;
+  std::unordered_map<std::thread::id, Ring*> thread_rings_;
+
+  std::mutex drain_mutex_;
+  std::string line_buffer_;
+  std::atomic<std::uint64_t> written_{0};
+
+  std::mutex stop_mutex_;
+  std::condition_variable stop_cv_;
+  bool stop_ = false;
+  std::thread drain_thread_;
+};
@@ -0,0 +1,133 @@
+#include "instrumented_repositories.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view kQueryDuration =
+    "taskmanager_repository_query_duration_seconds";
+constexpr std::string_view kQueryDurationHelp =
+    "Repository call latency, including waiting for a pooled connection.";
+
+LatencyHistogram& QueryHistogram(MetricsRegistry& metrics,
+                                 std::string repository,
+                                 std::string operation) {
+  return metrics.GetHistogram(
+      kQueryDuration, kQueryDurationHelp,
+      {{"repository", std::move(repository)},
+       {"operation", std::move(operation)}});
+}
+
+template <class F>
+auto Timed(LatencyHistogram& histogram, F&& call) {
+  const auto start = std::chrono::steady_clock::now();
+  auto result = call();
+  histogram.Record(std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start));
+  return result;
+}
+
+}  // namespace
+
+InstrumentedTaskRepository::InstrumentedTaskRepository(
+    std::unique_ptr<TaskRepository> repository, MetricsRegistry& metrics,
+    TaskBatchWriter* writer)
+    : repository_(std::move(repository)),
+      writer_(writer),
+      add_(QueryHistogram(metrics, "task", "AddTask")),
+      get_by_id_(QueryHistogram(metrics, "task", "GetTaskById")),
+      get_by_user_(QueryHistogram(metrics, "task", "GetTasksByUser")),
+      get_page_(QueryHistogram(metrics, "task", "GetTasksByUserPage")),
+      update_status_(QueryHistogram(metrics, "task", "UpdateTaskStatus")),
+      delete_(QueryHistogram(metrics, "task", "DeleteTaskById")),
+      add_bulk_(QueryHistogram(metrics, "task", "AddTasks")),
+      update_status_bulk_(
+          QueryHistogram(metrics, "task", "UpdateTaskStatuses")) {
+  if (writer_)
+    write_batch_ = &QueryHistogram(metrics, "task", "WriteBatch");
+}
+
+std::expected<Task, AddTaskError> InstrumentedTaskRepository::AddTask(
+    const Task& task) {
+  return Timed(add_, [&] { return repository_->AddTask(task); });
+}
+
+std::expected<Task, FindTaskError> InstrumentedTaskRepository::GetTaskById(
+    const Uuid& task_id) {
+  return Timed(get_by_id_, [&] { return repository_->GetTaskById(task_id); });
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+InstrumentedTaskRepository::GetTasksByUser(const Uuid& user_id) {
+  return Timed(get_by_user_,
+               [&] { return repository_->GetTasksByUser(user_id); });
+}
+
+std::expected<std::vector<Task>, FindTaskError>
+InstrumentedTaskRepository::GetTasksByUserPage(
+    const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+    std::size_t limit) {
+  return Timed(get_page_, [&] {
+    return repository_->GetTasksByUserPage(user_id, after, limit);
+  });
+}
+
+std::expected<Task, UpdateTaskError>
+InstrumentedTaskRepository::UpdateTaskStatus(const Uuid& task_id,
+                                             TaskStatus status) {
+  return Timed(update_status_, [&] {
+    return repository_->UpdateTaskStatus(task_id, status);
+  });
+}
+
+std::expected<Task, DeleteTaskError>
+InstrumentedTaskRepository::DeleteTaskById(const Uuid& task_id) {
+  return Timed(delete_, [&] { return repository_->DeleteTaskById(task_id); });
+}
+
+std::expected<std::vector<Task>, AddTaskError>
+InstrumentedTaskRepository::AddTasks(const std::vector<Task>& tasks) {
+  return Timed(add_bulk_, [&] { return repository_->AddTasks(tasks); });
+}
+
+std::expected<std::vector<Task>, UpdateTaskError>
+InstrumentedTaskRepository::UpdateTaskStatuses(
+    const std::vector<std::pair<Uuid, TaskStatus>>& updates) {
+  return Timed(update_status_bulk_,
+               [&] { return repository_->UpdateTaskStatuses(updates); });
+}
+
+TaskWriteBatchResult InstrumentedTaskRepository::WriteBatch(
+    const TaskWriteBatch& batch) {
+  if (!writer_)
+    throw std::logic_error("Wrapped task repository has no batch writer");
+  return Timed(*write_batch_, [&] { return writer_->WriteBatch(batch); });
+}
+
+InstrumentedUserRepository::InstrumentedUserRepository(
+    std::unique_ptr<UserRepository> repository, MetricsRegistry& metrics)
+    : repository_(std::move(repository)),
+      find_(QueryHistogram(metrics, "user", "FindUser")),
+      add_(QueryHistogram(metrics, "user", "AddUser")),
+      update_password_(QueryHistogram(metrics, "user", "UpdatePassword")) {}
+
+std::expected<User, FindUserError> InstrumentedUserRepository::FindUser(
+    const std::string& login) {
+  return Timed(find_, [&] { return repository_->FindUser(login); });
+}
+
+std::expected<User, AddUserError> InstrumentedUserRepository::AddUser(
+    User user) {
+  return Timed(add_,
+               [&] { return repository_->AddUser(std::move(user)); });
+}
+
+std::expected<void, UpdateUserError>
+InstrumentedUserRepository::UpdatePassword(const std::string& login,
+                                           const std::string& password) {
+  return Timed(update_password_, [&] {
+    return repository_->UpdatePassword(login, password);
+  });
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "metrics_registry.hpp"
+#include "task_batch_writer.hpp"
+#include "task_repository.hpp"
+#include "user_repository.hpp"
+
+// Обёртки, замеряющие время каждого обращения к репозиторию:
+// taskmanager_repository_query_duration_seconds{repository,operation}.
+// Ставятся прямо над репозиторием базы, под кэшем, чтобы считались только
+// настоящие запросы.
+//
+// writer — пакетная запись того же хранилища (обычно указывает внутрь
+// repository). С ним обёртка сама служит TaskBatchWriter для
+// CoalescingTaskRepository, и пакеты замеряются как operation="WriteBatch";
+// без него WriteBatch бросает std::logic_error.
+class InstrumentedTaskRepository final : public TaskRepository,
+                                         public TaskBatchWriter {
+ public:
+  InstrumentedTaskRepository(std::unique_ptr<TaskRepository> repository,
+                             MetricsRegistry& metrics,
+                             TaskBatchWriter* writer = nullptr);
+
+  std::expected<Task, AddTaskError> AddTask(const Task& task) override;
+  std::expected<Task, FindTaskError> GetTaskById(const Uuid& task_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUser(
+      const Uuid& user_id) override;
+  std::expected<std::vector<Task>, FindTaskError> GetTasksByUserPage(
+      const Uuid& user_id, const std::optional<TaskPageCursor>& after,
+      std::size_t limit) override;
+  std::expected<Task, UpdateTaskError> UpdateTaskStatus(
+      const Uuid& task_id, TaskStatus status) override;
+  std::expected<Task, DeleteTaskError> DeleteTaskById(
+      const Uuid& task_id) override;
+  std::expected<std::vector<Task>, AddTaskError> AddTasks(
+      const std::vector<Task>& tasks) override;
+  std::expected<std::vector<Task>, UpdateTaskError> UpdateTaskStatuses(
+      const std::vector<std::pair<Uuid, TaskStatus>>& updates) override;
+
+  TaskWriteBatchResult WriteBatch(const TaskWriteBatch& batch) override;
+
+ private:
+  std::unique_ptr<TaskRepository> repository_;
+  TaskBatchWriter* writer_;
+  LatencyHistogram& add_;
+  LatencyHistogram& get_by_id_;
+  LatencyHistogram& get_by_user_;
+  LatencyHistogram& get_page_;
+  LatencyHistogram& update_status_;
+  LatencyHistogram& delete_;
+  LatencyHistogram& add_bulk_;
+  LatencyHistogram& update_status_bulk_;
+  // Только при writer_.
+  LatencyHistogram* write_batch_ = nullptr;
+};
+
+class InstrumentedUserRepository final : public UserRepository {
+ public:
+  InstrumentedUserRepository(std::unique_ptr<UserRepository> repository,
+                             MetricsRegistry& metrics);
+
+  std::expected<User, FindUserError> FindUser(
+      const std::string& login) override;
+  std::expected<User, AddUserError> AddUser(User user) override;
+  std::expected<void, UpdateUserError> UpdatePassword(
+      const std::string& login, const std::string& password) override;
+
+ private:
+  std::unique_ptr<UserRepository> repository_;
+  LatencyHistogram& find_;
+  LatencyHistogram& add_;
+  LatencyHistogram& update_password_;
+};
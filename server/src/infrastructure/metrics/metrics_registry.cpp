@@ -0,0 +1,255 @@
+#include "metrics_registry.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace {
+
+std::atomic<std::size_t> g_next_shard{0};
+
+void AppendDouble(std::string& out, double value) {
+  if (std::isinf(value)) {
+    out += value > 0 ? "+Inf" : "-Inf";
+    return;
+  }
+  char buffer[32];
+  // Счётчики — целыми числами, остальное — 0.0001, а не 1e-04.
+  const auto [end, ec] =
+      value == std::trunc(value) && std::abs(value) < 1e15
+          ? std::to_chars(buffer, buffer + sizeof(buffer),
+                          static_cast<std::int64_t>(value))
+          : std::to_chars(buffer, buffer + sizeof(buffer), value,
+                          std::chars_format::general);
+  out.append(buffer, end);
+}
+
+void AppendLabelValue(std::string& out, std::string_view value) {
+  for (const char c : value) {
+    switch (c) {
+      case '\\':
+        out += "\\\\";
+        break;
+      case '"':
+        out += "\\\"";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      default:
+        out += c;
+    }
+  }
+}
+
+}  // namespace
+
+std::size_t ThisThreadMetricShard() {
+  thread_local const std::size_t shard =
+      g_next_shard.fetch_add(1, std::memory_order_relaxed);
+  return shard;
+}
+
+std::uint64_t Counter::Value() const {
+  std::uint64_t total = 0;
+  for (const auto& cell : cells_)
+    total += cell.value.load(std::memory_order_relaxed);
+  return total;
+}
+
+std::uint64_t LatencyHistogram::BucketMaxValue(std::size_t index) {
+  if (index < kSubBuckets)
+    return index;
+  const auto shift = static_cast<unsigned>(index / kSubBuckets - 1);
+  const std::uint64_t low = (kSubBuckets + index % kSubBuckets) << shift;
+  return low + (1ull << shift) - 1;
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+  Snapshot snapshot;
+  for (const auto& shard : shards_) {
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+      const auto n = shard.counts[i].load(std::memory_order_relaxed);
+      snapshot.counts[i] += n;
+      snapshot.count += n;
+    }
+    snapshot.sum += shard.sum.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+std::uint64_t LatencyHistogram::Snapshot::CountAtOrBelow(
+    std::uint64_t value) const {
+  std::size_t end = BucketIndex(value) + 1;
+  if (BucketMaxValue(end - 1) > value)
+    --end;
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i < end; ++i)
+    total += counts[i];
+  return total;
+}
+
+std::uint64_t LatencyHistogram::Snapshot::ValueAtQuantile(double q) const {
+  if (count == 0)
+    return 0;
+  const auto rank = std::max<std::uint64_t>(
+      1, static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) *
+                                              static_cast<double>(count))));
+  std::uint64_t seen = 0;
+  for (std::size_t i = 0; i < kBucketCount; ++i) {
+    seen += counts[i];
+    if (seen >= rank)
+      return BucketMaxValue(i);
+  }
+  return kMaxValue;
+}
+
+const std::array<double, 16> MetricsWriter::kLatencyBounds = {
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025,
+    0.05,   0.1,     0.25,   0.5,   1,      2.5,   5,     10};
+
+void MetricsWriter::WriteCounter(std::string_view name, std::string_view help,
+                                 const MetricLabels& labels, double value) {
+  Header(name, help, "counter");
+  Sample(name, labels, {}, {}, value);
+}
+
+void MetricsWriter::WriteGauge(std::string_view name, std::string_view help,
+                               const MetricLabels& labels, double value) {
+  Header(name, help, "gauge");
+  Sample(name, labels, {}, {}, value);
+}
+
+void MetricsWriter::WriteHistogram(std::string_view name,
+                                   std::string_view help,
+                                   const MetricLabels& labels,
+                                   std::span<const double> bounds,
+                                   std::span<const std::uint64_t> cumulative,
+                                   double sum, std::uint64_t count) {
+  Header(name, help, "histogram");
+  const std::string bucket = std::string(name) + "_bucket";
+  std::string le;
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    le.clear();
+    AppendDouble(le, bounds[i]);
+    Sample(bucket, labels, "le", le, static_cast<double>(cumulative[i]));
+  }
+  Sample(bucket, labels, "le", "+Inf", static_cast<double>(count));
+  Sample(std::string(name) + "_sum", labels, {}, {}, sum);
+  Sample(std::string(name) + "_count", labels, {}, {},
+         static_cast<double>(count));
+}
+
+void MetricsWriter::WriteLatency(std::string_view name, std::string_view help,
+                                 const MetricLabels& labels,
+                                 const LatencyHistogram::Snapshot& snapshot) {
+  std::array<std::uint64_t, kLatencyBounds.size()> cumulative{};
+  for (std::size_t i = 0; i < kLatencyBounds.size(); ++i) {
+    cumulative[i] = snapshot.CountAtOrBelow(
+        static_cast<std::uint64_t>(std::llround(kLatencyBounds[i] * 1e6)));
+  }
+  WriteHistogram(name, help, labels, kLatencyBounds, cumulative,
+                 static_cast<double>(snapshot.sum) / 1e6, snapshot.count);
+}
+
+void MetricsWriter::Header(std::string_view name, std::string_view help,
+                           std::string_view type) {
+  if (family_ == name)
+    return;
+  family_ = name;
+  out_ += "# HELP ";
+  out_ += name;
+  out_ += ' ';
+  out_ += help;
+  out_ += "\n# TYPE ";
+  out_ += name;
+  out_ += ' ';
+  out_ += type;
+  out_ += '\n';
+}
+
+void MetricsWriter::Sample(std::string_view name, const MetricLabels& labels,
+                           std::string_view extra_label,
+                           std::string_view extra_value, double value) {
+  out_ += name;
+  if (!labels.empty() || !extra_label.empty()) {
+    char separator = '{';
+    for (const auto& [key, label_value] : labels) {
+      out_ += separator;
+      out_ += key;
+      out_ += "=\"";
+      AppendLabelValue(out_, label_value);
+      out_ += '"';
+      separator = ',';
+    }
+    if (!extra_label.empty()) {
+      out_ += separator;
+      out_ += extra_label;
+      out_ += "=\"";
+      out_ += extra_value;
+      out_ += '"';
+    }
+    out_ += '}';
+  }
+  out_ += ' ';
+  AppendDouble(out_, value);
+  out_ += '\n';
+}
+
+template <class T>
+T& MetricsRegistry::GetOrAdd(std::vector<Family<T>>& families,
+                             std::string_view name, std::string_view help,
+                             const MetricLabels& labels) {
+  auto family = std::find_if(families.begin(), families.end(),
+                             [name](const auto& f) { return f.name == name; });
+  if (family == families.end()) {
+    families.push_back({std::string(name), std::string(help), {}});
+    family = std::prev(families.end());
+  }
+  for (auto& [metric_labels, metric] : family->metrics) {
+    if (metric_labels == labels)
+      return *metric;
+  }
+  family->metrics.emplace_back(labels, std::make_unique<T>());
+  return *family->metrics.back().second;
+}
+
+Counter& MetricsRegistry::GetCounter(std::string_view name,
+                                     std::string_view help,
+                                     const MetricLabels& labels) {
+  std::lock_guard lock(mutex_);
+  return GetOrAdd(counters_, name, help, labels);
+}
+
+LatencyHistogram& MetricsRegistry::GetHistogram(std::string_view name,
+                                                std::string_view help,
+                                                const MetricLabels& labels) {
+  std::lock_guard lock(mutex_);
+  return GetOrAdd(histograms_, name, help, labels);
+}
+
+void MetricsRegistry::AddCollector(Collector collector) {
+  std::lock_guard lock(mutex_);
+  collectors_.push_back(std::move(collector));
+}
+
+std::string MetricsRegistry::Render() const {
+  std::string out;
+  MetricsWriter writer(out);
+  std::lock_guard lock(mutex_);
+  for (const auto& family : counters_) {
+    for (const auto& [labels, counter] : family.metrics) {
+      writer.WriteCounter(family.name, family.help, labels,
+                          static_cast<double>(counter->Value()));
+    }
+  }
+  for (const auto& family : histograms_) {
+    for (const auto& [labels, histogram] : family.metrics) {
+      writer.WriteLatency(family.name, family.help, labels,
+                          histogram->GetSnapshot());
+    }
+  }
+  for (const auto& collector : collectors_)
+    collector(writer);
+  return out;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+// Ячейка счётчика выбирается по потоку: потоки с разными номерами пишут в
+// разные кэш-линии и не мешают друг другу.
+std::size_t ThisThreadMetricShard();
+
+// Монотонный счётчик.
+class Counter {
+ public:
+  static constexpr std::size_t kShards = 16;
+
+  void Add(std::uint64_t value = 1) {
+    cells_[ThisThreadMetricShard() % kShards].value.fetch_add(
+        value, std::memory_order_relaxed);
+  }
+
+  std::uint64_t Value() const;
+
+ private:
+  struct alignas(64) Cell {
+    std::atomic<std::uint64_t> value{0};
+  };
+
+  std::array<Cell, kShards> cells_;
+};
+
+// Гистограмма задержек в духе HdrHistogram: на каждую степень двойки
+// приходится kSubBuckets линейных корзин, так что значение известно с
+// точностью до 1/kSubBuckets. Значения — в микросекундах, больше
+// kMaxValue считаются равными kMaxValue.
+class LatencyHistogram {
+ public:
+  static constexpr unsigned kSubBucketBits = 3;
+  static constexpr std::uint64_t kSubBuckets = 1u << kSubBucketBits;
+  static constexpr unsigned kMaxValueBits = 36;
+  static constexpr std::uint64_t kMaxValue = (1ull << kMaxValueBits) - 1;
+  static constexpr std::size_t kBucketCount =
+      kSubBuckets + (kMaxValueBits - kSubBucketBits) * kSubBuckets;
+  static constexpr std::size_t kShards = 8;
+
+  struct Snapshot {
+    std::array<std::uint64_t, kBucketCount> counts{};
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+
+    // Записи со значением не больше value. Корзина, в которую попадает
+    // value, но которая заканчивается выше него, не считается: лучше
+    // недосчитать до 1/kSubBuckets, чем включить записи больше value.
+    std::uint64_t CountAtOrBelow(std::uint64_t value) const;
+    // Наибольшее значение корзины, в которой лежит q-квантиль (q в [0, 1]).
+    std::uint64_t ValueAtQuantile(double q) const;
+  };
+
+  void Record(std::chrono::microseconds value) {
+    const auto us = static_cast<std::uint64_t>(
+        value.count() > 0 ? value.count() : 0);
+    Shard& shard = shards_[ThisThreadMetricShard() % kShards];
+    shard.counts[BucketIndex(us)].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(us, std::memory_order_relaxed);
+  }
+
+  Snapshot GetSnapshot() const;
+
+  static std::size_t BucketIndex(std::uint64_t value) {
+    value = value < kMaxValue ? value : kMaxValue;
+    if (value < kSubBuckets)
+      return static_cast<std::size_t>(value);
+    const unsigned shift = std::bit_width(value) - 1 - kSubBucketBits;
+    return static_cast<std::size_t>(kSubBuckets * (shift + 1) +
+                                    (value >> shift) - kSubBuckets);
+  }
+  // Наибольшее значение, попадающее в корзину.
+  static std::uint64_t BucketMaxValue(std::size_t index);
+
+ private:
+  struct alignas(64) Shard {
+    std::array<std::atomic<std::uint64_t>, kBucketCount> counts{};
+    std::atomic<std::uint64_t> sum{0};
+  };
+
+  std::array<Shard, kShards> shards_;
+};
+
+// Текстовый формат Prometheus (version 0.0.4). Сэмплы одного семейства
+// должны идти подряд: HELP и TYPE пишутся при смене имени.
+class MetricsWriter {
+ public:
+  explicit MetricsWriter(std::string& out) : out_(out) {}
+
+  void WriteCounter(std::string_view name, std::string_view help,
+                    const MetricLabels& labels, double value);
+  void WriteGauge(std::string_view name, std::string_view help,
+                  const MetricLabels& labels, double value);
+  // bounds — верхние границы корзин по возрастанию, cumulative[i] — число
+  // наблюдений не больше bounds[i]; корзина +Inf равна count.
+  void WriteHistogram(std::string_view name, std::string_view help,
+                      const MetricLabels& labels,
+                      std::span<const double> bounds,
+                      std::span<const std::uint64_t> cumulative, double sum,
+                      std::uint64_t count);
+  // Гистограмма задержек в секундах с границами kLatencyBounds.
+  void WriteLatency(std::string_view name, std::string_view help,
+                    const MetricLabels& labels,
+                    const LatencyHistogram::Snapshot& snapshot);
+
+  // Границы в секундах для гистограмм задержек.
+  static const std::array<double, 16> kLatencyBounds;
+
+ private:
+  void Header(std::string_view name, std::string_view help,
+              std::string_view type);
+  void Sample(std::string_view name, const MetricLabels& labels,
+              std::string_view extra_label, std::string_view extra_value,
+              double value);
+
+  std::string& out_;
+  std::string family_;
+};
+
+// Реестр метрик процесса. Счётчики и гистограммы создаются при регистрации
+// компонентов и живут, пока жив реестр; запись в них не берёт блокировок.
+// Метрики, которые компоненты уже считают сами (Stats пулов и кэшей),
+// выводятся сборщиками, вызываемыми при каждом Render.
+class MetricsRegistry {
+ public:
+  using Collector = std::function<void(MetricsWriter&)>;
+
+  // Повторный вызов с теми же именем и метками возвращает тот же объект.
+  Counter& GetCounter(std::string_view name, std::string_view help,
+                      const MetricLabels& labels = {});
+  LatencyHistogram& GetHistogram(std::string_view name, std::string_view help,
+                                 const MetricLabels& labels = {});
+
+  void AddCollector(Collector collector);
+
+  std::string Render() const;
+
+ private:
+  template <class T>
+  struct Family {
+    std::string name;
+    std::string help;
+    std::vector<std::pair<MetricLabels, std::unique_ptr<T>>> metrics;
+  };
+
+  template <class T>
+  static T& GetOrAdd(std::vector<Family<T>>& families, std::string_view name,
+                     std::string_view help, const MetricLabels& labels);
+
+  mutable std::mutex mutex_;
+  std::vector<Family<Counter>> counters_;
+  std::vector<Family<LatencyHistogram>> histograms_;
+  std::vector<Collector> collectors_;
+};
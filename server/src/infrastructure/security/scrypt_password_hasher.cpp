@@ -0,0 +1,197 @@
+#include "scrypt_password_hasher.hpp"
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+namespace {
+
+using Options = ScryptPasswordHasher::Options;
+
+constexpr std::string_view kPrefix = "$scrypt$";
+constexpr std::size_t kSaltSize = 16;
+constexpr std::size_t kKeySize = 32;
+// Предел памяти на один хэш, в том числе для параметров, прочитанных из
+// хранилища.
+constexpr std::uint64_t kMaxMemory = std::uint64_t{1} << 30;
+constexpr std::size_t kMaxStoredKeySize = 64;
+
+// Столько выделяет EVP_PBE_scrypt: N + 2 блоков V и p блоков B.
+std::uint64_t MemoryFor(const Options& options) {
+  return std::uint64_t{128} * options.r *
+         ((std::uint64_t{1} << options.log_n) + 2 + options.p);
+}
+
+bool Valid(const Options& options) {
+  // N < 2^(16 r) — ограничение самого scrypt.
+  return options.log_n >= 1 && options.log_n <= 30 && options.r >= 1 &&
+         options.r <= 1024 && options.p >= 1 && options.p <= 1024 &&
+         options.log_n < 16 * options.r && MemoryFor(options) <= kMaxMemory;
+}
+
+bool SameOptions(const Options& a, const Options& b) {
+  return a.log_n == b.log_n && a.r == b.r && a.p == b.p;
+}
+
+bool Derive(const std::string& password, std::string_view salt,
+            const Options& options, unsigned char* key,
+            std::size_t key_size) {
+  return EVP_PBE_scrypt(
+             password.data(), password.size(),
+             reinterpret_cast<const unsigned char*>(salt.data()),
+             salt.size(), std::uint64_t{1} << options.log_n, options.r,
+             options.p, MemoryFor(options), key, key_size) == 1;
+}
+
+std::string EncodeBase64(const unsigned char* data, std::size_t size) {
+  std::string text(4 * ((size + 2) / 3), '\0');
+  EVP_EncodeBlock(reinterpret_cast<unsigned char*>(text.data()), data,
+                  static_cast<int>(size));
+  return text;
+}
+
+std::optional<std::string> DecodeBase64(std::string_view text) {
+  if (text.empty() || text.size() % 4 != 0)
+    return std::nullopt;
+  std::string data(text.size() / 4 * 3, '\0');
+  const int size = EVP_DecodeBlock(
+      reinterpret_cast<unsigned char*>(data.data()),
+      reinterpret_cast<const unsigned char*>(text.data()),
+      static_cast<int>(text.size()));
+  if (size < 0)
+    return std::nullopt;
+  // EVP_DecodeBlock возвращает дополнение '=' как нулевые байты.
+  std::size_t padding = 0;
+  while (padding < 2 && text[text.size() - 1 - padding] == '=')
+    ++padding;
+  data.resize(static_cast<std::size_t>(size) - padding);
+  return data;
+}
+
+// Разбирает "<name><число>" в начале text и отрезает его.
+bool ReadParam(std::string_view& text, std::string_view name,
+               unsigned& value) {
+  if (!text.starts_with(name))
+    return false;
+  text.remove_prefix(name.size());
+  const auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  if (error != std::errc{})
+    return false;
+  text.remove_prefix(static_cast<std::size_t>(end - text.data()));
+  return true;
+}
+
+struct StoredHash {
+  Options options;
+  std::string salt;
+  std::string key;
+};
+
+// stored — без префикса kPrefix.
+std::optional<StoredHash> ParseHash(std::string_view stored) {
+  const auto params_end = stored.find('$');
+  if (params_end == std::string_view::npos)
+    return std::nullopt;
+  const auto salt_end = stored.find('$', params_end + 1);
+  if (salt_end == std::string_view::npos)
+    return std::nullopt;
+
+  StoredHash hash;
+  std::string_view params = stored.substr(0, params_end);
+  if (!ReadParam(params, "ln=", hash.options.log_n) ||
+      !ReadParam(params, ",r=", hash.options.r) ||
+      !ReadParam(params, ",p=", hash.options.p) || !params.empty() ||
+      !Valid(hash.options)) {
+    return std::nullopt;
+  }
+  auto salt = DecodeBase64(
+      stored.substr(params_end + 1, salt_end - params_end - 1));
+  auto key = DecodeBase64(stored.substr(salt_end + 1));
+  if (!salt || !key || key->empty() || key->size() > kMaxStoredKeySize)
+    return std::nullopt;
+  hash.salt = std::move(*salt);
+  hash.key = std::move(*key);
+  return hash;
+}
+
+// Открытый пароль старой записи. Сравниваются SHA-256, чтобы время не
+// зависело и от длины.
+std::expected<bool, PasswordHashError> ComparePlain(
+    const std::string& password, const std::string& stored) {
+  std::array<unsigned char, EVP_MAX_MD_SIZE> a{};
+  std::array<unsigned char, EVP_MAX_MD_SIZE> b{};
+  unsigned int size = 0;
+  if (EVP_Digest(password.data(), password.size(), a.data(), &size,
+                 EVP_sha256(), nullptr) != 1 ||
+      EVP_Digest(stored.data(), stored.size(), b.data(), &size,
+                 EVP_sha256(), nullptr) != 1) {
+    return std::unexpected(PasswordHashError::InternalError);
+  }
+  return CRYPTO_memcmp(a.data(), b.data(), size) == 0;
+}
+
+}  // namespace
+
+ScryptPasswordHasher::ScryptPasswordHasher(Options options)
+    : options_(options) {
+  if (!Valid(options_))
+    throw std::invalid_argument("scrypt parameters are out of range");
+}
+
+std::expected<std::string, PasswordHashError> ScryptPasswordHasher::Hash(
+    const std::string& password) {
+  std::array<unsigned char, kSaltSize> salt{};
+  std::array<unsigned char, kKeySize> key{};
+  if (RAND_bytes(salt.data(), static_cast<int>(salt.size())) != 1 ||
+      !Derive(password,
+              {reinterpret_cast<const char*>(salt.data()), salt.size()},
+              options_, key.data(), key.size())) {
+    return std::unexpected(PasswordHashError::InternalError);
+  }
+  std::string hash(kPrefix);
+  hash += "ln=" + std::to_string(options_.log_n) +
+          ",r=" + std::to_string(options_.r) +
+          ",p=" + std::to_string(options_.p);
+  hash += '$';
+  hash += EncodeBase64(salt.data(), salt.size());
+  hash += '$';
+  hash += EncodeBase64(key.data(), key.size());
+  return hash;
+}
+
+std::expected<PasswordCheck, PasswordHashError> ScryptPasswordHasher::Verify(
+    const std::string& password, const std::string& stored) {
+  PasswordCheck check;
+  if (!std::string_view(stored).starts_with(kPrefix)) {
+    const auto matches = ComparePlain(password, stored);
+    if (!matches)
+      return std::unexpected(matches.error());
+    check.matches = *matches;
+    check.needs_rehash = true;
+    return check;
+  }
+
+  const auto hash = ParseHash(std::string_view(stored).substr(kPrefix.size()));
+  if (!hash)
+    return std::unexpected(PasswordHashError::InternalError);
+  std::string key(hash->key.size(), '\0');
+  if (!Derive(password, hash->salt, hash->options,
+              reinterpret_cast<unsigned char*>(key.data()), key.size())) {
+    return std::unexpected(PasswordHashError::InternalError);
+  }
+  check.matches =
+      CRYPTO_memcmp(key.data(), hash->key.data(), key.size()) == 0;
+  check.needs_rehash = !SameOptions(hash->options, options_) ||
+                       hash->salt.size() != kSaltSize ||
+                       hash->key.size() != kKeySize;
+  return check;
+}
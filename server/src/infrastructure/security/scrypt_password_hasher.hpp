@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <string>
+
+#include "password_hasher.hpp"
+
+// scrypt из OpenSSL. Хэш хранится строкой
+//   $scrypt$ln=<log2 N>,r=<r>,p=<p>$<соль base64>$<ключ base64>,
+// поэтому параметры можно менять: старые хэши проверяются со своими и
+// помечаются needs_rehash. Значение без префикса $scrypt$ считается
+// открытым паролем записи, созданной до хэширования.
+class ScryptPasswordHasher final : public PasswordHasher {
+ public:
+  struct Options {
+    // N = 2^log_n. Один хэш занимает около 128 * r * N байт памяти
+    // (32 МиБ по умолчанию); время растёт так же. p умножает время, но не
+    // память: OpenSSL выполняет проходы по очереди.
+    unsigned log_n = 15;
+    unsigned r = 8;
+    unsigned p = 1;
+  };
+
+  ScryptPasswordHasher() : ScryptPasswordHasher(Options{}) {}
+  // Бросает std::invalid_argument, если scrypt не примет параметры.
+  explicit ScryptPasswordHasher(Options options);
+
+  std::expected<std::string, PasswordHashError> Hash(
+      const std::string& password) override;
+  std::expected<PasswordCheck, PasswordHashError> Verify(
+      const std::string& password, const std::string& stored) override;
+
+ private:
+  Options options_;
+};
@@ -1,21 +1,94 @@
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <vector>
 
 #include <boost/log/trivial.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
 #include <boost/log/utility/setup/console.hpp>
 
+#include "access_log.hpp"
+#include "bootstrap/metrics.hpp"
 #include "bootstrap/routes.hpp"
+#include "dispatch_pool.hpp"
+#include "handlers/admin_handlers.hpp"
 #include "router.hpp"
 #include "server.hpp"
 
+#include "caching_task_repository.hpp"
+#include "coalescing_task_repository.hpp"
+#include "memory_task_repository.hpp"
+#include "memory_user_repository.hpp"
+#include "instrumented_repositories.hpp"
+#include "wal_repositories.hpp"
 #include "default_user_service.hpp"
+#include "scrypt_password_hasher.hpp"
+#include "postgres_task_repository.hpp"
 #include "postgres_user_repository.hpp"
 #include "connection_pool.hpp"
 
+namespace {
+
+std::size_t GetEnvSize(const char* name, std::size_t default_value) {
+  const char* value = std::getenv(name);
+  return value ? static_cast<std::size_t>(std::stoul(value)) : default_value;
+}
+
+struct Repositories {
+  std::unique_ptr<UserRepository> users;
+  std::unique_ptr<TaskRepository> tasks;
+  // Пакетная запись задач, если хранилище её умеет; указывает внутрь tasks.
+  TaskBatchWriter* task_writer = nullptr;
+};
+
+// Репозитории поверх пулов соединений; метрики пулов пишутся в metrics.
+// handler_threads — число потоков, выполняющих обработчики.
+Repositories MakePostgresRepositories(std::size_t handler_threads,
+                                      MetricsRegistry& metrics) {
+  const char* db_env = std::getenv("DB_CONNECTION_STRING");
+  const std::string connection_string =
+      db_env ? std::string{db_env} : std::string{};
+
+  // По умолчанию соединений столько же, сколько потоков, выполняющих
+  // обработчики, и все открываются при старте.
+  PqxxConnectionPool::Options pool_options;
+  pool_options.max_size = GetEnvSize("DB_POOL_MAX", handler_threads);
+  pool_options.min_size = GetEnvSize("DB_POOL_MIN", pool_options.max_size);
+  pool_options.acquire_timeout =
+      std::chrono::milliseconds(GetEnvSize("DB_ACQUIRE_TIMEOUT_MS", 5000));
+  const auto prepare = [](pqxx::connection& connection) {
+    PostgreSQLTaskRepository::PrepareStatements(connection);
+    PostgreSQLUserRepository::PrepareStatements(connection);
+  };
+  auto pool = std::make_shared<PqxxConnectionPool>(connection_string,
+                                                   pool_options, prepare);
+
+  // DB_READ_CONNECTION_STRING: реплика для чтения задач.
+  std::shared_ptr<PqxxConnectionPool> read_pool;
+  const char* read_env = std::getenv("DB_READ_CONNECTION_STRING");
+  if (read_env && *read_env) {
+    read_pool =
+        std::make_shared<PqxxConnectionPool>(read_env, pool_options, prepare);
+  }
+  NamedConnectionPools pools = {{"primary", pool}};
+  if (read_pool)
+    pools.emplace_back("replica", read_pool);
+  AddConnectionPoolMetrics(metrics, std::move(pools));
+
+  auto tasks = std::make_unique<PostgreSQLTaskRepository>(pool, read_pool);
+  TaskBatchWriter* task_writer = tasks.get();
+  return {std::make_unique<PostgreSQLUserRepository>(pool), std::move(tasks),
+          task_writer};
+}
+
+}  // namespace
+
 int main(int /*argc*/, char* /*argv*/[]) {
   try {
     boost::log::add_common_attributes();
@@ -32,25 +105,197 @@ int main(int /*argc*/, char* /*argv*/[]) {
     const std::size_t threads = std::thread::hardware_concurrency();
     std::cout << "Threads count: " << threads << "\n";
 
-    auto router = std::make_shared<SimpleRouter>();
+    // APP_DISPATCH_THREADS > 0 выносит обработчики (и обращения к БД)
+    // с потоков io_context на отдельный ограниченный пул.
+    const std::size_t dispatch_threads = GetEnvSize("APP_DISPATCH_THREADS", 0);
+    const std::size_t dispatch_queue = GetEnvSize("APP_DISPATCH_QUEUE", 1024);
+    std::shared_ptr<DispatchPool> dispatch_pool;
+    if (dispatch_threads > 0) {
+      dispatch_pool = std::make_shared<DispatchPool>(
+          "handlers", dispatch_threads, dispatch_queue);
+      std::cout << "Dispatch threads: " << dispatch_threads
+                << ", queue depth: " << dispatch_queue << "\n";
+    }
 
-    const char* db_env = std::getenv("DB_CONNECTION_STRING");
-    const std::string connection_string =
-        db_env ? std::string{db_env} : std::string{};
+    // Вход и регистрация выполняются целиком, вместе с обращениями к
+    // хранилищу, на своём пуле из PASSWORD_HASH_THREADS потоков: сессия ждёт
+    // их ответа, не занимая ни поток io_context, ни поток обработчиков.
+    // Сверх PASSWORD_HASH_QUEUE ожидающих — 429. Поток пула занят и на время
+    // запросов к базе (FindUser, AddUser, UpdatePassword), поэтому потоков
+    // берётся с запасом на задержку базы: scrypt держит 128 * r * N байт
+    // только во время хэширования. Медленная база сокращает пропускную
+    // способность входа, и лишние запросы получают 429, а не копятся.
+    auto hash_pool = std::make_shared<DispatchPool>(
+        "password_hash", GetEnvSize("PASSWORD_HASH_THREADS", 4),
+        GetEnvSize("PASSWORD_HASH_QUEUE", 16));
 
-    const std::size_t pool_size = threads;
-    auto pool = std::make_shared<PqxxConnectionPool>(connection_string, pool_size);
+    SessionOptions session_options;
+    session_options.idle_timeout =
+        std::chrono::seconds(GetEnvSize("APP_IDLE_TIMEOUT_SECONDS", 60));
+    session_options.read_timeout =
+        std::chrono::seconds(GetEnvSize("APP_READ_TIMEOUT_SECONDS", 30));
+
+    // Журнал запросов пишется фоновым потоком. LOG_LEVEL действует и на
+    // остальные логи, LOG_SAMPLE_EVERY=N оставляет каждый N-й успешный
+    // запрос (ошибки пишутся всегда).
+    AccessLog::Options log_options;
+    if (const char* level_env = std::getenv("LOG_LEVEL");
+        level_env && *level_env) {
+      const auto level = ParseLogLevel(level_env);
+      if (!level)
+        throw std::invalid_argument("Unknown LOG_LEVEL: " +
+                                    std::string{level_env});
+      log_options.level = *level;
+    }
+    log_options.sample_every =
+        static_cast<std::uint32_t>(GetEnvSize("LOG_SAMPLE_EVERY", 1));
+    auto access_log = std::make_shared<AccessLog>(std::clog, log_options);
+    session_options.access_log = access_log;
+
+    // Метрики отдаются на GET /metrics в формате Prometheus.
+    auto metrics = std::make_shared<MetricsRegistry>();
+    AddBufferPoolMetrics(*metrics);
+    AddAccessLogMetrics(*metrics, access_log);
+    std::vector<std::shared_ptr<DispatchPool>> pools = {hash_pool};
+    if (dispatch_pool)
+      pools.insert(pools.begin(), dispatch_pool);
+    AddDispatchPoolMetrics(*metrics, std::move(pools));
+
+    auto router = std::make_shared<SimpleRouter>(metrics);
+
+    // STORAGE=memory: задачи и пользователи в памяти процесса, без
+    // PostgreSQL. Данные теряются при перезапуске.
+    // STORAGE=wal: то же, но с журналом и снимками в каталоге WAL_DIR.
+    const char* storage_env = std::getenv("STORAGE");
+    const std::string storage =
+        storage_env && *storage_env ? storage_env : "postgres";
+    Repositories repositories;
+    if (storage == "memory") {
+      repositories = {std::make_unique<InMemoryUserRepository>(),
+                      std::make_unique<InMemoryTaskRepository>()};
+      std::cout << "Storage: in-memory\n";
+    } else if (storage == "wal") {
+      WalStorage::Options wal_options;
+      const char* wal_dir_env = std::getenv("WAL_DIR");
+      wal_options.directory =
+          wal_dir_env && *wal_dir_env ? wal_dir_env : "data";
+      wal_options.commit_delay =
+          std::chrono::microseconds(GetEnvSize("WAL_COMMIT_DELAY_US", 0));
+      wal_options.snapshot_every =
+          GetEnvSize("WAL_SNAPSHOT_EVERY", wal_options.snapshot_every);
+      auto wal_storage = std::make_shared<WalStorage>(wal_options);
+      repositories = {std::make_unique<WalUserRepository>(wal_storage),
+                      std::make_unique<WalTaskRepository>(wal_storage)};
+      std::cout << "Storage: WAL in " << wal_options.directory << "\n";
+    } else if (storage == "postgres") {
+      repositories = MakePostgresRepositories(
+          dispatch_threads > 0 ? dispatch_threads : threads, *metrics);
+    } else {
+      throw std::invalid_argument("Unknown STORAGE: " + storage);
+    }
+
+    // Стоимость scrypt; хэши с прежними параметрами пересчитываются при
+    // следующем входе.
+    ScryptPasswordHasher::Options scrypt_options;
+    scrypt_options.log_n = static_cast<unsigned>(
+        GetEnvSize("PASSWORD_SCRYPT_LOG_N", scrypt_options.log_n));
+    scrypt_options.r = static_cast<unsigned>(
+        GetEnvSize("PASSWORD_SCRYPT_R", scrypt_options.r));
+    scrypt_options.p = static_cast<unsigned>(
+        GetEnvSize("PASSWORD_SCRYPT_P", scrypt_options.p));
+    auto password_hasher =
+        std::make_shared<ScryptPasswordHasher>(scrypt_options);
 
     std::shared_ptr<UserService> user_service =
         std::make_shared<DefaultUserService>(
-            std::make_unique<PostgreSQLUserRepository>(pool));
+            std::make_unique<InstrumentedUserRepository>(
+                std::move(repositories.users), *metrics),
+            password_hasher);
+    auto instrumented_tasks = std::make_unique<InstrumentedTaskRepository>(
+        std::move(repositories.tasks), *metrics, repositories.task_writer);
+    // Пакеты объединителя проходят через ту же обёртку, что и одиночные
+    // запросы, и попадают в operation="WriteBatch".
+    TaskBatchWriter* task_writer =
+        repositories.task_writer ? instrumented_tasks.get() : nullptr;
+    std::unique_ptr<TaskRepository> task_repository =
+        std::move(instrumented_tasks);
+    // TASK_WRITE_COALESCE_US > 0 собирает параллельные AddTask,
+    // UpdateTaskStatus и DeleteTaskById в одну транзакцию на столько
+    // микросекунд (или до TASK_WRITE_BATCH_MAX изменений). Только для
+    // PostgreSQL: WAL и так делит fsync между записями.
+    const std::size_t coalesce_us = GetEnvSize("TASK_WRITE_COALESCE_US", 0);
+    if (coalesce_us > 0 && task_writer) {
+      CoalescingTaskRepository::Options coalescing_options;
+      coalescing_options.window = std::chrono::microseconds(coalesce_us);
+      coalescing_options.max_batch =
+          GetEnvSize("TASK_WRITE_BATCH_MAX", coalescing_options.max_batch);
+      auto coalescing = std::make_unique<CoalescingTaskRepository>(
+          std::move(task_repository), *task_writer,
+          coalescing_options);
+      // Как и кэш ниже, живёт в task_service до конца main.
+      AddWriteCoalescingMetrics(*metrics, [coalescing = coalescing.get()] {
+        return coalescing->GetStats();
+      });
+      task_repository = std::move(coalescing);
+      std::cout << "Task write coalescing window: " << coalesce_us << "us\n";
+    }
+    NamedCaches caches;
+    // TASK_CACHE_CAPACITY > 0 включает кэш задач в процессе (ёмкость в
+    // задачах). Инвалидация только локальная: включать, когда в базу пишет
+    // один экземпляр сервера. С репликой в кэш может попасть отставшее
+    // чтение и продержаться до следующего изменения задач пользователя.
+    const std::size_t cache_capacity = GetEnvSize("TASK_CACHE_CAPACITY", 0);
+    if (cache_capacity > 0) {
+      CachingTaskRepository::Options cache_options;
+      cache_options.capacity = cache_capacity;
+      auto caching = std::make_unique<CachingTaskRepository>(
+          std::move(task_repository), cache_options);
+      // Репозиторий живёт в task_service до конца main, как и реестр.
+      caches.emplace_back("tasks", [cache = caching.get()] {
+        return cache->GetStats().tasks;
+      });
+      caches.emplace_back("user_tasks", [cache = caching.get()] {
+        return cache->GetStats().user_tasks;
+      });
+      task_repository = std::move(caching);
+      std::cout << "Task cache capacity: " << cache_capacity << "\n";
+    }
     std::shared_ptr<TaskService> task_service =
-        std::make_shared<DefaultTaskService>(
-            std::make_unique<PostgreSQLTaskRepository>(pool));
+        std::make_shared<DefaultTaskService>(std::move(task_repository));
+
+    // RESPONSE_CACHE_BYTES > 0 включает ETag/304 и кэш сериализованных
+    // ответов на чтение задач. Версии данных ведутся в процессе, поэтому,
+    // как и TASK_CACHE_CAPACITY, — только для одного пишущего экземпляра.
+    std::shared_ptr<ResponseCache> response_cache;
+    if (const auto bytes = GetEnvSize("RESPONSE_CACHE_BYTES", 0); bytes > 0) {
+      response_cache = std::make_shared<ResponseCache>(bytes);
+      caches.emplace_back("responses", [response_cache] {
+        return response_cache->GetStats();
+      });
+      std::cout << "Response cache bytes: " << bytes << "\n";
+    }
+
+    if (!caches.empty())
+      AddCacheMetrics(*metrics, std::move(caches));
+
+    RouterDefaultConfigure(router, user_service, task_service, hash_pool,
+                           response_cache);
+    router->Add(std::make_shared<MetricsHandler>(metrics));
+    // ADMIN_TOKEN включает PUT /admin/log-level.
+    if (const char* token = std::getenv("ADMIN_TOKEN"); token && *token) {
+      router->Add(std::make_shared<LogLevelHandler>(access_log, token));
+    }
 
-    RouterDefaultConfigure(router, user_service, task_service);
+    // APP_IO_MODEL=sharded: io_context, SO_REUSEPORT acceptor и закреплённый
+    // поток на каждое ядро вместо общего io_context.
+    const char* io_model_env = std::getenv("APP_IO_MODEL");
+    const IoModel io_model =
+        io_model_env && std::string_view{io_model_env} == "sharded"
+            ? IoModel::ReusePortShards
+            : IoModel::SharedContext;
 
-    HttpServer server(host, port, router, threads);
+    HttpServer server(host, port, router, threads, dispatch_pool,
+                      session_options, io_model);
     BOOST_LOG_TRIVIAL(info) << "Starting Task Manager server on " << host << ":"
                             << port << std::endl;
     server.Run();
@@ -10,6 +10,15 @@
 using ::testing::_;
 using ::testing::Return;
 
+namespace {
+
+const Uuid kUserId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60");
+const Uuid kTaskId1 = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a21");
+const Uuid kTaskId2 = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a22");
+const Uuid kMissingId = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1aff");
+
+}  // namespace
+
 class DefaultTaskServiceTest : public ::testing::Test {
  protected:
   MockTaskRepository* repo_{};
@@ -24,73 +33,91 @@ class DefaultTaskServiceTest : public ::testing::Test {
 
 TEST_F(DefaultTaskServiceTest, Create_Success) {
   EXPECT_CALL(*repo_, AddTask(_))
-      .WillOnce(Return(Task{"id-1", "u1", "title", "desc", "new"}));
+      .WillOnce(Return(
+          Task{kTaskId1, kUserId, "title", "desc", TaskStatus::InProgress}));
 
-  auto r = service_->CreateTask("u1", "title", "desc", "new");
+  auto r =
+      service_->CreateTask(kUserId, "title", "desc", TaskStatus::InProgress);
 
   ASSERT_TRUE(r.has_value());
-  EXPECT_EQ(r->GetId(), "id-1");
+  EXPECT_EQ(r->GetId(), kTaskId1);
 }
 
 TEST_F(DefaultTaskServiceTest, ChangeStatus_Success) {
-  EXPECT_CALL(*repo_, UpdateTaskStatus("id-1", "done"))
-      .WillOnce(Return(Task{"id-1", "u1", "title", "desc", "done"}));
+  EXPECT_CALL(*repo_, UpdateTaskStatus(kTaskId1, TaskStatus::Done))
+      .WillOnce(
+          Return(Task{kTaskId1, kUserId, "title", "desc", TaskStatus::Done}));
 
-  auto r = service_->ChangeStatus("id-1", "done");
+  auto r = service_->ChangeStatus(kTaskId1, TaskStatus::Done);
 
   ASSERT_TRUE(r.has_value());
-  EXPECT_EQ(r->GetStatus(), "done");
+  EXPECT_EQ(r->GetStatus(), TaskStatus::Done);
 }
 
 TEST_F(DefaultTaskServiceTest, Delete_Success) {
-  EXPECT_CALL(*repo_, DeleteTaskById("id-1"))
-      .WillOnce(Return(std::expected<void, DeleteTaskError>{}));
+  EXPECT_CALL(*repo_, DeleteTaskById(kTaskId1))
+      .WillOnce(
+          Return(Task{kTaskId1, kUserId, "t", "d", TaskStatus::InProgress}));
 
-  auto r = service_->DeleteTask("id-1");
+  auto r = service_->DeleteTask(kTaskId1);
 
   ASSERT_TRUE(r.has_value());
 }
 
 TEST_F(DefaultTaskServiceTest, GetTask_Success) {
-  EXPECT_CALL(*repo_, GetTaskById("id-1"))
-      .WillOnce(Return(Task{"id-1", "u1", "t", "d", "s"}));
+  EXPECT_CALL(*repo_, GetTaskById(kTaskId1))
+      .WillOnce(
+          Return(Task{kTaskId1, kUserId, "t", "d", TaskStatus::InProgress}));
 
-  auto r = service_->GetTask("id-1");
+  auto r = service_->GetTask(kTaskId1);
 
   ASSERT_TRUE(r.has_value());
-  EXPECT_EQ(r->GetId(), "id-1");
-  EXPECT_EQ(r->GetUserId(), "u1");
+  EXPECT_EQ(r->GetId(), kTaskId1);
+  EXPECT_EQ(r->GetUserId(), kUserId);
 }
 
 TEST_F(DefaultTaskServiceTest, GetTask_NotFound) {
-  EXPECT_CALL(*repo_, GetTaskById("missing"))
+  EXPECT_CALL(*repo_, GetTaskById(kMissingId))
       .WillOnce(Return(std::unexpected(FindTaskError::NotFound)));
 
-  auto r = service_->GetTask("missing");
+  auto r = service_->GetTask(kMissingId);
 
   ASSERT_FALSE(r.has_value());
   EXPECT_EQ(r.error(), FindTaskError::NotFound);
 }
 
 TEST_F(DefaultTaskServiceTest, GetUserTasks_Success) {
-  EXPECT_CALL(*repo_, GetTasksByUser("u1"))
-      .WillOnce(
-          Return(std::vector<Task>{Task{"id-1", "u1", "t1", "d1", "Done"},
-                                   Task{"id-2", "u1", "t2", "d2", "Done"}}));
+  EXPECT_CALL(*repo_, GetTasksByUser(kUserId))
+      .WillOnce(Return(std::vector<Task>{
+          Task{kTaskId1, kUserId, "t1", "d1", TaskStatus::Done},
+          Task{kTaskId2, kUserId, "t2", "d2", TaskStatus::Done}}));
 
-  auto r = service_->GetUserTasks("u1");
+  auto r = service_->GetUserTasks(kUserId);
 
   ASSERT_TRUE(r.has_value());
   ASSERT_EQ(r->size(), 2);
-  EXPECT_EQ(r->at(0).GetId(), "id-1");
-  EXPECT_EQ(r->at(1).GetId(), "id-2");
+  EXPECT_EQ(r->at(0).GetId(), kTaskId1);
+  EXPECT_EQ(r->at(1).GetId(), kTaskId2);
+}
+
+TEST_F(DefaultTaskServiceTest, GetUserTasks_KeepsRepositoryOrder) {
+  EXPECT_CALL(*repo_, GetTasksByUser(kUserId))
+      .WillOnce(Return(std::vector<Task>{
+          Task{kTaskId1, kUserId, "b", "d", TaskStatus::InProgress},
+          Task{kTaskId2, kUserId, "a", "d", TaskStatus::Done}}));
+
+  auto r = service_->GetUserTasks(kUserId);
+
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(r->at(0).GetId(), kTaskId1);
+  EXPECT_EQ(r->at(1).GetId(), kTaskId2);
 }
 
 TEST_F(DefaultTaskServiceTest, GetUserTasks_Empty) {
-  EXPECT_CALL(*repo_, GetTasksByUser("u1"))
+  EXPECT_CALL(*repo_, GetTasksByUser(kUserId))
       .WillOnce(Return(std::vector<Task>{}));
 
-  auto r = service_->GetUserTasks("u1");
+  auto r = service_->GetUserTasks(kUserId);
 
   ASSERT_TRUE(r.has_value());
   EXPECT_TRUE(r->empty());
@@ -100,38 +127,55 @@ TEST_F(DefaultTaskServiceTest, Create_Fail) {
   EXPECT_CALL(*repo_, AddTask(_))
       .WillOnce(Return(std::unexpected(AddTaskError::RepositoryError)));
 
-  auto r = service_->CreateTask("u1", "title", "desc", "new");
+  auto r =
+      service_->CreateTask(kUserId, "title", "desc", TaskStatus::InProgress);
 
   ASSERT_FALSE(r.has_value());
   EXPECT_EQ(r.error(), AddTaskError::RepositoryError);
 }
 
 TEST_F(DefaultTaskServiceTest, ChangeStatus_NotFound) {
-  EXPECT_CALL(*repo_, UpdateTaskStatus("missing", "done"))
+  EXPECT_CALL(*repo_, UpdateTaskStatus(kMissingId, TaskStatus::Done))
       .WillOnce(Return(std::unexpected(UpdateTaskError::NotFound)));
 
-  auto r = service_->ChangeStatus("missing", "done");
+  auto r = service_->ChangeStatus(kMissingId, TaskStatus::Done);
 
   ASSERT_FALSE(r.has_value());
   EXPECT_EQ(r.error(), UpdateTaskError::NotFound);
 }
 
 TEST_F(DefaultTaskServiceTest, ChangeStatus_RepositoryError) {
-  EXPECT_CALL(*repo_, UpdateTaskStatus("id-1", "done"))
+  EXPECT_CALL(*repo_, UpdateTaskStatus(kTaskId1, TaskStatus::Done))
       .WillOnce(Return(std::unexpected(UpdateTaskError::RepositoryError)));
 
-  auto r = service_->ChangeStatus("id-1", "done");
+  auto r = service_->ChangeStatus(kTaskId1, TaskStatus::Done);
 
   ASSERT_FALSE(r.has_value());
   EXPECT_EQ(r.error(), UpdateTaskError::RepositoryError);
 }
 
 TEST_F(DefaultTaskServiceTest, Delete_NotFound) {
-  EXPECT_CALL(*repo_, DeleteTaskById("missing"))
+  EXPECT_CALL(*repo_, DeleteTaskById(kMissingId))
       .WillOnce(Return(std::unexpected(DeleteTaskError::NotFound)));
 
-  auto r = service_->DeleteTask("missing");
+  auto r = service_->DeleteTask(kMissingId);
 
   ASSERT_FALSE(r.has_value());
   EXPECT_EQ(r.error(), DeleteTaskError::NotFound);
 }
+
+TEST_F(DefaultTaskServiceTest, ChangeStatus_BumpsVersions) {
+  const Uuid other_user = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a61");
+  EXPECT_CALL(*repo_, UpdateTaskStatus(kTaskId1, TaskStatus::Done))
+      .WillOnce(
+          Return(Task{kTaskId1, kUserId, "t", "d", TaskStatus::Done}));
+  const auto user_version = service_->GetUserTasksVersion(kUserId);
+  const auto task_version = service_->GetTaskVersion(kTaskId1);
+  const auto other_version = service_->GetUserTasksVersion(other_user);
+
+  service_->ChangeStatus(kTaskId1, TaskStatus::Done);
+
+  EXPECT_NE(service_->GetUserTasksVersion(kUserId), user_version);
+  EXPECT_NE(service_->GetTaskVersion(kTaskId1), task_version);
+  EXPECT_EQ(service_->GetUserTasksVersion(other_user), other_version);
+}
@@ -2,42 +2,72 @@
 #include <gtest/gtest.h>
 #include <expected>
 #include <memory>
+#include <stdexcept>
 
 #include "default_user_service.hpp"
+#include "mocks/mock_password_hasher.hpp"
 #include "mocks/mock_user_repository.hpp"
 
 using ::testing::_;
+using ::testing::NiceMock;
 using ::testing::Return;
 
+namespace {
+
+const Uuid kUserId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60");
+
+// Хэш "pwd" у фейкового хэшера.
+const std::string kHash = "hash:pwd";
+
+}  // namespace
+
 class DefaultUserServiceTest : public ::testing::Test {
  protected:
   MockUserRepository* repo_{};  // raw pointer на мок
+  std::shared_ptr<NiceMock<MockPasswordHasher>> hasher_;
   std::unique_ptr<DefaultUserService> service_;
 
   void SetUp() override {
     auto repo_ptr = std::make_unique<MockUserRepository>();
     repo_ = repo_ptr.get();
-    service_ = std::make_unique<DefaultUserService>(std::move(repo_ptr));
+    // Хэш — "hash:" + пароль; значение без "hash:" — старый открытый
+    // пароль.
+    hasher_ = std::make_shared<NiceMock<MockPasswordHasher>>();
+    ON_CALL(*hasher_, Hash(_)).WillByDefault([](const std::string& p) {
+      return std::expected<std::string, PasswordHashError>("hash:" + p);
+    });
+    ON_CALL(*hasher_, Verify(_, _))
+        .WillByDefault([](const std::string& p, const std::string& stored) {
+          PasswordCheck check;
+          check.needs_rehash = !stored.starts_with("hash:");
+          check.matches = stored == (check.needs_rehash ? p : "hash:" + p);
+          return std::expected<PasswordCheck, PasswordHashError>(check);
+        });
+    service_ = std::make_unique<DefaultUserService>(std::move(repo_ptr),
+                                                    hasher_);
   }
 };
 
 TEST_F(DefaultUserServiceTest, Registration_Success) {
   EXPECT_CALL(*repo_, FindUser("alice"))
       .WillOnce(Return(std::unexpected(FindUserError::NotFound)));
-  EXPECT_CALL(*repo_, AddUser(_))
-      .WillOnce(Return(User{"id-1", "alice", "pwd"}));
+  EXPECT_CALL(*repo_, AddUser(_)).WillOnce([](User user) {
+    EXPECT_EQ(user.GetPassword(), kHash);
+    return std::expected<User, AddUserError>(
+        User{kUserId, user.GetName(), user.GetPassword()});
+  });
 
   auto r = service_->Registration("alice", "pwd");
 
   ASSERT_TRUE(r.has_value());
-  EXPECT_EQ(r->GetId(), "id-1");
+  EXPECT_EQ(r->GetId(), kUserId);
   EXPECT_EQ(r->GetName(), "alice");
-  EXPECT_EQ(r->GetPassword(), "pwd");
+  EXPECT_EQ(r->GetPassword(), kHash);
 }
 
 TEST_F(DefaultUserServiceTest, Registration_Duplicate) {
   EXPECT_CALL(*repo_, FindUser("alice"))
-      .WillOnce(Return(User{"id-1", "alice", "pwd"}));
+      .WillOnce(Return(User{kUserId, "alice", kHash}));
 
   auto r = service_->Registration("alice", "pwd");
 
@@ -57,19 +87,47 @@ TEST_F(DefaultUserServiceTest, Registration_RepositoryFail) {
 
 TEST_F(DefaultUserServiceTest, Login_Ok) {
   EXPECT_CALL(*repo_, FindUser("alice"))
-      .WillOnce(Return(User{"id-1", "alice", "pwd"}));
+      .WillOnce(Return(User{kUserId, "alice", kHash}));
+  EXPECT_CALL(*repo_, UpdatePassword(_, _)).Times(0);
 
   auto r = service_->Login("alice", "pwd");
 
   ASSERT_TRUE(r.has_value());
-  EXPECT_EQ(r->GetId(), "id-1");
+  EXPECT_EQ(r->GetId(), kUserId);
   EXPECT_EQ(r->GetName(), "alice");
+  EXPECT_EQ(r->GetPassword(), kHash);
+}
+
+TEST_F(DefaultUserServiceTest, Login_LegacyPasswordIsRehashed) {
+  EXPECT_CALL(*repo_, FindUser("alice"))
+      .WillOnce(Return(User{kUserId, "alice", "pwd"}));
+  EXPECT_CALL(*repo_, UpdatePassword("alice", kHash))
+      .WillOnce(Return(std::expected<void, UpdateUserError>()));
+
+  auto r = service_->Login("alice", "pwd");
+
+  ASSERT_TRUE(r.has_value());
+  EXPECT_EQ(r->GetId(), kUserId);
+  EXPECT_EQ(r->GetPassword(), kHash);
+}
+
+TEST_F(DefaultUserServiceTest, Login_RehashFailureKeepsLogin) {
+  EXPECT_CALL(*repo_, FindUser("alice"))
+      .WillOnce(Return(User{kUserId, "alice", "pwd"}));
+  EXPECT_CALL(*repo_, UpdatePassword("alice", kHash))
+      .WillOnce(Return(std::unexpected(UpdateUserError::RepositoryTimeout)));
+
+  auto r = service_->Login("alice", "pwd");
+
+  ASSERT_TRUE(r.has_value());
   EXPECT_EQ(r->GetPassword(), "pwd");
 }
 
 TEST_F(DefaultUserServiceTest, Login_NotFound) {
   EXPECT_CALL(*repo_, FindUser("alice"))
       .WillOnce(Return(std::unexpected(FindUserError::NotFound)));
+  // Пароль всё равно проверяется — против хэша, посчитанного заранее.
+  EXPECT_CALL(*hasher_, Verify("pwd", "hash:dummy password"));
 
   auto r = service_->Login("alice", "pwd");
 
@@ -77,9 +135,21 @@ TEST_F(DefaultUserServiceTest, Login_NotFound) {
   EXPECT_EQ(r.error(), LoginError::UserNotFound);
 }
 
+TEST(DefaultUserServiceCtorTest, ThrowsWithoutDummyHash) {
+  auto hasher = std::make_shared<NiceMock<MockPasswordHasher>>();
+  ON_CALL(*hasher, Hash(_))
+      .WillByDefault(
+          Return(std::unexpected(PasswordHashError::InternalError)));
+
+  EXPECT_THROW(DefaultUserService(std::make_unique<MockUserRepository>(),
+                                  hasher),
+               std::runtime_error);
+}
+
 TEST_F(DefaultUserServiceTest, Login_WrongPassword) {
   EXPECT_CALL(*repo_, FindUser("alice"))
-      .WillOnce(Return(User{"id-1", "alice", "pwd"}));
+      .WillOnce(Return(User{kUserId, "alice", kHash}));
+  EXPECT_CALL(*repo_, UpdatePassword(_, _)).Times(0);
 
   auto r = service_->Login("alice", "bad");
 
@@ -95,4 +165,25 @@ TEST_F(DefaultUserServiceTest, Login_RepositoryFail) {
 
   ASSERT_FALSE(r.has_value());
   EXPECT_EQ(r.error(), LoginError::InternalError);
-}
\ No newline at end of file
+}
+
+TEST_F(DefaultUserServiceTest, Login_RepositoryTimeout) {
+  EXPECT_CALL(*repo_, FindUser("alice"))
+      .WillOnce(Return(std::unexpected(FindUserError::RepositoryTimeout)));
+
+  auto r = service_->Login("alice", "pwd");
+
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error(), LoginError::ServiceUnavailable);
+}
+
+TEST_F(DefaultUserServiceTest, Registration_RepositoryTimeout) {
+  EXPECT_CALL(*repo_, FindUser("alice"))
+      .WillOnce(Return(std::unexpected(FindUserError::RepositoryTimeout)));
+  EXPECT_CALL(*repo_, AddUser(_)).Times(0);
+
+  auto r = service_->Registration("alice", "pwd");
+
+  ASSERT_FALSE(r.has_value());
+  EXPECT_EQ(r.error(), RegistrationError::ServiceUnavailable);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <gmock/gmock.h>
+#include <expected>
+
+#include "password_hasher.hpp"
+
+class MockPasswordHasher : public PasswordHasher {
+ public:
+  using HashResult = std::expected<std::string, PasswordHashError>;
+  using VerifyResult = std::expected<PasswordCheck, PasswordHashError>;
+
+  MOCK_METHOD(HashResult, Hash, (const std::string& password), (override));
+  MOCK_METHOD(VerifyResult, Verify,
+              (const std::string& password, const std::string& stored),
+              (override));
+  ~MockPasswordHasher() override = default;
+};
@@ -1,6 +1,10 @@
 #pragma once
 #include <gmock/gmock.h>
+#include <cstddef>
 #include <expected>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "task_repository.hpp"
@@ -11,12 +15,19 @@ class MockTaskRepository : public TaskRepository {
   using GetTaskByIdResult = std::expected<Task, FindTaskError>;
   using GetTasksByUserResult = std::expected<std::vector<Task>, FindTaskError>;
   using UpdateTaskStatusResult = std::expected<Task, UpdateTaskError>;
-  using DeleteTaskByIdResult = std::expected<void, DeleteTaskError>;
+  using DeleteTaskByIdResult = std::expected<Task, DeleteTaskError>;
+  using AddTasksResult = std::expected<std::vector<Task>, AddTaskError>;
+  using UpdateTaskStatusesResult =
+      std::expected<std::vector<Task>, UpdateTaskError>;
+  using StatusUpdates = std::vector<std::pair<Uuid, TaskStatus>>;
 
   MOCK_METHOD(AddTaskResult, AddTask, (const Task& task), (override));
-  MOCK_METHOD(GetTaskByIdResult, GetTaskById, (const std::string& task_id), (override));
-  MOCK_METHOD(GetTasksByUserResult, GetTasksByUser, (const std::string& user_id), (override));
-  MOCK_METHOD(UpdateTaskStatusResult, UpdateTaskStatus, (const std::string& task_id, const std::string& status), (override));
-  MOCK_METHOD(DeleteTaskByIdResult, DeleteTaskById, (const std::string& task_id), (override));
+  MOCK_METHOD(GetTaskByIdResult, GetTaskById, (const Uuid& task_id), (override));
+  MOCK_METHOD(GetTasksByUserResult, GetTasksByUser, (const Uuid& user_id), (override));
+  MOCK_METHOD(GetTasksByUserResult, GetTasksByUserPage, (const Uuid& user_id, const std::optional<TaskPageCursor>& after, std::size_t limit), (override));
+  MOCK_METHOD(UpdateTaskStatusResult, UpdateTaskStatus, (const Uuid& task_id, TaskStatus status), (override));
+  MOCK_METHOD(DeleteTaskByIdResult, DeleteTaskById, (const Uuid& task_id), (override));
+  MOCK_METHOD(AddTasksResult, AddTasks, (const std::vector<Task>& tasks), (override));
+  MOCK_METHOD(UpdateTaskStatusesResult, UpdateTaskStatuses, (const StatusUpdates& updates), (override));
   ~MockTaskRepository() override = default;
 };
\ No newline at end of file
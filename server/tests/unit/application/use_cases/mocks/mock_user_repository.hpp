@@ -9,9 +9,13 @@ class MockUserRepository : public UserRepository {
  public:
   using FindUserResult = std::expected<User, FindUserError>;
   using AddUserResult = std::expected<User, AddUserError>;
+  using UpdatePasswordResult = std::expected<void, UpdateUserError>;
 
   MOCK_METHOD(FindUserResult, FindUser, (const std::string& login), (override));
   MOCK_METHOD(AddUserResult, AddUser, (User user), (override));
+  MOCK_METHOD(UpdatePasswordResult, UpdatePassword,
+              (const std::string& login, const std::string& password),
+              (override));
   ~MockUserRepository() override = default;
 };
 
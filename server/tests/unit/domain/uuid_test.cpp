@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include "uuid.hpp"
+
+TEST(UuidTest, ParseAndFormatRoundTrip) {
+  const std::string text = "0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a21";
+
+  const auto id = Uuid::Parse(text);
+
+  ASSERT_TRUE(id.has_value());
+  EXPECT_EQ(id->GetBytes()[0], 0x0b);
+  EXPECT_EQ(id->GetBytes()[15], 0x21);
+  EXPECT_EQ(id->ToString(), text);
+}
+
+TEST(UuidTest, ParseAcceptsUpperCase) {
+  const auto id = Uuid::Parse("0B8E7A52-1F3C-4D2E-9A6B-7C8D9E0F1A21");
+
+  ASSERT_TRUE(id.has_value());
+  EXPECT_EQ(id->ToString(), "0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a21");
+}
+
+TEST(UuidTest, ParseRejectsMalformed) {
+  EXPECT_FALSE(Uuid::Parse("").has_value());
+  EXPECT_FALSE(Uuid::Parse("id-1").has_value());
+  EXPECT_FALSE(Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a2").has_value());
+  EXPECT_FALSE(Uuid::Parse("0b8e7a521-f3c-4d2e-9a6b-7c8d9e0f1a21").has_value());
+  EXPECT_FALSE(Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a2g").has_value());
+  EXPECT_FALSE(Uuid::Parse("0b8e7a52x1f3c-4d2e-9a6b-7c8d9e0f1a21").has_value());
+}
+
+TEST(UuidTest, OrderAndHash) {
+  const auto a = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a21");
+  const auto b = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a22");
+
+  EXPECT_LT(a, b);
+  EXPECT_TRUE(Uuid{}.IsNil());
+  EXPECT_FALSE(a.IsNil());
+  std::unordered_set<Uuid> ids{a, b, a};
+  EXPECT_EQ(ids.size(), 2u);
+}
+
+TEST(UuidTest, RandomIsVersion4) {
+  std::unordered_set<Uuid> ids;
+  for (int i = 0; i < 1000; ++i) {
+    const Uuid id = Uuid::Random();
+    const std::string text = id.ToString();
+    EXPECT_EQ(text[14], '4') << text;
+    EXPECT_NE(std::string_view{"89ab"}.find(text[19]), std::string_view::npos)
+        << text;
+    EXPECT_EQ(Uuid::Parse(text), id);
+    ids.insert(id);
+  }
+  EXPECT_EQ(ids.size(), 1000u);
+}
+
+TEST(UuidTest, RandomVariesEveryRandomBit) {
+  // Кроме 6 бит версии и варианта, каждый бит хоть раз бывает и 0, и 1.
+  Uuid::Bytes ones{};
+  Uuid::Bytes zeros{};
+  for (int i = 0; i < 1000; ++i) {
+    const Uuid id = Uuid::Random();
+    const auto& bytes = id.GetBytes();
+    for (std::size_t b = 0; b < Uuid::kSize; ++b) {
+      ones[b] |= bytes[b];
+      zeros[b] |= static_cast<std::uint8_t>(~bytes[b]);
+    }
+  }
+  for (std::size_t b = 0; b < Uuid::kSize; ++b) {
+    std::uint8_t fixed = 0;
+    if (b == 6)
+      fixed = 0xF0;
+    else if (b == 8)
+      fixed = 0xC0;
+    EXPECT_EQ(ones[b] | fixed, 0xFF) << "byte " << b;
+    EXPECT_EQ(zeros[b] | fixed, 0xFF) << "byte " << b;
+  }
+}
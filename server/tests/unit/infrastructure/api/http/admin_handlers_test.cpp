@@ -0,0 +1,64 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <boost/beast/http.hpp>
+#include <memory>
+#include <string>
+
+#include "handlers/admin_handlers.hpp"
+
+namespace http = boost::beast::http;
+
+namespace {
+
+class FakeLevelControl : public LogLevelControl {
+ public:
+  LogLevel GetLevel() const override { return level_; }
+  void SetLevel(LogLevel level) override { level_ = level; }
+
+ private:
+  LogLevel level_ = LogLevel::Info;
+};
+
+HttpRequest MakeReq(const std::string& authorization,
+                    const std::string& body) {
+  HttpRequest r;
+  r.method(http::verb::put);
+  r.target("/admin/log-level");
+  if (!authorization.empty())
+    r.set(http::field::authorization, authorization);
+  r.body() = body;
+  r.prepare_payload();
+  return r;
+}
+
+}  // namespace
+
+class LogLevelHandlerTest : public ::testing::Test {
+ protected:
+  std::shared_ptr<FakeLevelControl> control_ =
+      std::make_shared<FakeLevelControl>();
+  LogLevelHandler handler_{control_, "secret"};
+};
+
+TEST_F(LogLevelHandlerTest, SetsLevel) {
+  auto resp =
+      handler_.Execute(MakeReq("Bearer secret", R"({"level":"debug"})"));
+  EXPECT_EQ(resp.result(), http::status::ok);
+  EXPECT_EQ(resp.body(), R"({"level":"debug"})");
+  EXPECT_EQ(control_->GetLevel(), LogLevel::Debug);
+}
+
+TEST_F(LogLevelHandlerTest, RejectsWrongToken) {
+  for (const auto* auth : {"", "Bearer secre", "Bearer secret2", "secret"}) {
+    auto resp = handler_.Execute(MakeReq(auth, R"({"level":"off"})"));
+    EXPECT_EQ(resp.result(), http::status::unauthorized) << auth;
+  }
+  EXPECT_EQ(control_->GetLevel(), LogLevel::Info);
+}
+
+TEST_F(LogLevelHandlerTest, RejectsUnknownLevel) {
+  auto resp =
+      handler_.Execute(MakeReq("Bearer secret", R"({"level":"loud"})"));
+  EXPECT_EQ(resp.result(), http::status::bad_request);
+  EXPECT_EQ(control_->GetLevel(), LogLevel::Info);
+}
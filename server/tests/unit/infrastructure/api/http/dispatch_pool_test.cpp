@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include "dispatch_pool.hpp"
+
+TEST(DispatchPoolTest, RunsPostedTasks) {
+  DispatchPool pool("test", 2, 16);
+  std::atomic<int> counter{0};
+  std::promise<void> done;
+
+  for (int i = 0; i < 9; ++i) {
+    ASSERT_TRUE(pool.TryPost([&counter] { ++counter; }));
+  }
+  ASSERT_TRUE(pool.TryPost([&counter, &done] {
+    ++counter;
+    done.set_value();
+  }));
+  done.get_future().wait();
+  pool.Shutdown();
+
+  EXPECT_EQ(counter.load(), 10);
+  const auto stats = pool.GetStats();
+  EXPECT_EQ(stats.submitted, 10);
+  EXPECT_EQ(stats.completed, 10);
+  EXPECT_EQ(stats.rejected, 0);
+  EXPECT_EQ(stats.queue_depth, 0);
+}
+
+TEST(DispatchPoolTest, RejectsWhenQueueIsFull) {
+  DispatchPool pool("test", 1, 2);
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::promise<void> started;
+
+  ASSERT_TRUE(pool.TryPost([&started, released] {
+    started.set_value();
+    released.wait();
+  }));
+  started.get_future().wait();
+
+  EXPECT_TRUE(pool.TryPost([] {}));
+  EXPECT_TRUE(pool.TryPost([] {}));
+  EXPECT_FALSE(pool.TryPost([] {}));
+
+  auto stats = pool.GetStats();
+  EXPECT_EQ(stats.active, 1);
+  EXPECT_EQ(stats.queue_depth, 2);
+  EXPECT_EQ(stats.max_queue_depth_seen, 2);
+  EXPECT_EQ(stats.rejected, 1);
+
+  release.set_value();
+  while (pool.GetStats().completed < 3) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(pool.TryPost([] {}));
+}
+
+TEST(DispatchPoolTest, TaskExceptionDoesNotKillWorker) {
+  DispatchPool pool("test", 1, 4);
+  std::promise<void> done;
+
+  ASSERT_TRUE(pool.TryPost([] { throw std::runtime_error("boom"); }));
+  ASSERT_TRUE(pool.TryPost([&done] { done.set_value(); }));
+
+  EXPECT_EQ(done.get_future().wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+}
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+
+#include "json_reader.hpp"
+
+TEST(JsonFieldReaderTest, ExtractsFieldsAsViewsIntoBody) {
+  const std::string body =
+      R"( {"login":"alice","extra":[1,-2.5e+3,{"a":null}],"password":"p w"} )";
+  JsonFieldReader reader({"login", "password"});
+  ASSERT_TRUE(reader.Parse(body));
+  EXPECT_EQ(reader.Get("login"), "alice");
+  EXPECT_EQ(reader.Get("password"), "p w");
+  // Без escape-последовательностей значение не копируется.
+  EXPECT_GE(reader.Get("login").data(), body.data());
+  EXPECT_LT(reader.Get("login").data(), body.data() + body.size());
+}
+
+TEST(JsonFieldReaderTest, DecodesEscapes) {
+  JsonFieldReader reader({"title"});
+  ASSERT_TRUE(reader.Parse(R"({"title":"a\"b\\c\/\nж😀"})"));
+  EXPECT_EQ(reader.Get("title"), "a\"b\\c/\nж\xF0\x9F\x98\x80");
+}
+
+TEST(JsonFieldReaderTest, RejectsInvalidInput) {
+  JsonFieldReader reader({"id"});
+  for (const std::string_view body : {
+           "",
+           "[]",
+           R"({"id":"x")",
+           R"({"id":"x"} x)",
+           R"({"id":1})",
+           R"({"other":"x"})",
+           R"({"id":"x",})",
+           R"({"id":"x","n":01})",
+           R"({"id":"x","n":tru})",
+           "{\"id\":\"a\nb\"}",
+           R"({"id":"\q"})",
+           R"({"id":"\udc00"})",
+           "{\"id\":\"\xC0\xAF\"}",
+           "{\"id\":\"\xED\xA0\x80\"}",
+       }) {
+    EXPECT_FALSE(reader.Parse(body)) << body;
+  }
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+#include "handlers/task_json.hpp"
+#include "json_writer.hpp"
+
+TEST(JsonWriterTest, NestedCommas) {
+  std::string out;
+  JsonWriter w(out);
+  w.BeginObject();
+  w.Key("a");
+  w.BeginArray();
+  w.Uint(1);
+  w.BeginObject();
+  w.EndObject();
+  w.BeginArray();
+  w.EndArray();
+  w.Null();
+  w.EndArray();
+  w.Key("b");
+  w.Bool(false);
+  w.EndObject();
+  EXPECT_EQ(out, R"({"a":[1,{},[],null],"b":false})");
+}
+
+TEST(JsonWriterTest, EscapesStrings) {
+  std::string out;
+  JsonWriter w(out);
+  w.String(std::string("q\"b\\n\n\t\x01\x1f\x7f") + '\0' + "ю");
+  EXPECT_EQ(out, "\"q\\\"b\\\\n\\n\\t\\u0001\\u001f\x7f\\u0000ю\"");
+  EXPECT_EQ(nlohmann::json::parse(out).get<std::string>(),
+            std::string("q\"b\\n\n\t\x01\x1f\x7f") + '\0' + "ю");
+}
+
+TEST(JsonWriterTest, TaskListMatchesNlohmann) {
+  const Uuid user = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60");
+  const Uuid id = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a21");
+  const std::vector<Task> tasks = {
+      Task(id, user, "t\"1", "line\nbreak", TaskStatus::Done),
+      Task(id, user, "", "", TaskStatus::InProgress),
+  };
+  const std::string out = TaskListToJson(tasks);
+
+  const auto parsed = nlohmann::json::parse(out);
+  ASSERT_EQ(parsed.at("tasks").size(), 2u);
+  const auto& first = parsed["tasks"][0];
+  EXPECT_EQ(first.at("id"), id.ToString());
+  EXPECT_EQ(first.at("user_id"), user.ToString());
+  EXPECT_EQ(first.at("title"), "t\"1");
+  EXPECT_EQ(first.at("description"), "line\nbreak");
+  EXPECT_EQ(first.at("status"), "Done");
+  // Без экранирования оценка размера точна.
+  EXPECT_EQ(TaskToJson(tasks[1]).size(), TaskJsonSize(tasks[1]));
+}
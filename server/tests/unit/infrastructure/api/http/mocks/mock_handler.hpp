@@ -6,6 +6,5 @@
 class MockHandler : public Handler {
  public:
   MOCK_METHOD(std::string, GetMethodEndpoint, (), (const, override));
-  MOCK_METHOD(http::response<http::string_body>, Execute,
-              (const http::request<http::string_body>& req), (override));
+  MOCK_METHOD(HttpResponse, Execute, (const HttpRequest& req), (override));
 };
\ No newline at end of file
@@ -1,7 +1,12 @@
 #pragma once
 
 #include <gmock/gmock.h>
+#include <cstddef>
+#include <cstdint>
 #include <expected>
+#include <optional>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "../../../application/contracts/task_service.hpp"
@@ -13,12 +18,21 @@ class MockTaskService : public TaskService {
   using GetUserTasksResult = std::expected<std::vector<Task>, FindTaskError>;
   using ChangeStatusResult = std::expected<Task, UpdateTaskError>;
   using DeleteTaskResult = std::expected<void, DeleteTaskError>;
+  using CreateTasksResult = std::expected<std::vector<Task>, AddTaskError>;
+  using ChangeStatusesResult =
+      std::expected<std::vector<Task>, UpdateTaskError>;
+  using StatusUpdates = std::vector<std::pair<Uuid, TaskStatus>>;
 
-  MOCK_METHOD(CreateTaskResult, CreateTask, (const std::string& user_id, const std::string& title, const std::string& description, const std::string& status), (override));
-  MOCK_METHOD(GetTaskResult, GetTask, (const std::string& task_id), (override));
-  MOCK_METHOD(GetUserTasksResult, GetUserTasks, (const std::string& user_id), (override));
-  MOCK_METHOD(ChangeStatusResult, ChangeStatus, (const std::string& task_id, const std::string& status), (override));
-  MOCK_METHOD(DeleteTaskResult, DeleteTask, (const std::string& task_id), (override));
+  MOCK_METHOD(CreateTaskResult, CreateTask, (const Uuid& user_id, const std::string& title, const std::string& description, TaskStatus status), (override));
+  MOCK_METHOD(GetTaskResult, GetTask, (const Uuid& task_id), (override));
+  MOCK_METHOD(GetUserTasksResult, GetUserTasks, (const Uuid& user_id), (override));
+  MOCK_METHOD(GetUserTasksResult, GetUserTasksPage, (const Uuid& user_id, const std::optional<TaskPageCursor>& after, std::size_t limit), (override));
+  MOCK_METHOD(ChangeStatusResult, ChangeStatus, (const Uuid& task_id, TaskStatus status), (override));
+  MOCK_METHOD(DeleteTaskResult, DeleteTask, (const Uuid& task_id), (override));
+  MOCK_METHOD(CreateTasksResult, CreateTasks, (const std::vector<Task>& tasks), (override));
+  MOCK_METHOD(ChangeStatusesResult, ChangeStatuses, (const StatusUpdates& updates), (override));
+  MOCK_METHOD(std::uint64_t, GetUserTasksVersion, (const Uuid& user_id), (override));
+  MOCK_METHOD(std::uint64_t, GetTaskVersion, (const Uuid& task_id), (override));
   ~MockTaskService() override = default;
 };
 
@@ -1,6 +1,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <boost/beast/http.hpp>
+#include <thread>
 
 #include "router.hpp"
 #include "mocks/mock_handler.hpp"
@@ -11,9 +12,9 @@ using ::testing::Return;
 
 class RouterTest : public ::testing::Test {
  protected:
-  static http::request<http::string_body> MakeReq(const std::string& method,
-                                                  const std::string& target) {
-    http::request<http::string_body> r;
+  static HttpRequest MakeReq(const std::string& method,
+                             const std::string& target) {
+    HttpRequest r;
     r.method(http::string_to_verb(method));
     r.target(target);
     r.prepare_payload();
@@ -21,7 +22,7 @@ class RouterTest : public ::testing::Test {
   }
 
   std::shared_ptr<NiceMock<MockHandler>> MakeOkHandler(const std::string& endpoint) {
-    http::response<http::string_body> ok;
+    HttpResponse ok;
     ok.result(http::status::ok);
     ok.body() = "ok";
     ok.prepare_payload();
@@ -86,3 +87,121 @@ TEST_F(RouterTest, UserLogin_RoutesOk) {
 }
 
 
+class CapturingHandler : public Handler {
+ public:
+  std::string GetMethodEndpoint() const override { return "GET /task/{id}"; }
+  HttpResponse Execute(const HttpRequest& req) override {
+    return Execute(req, PathParams{});
+  }
+  HttpResponse Execute(
+      const HttpRequest& /*req*/, const PathParams& params) override {
+    id = std::string(params.Get("id"));
+    HttpResponse resp;
+    resp.result(http::status::ok);
+    return resp;
+  }
+
+  std::string id;
+};
+
+TEST_F(RouterTest, PathParam_PassedToHandler) {
+  auto handler = std::make_shared<CapturingHandler>();
+  router_.Add(handler);
+
+  auto resp = router_.Dispatch(MakeReq("GET", "/task/abc-123?x=1"));
+
+  EXPECT_EQ(resp.result(), http::status::ok);
+  EXPECT_EQ(handler->id, "abc-123");
+}
+
+TEST_F(RouterTest, StaticSegment_WinsOverPathParam) {
+  auto handler = std::make_shared<CapturingHandler>();
+  router_.Add(handler);
+
+  EXPECT_EQ(router_.Dispatch(MakeReq("GET", "/task/get?id=1")).result(),
+            http::status::ok);
+  EXPECT_TRUE(handler->id.empty());
+}
+
+TEST_F(RouterTest, PathParam_DoesNotMatchOtherMethodOrDepth) {
+  router_.Add(std::make_shared<CapturingHandler>());
+
+  EXPECT_EQ(router_.Dispatch(MakeReq("PUT", "/task/1")).result(),
+            http::status::not_found);
+  EXPECT_EQ(router_.Dispatch(MakeReq("GET", "/task/1/extra")).result(),
+            http::status::not_found);
+}
+
+// Готовит ответ в отдельном потоке.
+class ThreadDeferredHandler : public Handler {
+ public:
+  std::string GetMethodEndpoint() const override { return "GET /later"; }
+  HttpResponse Execute(const HttpRequest& /*req*/) override { return {}; }
+  std::unique_ptr<DeferredResponse> ExecuteDeferred(
+      const HttpRequest& /*req*/, const PathParams& /*params*/) override {
+    struct Response final : DeferredResponse {
+      void Start(Done done) override {
+        std::thread([done = std::move(done)]() mutable {
+          HttpResponse resp;
+          resp.result(http::status::accepted);
+          done(std::move(resp));
+        }).detach();
+      }
+    };
+    return std::make_unique<Response>();
+  }
+};
+
+TEST_F(RouterTest, Dispatch_WaitsForDeferredResponse) {
+  router_.Add(std::make_shared<ThreadDeferredHandler>());
+
+  EXPECT_EQ(router_.Dispatch(MakeReq("GET", "/later")).result(),
+            http::status::accepted);
+}
+
+TEST_F(RouterTest, CustomEndpoint_RoutesOk) {
+  router_.Add("GET /user/{user_id}/tasks", MakeOkHandler("GET /unused"));
+
+  EXPECT_EQ(router_.Dispatch(MakeReq("GET", "/user/u1/tasks")).result(),
+            http::status::ok);
+}
+
+TEST_F(RouterTest, InvalidEndpoint_Throws) {
+  EXPECT_THROW(router_.Add("FETCH /task", MakeOkHandler("GET /unused")),
+               std::invalid_argument);
+  EXPECT_THROW(router_.Add("GET task", MakeOkHandler("GET /unused")),
+               std::invalid_argument);
+}
+
+TEST(RouterMetricsTest, RecordsLatencyAndStatusPerRoute) {
+  auto metrics = std::make_shared<MetricsRegistry>();
+  SimpleRouter router(metrics);
+  auto handler = std::make_shared<NiceMock<MockHandler>>();
+  HttpResponse ok;
+  ok.result(http::status::ok);
+  ON_CALL(*handler, Execute(::testing::_)).WillByDefault(Return(ok));
+  router.Add("GET /task/{id}", handler);
+
+  HttpRequest req;
+  req.method(http::verb::get);
+  req.target("/task/1");
+  router.Dispatch(req);
+  router.Dispatch(req);
+  req.target("/nowhere");
+  router.Dispatch(req);
+
+  const auto& route = metrics->GetHistogram(
+      "taskmanager_http_request_duration_seconds", "",
+      {{"route", "GET /task/{id}"}});
+  EXPECT_EQ(route.GetSnapshot().count, 2u);
+  EXPECT_EQ(metrics
+                ->GetCounter("taskmanager_http_responses_total", "",
+                             {{"route", "GET /task/{id}"}, {"code", "2xx"}})
+                .Value(),
+            2u);
+  EXPECT_EQ(metrics
+                ->GetCounter("taskmanager_http_responses_total", "",
+                             {{"route", "unmatched"}, {"code", "4xx"}})
+                .Value(),
+            1u);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+
+#include "buffer_pool.hpp"
+#include "default_task_service.hpp"
+#include "dispatch_pool.hpp"
+#include "handlers/task_handlers.hpp"
+#include "memory_task_repository.hpp"
+#include "router.hpp"
+#include "session.hpp"
+
+namespace {
+
+// Глобальный operator new во всём процессе, как в bench/alloc_counter.cpp,
+// кроме потоков с t_uncounted: клиент теста и gtest в счёт не входят.
+std::atomic<std::uint64_t> g_allocations{0};
+thread_local bool t_uncounted = false;
+
+}  // namespace
+
+// Остальные формы operator new/delete по умолчанию вызывают эти; sized
+// delete заменяется явно, как в bench/alloc_counter.cpp.
+void* operator new(std::size_t size) {
+  if (!t_uncounted)
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t /*size*/) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+class PingHandler final : public Handler {
+ public:
+  std::string GetMethodEndpoint() const override { return "GET /ping"; }
+  HttpResponse Execute(const HttpRequest& /*req*/) override {
+    HttpResponse resp;
+    resp.result(http::status::ok);
+    resp.set(http::field::content_type, "application/json");
+    resp.body() = R"({"status":"ok","message":"pong from the test handler"})";
+    resp.prepare_payload();
+    return resp;
+  }
+};
+
+struct Allocations {
+  BufferPool::Stats pool;
+  // Вызовы operator new в потоках сервера.
+  std::uint64_t heap = 0;
+};
+
+std::shared_ptr<Router> PingRouter() {
+  auto router = std::make_shared<SimpleRouter>();
+  router->Add(std::make_shared<PingHandler>());
+  return router;
+}
+
+// Запросы keep-alive соединения к target после прогрева: сколько раз память
+// под заголовки и тела сообщений бралась из пула, сколько — у системы и
+// сколько раз сервер вызвал operator new. Клиент теста в счёт не входит.
+Allocations MeasureKeepAlive(std::shared_ptr<Router> router,
+                             std::shared_ptr<DispatchPool> pool,
+                             const std::string& target, int requests) {
+  net::io_context io_context;
+  net::io_context client_context;
+
+  ip::tcp::acceptor acceptor(io_context, {ip::make_address("127.0.0.1"), 0});
+  acceptor.async_accept(
+      net::make_strand(io_context),
+      [&router, pool](beast::error_code ec, ip::tcp::socket socket) {
+        ASSERT_FALSE(ec);
+        HttpSession::Start(std::make_shared<HttpSession>(
+            std::move(socket), router, pool, SessionOptions{}));
+      });
+  std::thread server([&io_context] { io_context.run(); });
+  t_uncounted = true;
+
+  ip::tcp::socket socket(client_context);
+  socket.connect(acceptor.local_endpoint());
+  beast::flat_buffer buffer;
+  const auto ping = [&] {
+    http::request<http::string_body> req{http::verb::get, target, 11};
+    req.set(http::field::host, "localhost");
+    req.set(http::field::user_agent, "session-allocations-test");
+    req.set(http::field::accept, "application/json");
+    http::write(socket, req);
+    http::response<http::string_body> resp;
+    http::read(socket, buffer, resp);
+    EXPECT_EQ(resp.result(), http::status::ok);
+  };
+
+  // Прогрев: кэши потоков и склад пула набирают блоки.
+  for (int i = 0; i < 200; ++i)
+    ping();
+  const auto before = BufferPool::GetStats();
+  const auto heap_before = g_allocations.load();
+  for (int i = 0; i < requests; ++i)
+    ping();
+  const auto heap_after = g_allocations.load();
+  const auto after = BufferPool::GetStats();
+
+  t_uncounted = false;
+  io_context.stop();
+  server.join();
+  return {{after.allocations - before.allocations,
+           after.system_allocations - before.system_allocations},
+          heap_after - heap_before};
+}
+
+}  // namespace
+
+// Всё, что остаётся в куче, — Asio: копии strand в any_io_executor и кадры
+// корутин крупнее его кэша. Сессия, маршрутизатор и обработчик operator new
+// не вызывают, поэтому границы проходят вплотную к замеру.
+TEST(HttpSessionAllocationsTest, KeepAliveRequestsReuseMessageMemory) {
+  constexpr int kRequests = 1000;
+  const auto stats = MeasureKeepAlive(PingRouter(), nullptr, "/ping",
+                                      kRequests);
+  // Заголовки запроса, заголовки и тело ответа — каждый запрос.
+  EXPECT_GE(stats.pool.allocations, 3u * kRequests);
+  EXPECT_EQ(stats.pool.system_allocations, 0u);
+  EXPECT_LE(stats.heap, 24u * kRequests);
+}
+
+TEST(HttpSessionAllocationsTest, ResponsesFreedOnAnotherThreadAreReused) {
+  // Ответ собирается на пуле обработчиков, а освобождается в потоке
+  // соединения: блоки возвращаются через общий склад.
+  constexpr int kRequests = 1000;
+  const auto stats = MeasureKeepAlive(
+      PingRouter(), std::make_shared<DispatchPool>("test", 2, 16), "/ping",
+      kRequests);
+  EXPECT_GE(stats.pool.allocations, 3u * kRequests);
+  // Поток пула, до которого во время прогрева почти не доходили задачи,
+  // может впервые взять блоки у системы уже во время замера.
+  EXPECT_LE(stats.pool.system_allocations, kRequests / 100u);
+  // Переходы между пулом и strand добавляют свои копии executor-а.
+  EXPECT_LE(stats.heap, 36u * kRequests);
+}
+
+TEST(HttpSessionAllocationsTest, TaskReadWritesJsonIntoPooledBody) {
+  // Сверх Asio — копия задачи из хранилища (описание длиннее SSO) и строка
+  // id из пути. JSON пишется сразу в тело ответа из пула, без промежуточной
+  // строки.
+  auto repository = std::make_unique<InMemoryTaskRepository>();
+  const auto task = repository->AddTask(
+      Task(*Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60"), "title",
+           std::string(1024, 'd'), TaskStatus::InProject));
+  ASSERT_TRUE(task.has_value());
+  auto router = std::make_shared<SimpleRouter>();
+  router->Add("GET /task/{id}",
+              std::make_shared<GetOneTaskHandler>(
+                  std::make_shared<DefaultTaskService>(std::move(repository))));
+
+  constexpr int kRequests = 1000;
+  const auto stats = MeasureKeepAlive(
+      router, nullptr, "/task/" + task->GetId().ToString(), kRequests);
+  EXPECT_EQ(stats.pool.system_allocations, 0u);
+  EXPECT_LE(stats.heap, 26u * kRequests);
+}
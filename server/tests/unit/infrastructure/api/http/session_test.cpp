@@ -0,0 +1,281 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+
+#include "mocks/mock_handler.hpp"
+#include "router.hpp"
+#include "session.hpp"
+
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace {
+
+class ChunksHandler final : public Handler {
+ public:
+  std::string GetMethodEndpoint() const override { return "GET /chunks"; }
+  HttpResponse Execute(const HttpRequest& /*req*/) override { return {}; }
+  std::unique_ptr<ChunkSource> ExecuteStreaming(
+      const HttpRequest& /*req*/, const PathParams& /*params*/,
+      HttpResponse& response) override {
+    struct Source final : ChunkSource {
+      std::optional<std::string> Next() override {
+        static const char* kChunks[] = {"ab", "", "cd"};
+        if (index == 3)
+          return std::nullopt;
+        return kChunks[index++];
+      }
+      int index = 0;
+    };
+    response.result(http::status::ok);
+    return std::make_unique<Source>();
+  }
+};
+
+class SlowHandler final : public Handler {
+ public:
+  std::string GetMethodEndpoint() const override { return "GET /slow"; }
+  HttpResponse Execute(const HttpRequest& /*req*/) override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // Тело больше буферов сокета: запись не завершится сразу и успеет
+    // увидеть истёкший таймер.
+    HttpResponse response;
+    response.result(http::status::ok);
+    response.body().assign(1 << 20, 'x');
+    response.prepare_payload();
+    return response;
+  }
+};
+
+// Ответ приходит, когда тест вызовет полученный done из своего потока.
+class DeferredHandler final : public Handler {
+ public:
+  std::string GetMethodEndpoint() const override { return "GET /deferred"; }
+  HttpResponse Execute(const HttpRequest& /*req*/) override { return {}; }
+  std::unique_ptr<DeferredResponse> ExecuteDeferred(
+      const HttpRequest& /*req*/, const PathParams& /*params*/) override {
+    struct Response final : DeferredResponse {
+      explicit Response(std::promise<Done>& started) : started(started) {}
+      void Start(Done done) override { started.set_value(std::move(done)); }
+      std::promise<Done>& started;
+    };
+    return std::make_unique<Response>(started);
+  }
+
+  std::promise<DeferredResponse::Done> started;
+};
+
+}  // namespace
+
+class HttpSessionTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    HttpResponse ok;
+    ok.result(http::status::ok);
+    ok.body() = "ok";
+    ok.prepare_payload();
+    auto handler = std::make_shared<NiceMock<MockHandler>>();
+    ON_CALL(*handler, GetMethodEndpoint()).WillByDefault(Return("GET /ping"));
+    ON_CALL(*handler, Execute(::testing::_)).WillByDefault(Return(ok));
+    router_->Add(handler);
+    router_->Add(std::make_shared<ChunksHandler>());
+    router_->Add(std::make_shared<SlowHandler>());
+  }
+
+  void TearDown() override {
+    io_context_.stop();
+    if (thread_.joinable())
+      thread_.join();
+  }
+
+  void StartServer(const SessionOptions& options,
+                   std::shared_ptr<DispatchPool> pool = nullptr) {
+    acceptor_.open(ip::tcp::v4());
+    acceptor_.bind({ip::make_address("127.0.0.1"), 0});
+    acceptor_.listen();
+    acceptor_.async_accept(
+        net::make_strand(io_context_),
+        [this, options, pool](beast::error_code ec, ip::tcp::socket socket) {
+          ASSERT_FALSE(ec);
+          HttpSession::Start(std::make_shared<HttpSession>(
+              std::move(socket), router_, pool, options));
+        });
+    thread_ = std::thread([this] { io_context_.run(); });
+  }
+
+  ip::tcp::socket Connect() {
+    ip::tcp::socket socket(client_context_);
+    socket.connect(acceptor_.local_endpoint());
+    return socket;
+  }
+
+  static http::response<http::string_body> Get(ip::tcp::socket& socket,
+                                               beast::flat_buffer& buffer) {
+    http::request<http::string_body> req{http::verb::get, "/ping", 11};
+    http::write(socket, req);
+    http::response<http::string_body> resp;
+    http::read(socket, buffer, resp);
+    return resp;
+  }
+
+  net::io_context io_context_;
+  net::io_context client_context_;
+  ip::tcp::acceptor acceptor_{io_context_};
+  std::thread thread_;
+  std::shared_ptr<SimpleRouter> router_ = std::make_shared<SimpleRouter>();
+};
+
+TEST_F(HttpSessionTest, ServesSeveralKeepAliveRequests) {
+  StartServer(SessionOptions{});
+  auto socket = Connect();
+  beast::flat_buffer buffer;
+
+  for (int i = 0; i < 3; ++i) {
+    auto resp = Get(socket, buffer);
+    EXPECT_EQ(resp.result(), http::status::ok);
+    EXPECT_EQ(resp.body(), "ok");
+    EXPECT_TRUE(resp.keep_alive());
+  }
+}
+
+TEST_F(HttpSessionTest, DispatchesOnPool) {
+  StartServer(SessionOptions{}, std::make_shared<DispatchPool>("test", 1, 4));
+  auto socket = Connect();
+  beast::flat_buffer buffer;
+
+  EXPECT_EQ(Get(socket, buffer).result(), http::status::ok);
+  EXPECT_EQ(Get(socket, buffer).result(), http::status::ok);
+}
+
+TEST_F(HttpSessionTest, AwaitsDeferredResponseWithoutBlockingIoThread) {
+  auto handler = std::make_shared<DeferredHandler>();
+  router_->Add(handler);
+  StartServer(SessionOptions{});
+  auto socket = Connect();
+  http::request<http::string_body> req{http::verb::get, "/deferred", 11};
+  http::write(socket, req);
+  auto done = handler->started.get_future().get();
+
+  // Пока ответ не готов, единственный поток io_context выполняет другие
+  // задачи.
+  auto ran = std::make_shared<std::promise<void>>();
+  net::post(io_context_, [ran] { ran->set_value(); });
+  EXPECT_EQ(ran->get_future().wait_for(std::chrono::seconds(5)),
+            std::future_status::ready);
+
+  HttpResponse late;
+  late.result(http::status::accepted);
+  late.body() = "late";
+  late.prepare_payload();
+  done(std::move(late));
+
+  beast::flat_buffer buffer;
+  http::response<http::string_body> resp;
+  http::read(socket, buffer, resp);
+  EXPECT_EQ(resp.result(), http::status::accepted);
+  EXPECT_EQ(resp.body(), "late");
+  EXPECT_EQ(Get(socket, buffer).result(), http::status::ok);
+}
+
+TEST_F(HttpSessionTest, ClosesIdleConnection) {
+  SessionOptions options;
+  options.idle_timeout = std::chrono::milliseconds(50);
+  StartServer(options);
+  auto socket = Connect();
+  beast::flat_buffer buffer;
+
+  EXPECT_EQ(Get(socket, buffer).result(), http::status::ok);
+
+  char byte;
+  beast::error_code ec;
+  socket.read_some(net::buffer(&byte, 1), ec);
+  EXPECT_TRUE(ec == net::error::eof || ec == net::error::connection_reset);
+}
+
+TEST_F(HttpSessionTest, AnswersPipelinedRequestsInOrder) {
+  StartServer(SessionOptions{});
+  auto socket = Connect();
+
+  const std::string pipelined =
+      "GET /ping HTTP/1.1\r\nHost: x\r\n\r\n"
+      "GET /missing HTTP/1.1\r\nHost: x\r\n\r\n"
+      "GET /ping HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n"
+      "GET /ping HTTP/1.1\r\nHost: x\r\n\r\n";
+  net::write(socket, net::buffer(pipelined));
+
+  beast::flat_buffer buffer;
+  const http::status expected[] = {http::status::ok, http::status::not_found,
+                                   http::status::ok};
+  for (const auto status : expected) {
+    http::response<http::string_body> resp;
+    http::read(socket, buffer, resp);
+    EXPECT_EQ(resp.result(), status);
+  }
+
+  http::response<http::string_body> extra;
+  beast::error_code ec;
+  http::read(socket, buffer, extra, ec);
+  EXPECT_EQ(ec, http::error::end_of_stream);
+}
+
+TEST_F(HttpSessionTest, SlowPipelinedHandlersDoNotUseUpWriteTimeout) {
+  // Обработчики пачки вместе дольше write_timeout, каждая запись — нет.
+  SessionOptions options;
+  options.write_timeout = std::chrono::milliseconds(200);
+  StartServer(options);
+  auto socket = Connect();
+
+  std::string pipelined;
+  for (int i = 0; i < 4; ++i)
+    pipelined += "GET /slow HTTP/1.1\r\nHost: x\r\n\r\n";
+  net::write(socket, net::buffer(pipelined));
+
+  beast::flat_buffer buffer;
+  for (int i = 0; i < 4; ++i) {
+    http::response<http::string_body> resp;
+    beast::error_code ec;
+    http::read(socket, buffer, resp, ec);
+    ASSERT_FALSE(ec) << ec.message();
+    EXPECT_EQ(resp.result(), http::status::ok);
+  }
+}
+
+TEST_F(HttpSessionTest, StreamsChunkedBody) {
+  StartServer(SessionOptions{}, std::make_shared<DispatchPool>("test", 1, 4));
+  auto socket = Connect();
+  beast::flat_buffer buffer;
+
+  http::request<http::string_body> req{http::verb::get, "/chunks", 11};
+  http::write(socket, req);
+  http::response<http::string_body> resp;
+  http::read(socket, buffer, resp);
+
+  EXPECT_EQ(resp.result(), http::status::ok);
+  EXPECT_TRUE(resp.chunked());
+  EXPECT_EQ(resp.body(), "abcd");
+  // Соединение остаётся рабочим после потокового ответа.
+  EXPECT_EQ(Get(socket, buffer).result(), http::status::ok);
+}
+
+TEST_F(HttpSessionTest, CollectsStreamForHttp10) {
+  StartServer(SessionOptions{});
+  auto socket = Connect();
+  beast::flat_buffer buffer;
+
+  http::request<http::string_body> req{http::verb::get, "/chunks", 10};
+  http::write(socket, req);
+  http::response<http::string_body> resp;
+  http::read(socket, buffer, resp);
+
+  EXPECT_FALSE(resp.chunked());
+  EXPECT_EQ(resp.body(), "abcd");
+}
@@ -2,6 +2,9 @@
 #include <gtest/gtest.h>
 #include <boost/beast/http.hpp>
 #include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <nlohmann/json.hpp>
 #include <vector>
 
@@ -13,30 +16,47 @@ using ::testing::Return;
 
 namespace http = boost::beast::http;
 
+namespace {
+
+const Uuid kUserId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60");
+const Uuid kTaskId1 = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a21");
+const Uuid kTaskId2 = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a22");
+const Uuid kTaskId3 = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a23");
+
+}  // namespace
+
 class TaskHandlersTest : public ::testing::Test {
  protected:
   MockTaskService* service_{};
+  std::shared_ptr<TaskService> service_ptr_;
   std::unique_ptr<CreateTaskHandler> create_task_handler_;
   std::unique_ptr<GetAllTasksHandler> get_user_tasks_handler_;
   std::unique_ptr<GetOneTaskHandler> get_task_handler_;
   std::unique_ptr<ChangeStatusTaskHandler> change_task_status_handler_;
   std::unique_ptr<DeleteTaskHandler> delete_task_handler_;
+  std::unique_ptr<CreateTasksBulkHandler> create_tasks_bulk_handler_;
+  std::unique_ptr<ChangeStatusBulkHandler> change_status_bulk_handler_;
 
   void SetUp() override {
     auto service_ptr = std::make_shared<MockTaskService>();
     service_ = service_ptr.get();
+    service_ptr_ = service_ptr;
     create_task_handler_ = std::make_unique<CreateTaskHandler>(service_ptr);
     get_user_tasks_handler_ = std::make_unique<GetAllTasksHandler>(service_ptr);
     get_task_handler_ = std::make_unique<GetOneTaskHandler>(service_ptr);
     change_task_status_handler_ =
         std::make_unique<ChangeStatusTaskHandler>(service_ptr);
     delete_task_handler_ = std::make_unique<DeleteTaskHandler>(service_ptr);
+    create_tasks_bulk_handler_ =
+        std::make_unique<CreateTasksBulkHandler>(service_ptr);
+    change_status_bulk_handler_ =
+        std::make_unique<ChangeStatusBulkHandler>(service_ptr);
   }
 
-  static http::request<http::string_body> MakeReq(const std::string& method,
-                                                  const std::string& target,
-                                                  const nlohmann::json& body) {
-    http::request<http::string_body> r;
+  static HttpRequest MakeReq(const std::string& method,
+                             const std::string& target,
+                             const nlohmann::json& body) {
+    HttpRequest r;
     r.method(http::string_to_verb(method));
     r.target(target);
     r.body() = body.dump();
@@ -44,9 +64,9 @@ class TaskHandlersTest : public ::testing::Test {
     return r;
   }
 
-  static http::request<http::string_body> MakeReq(const std::string& method,
-                                                  const std::string& target) {
-    http::request<http::string_body> r;
+  static HttpRequest MakeReq(const std::string& method,
+                             const std::string& target) {
+    HttpRequest r;
     r.method(http::string_to_verb(method));
     r.target(target);
     return r;
@@ -54,10 +74,12 @@ class TaskHandlersTest : public ::testing::Test {
 };
 
 TEST_F(TaskHandlersTest, CreateTask_Success) {
-  EXPECT_CALL(*service_, CreateTask("u1", "title", "desc", "InProject"))
-      .WillOnce(Return(Task{"id-1", "u1", "title", "desc", "InProject"}));
+  EXPECT_CALL(*service_,
+              CreateTask(kUserId, "title", "desc", TaskStatus::InProject))
+      .WillOnce(Return(
+          Task{kTaskId1, kUserId, "title", "desc", TaskStatus::InProject}));
   auto req = MakeReq("POST", "/task",
-                     {{"user_id", "u1"},
+                     {{"user_id", kUserId.ToString()},
                       {"title", "title"},
                       {"description", "desc"},
                       {"status", "InProject"}});
@@ -66,7 +88,9 @@ TEST_F(TaskHandlersTest, CreateTask_Success) {
   auto body = nlohmann::json::parse(resp.body());
 
   EXPECT_EQ(resp.result(), http::status::ok);
-  EXPECT_EQ(body["id"], "id-1");
+  EXPECT_EQ(body["id"], kTaskId1.ToString());
+  EXPECT_EQ(std::string_view(resp.body()),
+            R"({"id":")" + kTaskId1.ToString() + R"(","status":"ok"})");
 }
 
 TEST_F(TaskHandlersTest, CreateTask_BadRequest) {
@@ -77,11 +101,25 @@ TEST_F(TaskHandlersTest, CreateTask_BadRequest) {
   EXPECT_EQ(resp.result(), http::status::bad_request);
 }
 
+TEST_F(TaskHandlersTest, CreateTask_InvalidUserId) {
+  EXPECT_CALL(*service_, CreateTask(_, _, _, _)).Times(0);
+  auto req = MakeReq("POST", "/task",
+                     {{"user_id", "u1"},
+                      {"title", "title"},
+                      {"description", "desc"},
+                      {"status", "InProject"}});
+
+  auto resp = create_task_handler_->Execute(req);
+
+  EXPECT_EQ(resp.result(), http::status::bad_request);
+}
+
 TEST_F(TaskHandlersTest, CreateTask_InternalError) {
-  EXPECT_CALL(*service_, CreateTask("u1", "title", "desc", "InProject"))
+  EXPECT_CALL(*service_,
+              CreateTask(kUserId, "title", "desc", TaskStatus::InProject))
       .WillOnce(Return(std::unexpected(AddTaskError::RepositoryError)));
   auto req = MakeReq("POST", "/task",
-                     {{"user_id", "u1"},
+                     {{"user_id", kUserId.ToString()},
                       {"title", "title"},
                       {"description", "desc"},
                       {"status", "InProject"}});
@@ -92,11 +130,11 @@ TEST_F(TaskHandlersTest, CreateTask_InternalError) {
 }
 
 TEST_F(TaskHandlersTest, GetUserTasks_Success) {
-  EXPECT_CALL(*service_, GetUserTasks("u1"))
-      .WillOnce(Return(
-          std::vector<Task>{Task{"id-1", "u1", "t1", "d1", "InProject"},
-                            Task{"id-2", "u1", "t2", "d2", "InProject"}}));
-  auto req = MakeReq("GET", "/task/getByUser?user_id=u1");
+  EXPECT_CALL(*service_, GetUserTasks(kUserId))
+      .WillOnce(Return(std::vector<Task>{
+          Task{kTaskId1, kUserId, "t1", "d1", TaskStatus::InProject},
+          Task{kTaskId2, kUserId, "t2", "d2", TaskStatus::InProject}}));
+  auto req = MakeReq("GET", "/task/getByUser?user_id=" + kUserId.ToString());
 
   auto resp = get_user_tasks_handler_->Execute(req);
   auto body = nlohmann::json::parse(resp.body());
@@ -104,14 +142,14 @@ TEST_F(TaskHandlersTest, GetUserTasks_Success) {
   EXPECT_EQ(resp.result(), http::status::ok);
   ASSERT_TRUE(body.contains("tasks"));
   ASSERT_EQ(body["tasks"].size(), 2);
-  EXPECT_EQ(body["tasks"][0]["id"], "id-1");
-  EXPECT_EQ(body["tasks"][1]["id"], "id-2");
+  EXPECT_EQ(body["tasks"][0]["id"], kTaskId1.ToString());
+  EXPECT_EQ(body["tasks"][1]["id"], kTaskId2.ToString());
 }
 
 TEST_F(TaskHandlersTest, GetUserTasks_Empty) {
-  EXPECT_CALL(*service_, GetUserTasks("u1"))
+  EXPECT_CALL(*service_, GetUserTasks(kUserId))
       .WillOnce(Return(std::vector<Task>{}));
-  auto req = MakeReq("GET", "/task/getByUser?user_id=u1");
+  auto req = MakeReq("GET", "/task/getByUser?user_id=" + kUserId.ToString());
 
   auto resp = get_user_tasks_handler_->Execute(req);
   auto body = nlohmann::json::parse(resp.body());
@@ -121,34 +159,169 @@ TEST_F(TaskHandlersTest, GetUserTasks_Empty) {
   EXPECT_TRUE(body["tasks"].empty());
 }
 
+TEST_F(TaskHandlersTest, GetUserTasks_ETagAndBodyCache) {
+  auto cache = std::make_shared<ResponseCache>(1 << 20);
+  auto handler = std::make_unique<GetAllTasksHandler>(service_ptr_, cache);
+  EXPECT_CALL(*service_, GetUserTasksVersion(kUserId))
+      .WillOnce(Return(7))
+      .WillOnce(Return(7))
+      .WillOnce(Return(7))
+      .WillOnce(Return(8));
+  EXPECT_CALL(*service_, GetUserTasks(kUserId))
+      .Times(2)
+      .WillRepeatedly(Return(std::vector<Task>{
+          Task{kTaskId1, kUserId, "t1", "d1", TaskStatus::InProject}}));
+  const std::string target = "/task/getByUser?user_id=" + kUserId.ToString();
+
+  auto first = handler->Execute(MakeReq("GET", target));
+  ASSERT_EQ(first.result(), http::status::ok);
+  const std::string etag(first[http::field::etag]);
+  ASSERT_FALSE(etag.empty());
+
+  auto req = MakeReq("GET", target);
+  req.set(http::field::if_none_match, "\"other\", " + etag);
+  auto not_modified = handler->Execute(req);
+  EXPECT_EQ(not_modified.result(), http::status::not_modified);
+  EXPECT_TRUE(not_modified.body().empty());
+
+  // Та же версия без If-None-Match — тело из кэша, без обращения к сервису.
+  auto cached = handler->Execute(MakeReq("GET", target));
+  EXPECT_EQ(cached.body(), first.body());
+
+  // Новая версия — старый ETag больше не подходит.
+  auto changed = handler->Execute(req);
+  EXPECT_EQ(changed.result(), http::status::ok);
+  EXPECT_NE(std::string(changed[http::field::etag]), etag);
+}
+
+TEST_F(TaskHandlersTest, GetUserTasks_PageWithCursor) {
+  EXPECT_CALL(*service_,
+              GetUserTasksPage(kUserId, std::optional<TaskPageCursor>{}, 3))
+      .WillOnce(Return(std::vector<Task>{
+          Task{kTaskId1, kUserId, "a", "d", TaskStatus::InProgress},
+          Task{kTaskId2, kUserId, "b", "d", TaskStatus::InProject},
+          Task{kTaskId3, kUserId, "c", "d", TaskStatus::Done}}));
+  auto resp = get_user_tasks_handler_->Execute(
+      MakeReq("GET", "/task/getByUser?user_id=" + kUserId.ToString() +
+                         "&limit=2"));
+  auto body = nlohmann::json::parse(resp.body());
+
+  EXPECT_EQ(resp.result(), http::status::ok);
+  ASSERT_EQ(body["tasks"].size(), 2);
+  ASSERT_TRUE(body["next"].is_string());
+
+  EXPECT_CALL(*service_, GetUserTasksPage(kUserId, _, 3))
+      .WillOnce([](const Uuid&, const std::optional<TaskPageCursor>& after,
+                   std::size_t) {
+        EXPECT_TRUE(after.has_value());
+        EXPECT_EQ(after->task_id, kTaskId2);
+        EXPECT_EQ(after->title, "b");
+        EXPECT_EQ(after->status, TaskStatus::InProject);
+        return std::vector<Task>{
+            Task{kTaskId3, kUserId, "c", "d", TaskStatus::Done}};
+      });
+  resp = get_user_tasks_handler_->Execute(
+      MakeReq("GET", "/task/getByUser?user_id=" + kUserId.ToString() +
+                         "&limit=2&after=" + body["next"].get<std::string>()));
+  body = nlohmann::json::parse(resp.body());
+
+  ASSERT_EQ(body["tasks"].size(), 1);
+  EXPECT_TRUE(body["next"].is_null());
+}
+
+TEST_F(TaskHandlersTest, GetUserTasks_InvalidCursor) {
+  auto resp = get_user_tasks_handler_->Execute(
+      MakeReq("GET", "/task/getByUser?user_id=" + kUserId.ToString() +
+                         "&after=zz"));
+
+  EXPECT_EQ(resp.result(), http::status::bad_request);
+}
+
+TEST_F(TaskHandlersTest, GetUserTasks_Stream) {
+  EXPECT_CALL(*service_, GetUserTasksPage(kUserId, _, 2))
+      .WillOnce(Return(std::vector<Task>{
+          Task{kTaskId1, kUserId, "a", "d", TaskStatus::InProgress},
+          Task{kTaskId2, kUserId, "b", "d", TaskStatus::Done}}))
+      .WillOnce(Return(std::vector<Task>{
+          Task{kTaskId3, kUserId, "c", "d", TaskStatus::Done}}));
+  HttpResponse resp;
+
+  auto stream = get_user_tasks_handler_->ExecuteStreaming(
+      MakeReq("GET", "/task/getByUser?user_id=" + kUserId.ToString() +
+                         "&stream=1&limit=2"),
+      PathParams{}, resp);
+  ASSERT_NE(stream, nullptr);
+  std::string body;
+  while (auto chunk = stream->Next()) {
+    body += *chunk;
+  }
+
+  EXPECT_EQ(resp.result(), http::status::ok);
+  auto json = nlohmann::json::parse(body);
+  ASSERT_EQ(json["tasks"].size(), 3);
+  EXPECT_EQ(json["tasks"][2]["id"], kTaskId3.ToString());
+}
+
 TEST_F(TaskHandlersTest, GetTask_Success) {
-  EXPECT_CALL(*service_, GetTask("id-1"))
-      .WillOnce(Return(Task{"id-1", "u1", "t", "d", "InProject"}));
-  auto req = MakeReq("GET", "/task/get?id=id-1");
+  EXPECT_CALL(*service_, GetTask(kTaskId1))
+      .WillOnce(
+          Return(Task{kTaskId1, kUserId, "t", "d", TaskStatus::InProject}));
+  auto req = MakeReq("GET", "/task/get?id=" + kTaskId1.ToString());
 
   auto resp = get_task_handler_->Execute(req);
   auto body = nlohmann::json::parse(resp.body());
 
   EXPECT_EQ(resp.result(), http::status::ok);
-  EXPECT_EQ(body["id"], "id-1");
-  EXPECT_EQ(body["user_id"], "u1");
+  EXPECT_EQ(body["id"], kTaskId1.ToString());
+  EXPECT_EQ(body["user_id"], kUserId.ToString());
 }
 
 TEST_F(TaskHandlersTest, GetTask_NotFound) {
-  EXPECT_CALL(*service_, GetTask("id-1"))
+  EXPECT_CALL(*service_, GetTask(kTaskId1))
       .WillOnce(Return(std::unexpected(FindTaskError::NotFound)));
-  auto req = MakeReq("GET", "/task/get?id=id-1");
+  auto req = MakeReq("GET", "/task/get?id=" + kTaskId1.ToString());
 
   auto resp = get_task_handler_->Execute(req);
 
   EXPECT_EQ(resp.result(), http::status::not_found);
 }
 
+TEST_F(TaskHandlersTest, GetTask_IfNoneMatchAny) {
+  auto cache = std::make_shared<ResponseCache>(1 << 20);
+  auto handler = std::make_unique<GetOneTaskHandler>(service_ptr_, cache);
+  EXPECT_CALL(*service_, GetTaskVersion(_)).WillRepeatedly(Return(3));
+  EXPECT_CALL(*service_, GetTask(kTaskId1))
+      .WillOnce(
+          Return(Task{kTaskId1, kUserId, "t", "d", TaskStatus::InProject}));
+  EXPECT_CALL(*service_, GetTask(kTaskId2))
+      .WillOnce(Return(std::unexpected(FindTaskError::NotFound)));
+
+  // "*" совпадает только с существующей задачей.
+  auto existing = MakeReq("GET", "/task/get?id=" + kTaskId1.ToString());
+  existing.set(http::field::if_none_match, "*");
+  EXPECT_EQ(handler->Execute(existing).result(), http::status::not_modified);
+
+  auto missing = MakeReq("GET", "/task/get?id=" + kTaskId2.ToString());
+  missing.set(http::field::if_none_match, "*");
+  EXPECT_EQ(handler->Execute(missing).result(), http::status::not_found);
+}
+
+TEST_F(TaskHandlersTest, GetTask_RepositoryTimeout) {
+  EXPECT_CALL(*service_, GetTask(kTaskId1))
+      .WillOnce(Return(std::unexpected(FindTaskError::RepositoryTimeout)));
+  auto req = MakeReq("GET", "/task/get?id=" + kTaskId1.ToString());
+
+  auto resp = get_task_handler_->Execute(req);
+
+  EXPECT_EQ(resp.result(), http::status::service_unavailable);
+  EXPECT_EQ(resp[http::field::retry_after], "1");
+}
+
 TEST_F(TaskHandlersTest, ChangeStatus_Success) {
-  EXPECT_CALL(*service_, ChangeStatus("id-1", "Done"))
-      .WillOnce(Return(Task{"id-1", "u1", "t", "d", "Done"}));
-  auto req =
-      MakeReq("PATCH", "/task/status", {{"id", "id-1"}, {"status", "Done"}});
+  EXPECT_CALL(*service_, ChangeStatus(kTaskId1, TaskStatus::Done))
+      .WillOnce(Return(Task{kTaskId1, kUserId, "t", "d", TaskStatus::Done}));
+  auto req = MakeReq("PATCH", "/task/status",
+                     {{"id", kTaskId1.ToString()}, {"status", "Done"}});
 
   auto resp = change_task_status_handler_->Execute(req);
   auto body = nlohmann::json::parse(resp.body());
@@ -166,10 +339,10 @@ TEST_F(TaskHandlersTest, ChangeStatus_BadRequest) {
 }
 
 TEST_F(TaskHandlersTest, ChangeStatus_NotFound) {
-  EXPECT_CALL(*service_, ChangeStatus("id-1", "Done"))
+  EXPECT_CALL(*service_, ChangeStatus(kTaskId1, TaskStatus::Done))
       .WillOnce(Return(std::unexpected(UpdateTaskError::NotFound)));
-  auto req =
-      MakeReq("PATCH", "/task/status", {{"id", "id-1"}, {"status", "Done"}});
+  auto req = MakeReq("PATCH", "/task/status",
+                     {{"id", kTaskId1.ToString()}, {"status", "Done"}});
 
   auto resp = change_task_status_handler_->Execute(req);
 
@@ -177,9 +350,10 @@ TEST_F(TaskHandlersTest, ChangeStatus_NotFound) {
 }
 
 TEST_F(TaskHandlersTest, ChangeStatus_InternalError) {
-  EXPECT_CALL(*service_, ChangeStatus("id-1", "Done"))
+  EXPECT_CALL(*service_, ChangeStatus(kTaskId1, TaskStatus::Done))
       .WillOnce(Return(std::unexpected(UpdateTaskError::RepositoryError)));
-  auto req = MakeReq("PATCH", "/task/status", {{"id", "id-1"}, {"status", "Done"}});
+  auto req = MakeReq("PATCH", "/task/status",
+                     {{"id", kTaskId1.ToString()}, {"status", "Done"}});
 
   auto resp = change_task_status_handler_->Execute(req);
 
@@ -187,9 +361,9 @@ TEST_F(TaskHandlersTest, ChangeStatus_InternalError) {
 }
 
 TEST_F(TaskHandlersTest, DeleteTask_Success) {
-  EXPECT_CALL(*service_, DeleteTask("id-1"))
+  EXPECT_CALL(*service_, DeleteTask(kTaskId1))
       .WillOnce(Return(std::expected<void, DeleteTaskError>{}));
-  auto req = MakeReq("DELETE", "/task/delete?id=id-1");
+  auto req = MakeReq("DELETE", "/task/delete?id=" + kTaskId1.ToString());
 
   auto resp = delete_task_handler_->Execute(req);
 
@@ -197,9 +371,9 @@ TEST_F(TaskHandlersTest, DeleteTask_Success) {
 }
 
 TEST_F(TaskHandlersTest, DeleteTask_NotFound) {
-  EXPECT_CALL(*service_, DeleteTask("id-1"))
+  EXPECT_CALL(*service_, DeleteTask(kTaskId1))
       .WillOnce(Return(std::unexpected(DeleteTaskError::NotFound)));
-  auto req = MakeReq("DELETE", "/task/delete?id=id-1");
+  auto req = MakeReq("DELETE", "/task/delete?id=" + kTaskId1.ToString());
 
   auto resp = delete_task_handler_->Execute(req);
 
@@ -207,11 +381,107 @@ TEST_F(TaskHandlersTest, DeleteTask_NotFound) {
 }
 
 TEST_F(TaskHandlersTest, DeleteTask_InternalError) {
-  EXPECT_CALL(*service_, DeleteTask("id-1"))
+  EXPECT_CALL(*service_, DeleteTask(kTaskId1))
       .WillOnce(Return(std::unexpected(DeleteTaskError::RepositoryError)));
-  auto req = MakeReq("DELETE", "/task/delete?id=id-1");
+  auto req = MakeReq("DELETE", "/task/delete?id=" + kTaskId1.ToString());
 
   auto resp = delete_task_handler_->Execute(req);
 
   EXPECT_EQ(resp.result(), http::status::bad_request);
-}
\ No newline at end of file
+}
+TEST_F(TaskHandlersTest, GetTask_IdFromPath) {
+  EXPECT_CALL(*service_, GetTask(kTaskId1))
+      .WillOnce(
+          Return(Task{kTaskId1, kUserId, "t", "d", TaskStatus::InProject}));
+  const std::string id = kTaskId1.ToString();
+  PathParams params;
+  params.Add("id", id);
+
+  auto resp = get_task_handler_->Execute(MakeReq("GET", "/task/" + id), params);
+
+  EXPECT_EQ(resp.result(), http::status::ok);
+}
+
+TEST_F(TaskHandlersTest, GetTask_InvalidId) {
+  EXPECT_CALL(*service_, GetTask(_)).Times(0);
+  PathParams params;
+  params.Add("id", "id-1");
+
+  auto resp = get_task_handler_->Execute(MakeReq("GET", "/task/id-1"), params);
+
+  EXPECT_EQ(resp.result(), http::status::bad_request);
+}
+
+TEST_F(TaskHandlersTest, CreateTasksBulk_Success) {
+  EXPECT_CALL(*service_, CreateTasks(_))
+      .WillOnce([](const std::vector<Task>& tasks) {
+        EXPECT_EQ(tasks.size(), 2u);
+        EXPECT_EQ(tasks[1].GetTitle(), "t2");
+        return std::vector<Task>{
+            Task{kTaskId1, kUserId, "t1", "d", TaskStatus::Done},
+            Task{kTaskId2, kUserId, "t2", "d", TaskStatus::InProject}};
+      });
+  auto req = MakeReq(
+      "POST", "/task/bulk",
+      {{"tasks",
+        {{{"user_id", kUserId.ToString()},
+          {"title", "t1"},
+          {"description", "d"},
+          {"status", "Done"}},
+         {{"user_id", kUserId.ToString()},
+          {"title", "t2"},
+          {"description", "d"},
+          {"status", "InProject"}}}}});
+
+  auto resp = create_tasks_bulk_handler_->Execute(req);
+  auto body = nlohmann::json::parse(resp.body());
+
+  EXPECT_EQ(resp.result(), http::status::ok);
+  EXPECT_EQ(body["ids"], nlohmann::json::array(
+                             {kTaskId1.ToString(), kTaskId2.ToString()}));
+}
+
+TEST_F(TaskHandlersTest, CreateTasksBulk_InvalidStatus) {
+  EXPECT_CALL(*service_, CreateTasks(_)).Times(0);
+  auto req = MakeReq("POST", "/task/bulk",
+                     {{"tasks",
+                       {{{"user_id", kUserId.ToString()},
+                         {"title", "t1"},
+                         {"description", "d"},
+                         {"status", "Unknown"}}}}});
+
+  auto resp = create_tasks_bulk_handler_->Execute(req);
+
+  EXPECT_EQ(resp.result(), http::status::bad_request);
+}
+
+TEST_F(TaskHandlersTest, ChangeStatusBulk_NotFound) {
+  EXPECT_CALL(*service_, ChangeStatuses(_))
+      .WillOnce(Return(std::unexpected(UpdateTaskError::NotFound)));
+  auto req = MakeReq("PATCH", "/task/status/bulk",
+                     {{"updates",
+                       {{{"id", kTaskId1.ToString()}, {"status", "Done"}},
+                        {{"id", kTaskId2.ToString()},
+                         {"status", "InProgress"}}}}});
+
+  auto resp = change_status_bulk_handler_->Execute(req);
+
+  EXPECT_EQ(resp.result(), http::status::not_found);
+}
+
+TEST_F(TaskHandlersTest, ChangeStatusBulk_Success) {
+  EXPECT_CALL(*service_, ChangeStatuses(_))
+      .WillOnce(Return(std::vector<Task>{
+          Task{kTaskId1, kUserId, "t1", "d1", TaskStatus::Done},
+          Task{kTaskId2, kUserId, "t2", "d2", TaskStatus::InProgress}}));
+  auto req = MakeReq("PATCH", "/task/status/bulk",
+                     {{"updates",
+                       {{{"id", kTaskId1.ToString()}, {"status", "Done"}},
+                        {{"id", kTaskId2.ToString()},
+                         {"status", "InProgress"}}}}});
+
+  auto resp = change_status_bulk_handler_->Execute(req);
+
+  EXPECT_EQ(resp.result(), http::status::ok);
+  EXPECT_EQ(std::string_view(resp.body()), R"({"status":"ok","updated":2})");
+}
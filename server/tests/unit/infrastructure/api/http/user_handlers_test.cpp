@@ -1,7 +1,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <boost/beast/http.hpp>
+#include <future>
 #include <memory>
+#include <thread>
 #include <nlohmann/json.hpp>
 
 #include "handlers/user_handlers.hpp"
@@ -12,6 +14,12 @@ using ::testing::Return;
 
 namespace http = boost::beast::http;
 
+namespace {
+
+const Uuid kUserId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60");
+
+}  // namespace
+
 class UserHandlersTest : public ::testing::Test {
  protected:
   MockUserService* service_{};
@@ -25,10 +33,10 @@ class UserHandlersTest : public ::testing::Test {
     login_handler_ = std::make_unique<LoginUserHandler>(service_ptr);
   }
 
-  static http::request<http::string_body> MakeJsonReq(
+  static HttpRequest MakeJsonReq(
       const std::string& method, const std::string& target,
       const nlohmann::json& body) {
-    http::request<http::string_body> r;
+    HttpRequest r;
     r.method(http::string_to_verb(method));
     r.target(target);
     r.body() = body.dump();
@@ -39,7 +47,7 @@ class UserHandlersTest : public ::testing::Test {
 
 TEST_F(UserHandlersTest, Register_Success) {
   EXPECT_CALL(*service_, Registration("alice", "pwd"))
-      .WillOnce(Return(User{"id-1", "alice", "pwd"}));
+      .WillOnce(Return(User{kUserId, "alice", "pwd"}));
   auto req = MakeJsonReq("POST", "/user/register",
                          {{"login", "alice"}, {"password", "pwd"}});
 
@@ -47,7 +55,7 @@ TEST_F(UserHandlersTest, Register_Success) {
   auto body = nlohmann::json::parse(resp.body());
 
   EXPECT_EQ(resp.result(), http::status::ok);
-  EXPECT_EQ(body["id"], "id-1");
+  EXPECT_EQ(body["id"], kUserId.ToString());
 }
 
 TEST_F(UserHandlersTest, Register_NameAlreadyExists) {
@@ -82,7 +90,7 @@ TEST_F(UserHandlersTest, Register_InternalError) {
 
 TEST_F(UserHandlersTest, Login_Success) {
   EXPECT_CALL(*service_, Login("alice", "pwd"))
-      .WillOnce(Return(User{"id-1", "alice", "pwd"}));
+      .WillOnce(Return(User{kUserId, "alice", "pwd"}));
   auto req = MakeJsonReq("POST", "/user/login",
                          {{"login", "alice"}, {"password", "pwd"}});
 
@@ -124,10 +132,80 @@ TEST_F(UserHandlersTest, Login_InternalError) {
   EXPECT_EQ(resp.result(), http::status::internal_server_error);
 }
 
+TEST_F(UserHandlersTest, Login_ServiceUnavailable) {
+  EXPECT_CALL(*service_, Login("alice", "pwd"))
+      .WillOnce(Return(std::unexpected(LoginError::ServiceUnavailable)));
+  auto req = MakeJsonReq("POST", "/user/login",
+                         {{"login", "alice"}, {"password", "pwd"}});
+
+  auto resp = login_handler_->Execute(req);
+
+  EXPECT_EQ(resp.result(), http::status::service_unavailable);
+}
+
 TEST_F(UserHandlersTest, Login_BadRequest) {
   auto req = MakeJsonReq("POST", "/user/login", {{"login", "alice"}});
 
   auto resp = login_handler_->Execute(req);
 
   EXPECT_EQ(resp.result(), http::status::bad_request);
-}
\ No newline at end of file
+}
+
+TEST_F(UserHandlersTest, Login_RunsOnHashPool) {
+  auto service = std::make_shared<MockUserService>();
+  LoginUserHandler handler(service,
+                           std::make_shared<DispatchPool>("hash", 1, 4));
+  std::thread::id service_thread;
+  EXPECT_CALL(*service, Login("alice", "pwd"))
+      .WillOnce([&service_thread](const std::string&, const std::string&)
+                    -> MockUserService::LoginResult {
+        service_thread = std::this_thread::get_id();
+        return User{kUserId, "alice", "pwd"};
+      });
+  auto req = MakeJsonReq("POST", "/user/login",
+                         {{"login", "alice"}, {"password", "pwd"}});
+
+  auto deferred = handler.ExecuteDeferred(req, PathParams{});
+  ASSERT_NE(deferred, nullptr);
+  std::promise<HttpResponse> done;
+  deferred->Start(
+      [&done](HttpResponse resp) { done.set_value(std::move(resp)); });
+  auto resp = done.get_future().get();
+
+  EXPECT_EQ(resp.result(), http::status::ok);
+  EXPECT_NE(service_thread, std::this_thread::get_id());
+}
+
+TEST_F(UserHandlersTest, Register_HashPoolFull) {
+  auto service = std::make_shared<MockUserService>();
+  auto pool = std::make_shared<DispatchPool>("hash", 1, 1);
+  RegisterUserHandler handler(service, pool);
+  // Единственный поток занят, единственное место в очереди тоже.
+  std::promise<void> started;
+  std::promise<void> release;
+  ASSERT_TRUE(pool->TryPost([&started, gate = release.get_future()] {
+    started.set_value();
+    gate.wait();
+  }));
+  started.get_future().wait();
+  ASSERT_TRUE(pool->TryPost([] {}));
+  EXPECT_CALL(*service, Registration(_, _)).Times(0);
+  auto req = MakeJsonReq("POST", "/user/register",
+                         {{"login", "alice"}, {"password", "pwd"}});
+
+  auto deferred = handler.ExecuteDeferred(req, PathParams{});
+  ASSERT_NE(deferred, nullptr);
+  HttpResponse resp;
+  deferred->Start([&resp](HttpResponse r) { resp = std::move(r); });
+
+  EXPECT_EQ(resp.result(), http::status::too_many_requests);
+  EXPECT_EQ(resp[http::field::retry_after], "1");
+  release.set_value();
+}
+
+TEST_F(UserHandlersTest, Login_WithoutHashPoolAnswersDirectly) {
+  LoginUserHandler handler(std::make_shared<MockUserService>());
+  HttpRequest req;
+
+  EXPECT_EQ(handler.ExecuteDeferred(req, PathParams{}), nullptr);
+}
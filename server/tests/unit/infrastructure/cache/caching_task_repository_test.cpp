@@ -0,0 +1,105 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "../../application/use_cases/mocks/mock_task_repository.hpp"
+#include "caching_task_repository.hpp"
+
+using ::testing::_;
+using ::testing::Return;
+
+namespace {
+
+const Uuid kUserId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60");
+const Uuid kTaskId1 = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a21");
+const Uuid kTaskId2 = *Uuid::Parse("0b8e7a52-1f3c-4d2e-9a6b-7c8d9e0f1a22");
+
+}  // namespace
+
+class CachingTaskRepositoryTest : public ::testing::Test {
+ protected:
+  MockTaskRepository* repo_{};
+  std::unique_ptr<CachingTaskRepository> cache_;
+
+  void SetUp() override {
+    auto repo_ptr = std::make_unique<MockTaskRepository>();
+    repo_ = repo_ptr.get();
+    cache_ = std::make_unique<CachingTaskRepository>(
+        std::move(repo_ptr), CachingTaskRepository::Options{100, 4});
+  }
+
+  static std::vector<Task> UserTasks() {
+    return {Task{kTaskId1, kUserId, "a", "d", TaskStatus::InProgress},
+            Task{kTaskId2, kUserId, "b", "d", TaskStatus::Done}};
+  }
+};
+
+TEST_F(CachingTaskRepositoryTest, ServesRepeatedReadsFromCache) {
+  EXPECT_CALL(*repo_, GetTasksByUser(kUserId)).WillOnce(Return(UserTasks()));
+  EXPECT_CALL(*repo_, GetTaskById(kTaskId1))
+      .WillOnce(Return(UserTasks()[0]));
+
+  for (int i = 0; i < 3; ++i) {
+    auto tasks = cache_->GetTasksByUser(kUserId);
+    ASSERT_TRUE(tasks.has_value());
+    EXPECT_EQ(tasks->size(), 2u);
+    EXPECT_TRUE(cache_->GetTaskById(kTaskId1).has_value());
+  }
+
+  const auto stats = cache_->GetStats();
+  EXPECT_EQ(stats.user_tasks.hits, 2u);
+  EXPECT_EQ(stats.user_tasks.misses, 1u);
+  EXPECT_EQ(stats.tasks.hits, 2u);
+}
+
+TEST_F(CachingTaskRepositoryTest, DoesNotCacheErrors) {
+  EXPECT_CALL(*repo_, GetTaskById(kTaskId1))
+      .WillOnce(Return(std::unexpected(FindTaskError::NotFound)))
+      .WillOnce(Return(UserTasks()[0]));
+
+  EXPECT_FALSE(cache_->GetTaskById(kTaskId1).has_value());
+  EXPECT_TRUE(cache_->GetTaskById(kTaskId1).has_value());
+}
+
+TEST_F(CachingTaskRepositoryTest, UpdateInvalidatesTaskAndOwnerList) {
+  EXPECT_CALL(*repo_, GetTasksByUser(kUserId))
+      .Times(2)
+      .WillRepeatedly(Return(UserTasks()));
+  EXPECT_CALL(*repo_, GetTaskById(kTaskId1))
+      .Times(2)
+      .WillRepeatedly(Return(UserTasks()[0]));
+  EXPECT_CALL(*repo_, UpdateTaskStatus(kTaskId1, TaskStatus::Done))
+      .WillOnce(
+          Return(Task{kTaskId1, kUserId, "a", "d", TaskStatus::Done}));
+
+  cache_->GetTasksByUser(kUserId);
+  cache_->GetTaskById(kTaskId1);
+  ASSERT_TRUE(cache_->UpdateTaskStatus(kTaskId1, TaskStatus::Done));
+  cache_->GetTasksByUser(kUserId);
+  cache_->GetTaskById(kTaskId1);
+}
+
+TEST_F(CachingTaskRepositoryTest, DeleteInvalidatesOwnerList) {
+  EXPECT_CALL(*repo_, GetTasksByUser(kUserId))
+      .Times(2)
+      .WillRepeatedly(Return(UserTasks()));
+  EXPECT_CALL(*repo_, DeleteTaskById(kTaskId2))
+      .WillOnce(Return(UserTasks()[1]));
+
+  cache_->GetTasksByUser(kUserId);
+  ASSERT_TRUE(cache_->DeleteTaskById(kTaskId2));
+  cache_->GetTasksByUser(kUserId);
+}
+
+TEST_F(CachingTaskRepositoryTest, AddInvalidatesOwnerList) {
+  EXPECT_CALL(*repo_, GetTasksByUser(kUserId))
+      .Times(2)
+      .WillRepeatedly(Return(UserTasks()));
+  EXPECT_CALL(*repo_, AddTask(_)).WillOnce(Return(UserTasks()[0]));
+
+  cache_->GetTasksByUser(kUserId);
+  cache_->AddTask(Task{kUserId, "c", "d", TaskStatus::InProject});
+  cache_->GetTasksByUser(kUserId);
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "lru_cache.hpp"
+
+TEST(ShardedLruCacheTest, EvictsLeastRecentlyUsed) {
+  ShardedLruCache<int, std::string> cache(2, 1);
+  cache.Put(1, "a", 1);
+  cache.Put(2, "b", 1);
+  ASSERT_TRUE(cache.Get(1).has_value());
+
+  cache.Put(3, "c", 1);
+
+  EXPECT_TRUE(cache.Get(1).has_value());
+  EXPECT_FALSE(cache.Get(2).has_value());
+  EXPECT_TRUE(cache.Get(3).has_value());
+  EXPECT_EQ(cache.GetStats().evictions, 1u);
+}
+
+TEST(ShardedLruCacheTest, BoundsByWeight) {
+  ShardedLruCache<int, std::string> cache(10, 1);
+  cache.Put(1, "a", 6);
+  cache.Put(2, "b", 6);
+  cache.Put(3, "c", 11);
+
+  EXPECT_FALSE(cache.Get(1).has_value());
+  EXPECT_TRUE(cache.Get(2).has_value());
+  EXPECT_FALSE(cache.Get(3).has_value());
+  EXPECT_EQ(cache.GetStats().weight, 6u);
+}
+
+TEST(ShardedLruCacheTest, PutAfterEraseIsDropped) {
+  ShardedLruCache<int, std::string> cache(10, 1);
+  ShardedLruCache<int, std::string>::Generation generation = 0;
+  ASSERT_FALSE(cache.Get(1, &generation).has_value());
+
+  cache.Erase(1);
+  cache.Put(1, "stale", 1, generation);
+
+  EXPECT_FALSE(cache.Get(1).has_value());
+  const auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 0u);
+  EXPECT_EQ(stats.misses, 2u);
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "coalescing_task_repository.hpp"
+#include "memory_task_repository.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+const Uuid kUserId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60");
+const Uuid kMissingId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a61");
+
+// Пакет выполняется последовательными вызовами InMemoryTaskRepository;
+// запоминает размеры пакетов.
+class FakeBatchWriter : public TaskBatchWriter {
+ public:
+  explicit FakeBatchWriter(TaskRepository& repository)
+      : repository_(repository) {}
+
+  TaskWriteBatchResult WriteBatch(const TaskWriteBatch& batch) override {
+    {
+      std::lock_guard lock(mutex_);
+      sizes_.push_back(batch.adds.size() + batch.updates.size() +
+                       batch.deletes.size());
+    }
+    if (fail)
+      throw std::runtime_error("connection lost");
+    TaskWriteBatchResult result;
+    for (const auto& task : batch.adds)
+      result.adds.push_back(repository_.AddTask(task));
+    for (const auto& [task_id, status] : batch.updates)
+      result.updates.push_back(repository_.UpdateTaskStatus(task_id, status));
+    for (const auto& task_id : batch.deletes)
+      result.deletes.push_back(repository_.DeleteTaskById(task_id));
+    return result;
+  }
+
+  std::vector<std::size_t> Sizes() {
+    std::lock_guard lock(mutex_);
+    return sizes_;
+  }
+
+  std::atomic<bool> fail{false};
+
+ private:
+  TaskRepository& repository_;
+  std::mutex mutex_;
+  std::vector<std::size_t> sizes_;
+};
+
+class CoalescingTaskRepositoryTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<CoalescingTaskRepository> Make(
+      std::chrono::microseconds window, std::size_t max_batch) {
+    CoalescingTaskRepository::Options options;
+    options.window = window;
+    options.max_batch = max_batch;
+    auto memory = std::make_unique<InMemoryTaskRepository>();
+    memory_ = memory.get();
+    writer_ = std::make_unique<FakeBatchWriter>(*memory_);
+    return std::make_unique<CoalescingTaskRepository>(std::move(memory),
+                                                      *writer_, options);
+  }
+
+  Uuid AddDirectly(const std::string& title) {
+    return memory_->AddTask(Task{kUserId, title, "d", TaskStatus::InProgress})
+        ->GetId();
+  }
+
+  InMemoryTaskRepository* memory_ = nullptr;
+  std::unique_ptr<FakeBatchWriter> writer_;
+};
+
+}  // namespace
+
+TEST_F(CoalescingTaskRepositoryTest, SingleWritesGoThroughTheWriter) {
+  auto repo = Make(0us, 128);
+
+  const auto added =
+      repo->AddTask(Task{kUserId, "a", "d", TaskStatus::InProgress});
+  ASSERT_TRUE(added.has_value());
+  EXPECT_EQ(repo->GetTaskById(added->GetId())->GetTitle(), "a");
+
+  const auto updated = repo->UpdateTaskStatus(added->GetId(), TaskStatus::Done);
+  ASSERT_TRUE(updated.has_value());
+  EXPECT_EQ(updated->GetStatus(), TaskStatus::Done);
+  EXPECT_EQ(repo->UpdateTaskStatus(kMissingId, TaskStatus::Done).error(),
+            UpdateTaskError::NotFound);
+
+  EXPECT_EQ(repo->DeleteTaskById(added->GetId())->GetId(), added->GetId());
+  EXPECT_EQ(repo->DeleteTaskById(added->GetId()).error(),
+            DeleteTaskError::NotFound);
+
+  EXPECT_EQ(writer_->Sizes(), (std::vector<std::size_t>{1, 1, 1, 1, 1}));
+  EXPECT_EQ(repo->GetStats().batches, 5u);
+}
+
+TEST_F(CoalescingTaskRepositoryTest, ConcurrentWritesShareBatches) {
+  constexpr int kThreads = 8;
+  auto repo = Make(50ms, 128);
+  std::vector<Uuid> ids;
+  for (int i = 0; i < kThreads; ++i)
+    ids.push_back(AddDirectly("task " + std::to_string(i)));
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&, i] {
+      // Каждый поток получает свою задачу, а не соседнюю по пакету; NotFound
+      // одного не мешает остальным.
+      const auto status = i % 2 ? TaskStatus::Done : TaskStatus::InProject;
+      const auto updated = repo->UpdateTaskStatus(ids[i], status);
+      ASSERT_TRUE(updated.has_value());
+      EXPECT_EQ(updated->GetId(), ids[i]);
+      EXPECT_EQ(updated->GetStatus(), status);
+      EXPECT_EQ(repo->DeleteTaskById(kMissingId).error(),
+                DeleteTaskError::NotFound);
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  const auto stats = repo->GetStats();
+  EXPECT_EQ(stats.writes, 2u * kThreads);
+  EXPECT_LT(stats.batches, stats.writes);
+  for (int i = 0; i < kThreads; ++i) {
+    EXPECT_EQ(memory_->GetTaskById(ids[i])->GetStatus(),
+              i % 2 ? TaskStatus::Done : TaskStatus::InProject);
+  }
+}
+
+TEST_F(CoalescingTaskRepositoryTest, FullBatchDoesNotWaitForWindow) {
+  constexpr int kThreads = 4;
+  auto repo = Make(10s, kThreads);
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([&] {
+      EXPECT_TRUE(
+          repo->AddTask(Task{kUserId, "t", "d", TaskStatus::InProgress}));
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  EXPECT_EQ(writer_->Sizes(), std::vector<std::size_t>{kThreads});
+  EXPECT_EQ(memory_->Size(), static_cast<std::size_t>(kThreads));
+}
+
+TEST_F(CoalescingTaskRepositoryTest, WriterFailureFailsEveryWriteOfBatch) {
+  auto repo = Make(0us, 128);
+  const Uuid id = AddDirectly("a");
+  writer_->fail = true;
+
+  EXPECT_EQ(repo->UpdateTaskStatus(id, TaskStatus::Done).error(),
+            UpdateTaskError::RepositoryError);
+  EXPECT_EQ(
+      repo->AddTask(Task{kUserId, "b", "d", TaskStatus::InProgress}).error(),
+      AddTaskError::RepositoryError);
+
+  writer_->fail = false;
+  EXPECT_TRUE(repo->UpdateTaskStatus(id, TaskStatus::Done));
+}
+
+TEST_F(CoalescingTaskRepositoryTest, BulkOperationsBypassBatching) {
+  auto repo = Make(10s, 128);
+
+  const auto added =
+      repo->AddTasks({Task{kUserId, "a", "d", TaskStatus::InProgress},
+                      Task{kUserId, "b", "d", TaskStatus::InProgress}});
+  ASSERT_TRUE(added.has_value());
+  EXPECT_TRUE(repo->UpdateTaskStatuses(
+      {{(*added)[0].GetId(), TaskStatus::Done},
+       {(*added)[1].GetId(), TaskStatus::Done}}));
+  EXPECT_EQ(repo->GetTasksByUser(kUserId)->size(), 2u);
+  EXPECT_TRUE(writer_->Sizes().empty());
+}
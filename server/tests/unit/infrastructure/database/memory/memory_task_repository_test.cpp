@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "memory_task_repository.hpp"
+
+namespace {
+
+const Uuid kUserId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60");
+const Uuid kOtherUserId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a61");
+
+bool InPageOrder(const std::vector<Task>& tasks) {
+  return std::is_sorted(tasks.begin(), tasks.end(),
+                        [](const Task& a, const Task& b) {
+                          return std::forward_as_tuple(a.GetStatus(),
+                                                       a.GetTitle(),
+                                                       a.GetId()) <
+                                 std::forward_as_tuple(b.GetStatus(),
+                                                       b.GetTitle(),
+                                                       b.GetId());
+                        });
+}
+
+}  // namespace
+
+class InMemoryTaskRepositoryTest : public ::testing::Test {
+ protected:
+  InMemoryTaskRepository repo_{InMemoryTaskRepository::Options{4}};
+
+  Task Add(const Uuid& user_id, const std::string& title, TaskStatus status) {
+    auto r = repo_.AddTask(Task{user_id, title, "d", status});
+    EXPECT_TRUE(r.has_value());
+    return *r;
+  }
+};
+
+TEST_F(InMemoryTaskRepositoryTest, AddAssignsIdAndGetReturnsTask) {
+  const Task added = Add(kUserId, "title", TaskStatus::InProject);
+
+  EXPECT_FALSE(added.GetId().IsNil());
+  const auto found = repo_.GetTaskById(added.GetId());
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->GetUserId(), kUserId);
+  EXPECT_EQ(found->GetTitle(), "title");
+  EXPECT_EQ(found->GetDescription(), "d");
+  EXPECT_EQ(found->GetStatus(), TaskStatus::InProject);
+  EXPECT_EQ(repo_.GetTaskById(Uuid{}).error(), FindTaskError::NotFound);
+}
+
+TEST_F(InMemoryTaskRepositoryTest, UserTasksAreInPageOrder) {
+  Add(kUserId, "b", TaskStatus::Done);
+  Add(kUserId, "a", TaskStatus::Done);
+  Add(kUserId, "z", TaskStatus::InProgress);
+  Add(kOtherUserId, "c", TaskStatus::InProgress);
+
+  const auto tasks = repo_.GetTasksByUser(kUserId);
+  ASSERT_TRUE(tasks.has_value());
+  ASSERT_EQ(tasks->size(), 3u);
+  EXPECT_EQ((*tasks)[0].GetTitle(), "z");
+  EXPECT_EQ((*tasks)[1].GetTitle(), "a");
+  EXPECT_EQ((*tasks)[2].GetTitle(), "b");
+  EXPECT_TRUE(repo_.GetTasksByUser(Uuid{})->empty());
+}
+
+TEST_F(InMemoryTaskRepositoryTest, PagesContinueAfterCursor) {
+  for (int i = 0; i < 7; ++i)
+    Add(kUserId, "t" + std::to_string(i), TaskStatus::InProject);
+
+  std::vector<Task> all;
+  std::optional<TaskPageCursor> after;
+  for (;;) {
+    const auto page = repo_.GetTasksByUserPage(kUserId, after, 3);
+    ASSERT_TRUE(page.has_value());
+    if (page->empty())
+      break;
+    EXPECT_LE(page->size(), 3u);
+    all.insert(all.end(), page->begin(), page->end());
+    const Task& last = page->back();
+    after = TaskPageCursor{last.GetStatus(), last.GetTitle(), last.GetId()};
+  }
+  ASSERT_EQ(all.size(), 7u);
+  EXPECT_TRUE(InPageOrder(all));
+  EXPECT_EQ(all.front().GetTitle(), "t0");
+}
+
+TEST_F(InMemoryTaskRepositoryTest, UpdateStatusMovesTaskInUserList) {
+  const Task a = Add(kUserId, "a", TaskStatus::InProgress);
+  Add(kUserId, "b", TaskStatus::InProgress);
+
+  const auto updated = repo_.UpdateTaskStatus(a.GetId(), TaskStatus::Done);
+  ASSERT_TRUE(updated.has_value());
+  EXPECT_EQ(updated->GetStatus(), TaskStatus::Done);
+  EXPECT_EQ(updated->GetTitle(), "a");
+
+  const auto tasks = repo_.GetTasksByUser(kUserId);
+  ASSERT_EQ(tasks->size(), 2u);
+  EXPECT_EQ((*tasks)[1].GetId(), a.GetId());
+  EXPECT_EQ(repo_.GetTaskById(a.GetId())->GetStatus(), TaskStatus::Done);
+  EXPECT_EQ(repo_.UpdateTaskStatus(Uuid{}, TaskStatus::Done).error(),
+            UpdateTaskError::NotFound);
+}
+
+TEST_F(InMemoryTaskRepositoryTest, DeleteReturnsDeletedTask) {
+  const Task a = Add(kUserId, "a", TaskStatus::InProgress);
+
+  const auto deleted = repo_.DeleteTaskById(a.GetId());
+  ASSERT_TRUE(deleted.has_value());
+  EXPECT_EQ(deleted->GetTitle(), "a");
+  EXPECT_EQ(repo_.GetTaskById(a.GetId()).error(), FindTaskError::NotFound);
+  EXPECT_TRUE(repo_.GetTasksByUser(kUserId)->empty());
+  EXPECT_EQ(repo_.DeleteTaskById(a.GetId()).error(),
+            DeleteTaskError::NotFound);
+  EXPECT_EQ(repo_.Size(), 0u);
+}
+
+TEST_F(InMemoryTaskRepositoryTest, BatchUpdateIsAllOrNothing) {
+  const auto created = repo_.AddTasks(
+      {Task{kUserId, "a", "d", TaskStatus::InProgress},
+       Task{kOtherUserId, "b", "d", TaskStatus::InProgress}});
+  ASSERT_TRUE(created.has_value());
+  ASSERT_EQ(created->size(), 2u);
+
+  const auto failed = repo_.UpdateTaskStatuses(
+      {{(*created)[0].GetId(), TaskStatus::Done}, {Uuid{}, TaskStatus::Done}});
+  EXPECT_EQ(failed.error(), UpdateTaskError::NotFound);
+  EXPECT_EQ(repo_.GetTaskById((*created)[0].GetId())->GetStatus(),
+            TaskStatus::InProgress);
+
+  const auto updated =
+      repo_.UpdateTaskStatuses({{(*created)[0].GetId(), TaskStatus::Done},
+                                {(*created)[1].GetId(), TaskStatus::Done}});
+  ASSERT_TRUE(updated.has_value());
+  EXPECT_EQ(repo_.GetTaskById((*created)[1].GetId())->GetStatus(),
+            TaskStatus::Done);
+}
+
+// Все ядра одновременно создают, меняют, удаляют и читают задачи общих
+// пользователей. Пакетная смена статуса пары задач одного пользователя
+// должна быть видна в его списке целиком.
+TEST_F(InMemoryTaskRepositoryTest, StressFromAllCores) {
+  const std::size_t threads =
+      std::max(4u, std::thread::hardware_concurrency());
+  constexpr int kOperations = 5000;
+  constexpr int kUsers = 8;
+
+  std::vector<Uuid> users;
+  std::vector<std::pair<Uuid, Uuid>> pairs;
+  for (int u = 0; u < kUsers; ++u) {
+    users.push_back(Uuid::Random());
+    const auto pair =
+        repo_.AddTasks({Task{users.back(), "pair-a", "d", TaskStatus::Done},
+                        Task{users.back(), "pair-b", "d", TaskStatus::Done}});
+    ASSERT_TRUE(pair.has_value());
+    pairs.emplace_back((*pair)[0].GetId(), (*pair)[1].GetId());
+  }
+
+  std::atomic<std::int64_t> added{0};
+  std::atomic<std::int64_t> deleted{0};
+  std::atomic<int> violations{0};
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      std::mt19937_64 rng(t);
+      std::vector<Uuid> own;
+      for (int i = 0; i < kOperations; ++i) {
+        const Uuid& user = users[rng() % users.size()];
+        const auto status = static_cast<TaskStatus>(rng() % 3);
+        switch (rng() % 6) {
+          case 0:
+          case 1: {
+            auto r = repo_.AddTask(
+                Task{user, "t" + std::to_string(rng() % 100), "d", status});
+            if (r) {
+              own.push_back(r->GetId());
+              added.fetch_add(1);
+            }
+            break;
+          }
+          case 2:
+            if (!own.empty()) {
+              if (!repo_.UpdateTaskStatus(own[rng() % own.size()], status))
+                violations.fetch_add(1);
+            }
+            break;
+          case 3:
+            if (!own.empty()) {
+              const std::size_t index = rng() % own.size();
+              if (repo_.DeleteTaskById(own[index]))
+                deleted.fetch_add(1);
+              else
+                violations.fetch_add(1);
+              own.erase(own.begin() + static_cast<std::ptrdiff_t>(index));
+            }
+            break;
+          case 4: {
+            const auto& [a, b] = pairs[rng() % pairs.size()];
+            if (!repo_.UpdateTaskStatuses({{a, status}, {b, status}}))
+              violations.fetch_add(1);
+            break;
+          }
+          default: {
+            const std::size_t u = rng() % users.size();
+            const auto tasks = repo_.GetTasksByUser(users[u]);
+            if (!tasks || !InPageOrder(*tasks)) {
+              violations.fetch_add(1);
+              break;
+            }
+            std::optional<TaskStatus> a_status;
+            std::optional<TaskStatus> b_status;
+            for (const auto& task : *tasks) {
+              if (task.GetId() == pairs[u].first)
+                a_status = task.GetStatus();
+              if (task.GetId() == pairs[u].second)
+                b_status = task.GetStatus();
+            }
+            if (!a_status || a_status != b_status)
+              violations.fetch_add(1);
+          }
+        }
+      }
+    });
+  }
+  for (auto& worker : workers)
+    worker.join();
+
+  EXPECT_EQ(violations.load(), 0);
+  const auto expected_size =
+      static_cast<std::size_t>(2 * kUsers + added.load() - deleted.load());
+  EXPECT_EQ(repo_.Size(), expected_size);
+  std::size_t listed = 0;
+  for (const auto& user : users) {
+    const auto tasks = repo_.GetTasksByUser(user);
+    ASSERT_TRUE(tasks.has_value());
+    for (const auto& task : *tasks) {
+      const auto found = repo_.GetTaskById(task.GetId());
+      ASSERT_TRUE(found.has_value());
+      EXPECT_EQ(found->GetStatus(), task.GetStatus());
+    }
+    listed += tasks->size();
+  }
+  EXPECT_EQ(listed, expected_size);
+}
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "memory_user_repository.hpp"
+
+TEST(InMemoryUserRepositoryTest, AddThenFind) {
+  InMemoryUserRepository repo;
+
+  const auto added = repo.AddUser(User{"alice", "secret"});
+  ASSERT_TRUE(added.has_value());
+  EXPECT_FALSE(added->GetId().IsNil());
+
+  const auto found = repo.FindUser("alice");
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->GetId(), added->GetId());
+  EXPECT_EQ(found->GetPassword(), "secret");
+  EXPECT_EQ(repo.FindUser("bob").error(), FindUserError::NotFound);
+}
+
+TEST(InMemoryUserRepositoryTest, UpdatePasswordKeepsId) {
+  InMemoryUserRepository repo;
+  const auto added = repo.AddUser(User{"alice", "secret"});
+  ASSERT_TRUE(added.has_value());
+
+  ASSERT_TRUE(repo.UpdatePassword("alice", "hash"));
+
+  const auto found = repo.FindUser("alice");
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->GetId(), added->GetId());
+  EXPECT_EQ(found->GetPassword(), "hash");
+  EXPECT_EQ(repo.UpdatePassword("bob", "hash").error(),
+            UpdateUserError::NotFound);
+}
+
+TEST(InMemoryUserRepositoryTest, LoginIsUniqueUnderConcurrentRegistration) {
+  InMemoryUserRepository repo;
+  std::atomic<int> registered{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&] {
+      auto r = repo.AddUser(User{"alice", "secret"});
+      if (r) {
+        registered.fetch_add(1);
+      } else {
+        EXPECT_EQ(r.error(), AddUserError::AlreadyExists);
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  EXPECT_EQ(registered.load(), 1);
+}
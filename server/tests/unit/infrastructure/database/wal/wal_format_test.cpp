@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "wal_format.hpp"
+
+namespace {
+
+const Uuid kTaskId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60");
+const Uuid kUserId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a61");
+
+std::vector<WalOp> SampleOps() {
+  return {WalAddUser{User{kUserId, "alice", "secret"}},
+          WalAddTask{Task{kTaskId, kUserId, "title", "",
+                          TaskStatus::InProject}},
+          WalUpdateTaskStatus{kTaskId, TaskStatus::Done},
+          WalDeleteTask{kTaskId}};
+}
+
+std::vector<std::vector<WalOp>> ParseAll(std::string_view data,
+                                         WalParseResult* result = nullptr) {
+  std::vector<std::vector<WalOp>> records;
+  const auto parsed = ParseWalRecords(
+      data, [&](const std::vector<WalOp>& ops) { records.push_back(ops); });
+  if (result)
+    *result = parsed;
+  return records;
+}
+
+}  // namespace
+
+TEST(WalFormatTest, Crc32cMatchesKnownValue) {
+  EXPECT_EQ(Crc32c("123456789"), 0xE3069283u);
+}
+
+TEST(WalFormatTest, HeaderRoundTrip) {
+  std::string data;
+  AppendWalHeader(data, kWalLogMagic, 42);
+  ASSERT_EQ(data.size(), kWalHeaderSize);
+  EXPECT_EQ(ReadWalHeader(data, kWalLogMagic), 42);
+  EXPECT_EQ(ReadWalHeader(data, kWalSnapshotMagic), -1);
+  EXPECT_EQ(ReadWalHeader(data.substr(0, 10), kWalLogMagic), -1);
+}
+
+TEST(WalFormatTest, RecordRoundTrip) {
+  std::string data;
+  AppendWalRecord(data, SampleOps());
+  AppendWalRecord(data, {WalDeleteTask{kUserId}});
+  AppendWalRecord(data, {WalUpdateUserPassword{"alice", "hash"}});
+
+  WalParseResult result;
+  const auto records = ParseAll(data, &result);
+  EXPECT_EQ(result.valid_bytes, data.size());
+  ASSERT_EQ(records.size(), 3u);
+  ASSERT_EQ(records[0].size(), 4u);
+
+  const auto& user = std::get<WalAddUser>(records[0][0]).user;
+  EXPECT_EQ(user.GetId(), kUserId);
+  EXPECT_EQ(user.GetName(), "alice");
+  EXPECT_EQ(user.GetPassword(), "secret");
+  const auto& task = std::get<WalAddTask>(records[0][1]).task;
+  EXPECT_EQ(task.GetId(), kTaskId);
+  EXPECT_EQ(task.GetUserId(), kUserId);
+  EXPECT_EQ(task.GetTitle(), "title");
+  EXPECT_EQ(task.GetDescription(), "");
+  EXPECT_EQ(task.GetStatus(), TaskStatus::InProject);
+  const auto& update = std::get<WalUpdateTaskStatus>(records[0][2]);
+  EXPECT_EQ(update.task_id, kTaskId);
+  EXPECT_EQ(update.status, TaskStatus::Done);
+  EXPECT_EQ(std::get<WalDeleteTask>(records[0][3]).task_id, kTaskId);
+  EXPECT_EQ(std::get<WalDeleteTask>(records[1][0]).task_id, kUserId);
+  const auto& password = std::get<WalUpdateUserPassword>(records[2][0]);
+  EXPECT_EQ(password.login, "alice");
+  EXPECT_EQ(password.password, "hash");
+}
+
+TEST(WalFormatTest, StopsAtTornTail) {
+  std::string data;
+  AppendWalRecord(data, SampleOps());
+  const std::size_t first = data.size();
+  AppendWalRecord(data, SampleOps());
+
+  for (std::size_t cut = first; cut < data.size(); ++cut) {
+    WalParseResult result;
+    const auto records = ParseAll(std::string_view(data).substr(0, cut),
+                                  &result);
+    EXPECT_EQ(records.size(), 1u) << "cut at " << cut;
+    EXPECT_EQ(result.valid_bytes, first) << "cut at " << cut;
+  }
+}
+
+TEST(WalFormatTest, StopsAtCorruptedRecord) {
+  std::string data;
+  AppendWalRecord(data, SampleOps());
+  const std::size_t first = data.size();
+  AppendWalRecord(data, SampleOps());
+  AppendWalRecord(data, SampleOps());
+  data[first + kWalRecordHeaderSize + 3] ^= 0x01;
+
+  WalParseResult result;
+  const auto records = ParseAll(data, &result);
+  EXPECT_EQ(records.size(), 1u);
+  EXPECT_EQ(result.valid_bytes, first);
+}
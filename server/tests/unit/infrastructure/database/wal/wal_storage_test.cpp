@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "wal_repositories.hpp"
+#include "wal_storage.hpp"
+
+namespace {
+
+const Uuid kUserId = *Uuid::Parse("6f1c2a9e-3b4d-4e5f-8a7b-1c2d3e4f5a60");
+
+class WalStorageTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    directory_ = std::filesystem::temp_directory_path() /
+                 ("wal_storage_test_" + std::to_string(std::random_device{}()));
+    std::filesystem::remove_all(directory_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  std::shared_ptr<WalStorage> Open(std::uint64_t snapshot_every = 0) {
+    WalStorage::Options options;
+    options.directory = directory_;
+    options.snapshot_every = snapshot_every;
+    return std::make_shared<WalStorage>(options);
+  }
+
+  std::vector<std::filesystem::path> Segments() const {
+    std::vector<std::filesystem::path> segments;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+      if (entry.path().extension() == ".log")
+        segments.push_back(entry.path());
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+  }
+
+  void AppendToFile(const std::filesystem::path& path,
+                    const std::string& data) {
+    std::ofstream(path, std::ios::binary | std::ios::app) << data;
+  }
+
+  std::filesystem::path directory_;
+};
+
+Task NewTask(const std::string& title) {
+  return Task{kUserId, title, "d", TaskStatus::InProgress};
+}
+
+}  // namespace
+
+TEST_F(WalStorageTest, ReopenRestoresCommittedChanges) {
+  Uuid kept;
+  Uuid deleted;
+  Uuid user_id;
+  {
+    auto storage = Open();
+    WalTaskRepository tasks(storage);
+    WalUserRepository users(storage);
+    user_id = users.AddUser(User{"alice", "plain"})->GetId();
+    ASSERT_TRUE(users.UpdatePassword("alice", "secret"));
+    EXPECT_EQ(users.UpdatePassword("bob", "secret").error(),
+              UpdateUserError::NotFound);
+    kept = tasks.AddTask(NewTask("kept"))->GetId();
+    deleted = tasks.AddTask(NewTask("deleted"))->GetId();
+    ASSERT_TRUE(tasks.UpdateTaskStatus(kept, TaskStatus::Done));
+    ASSERT_TRUE(tasks.DeleteTaskById(deleted));
+    ASSERT_TRUE(tasks.AddTasks({NewTask("a"), NewTask("b")}));
+    EXPECT_EQ(tasks.UpdateTaskStatus(deleted, TaskStatus::Done).error(),
+              UpdateTaskError::NotFound);
+  }
+
+  auto storage = Open();
+  WalTaskRepository tasks(storage);
+  WalUserRepository users(storage);
+  const auto user = users.FindUser("alice");
+  ASSERT_TRUE(user.has_value());
+  EXPECT_EQ(user->GetId(), user_id);
+  EXPECT_EQ(user->GetPassword(), "secret");
+  EXPECT_EQ(tasks.GetTaskById(kept)->GetStatus(), TaskStatus::Done);
+  EXPECT_EQ(tasks.GetTaskById(deleted).error(), FindTaskError::NotFound);
+  EXPECT_EQ(tasks.GetTasksByUser(kUserId)->size(), 3u);
+}
+
+TEST_F(WalStorageTest, TornTailIsDroppedAndLaterWritesSurvive) {
+  {
+    auto storage = Open();
+    WalTaskRepository tasks(storage);
+    ASSERT_TRUE(tasks.AddTask(NewTask("before crash")));
+  }
+  // Сбой посреди записи: в конце сегмента ползаписи.
+  ASSERT_EQ(Segments().size(), 1u);
+  AppendToFile(Segments()[0], std::string("\x40\x00\x00\x00\x12\x34", 6));
+
+  {
+    auto storage = Open();
+    WalTaskRepository tasks(storage);
+    EXPECT_EQ(tasks.GetTasksByUser(kUserId)->size(), 1u);
+    ASSERT_TRUE(tasks.AddTask(NewTask("after crash")));
+  }
+
+  auto storage = Open();
+  EXPECT_EQ(storage->Tasks().Size(), 2u);
+}
+
+TEST_F(WalStorageTest, TornSegmentHeaderIsRecreated) {
+  {
+    auto storage = Open();
+    WalTaskRepository tasks(storage);
+    ASSERT_TRUE(tasks.AddTask(NewTask("a")));
+    storage->Snapshot();
+  }
+  // Сбой при создании сегмента: заголовок записан не целиком.
+  const auto segment = Segments().back();
+  std::filesystem::resize_file(segment, 5);
+
+  {
+    auto storage = Open();
+    WalTaskRepository tasks(storage);
+    ASSERT_TRUE(tasks.AddTask(NewTask("b")));
+  }
+  EXPECT_EQ(Open()->Tasks().Size(), 2u);
+}
+
+TEST_F(WalStorageTest, SnapshotReplacesOldSegments) {
+  Uuid updated;
+  {
+    auto storage = Open();
+    WalTaskRepository tasks(storage);
+    for (int i = 0; i < 10; ++i)
+      ASSERT_TRUE(tasks.AddTask(NewTask("task " + std::to_string(i))));
+    updated = tasks.GetTasksByUser(kUserId)->front().GetId();
+    storage->Snapshot();
+    EXPECT_EQ(storage->GetStats().snapshots, 1u);
+    ASSERT_TRUE(tasks.UpdateTaskStatus(updated, TaskStatus::Done));
+    ASSERT_TRUE(tasks.AddTask(NewTask("after snapshot")));
+  }
+  ASSERT_EQ(Segments().size(), 1u);
+  EXPECT_TRUE(std::filesystem::exists(directory_ / "snapshot"));
+
+  auto storage = Open();
+  EXPECT_EQ(storage->Tasks().Size(), 11u);
+  EXPECT_EQ(storage->Tasks().GetTaskById(updated)->GetStatus(),
+            TaskStatus::Done);
+}
+
+TEST_F(WalStorageTest, SegmentsLeftBeforeSnapshotAreIgnored) {
+  Uuid deleted;
+  std::filesystem::path old_segment;
+  std::string old_contents;
+  {
+    auto storage = Open();
+    WalTaskRepository tasks(storage);
+    deleted = tasks.AddTask(NewTask("deleted"))->GetId();
+    old_segment = Segments()[0];
+    std::ifstream in(old_segment, std::ios::binary);
+    old_contents.assign(std::istreambuf_iterator<char>(in), {});
+    storage->Snapshot();
+    ASSERT_TRUE(tasks.DeleteTaskById(deleted));
+  }
+  // Сбой между записью снимка и удалением старых сегментов.
+  std::ofstream(old_segment, std::ios::binary) << old_contents;
+
+  auto storage = Open();
+  EXPECT_EQ(storage->Tasks().GetTaskById(deleted).error(),
+            FindTaskError::NotFound);
+  EXPECT_FALSE(std::filesystem::exists(old_segment));
+}
+
+TEST_F(WalStorageTest, BackgroundSnapshotKeepsWritesDuringIt) {
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 200;
+  {
+    auto storage = Open(/*snapshot_every=*/50);
+    WalTaskRepository tasks(storage);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&] {
+        for (int i = 0; i < kPerThread; ++i) {
+          const auto task = tasks.AddTask(NewTask("t"));
+          ASSERT_TRUE(task.has_value());
+          if (i % 2 == 0) {
+            ASSERT_TRUE(tasks.UpdateTaskStatus(task->GetId(),
+                                               TaskStatus::Done));
+          }
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    storage->Snapshot();
+    EXPECT_GE(storage->GetStats().snapshots, 1u);
+  }
+
+  auto storage = Open();
+  const auto all = storage->Tasks().GetTasksByUser(kUserId);
+  ASSERT_EQ(all->size(), static_cast<std::size_t>(kThreads * kPerThread));
+  const auto done = std::count_if(all->begin(), all->end(), [](const Task& t) {
+    return t.GetStatus() == TaskStatus::Done;
+  });
+  EXPECT_EQ(done, kThreads * kPerThread / 2);
+}
+
+TEST_F(WalStorageTest, CorruptSnapshotFailsToOpen) {
+  {
+    auto storage = Open();
+    WalTaskRepository tasks(storage);
+    ASSERT_TRUE(tasks.AddTask(NewTask("a")));
+    storage->Snapshot();
+  }
+  std::fstream file(directory_ / "snapshot",
+                    std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(-1, std::ios::end);
+  file.put('\xff');
+  file.close();
+
+  EXPECT_THROW(Open(), std::runtime_error);
+}
+
+TEST_F(WalStorageTest, ConcurrentWritersShareSyncs) {
+  constexpr int kThreads = 8;
+  constexpr int kPerThread = 50;
+  WalStorage::Options options;
+  options.directory = directory_;
+  options.snapshot_every = 0;
+  options.commit_delay = std::chrono::microseconds(500);
+  auto storage = std::make_shared<WalStorage>(options);
+  WalTaskRepository tasks(storage);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < kPerThread; ++i)
+        ASSERT_TRUE(tasks.AddTask(NewTask("t")));
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  const auto stats = storage->GetStats();
+  EXPECT_EQ(stats.records, static_cast<std::uint64_t>(kThreads * kPerThread));
+  EXPECT_LT(stats.syncs, stats.records);
+}
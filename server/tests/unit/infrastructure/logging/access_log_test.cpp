@@ -0,0 +1,158 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "access_log.hpp"
+
+using ::testing::HasSubstr;
+using ::testing::MatchesRegex;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Фоновый поток не успевает сработать за время теста: записи попадают в out
+// только через Flush.
+AccessLog::Options ManualOptions() {
+  AccessLog::Options options;
+  options.drain_interval = std::chrono::hours(1);
+  return options;
+}
+
+std::vector<std::string> Lines(const std::ostringstream& out) {
+  std::vector<std::string> lines;
+  std::istringstream in(out.str());
+  for (std::string line; std::getline(in, line);)
+    lines.push_back(line);
+  return lines;
+}
+
+}  // namespace
+
+TEST(AccessLogTest, WritesStructuredLine) {
+  std::ostringstream out;
+  AccessLog log(out, ManualOptions());
+
+  log.Log("GET", "/task/1", 200, 153us);
+  EXPECT_TRUE(out.str().empty());
+  log.Flush();
+
+  const auto lines = Lines(out);
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_THAT(lines[0],
+              MatchesRegex("ts=[0-9]{4}-[0-9]{2}-[0-9]{2}T[0-9]{2}:[0-9]{2}:"
+                           "[0-9]{2}\\.[0-9]{6}Z level=info method=GET "
+                           "target=/task/1 status=200 latency_us=153 "
+                           "thread=[0-9]+"));
+  EXPECT_EQ(log.GetStats().written, 1u);
+}
+
+TEST(AccessLogTest, ServerErrorsAreWarnings) {
+  std::ostringstream out;
+  AccessLog log(out, ManualOptions());
+
+  log.Log("POST", "/task", 503, 1ms);
+  log.Flush();
+
+  EXPECT_THAT(out.str(), HasSubstr("level=warning method=POST"));
+  EXPECT_THAT(out.str(), HasSubstr("latency_us=1000"));
+}
+
+TEST(AccessLogTest, SamplesOnlySuccessfulRequests) {
+  std::ostringstream out;
+  auto options = ManualOptions();
+  options.sample_every = 4;
+  AccessLog log(out, options);
+
+  for (int i = 0; i < 8; ++i)
+    log.Log("GET", "/task", 200, 1us);
+  log.Log("GET", "/task", 404, 1us);
+  log.Flush();
+
+  const auto lines = Lines(out);
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_THAT(lines[2], HasSubstr("status=404"));
+  EXPECT_EQ(log.GetStats().sampled_out, 6u);
+}
+
+TEST(AccessLogTest, LevelCanBeChangedAtRuntime) {
+  std::ostringstream out;
+  AccessLog log(out, ManualOptions());
+
+  log.SetLevel(LogLevel::Warning);
+  EXPECT_EQ(log.GetLevel(), LogLevel::Warning);
+  log.Log("GET", "/task", 200, 1us);
+  log.Log("GET", "/task", 400, 1us);
+  log.Log("GET", "/task", 500, 1us);
+  log.Flush();
+  ASSERT_EQ(Lines(out).size(), 1u);
+
+  log.SetLevel(LogLevel::Info);
+  log.Log("GET", "/task", 200, 1us);
+  log.Flush();
+  EXPECT_EQ(Lines(out).size(), 2u);
+}
+
+TEST(AccessLogTest, DropsRecordsWhenRingIsFull) {
+  std::ostringstream out;
+  auto options = ManualOptions();
+  options.ring_capacity = 4;
+  AccessLog log(out, options);
+
+  for (int i = 0; i < 6; ++i)
+    log.Log("GET", "/task", 200, 1us);
+  log.Flush();
+
+  EXPECT_EQ(Lines(out).size(), 4u);
+  EXPECT_EQ(log.GetStats().dropped, 2u);
+}
+
+TEST(AccessLogTest, SanitizesAndTruncatesTarget) {
+  std::ostringstream out;
+  AccessLog log(out, ManualOptions());
+
+  log.Log("GET", "/a b\"c\n", 200, 1us);
+  log.Log("GET", "/" + std::string(1000, 'x'), 200, 1us);
+  log.Flush();
+
+  const auto lines = Lines(out);
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_THAT(lines[0], HasSubstr("target=/a?b?c? status=200"));
+  EXPECT_THAT(lines[1], HasSubstr("xxx... status=200"));
+}
+
+TEST(AccessLogTest, CollectsRecordsFromAllThreads) {
+  std::ostringstream out;
+  AccessLog::Options options;
+  options.drain_interval = 1ms;
+  AccessLog log(out, options);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&log] {
+      for (int i = 0; i < 500; ++i) {
+        log.Log("GET", "/task", 200, 1us);
+        if (i % 100 == 0)
+          std::this_thread::sleep_for(2ms);
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  log.Flush();
+
+  const auto stats = log.GetStats();
+  EXPECT_EQ(stats.written + stats.dropped, 2000u);
+  EXPECT_EQ(Lines(out).size(), stats.written);
+}
+
+TEST(LogLevelTest, ParsesNames) {
+  EXPECT_EQ(ParseLogLevel("debug"), LogLevel::Debug);
+  EXPECT_EQ(ParseLogLevel("off"), LogLevel::Off);
+  EXPECT_EQ(ParseLogLevel("verbose"), std::nullopt);
+  EXPECT_EQ(ToString(LogLevel::Warning), "warning");
+}
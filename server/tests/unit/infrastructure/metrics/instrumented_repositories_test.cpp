@@ -0,0 +1,54 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+
+#include "instrumented_repositories.hpp"
+#include "memory_task_repository.hpp"
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+namespace {
+
+class CountingBatchWriter final : public TaskBatchWriter {
+ public:
+  TaskWriteBatchResult WriteBatch(const TaskWriteBatch& batch) override {
+    ++calls;
+    TaskWriteBatchResult result;
+    result.deletes.assign(batch.deletes.size(),
+                          std::unexpected(DeleteTaskError::NotFound));
+    return result;
+  }
+
+  int calls = 0;
+};
+
+}  // namespace
+
+TEST(InstrumentedTaskRepositoryTest, TimesBatchWrites) {
+  MetricsRegistry metrics;
+  CountingBatchWriter writer;
+  InstrumentedTaskRepository repository(
+      std::make_unique<InMemoryTaskRepository>(), metrics, &writer);
+
+  TaskWriteBatch batch;
+  batch.deletes.push_back(Uuid::Random());
+  const auto result = repository.WriteBatch(batch);
+  EXPECT_EQ(writer.calls, 1);
+  ASSERT_EQ(result.deletes.size(), 1u);
+  EXPECT_FALSE(result.deletes[0].has_value());
+  EXPECT_THAT(metrics.Render(),
+              HasSubstr("taskmanager_repository_query_duration_seconds_count{"
+                        "repository=\"task\",operation=\"WriteBatch\"} 1\n"));
+}
+
+TEST(InstrumentedTaskRepositoryTest, WithoutWriterHasNoBatchSeries) {
+  MetricsRegistry metrics;
+  InstrumentedTaskRepository repository(
+      std::make_unique<InMemoryTaskRepository>(), metrics);
+
+  EXPECT_THROW(repository.WriteBatch(TaskWriteBatch{}), std::logic_error);
+  EXPECT_THAT(metrics.Render(), Not(HasSubstr("WriteBatch")));
+}
@@ -0,0 +1,112 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics_registry.hpp"
+
+using ::testing::HasSubstr;
+using namespace std::chrono_literals;
+
+TEST(LatencyHistogramTest, BucketsKeepRelativePrecision) {
+  const std::uint64_t values[] = {0,    7,      8,
+                                  100,  1234,   999999,
+                                  LatencyHistogram::kMaxValue - 1};
+  for (const std::uint64_t value : values) {
+    const auto index = LatencyHistogram::BucketIndex(value);
+    ASSERT_LT(index, LatencyHistogram::kBucketCount);
+    const auto max = LatencyHistogram::BucketMaxValue(index);
+    EXPECT_GE(max, value);
+    EXPECT_LE(max - value, value / LatencyHistogram::kSubBuckets) << value;
+    EXPECT_EQ(LatencyHistogram::BucketIndex(max), index);
+    if (index + 1 < LatencyHistogram::kBucketCount) {
+      EXPECT_EQ(LatencyHistogram::BucketIndex(max + 1), index + 1) << value;
+    }
+  }
+}
+
+TEST(LatencyHistogramTest, ClampsLargeValues) {
+  EXPECT_EQ(LatencyHistogram::BucketIndex(~0ull),
+            LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, ReportsQuantiles) {
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 1000; ++i)
+    histogram.Record(std::chrono::microseconds(i));
+
+  const auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.count, 1000u);
+  EXPECT_EQ(snapshot.sum, 500500u);
+  EXPECT_NEAR(snapshot.ValueAtQuantile(0.5), 500, 500 / 8);
+  EXPECT_NEAR(snapshot.ValueAtQuantile(0.99), 990, 990 / 8);
+  EXPECT_EQ(snapshot.CountAtOrBelow(5), 5u);
+}
+
+TEST(LatencyHistogramTest, CountAtOrBelowSkipsBucketCrossingValue) {
+  // 250 и 254 лежат в корзине 240..255.
+  LatencyHistogram histogram;
+  histogram.Record(std::chrono::microseconds(239));
+  histogram.Record(std::chrono::microseconds(250));
+  histogram.Record(std::chrono::microseconds(254));
+
+  const auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.CountAtOrBelow(250), 1u);
+  EXPECT_EQ(snapshot.CountAtOrBelow(255), 3u);
+  EXPECT_EQ(snapshot.CountAtOrBelow(LatencyHistogram::kMaxValue), 3u);
+}
+
+TEST(CounterTest, SumsAcrossThreads) {
+  Counter counter;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&counter] {
+      for (int i = 0; i < 10000; ++i)
+        counter.Add();
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  EXPECT_EQ(counter.Value(), 80000u);
+}
+
+TEST(MetricsRegistryTest, ReturnsSameMetricForSameLabels) {
+  MetricsRegistry registry;
+  auto& a = registry.GetCounter("requests_total", "Requests.",
+                                {{"route", "GET /task"}});
+  auto& b = registry.GetCounter("requests_total", "Requests.",
+                                {{"route", "GET /task"}});
+  auto& c = registry.GetCounter("requests_total", "Requests.",
+                                {{"route", "POST /task"}});
+  EXPECT_EQ(&a, &b);
+  EXPECT_NE(&a, &c);
+}
+
+TEST(MetricsRegistryTest, RendersPrometheusText) {
+  MetricsRegistry registry;
+  registry.GetCounter("requests_total", "Requests.", {{"route", "GET /x"}})
+      .Add(3);
+  registry.GetCounter("requests_total", "Requests.", {{"route", "a\"b"}})
+      .Add();
+  registry.GetHistogram("latency_seconds", "Latency.").Record(300us);
+  registry.AddCollector([](MetricsWriter& writer) {
+    writer.WriteGauge("in_use", "In use.", {}, 2);
+  });
+
+  const auto text = registry.Render();
+  EXPECT_THAT(text, HasSubstr("# HELP requests_total Requests.\n"
+                              "# TYPE requests_total counter\n"
+                              "requests_total{route=\"GET /x\"} 3\n"
+                              "requests_total{route=\"a\\\"b\"} 1\n"));
+  EXPECT_THAT(text, HasSubstr("# TYPE latency_seconds histogram\n"
+                              "latency_seconds_bucket{le=\"0.0001\"} 0\n"
+                              "latency_seconds_bucket{le=\"0.00025\"} 0\n"
+                              "latency_seconds_bucket{le=\"0.0005\"} 1\n"));
+  EXPECT_THAT(text, HasSubstr("latency_seconds_bucket{le=\"+Inf\"} 1\n"
+                              "latency_seconds_sum 0.0003\n"
+                              "latency_seconds_count 1\n"));
+  EXPECT_THAT(text, HasSubstr("# TYPE in_use gauge\nin_use 2\n"));
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "scrypt_password_hasher.hpp"
+
+namespace {
+
+// Дешёвые параметры, чтобы тесты шли быстро.
+ScryptPasswordHasher::Options Cheap(unsigned log_n = 10) {
+  ScryptPasswordHasher::Options options;
+  options.log_n = log_n;
+  options.r = 8;
+  options.p = 1;
+  return options;
+}
+
+}  // namespace
+
+TEST(ScryptPasswordHasherTest, VerifiesItsOwnHash) {
+  ScryptPasswordHasher hasher(Cheap());
+
+  const auto hash = hasher.Hash("secret");
+  ASSERT_TRUE(hash.has_value());
+  EXPECT_TRUE(hash->starts_with("$scrypt$ln=10,r=8,p=1$"));
+  EXPECT_EQ(hash->find("secret"), std::string::npos);
+
+  const auto good = hasher.Verify("secret", *hash);
+  ASSERT_TRUE(good.has_value());
+  EXPECT_TRUE(good->matches);
+  EXPECT_FALSE(good->needs_rehash);
+
+  const auto bad = hasher.Verify("Secret", *hash);
+  ASSERT_TRUE(bad.has_value());
+  EXPECT_FALSE(bad->matches);
+}
+
+TEST(ScryptPasswordHasherTest, SaltsEveryHash) {
+  ScryptPasswordHasher hasher(Cheap());
+
+  const auto first = hasher.Hash("secret");
+  const auto second = hasher.Hash("secret");
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(second.has_value());
+  EXPECT_NE(*first, *second);
+  EXPECT_TRUE(hasher.Verify("secret", *second)->matches);
+}
+
+TEST(ScryptPasswordHasherTest, LegacyPlaintextNeedsRehash) {
+  ScryptPasswordHasher hasher(Cheap());
+
+  const auto good = hasher.Verify("secret", "secret");
+  ASSERT_TRUE(good.has_value());
+  EXPECT_TRUE(good->matches);
+  EXPECT_TRUE(good->needs_rehash);
+
+  EXPECT_FALSE(hasher.Verify("secret", "secret2")->matches);
+  EXPECT_FALSE(hasher.Verify("", "secret")->matches);
+}
+
+TEST(ScryptPasswordHasherTest, OldParametersNeedRehash) {
+  const auto hash = ScryptPasswordHasher(Cheap(10)).Hash("secret");
+  ASSERT_TRUE(hash.has_value());
+
+  const auto check = ScryptPasswordHasher(Cheap(11)).Verify("secret", *hash);
+  ASSERT_TRUE(check.has_value());
+  EXPECT_TRUE(check->matches);
+  EXPECT_TRUE(check->needs_rehash);
+}
+
+TEST(ScryptPasswordHasherTest, CorruptHashIsAnError) {
+  ScryptPasswordHasher hasher(Cheap());
+
+  for (const std::string stored :
+       {"$scrypt$", "$scrypt$ln=10,r=8,p=1$c2FsdA==",
+        "$scrypt$ln=10,r=8$c2FsdA==$a2V5",
+        "$scrypt$ln=10,r=8,p=1$c2FsdA==$!!!!",
+        // Параметры из хранилища тоже ограничены.
+        "$scrypt$ln=40,r=8,p=1$c2FsdA==$a2V5"}) {
+    const auto check = hasher.Verify("secret", stored);
+    ASSERT_FALSE(check.has_value()) << stored;
+    EXPECT_EQ(check.error(), PasswordHashError::InternalError);
+  }
+}
+
+TEST(ScryptPasswordHasherTest, RejectsOutOfRangeOptions) {
+  EXPECT_THROW(ScryptPasswordHasher(Cheap(0)), std::invalid_argument);
+  EXPECT_THROW(ScryptPasswordHasher(Cheap(31)), std::invalid_argument);
+}